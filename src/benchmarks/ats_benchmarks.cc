@@ -0,0 +1,81 @@
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+*/
+//! Driver for the ATS microbenchmark suite.
+
+/*
+  Usage:
+
+    ats_benchmarks [--ncells=N] [--repeats=R] [--group=G] [--output=file.json] [--label=L]
+
+  Groups are: wrm, permafrost, eos, thermal_conductivity, seb, upwinding,
+  advection, column.  If no group is given, all are run.
+*/
+
+#include <fstream>
+#include <iostream>
+
+#include "Teuchos_GlobalMPISession.hpp"
+#include "Teuchos_CommandLineProcessor.hpp"
+
+#include "VerboseObject_objs.hh"
+
+// registration files, required for factory-created models
+#include "ats_relations_registration.hh"
+
+#include "benchmark_harness.hh"
+
+int main(int argc, char *argv[])
+{
+  Teuchos::GlobalMPISession mpiSession(&argc,&argv,0);
+  int rank = mpiSession.getRank();
+
+  Teuchos::CommandLineProcessor clp;
+  clp.setDocString("Microbenchmarks of ATS constitutive kernels and operators.\n");
+
+  int ncells = 1000000;
+  clp.setOption("ncells", &ncells, "Approximate number of cells (or units of work) per kernel call.");
+
+  int nrepeats = 10;
+  clp.setOption("repeats", &nrepeats, "Number of timed repetitions of each kernel.");
+
+  std::string group;
+  clp.setOption("group", &group, "Run only this group of benchmarks.");
+
+  std::string output;
+  clp.setOption("output", &output, "Write results as JSON to this file.");
+
+  std::string label = "ats";
+  clp.setOption("label", &label, "Label stored with JSON results, e.g. a version or git hash.");
+
+  clp.throwExceptions(false);
+  clp.recogniseAllOptions(true);
+
+  auto parseReturn = clp.parse(argc, argv);
+  if (parseReturn == Teuchos::CommandLineProcessor::PARSE_HELP_PRINTED) {
+    return 0;
+  }
+  if (parseReturn != Teuchos::CommandLineProcessor::PARSE_SUCCESSFUL) {
+    return 1;
+  }
+
+  ATS::Benchmarks::Harness harness(ncells, nrepeats, group);
+  try {
+    ATS::Benchmarks::RunConstitutiveBenchmarks(harness);
+    ATS::Benchmarks::RunOperatorBenchmarks(harness);
+  } catch (std::exception& e) {
+    if (rank == 0) std::cerr << "ERROR:" << std::endl << e.what() << std::endl;
+    return 1;
+  }
+
+  if (rank == 0) {
+    harness.WriteTable(std::cout);
+    if (!output.empty()) {
+      std::ofstream os(output);
+      harness.WriteJSON(os, label);
+    }
+  }
+  return 0;
+}
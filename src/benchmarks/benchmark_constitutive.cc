@@ -0,0 +1,353 @@
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+*/
+//! Microbenchmarks for pointwise constitutive models.
+
+/*
+  These exercise the models directly on flat arrays, independent of the
+  evaluator machinery, so that they measure the cost of the physics kernel
+  itself.  Inputs are swept across the physically interesting range (e.g.
+  through the freezing point) so that every branch of a model is hit.
+*/
+
+#include <cmath>
+#include <vector>
+
+#include "Teuchos_ParameterList.hpp"
+#include "Teuchos_RCP.hpp"
+
+// flow
+#include "wrm_van_genuchten.hh"
+#include "wrm_fpd_permafrost_model.hh"
+#include "wrm_fpd_smoothed_permafrost_model.hh"
+#include "wrm_implicit_permafrost_model.hh"
+#include "wrm_sutra_permafrost_model.hh"
+#include "pc_ice_water.hh"
+
+// eos
+#include "eos_factory.hh"
+#include "eos_water.hh"
+#include "eos_ice.hh"
+#include "vapor_pressure_water.hh"
+
+// energy
+#include "thermal_conductivity_threephase_peterslidard.hh"
+#include "thermal_conductivity_threephase_wetdry.hh"
+#include "thermal_conductivity_threephase_volume_averaged.hh"
+#include "thermal_conductivity_threephase_sutra_hacked.hh"
+
+// surface energy balance
+#include "seb_physics_defs.hh"
+#include "seb_physics_funcs.hh"
+
+#include "benchmark_harness.hh"
+
+namespace ATS {
+namespace Benchmarks {
+
+using namespace Amanzi;
+
+namespace {
+
+// linearly spaced inputs in [lo, hi]
+std::vector<double>
+Linspace(long n, double lo, double hi)
+{
+  std::vector<double> vec(n);
+  double dx = n > 1 ? (hi - lo) / (n-1) : 0.;
+  for (long i=0; i!=n; ++i) vec[i] = lo + i*dx;
+  return vec;
+}
+
+
+Teuchos::RCP<Flow::WRMVanGenuchten>
+CreateVanGenuchten()
+{
+  Teuchos::ParameterList plist;
+  plist.set<double>("van Genuchten alpha [Pa^-1]", 1.5e-4);
+  plist.set<double>("van Genuchten m [-]", 0.8);
+  plist.set<double>("residual saturation [-]", 0.1);
+  plist.set<double>("smoothing interval width [saturation]", 0.05);
+  return Teuchos::rcp(new Flow::WRMVanGenuchten(plist));
+}
+
+
+void
+RunWRMBenchmarks(Harness& harness)
+{
+  long n = harness.ncells();
+  auto wrm = CreateVanGenuchten();
+
+  auto pc = Linspace(n, -1.e4, 1.e6);
+  auto sat = Linspace(n, 0.11, 1.0);
+  std::vector<double> result(n);
+
+  harness.Run("wrm", "van Genuchten saturation", n, 16., [&]() {
+      for (long i=0; i!=n; ++i) result[i] = wrm->saturation(pc[i]);
+      DoNotOptimize(result);
+    });
+  harness.Run("wrm", "van Genuchten d_saturation", n, 16., [&]() {
+      for (long i=0; i!=n; ++i) result[i] = wrm->d_saturation(pc[i]);
+      DoNotOptimize(result);
+    });
+  harness.Run("wrm", "van Genuchten k_relative", n, 16., [&]() {
+      for (long i=0; i!=n; ++i) result[i] = wrm->k_relative(sat[i]);
+      DoNotOptimize(result);
+    });
+  harness.Run("wrm", "van Genuchten capillaryPressure", n, 16., [&]() {
+      for (long i=0; i!=n; ++i) result[i] = wrm->capillaryPressure(sat[i]);
+      DoNotOptimize(result);
+    });
+}
+
+
+void
+RunPermafrostBenchmarks(Harness& harness)
+{
+  long n = harness.ncells();
+  auto wrm = CreateVanGenuchten();
+
+  // temperature is swept through the freezing point, which determines pc_ice
+  Teuchos::ParameterList pc_plist;
+  Flow::PCIceWater pc_ice_water(pc_plist);
+  auto temp = Linspace(n, 263.15, 278.15);
+  std::vector<double> pc_ice(n);
+  for (long i=0; i!=n; ++i) pc_ice[i] = pc_ice_water.CapillaryPressure(temp[i], 999.87);
+  auto pc_liq = Linspace(n, -1.e3, 1.e5);
+  std::vector<double> result(3*n);
+
+  harness.Run("permafrost", "PCIceWater CapillaryPressure", n, 16., [&]() {
+      for (long i=0; i!=n; ++i) result[i] = pc_ice_water.CapillaryPressure(temp[i], 999.87);
+      DoNotOptimize(result);
+    });
+
+  std::vector<std::pair<std::string, Teuchos::RCP<Flow::WRMPermafrostModel> > > models;
+  {
+    Teuchos::ParameterList plist;
+    models.emplace_back("fpd", Teuchos::rcp(new Flow::WRMFPDPermafrostModel(plist)));
+  }
+  {
+    Teuchos::ParameterList plist;
+    plist.set<double>("smoothing width [K]", 1.0);
+    models.emplace_back("fpd smoothed", Teuchos::rcp(new Flow::WRMFPDSmoothedPermafrostModel(plist)));
+  }
+  {
+    Teuchos::ParameterList plist;
+    models.emplace_back("implicit", Teuchos::rcp(new Flow::WRMImplicitPermafrostModel(plist)));
+  }
+  {
+    Teuchos::ParameterList plist;
+    plist.set<double>("temperature transition [K]", 1.0);
+    plist.set<double>("residual saturation [-]", 0.1);
+    models.emplace_back("sutra", Teuchos::rcp(new Flow::WRMSutraPermafrostModel(plist)));
+  }
+
+  for (auto& model : models) {
+    model.second->set_WRM(wrm);
+    auto& m = *model.second;
+
+    harness.Run("permafrost", model.first + " saturations", n, 40., [&]() {
+        double sats[3];
+        for (long i=0; i!=n; ++i) {
+          m.saturations(pc_liq[i], pc_ice[i], sats);
+          result[3*i] = sats[0]; result[3*i+1] = sats[1]; result[3*i+2] = sats[2];
+        }
+        DoNotOptimize(result);
+      });
+    harness.Run("permafrost", model.first + " dsaturations_dpc_liq", n, 40., [&]() {
+        double dsats[3];
+        for (long i=0; i!=n; ++i) {
+          m.dsaturations_dpc_liq(pc_liq[i], pc_ice[i], dsats);
+          result[3*i] = dsats[0]; result[3*i+1] = dsats[1]; result[3*i+2] = dsats[2];
+        }
+        DoNotOptimize(result);
+      });
+  }
+}
+
+
+void
+RunEOSBenchmarks(Harness& harness)
+{
+  long n = harness.ncells();
+  auto temp = Linspace(n, 263.15, 303.15);
+  auto pres = Linspace(n, 101325., 1.e6);
+  std::vector<double> result(n);
+  std::vector<double> params(2);
+
+  std::vector<std::pair<std::string, Teuchos::RCP<Relations::EOS> > > eoses;
+  {
+    Teuchos::ParameterList plist;
+    eoses.emplace_back("water", Teuchos::rcp(new Relations::EOSWater(plist)));
+  }
+  {
+    Teuchos::ParameterList plist;
+    eoses.emplace_back("ice", Teuchos::rcp(new Relations::EOSIce(plist)));
+  }
+  {
+    Teuchos::ParameterList plist;
+    plist.set<std::string>("EOS type", "vapor in gas");
+    plist.sublist("gas EOS parameters").set<std::string>("EOS type", "ideal gas");
+    Relations::EOSFactory fac;
+    eoses.emplace_back("vapor in gas", fac.createEOS(plist));
+  }
+
+  for (auto& eos : eoses) {
+    auto& e = *eos.second;
+    harness.Run("eos", eos.first + " MolarDensity", n, 24., [&]() {
+        for (long i=0; i!=n; ++i) {
+          params[0] = temp[i]; params[1] = pres[i];
+          result[i] = e.MolarDensity(params);
+        }
+        DoNotOptimize(result);
+      });
+    harness.Run("eos", eos.first + " DMolarDensityDT", n, 24., [&]() {
+        for (long i=0; i!=n; ++i) {
+          params[0] = temp[i]; params[1] = pres[i];
+          result[i] = e.DMolarDensityDT(params);
+        }
+        DoNotOptimize(result);
+      });
+  }
+
+  Teuchos::ParameterList vp_plist;
+  Relations::VaporPressureWater vp(vp_plist);
+  harness.Run("eos", "vapor pressure SaturatedVaporPressure", n, 16., [&]() {
+      for (long i=0; i!=n; ++i) result[i] = vp.SaturatedVaporPressure(temp[i]);
+      DoNotOptimize(result);
+    });
+}
+
+
+void
+RunThermalConductivityBenchmarks(Harness& harness)
+{
+  long n = harness.ncells();
+  auto poro = Linspace(n, 0.2, 0.6);
+  auto sat_liq = Linspace(n, 0.0, 1.0);
+  std::vector<double> sat_ice(n);
+  for (long i=0; i!=n; ++i) sat_ice[i] = 0.5 * (1.0 - sat_liq[i]);
+  auto temp = Linspace(n, 263.15, 283.15);
+  std::vector<double> result(n);
+
+  std::vector<std::pair<std::string, Teuchos::RCP<Energy::ThermalConductivityThreePhase> > > tcs;
+  {
+    Teuchos::ParameterList plist;
+    plist.set<double>("unsaturated alpha unfrozen [-]", 0.92);
+    plist.set<double>("unsaturated alpha frozen [-]", 0.27);
+    plist.set<double>("thermal conductivity of soil [W m^-1 K^-1]", 1.0);
+    plist.set<double>("thermal conductivity of ice [W m^-1 K^-1]", 2.3);
+    plist.set<double>("thermal conductivity of liquid [W m^-1 K^-1]", 0.6);
+    plist.set<double>("thermal conductivity of gas [W m^-1 K^-1]", 0.024);
+    tcs.emplace_back("Peters-Lidard", Teuchos::rcp(new Energy::ThermalConductivityThreePhasePetersLidard(plist)));
+  }
+  {
+    Teuchos::ParameterList plist;
+    plist.set<double>("unsaturated alpha unfrozen [-]", 0.92);
+    plist.set<double>("unsaturated alpha frozen [-]", 0.27);
+    plist.set<double>("thermal conductivity, dry [W m^-1 K^-1]", 0.29);
+    plist.set<double>("thermal conductivity, saturated (unfrozen) [W m^-1 K^-1]", 1.0);
+    tcs.emplace_back("wet-dry", Teuchos::rcp(new Energy::ThermalConductivityThreePhaseWetDry(plist)));
+  }
+  {
+    Teuchos::ParameterList plist;
+    plist.set<double>("thermal conductivity of soil [W m^-1 K^-1]", 1.0);
+    plist.set<double>("thermal conductivity of ice [W m^-1 K^-1]", 2.3);
+    plist.set<double>("thermal conductivity of liquid [W m^-1 K^-1]", 0.6);
+    plist.set<double>("thermal conductivity of gas [W m^-1 K^-1]", 0.024);
+    tcs.emplace_back("volume averaged", Teuchos::rcp(new Energy::ThermalConductivityThreePhaseVolumeAveraged(plist)));
+  }
+  {
+    Teuchos::ParameterList plist;
+    plist.set<double>("thermal conductivity of frozen zone [W m^-1 K^-1]", 2.0);
+    plist.set<double>("thermal conductivity of unfrozen zone [W m^-1 K^-1]", 1.0);
+    plist.set<double>("thermal conductivity of mushy zone [W m^-1 K^-1]", 1.5);
+    plist.set<double>("residual saturation [-]", 0.1);
+    tcs.emplace_back("sutra hacked", Teuchos::rcp(new Energy::ThermalConductivityThreePhaseSutraHacked(plist)));
+  }
+
+  for (auto& tc : tcs) {
+    auto& t = *tc.second;
+    harness.Run("thermal_conductivity", tc.first + " ThermalConductivity", n, 40., [&]() {
+        for (long i=0; i!=n; ++i)
+          result[i] = t.ThermalConductivity(poro[i], sat_liq[i], sat_ice[i], temp[i]);
+        DoNotOptimize(result);
+      });
+  }
+}
+
+
+void
+RunSEBBenchmarks(Harness& harness)
+{
+  namespace SEB = SurfaceBalance::Relations;
+  long n = harness.ncells();
+  auto air_temp = Linspace(n, 253.15, 293.15);
+  auto skin_temp = Linspace(n, 263.15, 283.15);
+  auto wind = Linspace(n, 0.5, 10.);
+  std::vector<double> result(n);
+
+  harness.Run("seb", "SaturatedVaporPressure", n, 16., [&]() {
+      for (long i=0; i!=n; ++i) result[i] = SEB::SaturatedVaporPressure(air_temp[i]);
+      DoNotOptimize(result);
+    });
+  harness.Run("seb", "StabilityFunction", n, 32., [&]() {
+      for (long i=0; i!=n; ++i)
+        result[i] = SEB::StabilityFunction(air_temp[i], skin_temp[i], wind[i], 2.0, 9.807);
+      DoNotOptimize(result);
+    });
+  harness.Run("seb", "IncomingLongwaveRadiation", n, 16., [&]() {
+      for (long i=0; i!=n; ++i) result[i] = SEB::IncomingLongwaveRadiation(air_temp[i], 0.8);
+      DoNotOptimize(result);
+    });
+
+  // full energy balance, no snow
+  SEB::ModelParams params;
+  SEB::GroundProperties surf;
+  surf.pressure = 101325.;
+  surf.ponded_depth = 0.;
+  surf.porosity = 0.5;
+  surf.density_w = 1000.;
+  surf.dz = 0.01;
+  surf.albedo = 0.2;
+  surf.emissivity = 0.95;
+  surf.saturation_gas = 0.3;
+  surf.roughness = 0.04;
+  surf.unfrozen_fraction = 1.0;
+
+  SEB::MetData met;
+  met.Z_Us = 2.0;
+  met.QswIn = 300.;
+  met.QlwIn = 250.;
+  met.Ps = 0.;
+  met.Pr = 0.;
+  met.relative_humidity = 0.8;
+
+  harness.Run("seb", "UpdateEnergyBalanceWithoutSnow", n, 32., [&]() {
+      for (long i=0; i!=n; ++i) {
+        surf.temp = skin_temp[i];
+        met.air_temp = air_temp[i];
+        met.Us = wind[i];
+        result[i] = SEB::UpdateEnergyBalanceWithoutSnow(surf, met, params).fQc;
+      }
+      DoNotOptimize(result);
+    });
+}
+
+} // namespace
+
+
+void
+RunConstitutiveBenchmarks(Harness& harness)
+{
+  if (harness.Enabled("wrm")) RunWRMBenchmarks(harness);
+  if (harness.Enabled("permafrost")) RunPermafrostBenchmarks(harness);
+  if (harness.Enabled("eos")) RunEOSBenchmarks(harness);
+  if (harness.Enabled("thermal_conductivity")) RunThermalConductivityBenchmarks(harness);
+  if (harness.Enabled("seb")) RunSEBBenchmarks(harness);
+}
+
+} // namespace Benchmarks
+} // namespace ATS
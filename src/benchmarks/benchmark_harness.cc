@@ -0,0 +1,122 @@
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+*/
+//! A minimal timing harness for microbenchmarks of ATS kernels.
+
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+
+#include "Teuchos_Time.hpp"
+
+#include "benchmark_harness.hh"
+
+namespace ATS {
+namespace Benchmarks {
+
+Harness::Harness(long ncells, int nrepeats, const std::string& filter) :
+    ncells_(ncells),
+    nrepeats_(std::max(nrepeats, 1)),
+    filter_(filter) {}
+
+
+bool
+Harness::Enabled(const std::string& group) const
+{
+  return filter_.empty() || filter_ == group;
+}
+
+
+void
+Harness::Run(const std::string& group, const std::string& name,
+             long ncells, double bytes_per_cell,
+             const std::function<void()>& kernel)
+{
+  if (!Enabled(group)) return;
+
+  // warm up caches, page in memory, etc
+  kernel();
+
+  Teuchos::Time timer(name);
+  double best = std::numeric_limits<double>::max();
+  double total = 0.;
+  for (int i=0; i!=nrepeats_; ++i) {
+    timer.start(true);
+    kernel();
+    timer.stop();
+    double elapsed = timer.totalElapsedTime();
+    best = std::min(best, elapsed);
+    total += elapsed;
+  }
+
+  BenchmarkResult result;
+  result.group = group;
+  result.name = name;
+  result.ncells = ncells;
+  result.bytes_per_cell = bytes_per_cell;
+  result.nrepeats = nrepeats_;
+  result.best_seconds = best;
+  result.mean_seconds = total / nrepeats_;
+  results_.push_back(result);
+}
+
+
+void
+Harness::WriteTable(std::ostream& os) const
+{
+  os << std::left << std::setw(14) << "group"
+     << std::setw(48) << "benchmark"
+     << std::right << std::setw(12) << "cells"
+     << std::setw(14) << "ns/cell"
+     << std::setw(12) << "GB/s" << std::endl;
+  os << std::string(100, '-') << std::endl;
+  for (const auto& r : results_) {
+    os << std::left << std::setw(14) << r.group
+       << std::setw(48) << r.name
+       << std::right << std::setw(12) << r.ncells
+       << std::setw(14) << std::fixed << std::setprecision(3) << r.ns_per_cell()
+       << std::setw(12) << std::setprecision(3) << r.gb_per_second() << std::endl;
+  }
+  os.unsetf(std::ios::fixed);
+}
+
+
+void
+Harness::WriteJSON(std::ostream& os, const std::string& label) const
+{
+  os << std::setprecision(8);
+  os << "{" << std::endl
+     << "  \"label\": \"" << label << "\"," << std::endl
+     << "  \"repeats\": " << nrepeats_ << "," << std::endl
+     << "  \"benchmarks\": [" << std::endl;
+  for (int i=0; i!=results_.size(); ++i) {
+    const auto& r = results_[i];
+    os << "    {\"group\": \"" << r.group << "\", "
+       << "\"name\": \"" << r.name << "\", "
+       << "\"ncells\": " << r.ncells << ", "
+       << "\"bytes_per_cell\": " << r.bytes_per_cell << ", "
+       << "\"best_seconds\": " << r.best_seconds << ", "
+       << "\"mean_seconds\": " << r.mean_seconds << ", "
+       << "\"ns_per_cell\": " << r.ns_per_cell() << ", "
+       << "\"GB_per_second\": " << r.gb_per_second() << "}";
+    if (i != results_.size()-1) os << ",";
+    os << std::endl;
+  }
+  os << "  ]" << std::endl
+     << "}" << std::endl;
+}
+
+
+void
+DoNotOptimize(const std::vector<double>& vec)
+{
+  // a volatile read of the output prevents dead code elimination of the
+  // kernel that wrote it
+  volatile double sink = vec.empty() ? 0. : vec[vec.size()/2];
+  (void) sink;
+}
+
+} // namespace Benchmarks
+} // namespace ATS
@@ -0,0 +1,89 @@
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+*/
+//! A minimal timing harness for microbenchmarks of ATS kernels.
+
+/*!
+
+Each benchmark is a kernel that is applied to N "cells" (or faces, or
+columns, whatever the natural unit of work is) and is characterized by the
+number of bytes it must move per cell.  The harness times a number of
+repetitions of the kernel after a warmup pass and reports the best and mean
+wall-clock times as ns/cell and effective GB/s.
+
+Results may be written as JSON so that they can be tracked across releases,
+e.g. with:
+
+  ats_benchmarks --ncells=1000000 --repeats=10 --output=ats-1.2.json
+
+*/
+
+#ifndef ATS_BENCHMARKS_HARNESS_HH_
+#define ATS_BENCHMARKS_HARNESS_HH_
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <ostream>
+
+namespace ATS {
+namespace Benchmarks {
+
+struct BenchmarkResult {
+  std::string group;            // e.g. "wrm", "eos", "upwinding"
+  std::string name;             // e.g. "van Genuchten saturation"
+  long ncells;                  // units of work per repetition
+  double bytes_per_cell;        // bytes read + written per unit of work
+  int nrepeats;
+  double best_seconds;          // fastest repetition
+  double mean_seconds;          // average over repetitions
+
+  double ns_per_cell() const { return 1.e9 * best_seconds / ncells; }
+  double gb_per_second() const {
+    return best_seconds > 0. ? bytes_per_cell * ncells / best_seconds * 1.e-9 : 0.;
+  }
+};
+
+
+class Harness {
+ public:
+  Harness(long ncells, int nrepeats, const std::string& filter="");
+
+  long ncells() const { return ncells_; }
+
+  // Time a kernel.  The kernel is called once to warm up, then nrepeats
+  // times.  ncells and bytes_per_cell describe the work done in each call.
+  void Run(const std::string& group, const std::string& name,
+           long ncells, double bytes_per_cell,
+           const std::function<void()>& kernel);
+
+  // Is a given group requested?  Allows skipping expensive setup.
+  bool Enabled(const std::string& group) const;
+
+  const std::vector<BenchmarkResult>& results() const { return results_; }
+
+  void WriteTable(std::ostream& os) const;
+  void WriteJSON(std::ostream& os, const std::string& label) const;
+
+ private:
+  long ncells_;
+  int nrepeats_;
+  std::string filter_;
+  std::vector<BenchmarkResult> results_;
+};
+
+
+// Keeps the compiler from optimizing away the result of a kernel.
+void DoNotOptimize(const std::vector<double>& vec);
+
+
+// Each set of benchmarks registers itself through one of these.
+void RunConstitutiveBenchmarks(Harness& harness);
+void RunOperatorBenchmarks(Harness& harness);
+
+} // namespace Benchmarks
+} // namespace ATS
+
+#endif
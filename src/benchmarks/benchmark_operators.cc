@@ -0,0 +1,324 @@
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+*/
+//! Microbenchmarks for mesh-based kernels: upwinding, advection, column reductions.
+
+/*
+  These run on a synthetic, generated, columnar box mesh whose number of
+  cells is roughly the requested number of cells, with NZ cells in each
+  column.  Fields are filled with smooth, deterministic data, and fluxes
+  change sign across the domain so that both upwind directions are
+  exercised.
+*/
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "Teuchos_ParameterList.hpp"
+#include "Teuchos_RCP.hpp"
+#include "Epetra_Vector.h"
+
+#include "AmanziComm.hh"
+#include "GeometricModel.hh"
+#include "MeshFactory.hh"
+#include "CompositeVector.hh"
+#include "CompositeVectorSpace.hh"
+#include "Tensor.hh"
+
+#include "upwind_arithmetic_mean.hh"
+#include "upwind_cell_centered.hh"
+#include "upwind_flux_fo_cont.hh"
+#include "upwind_flux_harmonic_mean.hh"
+#include "upwind_flux_split_denominator.hh"
+#include "upwind_gravity_flux.hh"
+#include "upwind_potential_difference.hh"
+#include "upwind_total_flux.hh"
+#include "advection_donor_upwind.hh"
+#include "advection_donor_upwind_explicit.hh"
+
+#include "benchmark_harness.hh"
+
+namespace ATS {
+namespace Benchmarks {
+
+using namespace Amanzi;
+
+namespace {
+
+const int NZ = 50; // cells per column
+
+Teuchos::RCP<AmanziMesh::Mesh>
+CreateColumnarMesh(long ncells)
+{
+  auto comm = getDefaultComm();
+  Teuchos::ParameterList region_list;
+  auto gm = Teuchos::rcp(new AmanziGeometry::GeometricModel(3, region_list, *comm));
+
+  int nxy = std::max(1, (int) std::round(std::sqrt((double) ncells / NZ)));
+  AmanziMesh::MeshFactory factory(comm, gm);
+  auto mesh = factory.create(0., 0., -10., 100.*nxy, 100.*nxy, 0., nxy, nxy, NZ);
+  mesh->build_columns();
+  return mesh;
+}
+
+
+Teuchos::RCP<CompositeVector>
+CreateVector(const Teuchos::RCP<const AmanziMesh::Mesh>& mesh,
+             bool cells, bool faces, int ndofs=1)
+{
+  CompositeVectorSpace space;
+  space.SetMesh(mesh)->SetGhosted();
+  if (cells) space.AddComponent("cell", AmanziMesh::CELL, ndofs);
+  if (faces) space.AddComponent("face", AmanziMesh::FACE, ndofs);
+  return Teuchos::rcp(new CompositeVector(space));
+}
+
+
+// Fills cell components with a smooth function of the centroid, and face
+// components with a flux that changes sign across the domain.
+void
+FillVector(CompositeVector& vec, double scale, double offset)
+{
+  auto mesh = vec.Mesh();
+  if (vec.HasComponent("cell")) {
+    Epetra_MultiVector& vec_c = *vec.ViewComponent("cell", false);
+    for (int c=0; c!=vec_c.MyLength(); ++c) {
+      const auto& xc = mesh->cell_centroid(c);
+      for (int i=0; i!=vec_c.NumVectors(); ++i)
+        vec_c[i][c] = offset + scale * (1.0 + std::sin(0.01*xc[0]) * std::cos(0.01*xc[1]) + 0.1*xc[2]);
+    }
+  }
+  if (vec.HasComponent("face")) {
+    Epetra_MultiVector& vec_f = *vec.ViewComponent("face", false);
+    for (int f=0; f!=vec_f.MyLength(); ++f) {
+      const auto& xf = mesh->face_centroid(f);
+      for (int i=0; i!=vec_f.NumVectors(); ++i)
+        vec_f[i][f] = offset + scale * std::sin(0.02*xf[0] + 0.03*xf[1] + xf[2]);
+    }
+  }
+  vec.ScatterMasterToGhosted();
+}
+
+
+void
+RunUpwindingBenchmarks(Harness& harness, const Teuchos::RCP<AmanziMesh::Mesh>& mesh)
+{
+  long ncells = mesh->num_entities(AmanziMesh::CELL, AmanziMesh::Parallel_type::OWNED);
+  long nfaces = mesh->num_entities(AmanziMesh::FACE, AmanziMesh::Parallel_type::OWNED);
+
+  auto cell_coef = CreateVector(mesh, true, false);
+  FillVector(*cell_coef, 0.5, 0.5);
+  auto flux = CreateVector(mesh, false, true);
+  FillVector(*flux, 1.e-3, 0.);
+  auto potential = CreateVector(mesh, true, true);
+  FillVector(*potential, 1.e4, 101325.);
+  auto overlap = CreateVector(mesh, true, false);
+  FillVector(*overlap, 0.1, 0.);
+  auto face_coef = CreateVector(mesh, true, true);
+
+  // surface-like fields for the overland schemes
+  auto slope = CreateVector(mesh, true, false);
+  FillVector(*slope, 1.e-3, 1.e-3);
+  auto manning = CreateVector(mesh, true, false);
+  manning->PutScalar(0.15);
+  auto elevation = CreateVector(mesh, true, false);
+  FillVector(*elevation, 1.0, 0.);
+
+  // per face: flux, face coef, and two upwind/downwind cell values, with
+  // integer index lookups for the neighbors
+  double bytes_per_face = 4 * sizeof(double) + 2 * sizeof(int);
+
+  {
+    Operators::UpwindTotalFlux upwind("bench", "", "", "", 1.e-8);
+    harness.Run("upwinding", "total flux", nfaces, bytes_per_face, [&]() {
+        upwind.CalculateCoefficientsOnFaces(*cell_coef, *flux, face_coef.ptr(), Teuchos::null);
+      });
+  }
+  {
+    Operators::UpwindFluxHarmonicMean upwind("bench", "", "", "", 1.e-8);
+    harness.Run("upwinding", "flux harmonic mean", nfaces, bytes_per_face, [&]() {
+        upwind.CalculateCoefficientsOnFaces(*cell_coef, *flux, face_coef.ptr(), Teuchos::null);
+      });
+  }
+  {
+    Operators::UpwindPotentialDifference upwind("bench", "", "", "");
+    harness.Run("upwinding", "potential difference", nfaces, bytes_per_face + 2*sizeof(double), [&]() {
+        upwind.CalculateCoefficientsOnFaces(*cell_coef, *potential, *overlap, face_coef.ptr());
+      });
+  }
+  {
+    Operators::UpwindArithmeticMean upwind("bench", "", "");
+    harness.Run("upwinding", "arithmetic mean", nfaces, bytes_per_face - sizeof(double), [&]() {
+        upwind.CalculateCoefficientsOnFaces(*cell_coef, face_coef.ptr());
+      });
+  }
+  {
+    Operators::UpwindCellCentered upwind("bench", "", "");
+    harness.Run("upwinding", "cell centered", ncells, 2*sizeof(double), [&]() {
+        upwind.CalculateCoefficientsOnFaces(*cell_coef, face_coef.ptr());
+      });
+  }
+  {
+    int ncells_all = mesh->num_entities(AmanziMesh::CELL, AmanziMesh::Parallel_type::ALL);
+    auto K = Teuchos::rcp(new std::vector<WhetStone::Tensor>(ncells_all));
+    for (auto& Kc : *K) {
+      Kc.Init(3, 1);
+      Kc(0,0) = 1.e-12;
+    }
+    Epetra_Vector gravity(*mesh->get_comm(), 3);
+    gravity[2] = -9.80665;
+
+    Operators::UpwindGravityFlux upwind("bench", "", "", K);
+    harness.Run("upwinding", "gravity flux", nfaces, bytes_per_face + sizeof(double), [&]() {
+        upwind.CalculateCoefficientsOnFaces(*cell_coef, gravity, face_coef.ptr());
+      });
+  }
+  {
+    Operators::UpwindFluxFOCont upwind("bench", "", "", "", "", "", "", 1.e-8, 0.6667);
+    harness.Run("upwinding", "flux FO cont", nfaces, bytes_per_face + 6*sizeof(double), [&]() {
+        upwind.CalculateCoefficientsOnFaces(*cell_coef, *flux, *slope, *manning, *elevation,
+                face_coef.ptr(), Teuchos::null);
+      });
+  }
+  {
+    Operators::UpwindFluxSplitDenominator upwind("bench", "", "", "", 1.e-8, "", "", 1.e-8, "");
+    harness.Run("upwinding", "flux split denominator", nfaces, bytes_per_face + 6*sizeof(double), [&]() {
+        upwind.CalculateCoefficientsOnFaces(*cell_coef, *flux, *slope, *manning, *cell_coef,
+                face_coef.ptr(), Teuchos::null);
+      });
+  }
+}
+
+
+void
+RunAdvectionBenchmarks(Harness& harness, const Teuchos::RCP<AmanziMesh::Mesh>& mesh)
+{
+  long nfaces = mesh->num_entities(AmanziMesh::FACE, AmanziMesh::Parallel_type::OWNED);
+
+  auto flux = CreateVector(mesh, false, true);
+  FillVector(*flux, 1.e-3, 0.);
+
+  for (int ndofs : {1, 4}) {
+    Teuchos::ParameterList plist;
+    Operators::AdvectionDonorUpwind advection(plist, mesh);
+    advection.set_num_dofs(ndofs);
+
+    harness.Run("advection", "donor upwind IdentifyUpwindCells", nfaces,
+                sizeof(double) + 2*sizeof(int), [&]() {
+        advection.set_flux(flux);
+      });
+
+    // Apply overwrites the cell values, so they are restored from a filled
+    // copy on each repetition
+    FillVector(*advection.field(), 1.0, 0.);
+    Epetra_MultiVector& field_c = *advection.field()->ViewComponent("cell", false);
+    Epetra_MultiVector field_c_init(field_c);
+    std::size_t cell_bytes = field_c.MyLength() * sizeof(double);
+
+    // per face: flux, upwind cell value, face value written, then read back
+    // and accumulated into two cells
+    double bytes_per_face = sizeof(double) + ndofs * 5 * sizeof(double) + 2*sizeof(int);
+    harness.Run("advection", "donor upwind Apply, " + std::to_string(ndofs) + " dofs",
+                nfaces, bytes_per_face, [&]() {
+        for (int i=0; i!=ndofs; ++i) std::memcpy(field_c[i], field_c_init[i], cell_bytes);
+        advection.Apply(Teuchos::null, false);
+      });
+  }
+
+  // the explicit engine used by the transport PKs
+  Operators::AdvectionDonorUpwindExplicit explicit_advection(mesh);
+  const Epetra_MultiVector& flux_f = *flux->ViewComponent("face", true);
+  harness.Run("advection", "explicit donor upwind IdentifyUpwindCells", nfaces,
+              sizeof(double) + 4*sizeof(int), [&]() {
+      explicit_advection.IdentifyUpwindCells(flux_f);
+    });
+
+  for (int ndofs : {1, 4}) {
+    auto tcc = CreateVector(mesh, true, false, ndofs);
+    FillVector(*tcc, 1.0, 0.);
+    auto conserve = CreateVector(mesh, true, false, ndofs);
+    const Epetra_MultiVector& tcc_c = *tcc->ViewComponent("cell", true);
+    Epetra_MultiVector& conserve_c = *conserve->ViewComponent("cell", false);
+
+    // per face: flux, and the donor and receiver values
+    double bytes_per_face = sizeof(double) + ndofs * 2 * sizeof(double) + 2*sizeof(int);
+    harness.Run("advection", "explicit donor upwind Advect, " + std::to_string(ndofs) + " dofs",
+                nfaces, bytes_per_face, [&]() {
+        explicit_advection.Advect(1.0, flux_f, tcc_c, ndofs, conserve_c);
+      });
+  }
+}
+
+
+void
+RunColumnBenchmarks(Harness& harness, const Teuchos::RCP<AmanziMesh::Mesh>& mesh)
+{
+  long ncells = mesh->num_entities(AmanziMesh::CELL, AmanziMesh::Parallel_type::OWNED);
+  int ncols = mesh->num_columns(false);
+
+  auto dep = CreateVector(mesh, true, false);
+  FillVector(*dep, 0.5, 0.5);
+  auto cv = CreateVector(mesh, true, false);
+  FillVector(*cv, 1.0, 1.0);
+  auto dens = CreateVector(mesh, true, false);
+  FillVector(*dens, 1000., 54000.);
+  auto temp = CreateVector(mesh, true, false);
+  FillVector(*temp, 5., 270.);
+
+  const Epetra_MultiVector& dep_c = *dep->ViewComponent("cell", false);
+  const Epetra_MultiVector& cv_c = *cv->ViewComponent("cell", false);
+  const Epetra_MultiVector& dens_c = *dens->ViewComponent("cell", false);
+  const Epetra_MultiVector& temp_c = *temp->ViewComponent("cell", false);
+  std::vector<double> result(ncols);
+
+  // as in ColumnSumEvaluator, with volume factor and density
+  harness.Run("column", "column sum", ncells, 3*sizeof(double) + sizeof(int), [&]() {
+      for (int col=0; col!=ncols; ++col) {
+        double sum = 0.;
+        for (auto c : mesh->cells_of_column(col)) {
+          sum += dep_c[0][c] * cv_c[0][c] / dens_c[0][c];
+        }
+        result[col] = sum;
+      }
+      DoNotOptimize(result);
+    });
+
+  // as in ThawDepthEvaluator, a top-down search for the first frozen cell
+  harness.Run("column", "column thaw depth search", ncells, sizeof(double) + sizeof(int), [&]() {
+      for (int col=0; col!=ncols; ++col) {
+        const auto& col_cells = mesh->cells_of_column(col);
+        const auto& col_faces = mesh->faces_of_column(col);
+        double z_top = mesh->face_centroid(col_faces[0])[2];
+        double depth = 0.;
+        for (int i=0; i!=col_cells.size(); ++i) {
+          if (temp_c[0][col_cells[i]] < 273.15) {
+            depth = z_top - mesh->face_centroid(col_faces[i])[2];
+            break;
+          }
+        }
+        result[col] = depth;
+      }
+      DoNotOptimize(result);
+    });
+}
+
+} // namespace
+
+
+void
+RunOperatorBenchmarks(Harness& harness)
+{
+  if (!harness.Enabled("upwinding") && !harness.Enabled("advection") && !harness.Enabled("column"))
+    return;
+
+  auto mesh = CreateColumnarMesh(harness.ncells());
+  if (harness.Enabled("upwinding")) RunUpwindingBenchmarks(harness, mesh);
+  if (harness.Enabled("advection")) RunAdvectionBenchmarks(harness, mesh);
+  if (harness.Enabled("column")) RunColumnBenchmarks(harness, mesh);
+}
+
+} // namespace Benchmarks
+} // namespace ATS
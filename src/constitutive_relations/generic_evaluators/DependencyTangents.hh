@@ -0,0 +1,83 @@
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+*/
+//! Values and derivatives of an evaluator's dependencies, for forward-mode derivatives.
+
+/*!
+
+By default, the total derivative of a secondary variable is assembled by
+calling EvaluateFieldPartialDerivative_() once per dependency, each a full
+pass over the mesh into a temporary field, and summing the chain rule.
+Evaluators whose models are templated on their scalar type may instead
+override UpdateFieldDerivative_() and evaluate the model once on Tangent
+arguments built here: each dependency carries its value and its (already
+computed) total derivative with respect to the requested variable.
+
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Teuchos_RCP.hpp"
+#include "State.hh"
+#include "Tangent.hh"
+
+namespace Amanzi {
+namespace Relations {
+
+class DependencyTangents {
+ public:
+  // Views, on component comp, the values of deps and their total derivatives
+  // with respect to wrt_key.  A dependency which is wrt_key has unit
+  // derivative, and one which does not depend upon it has zero derivative.
+  DependencyTangents(const Teuchos::Ptr<State>& S, const std::vector<Key>& deps,
+                     const Key& wrt_key, const std::string& comp) {
+    for (const auto& dep : deps) {
+      values_.push_back((*S->GetFieldData(dep)->ViewComponent(comp, false))[0]);
+      const double* derivs = nullptr;
+      double unit = 0.;
+      if (dep == wrt_key) {
+        unit = 1.;
+      } else if (S->GetFieldEvaluator(dep)->IsDependency(S, wrt_key)) {
+        derivs = (*S->GetFieldData(Keys::getDerivKey(dep, wrt_key))->ViewComponent(comp, false))[0];
+      }
+      derivs_.push_back(derivs);
+      units_.push_back(unit);
+    }
+  }
+
+  // the k-th dependency on entity i
+  Tangent operator()(int k, int i) const {
+    return Tangent(values_[k][i], derivs_[k] ? derivs_[k][i] : units_[k]);
+  }
+
+  // Gets, creating it if needed, the field of d(my_key)/d(wrt_key), as
+  // SecondaryVariableFieldEvaluator does.
+  static Teuchos::RCP<CompositeVector>
+  RequireDerivativeData(const Teuchos::Ptr<State>& S, const Key& my_key, const Key& wrt_key) {
+    Key dmy_key = Keys::getDerivKey(my_key, wrt_key);
+    if (S->HasField(dmy_key)) return S->GetFieldData(dmy_key, my_key);
+
+    Teuchos::RCP<CompositeVectorSpace> my_fac = S->RequireField(my_key);
+    Teuchos::RCP<CompositeVectorSpace> new_fac = S->RequireField(dmy_key, my_key);
+    new_fac->Update(*my_fac);
+    Teuchos::RCP<CompositeVector> dmy = Teuchos::rcp(new CompositeVector(*my_fac));
+    S->SetData(dmy_key, my_key, dmy);
+    S->GetField(dmy_key, my_key)->set_initialized();
+    S->GetField(dmy_key, my_key)->set_io_vis(false);
+    S->GetField(dmy_key, my_key)->set_io_checkpoint(false);
+    return dmy;
+  }
+
+ private:
+  std::vector<const double*> values_;
+  std::vector<const double*> derivs_;
+  std::vector<double> units_;
+};
+
+} // namespace Relations
+} // namespace Amanzi
@@ -0,0 +1,72 @@
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+*/
+//! A value carried together with its derivative, for forward-mode differentiation.
+
+/*!
+
+A Tangent is a dual number: a value and its derivative with respect to one
+variable.  Arithmetic on tangents applies the chain rule, so a model templated
+on its scalar type and evaluated on tangents returns the total derivative of
+its result in the same pass as its value.
+
+*/
+
+#pragma once
+
+namespace Amanzi {
+
+class Tangent {
+ public:
+  Tangent(double value=0., double d=0.) : value_(value), d_(d) {}
+
+  double value() const { return value_; }
+  double d() const { return d_; }
+
+  Tangent& operator+=(const Tangent& o) {
+    value_ += o.value_;
+    d_ += o.d_;
+    return *this;
+  }
+  Tangent& operator-=(const Tangent& o) {
+    value_ -= o.value_;
+    d_ -= o.d_;
+    return *this;
+  }
+  Tangent& operator*=(const Tangent& o) {
+    d_ = d_ * o.value_ + value_ * o.d_;
+    value_ *= o.value_;
+    return *this;
+  }
+  Tangent& operator/=(const Tangent& o) {
+    double inv = 1. / o.value_;
+    value_ *= inv;
+    d_ = (d_ - value_ * o.d_) * inv;
+    return *this;
+  }
+
+ private:
+  double value_;
+  double d_;
+};
+
+inline Tangent operator-(const Tangent& a) { return Tangent(-a.value(), -a.d()); }
+
+inline Tangent operator+(Tangent a, const Tangent& b) { return a += b; }
+inline Tangent operator-(Tangent a, const Tangent& b) { return a -= b; }
+inline Tangent operator*(Tangent a, const Tangent& b) { return a *= b; }
+inline Tangent operator/(Tangent a, const Tangent& b) { return a /= b; }
+
+inline Tangent operator+(Tangent a, double b) { return a += Tangent(b); }
+inline Tangent operator-(Tangent a, double b) { return a -= Tangent(b); }
+inline Tangent operator*(Tangent a, double b) { return a *= Tangent(b); }
+inline Tangent operator/(Tangent a, double b) { return a /= Tangent(b); }
+
+inline Tangent operator+(double a, const Tangent& b) { return Tangent(a) += b; }
+inline Tangent operator-(double a, const Tangent& b) { return Tangent(a) -= b; }
+inline Tangent operator*(double a, const Tangent& b) { return Tangent(a) *= b; }
+inline Tangent operator/(double a, const Tangent& b) { return Tangent(a) /= b; }
+
+} // namespace Amanzi
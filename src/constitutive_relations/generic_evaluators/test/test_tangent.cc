@@ -0,0 +1,98 @@
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+*/
+
+#include "UnitTest++.h"
+
+#include "Tangent.hh"
+
+using namespace Amanzi;
+
+namespace {
+
+// a rational function of x, exercising every operator, and its derivative
+template<typename Scalar>
+Scalar f(const Scalar& x) {
+  Scalar y = 2. * x * x - x / 3. + 1.;
+  y -= 0.5 / (x + 2.);
+  y += -x * (4. - x);
+  return y / (x - 5.) + 7.;
+}
+
+double dfdx(double x) {
+  double num = 3.*x*x - x/3. + 1. - 0.5/(x + 2.) - 4.*x;
+  double dnum = 6.*x - 1./3. + 0.5/((x + 2.)*(x + 2.)) - 4.;
+  return (dnum * (x - 5.) - num) / ((x - 5.)*(x - 5.));
+}
+
+} // namespace
+
+
+SUITE(TANGENT) {
+
+TEST(CONSTANTS) {
+  Tangent c(3.);
+  CHECK_EQUAL(3., c.value());
+  CHECK_EQUAL(0., c.d());
+
+  Tangent y = c * c + 1. / c - c;
+  CHECK_CLOSE(9. + 1./3. - 3., y.value(), 1.e-14);
+  CHECK_EQUAL(0., y.d());
+}
+
+TEST(ARITHMETIC) {
+  Tangent a(2., 1.), b(-3., 0.5);
+  Tangent sum = a + b;
+  CHECK_CLOSE(-1., sum.value(), 1.e-14);
+  CHECK_CLOSE(1.5, sum.d(), 1.e-14);
+
+  Tangent diff = a - b;
+  CHECK_CLOSE(5., diff.value(), 1.e-14);
+  CHECK_CLOSE(0.5, diff.d(), 1.e-14);
+
+  Tangent prod = a * b;
+  CHECK_CLOSE(-6., prod.value(), 1.e-14);
+  CHECK_CLOSE(1.*-3. + 2.*0.5, prod.d(), 1.e-14);
+
+  Tangent quot = a / b;
+  CHECK_CLOSE(-2./3., quot.value(), 1.e-14);
+  CHECK_CLOSE((1.*-3. - 2.*0.5) / 9., quot.d(), 1.e-14);
+
+  Tangent neg = -a;
+  CHECK_CLOSE(-2., neg.value(), 1.e-14);
+  CHECK_CLOSE(-1., neg.d(), 1.e-14);
+}
+
+TEST(MIXED_WITH_DOUBLES) {
+  Tangent x(4., 1.);
+  CHECK_CLOSE(1., (x + 2.).d(), 1.e-14);
+  CHECK_CLOSE(1., (x - 2.).d(), 1.e-14);
+  CHECK_CLOSE(-1., (2. - x).d(), 1.e-14);
+  CHECK_CLOSE(3., (3. * x).d(), 1.e-14);
+  CHECK_CLOSE(0.5, (x / 2.).d(), 1.e-14);
+  CHECK_CLOSE(-2. / 16., (2. / x).d(), 1.e-14);
+}
+
+// the derivative carried through a templated function matches the
+// analytic derivative and a finite difference, and its value matches the
+// double evaluation
+TEST(CHAIN_RULE) {
+  double xs[] = { -1.5, 0., 0.7, 3. };
+  for (double x : xs) {
+    Tangent y = f(Tangent(x, 1.));
+    CHECK_CLOSE(f(x), y.value(), 1.e-12);
+    CHECK_CLOSE(dfdx(x), y.d(), 1.e-10);
+
+    double h = 1.e-6;
+    CHECK_CLOSE((f(x + h) - f(x - h)) / (2.*h), y.d(), 1.e-6);
+  }
+
+  // a seed scales the derivative, as for a dependency carrying its own
+  // total derivative
+  Tangent y = f(Tangent(0.7, 2.5));
+  CHECK_CLOSE(2.5 * dfdx(0.7), y.d(), 1.e-10);
+}
+
+}
@@ -9,6 +9,8 @@
   Authors: Ethan Coon (ecoon@lanl.gov)
 */
 
+#include <memory>
+
 #include "Epetra_MpiComm.h"
 #include "Teuchos_ParameterList.hpp"
 #include "Teuchos_TimeMonitor.hpp"
@@ -31,6 +33,26 @@ namespace Mesh {
 
 using namespace Amanzi;
 
+namespace {
+
+//
+// Reference maps of domain set subdomains, from the setup cache if possible.
+//
+template<class Creator>
+Teuchos::RCP<const std::vector<int>>
+getCachedMap(SetupCache* cache, const std::string& subdomain_name, const Creator& create)
+{
+  std::string cache_name = "domain set map " + subdomain_name;
+  auto map = Teuchos::rcp(new std::vector<int>());
+  if (cache != nullptr && cache->Get(cache_name, *map)) return map;
+
+  auto created = create();
+  if (cache != nullptr) cache->Put(cache_name, *created);
+  return created;
+}
+
+} // namespace
+
 //
 // Create a mesh from an ExodusII file
 //
@@ -477,7 +499,8 @@ createDomainSetIndexed(const std::string& mesh_name_pristine,
                     Teuchos::ParameterList& mesh_plist,
                     const Teuchos::RCP<AmanziGeometry::GeometricModel>& gm,
                     State& S,
-                    VerboseObject& vo)
+                    VerboseObject& vo,
+                    SetupCache* cache)
 {
   // strip a :* from the end of the domain set name if needed
   std::string delim(1, Keys::dset_delimiter);
@@ -520,7 +543,11 @@ createDomainSetIndexed(const std::string& mesh_name_pristine,
     // create the subdomains, indexed over entities
     for (const auto& region : regions) {
       AmanziMesh::Entity_ID_List region_ents;
-      indexing_parent_mesh->get_set_entities(region, entity_kind, AmanziMesh::Parallel_type::OWNED, &region_ents);
+      std::string region_cache_name = "domain set " + mesh_name + " region " + region;
+      if (cache == nullptr || !cache->Get(region_cache_name, region_ents)) {
+        indexing_parent_mesh->get_set_entities(region, entity_kind, AmanziMesh::Parallel_type::OWNED, &region_ents);
+        if (cache) cache->Put(region_cache_name, region_ents);
+      }
       const auto& map = indexing_parent_mesh->map(entity_kind, false);
 
       for (const AmanziMesh::Entity_ID& lid : region_ents) {
@@ -552,18 +579,20 @@ createDomainSetIndexed(const std::string& mesh_name_pristine,
             subdomain_param_list.set("parent domain", indexing_parent_name);
 
         // construct
-        auto subdomain_mesh = createMesh(subdomain_list, indexing_parent_mesh->get_comm(), gm, S, vo);
+        auto subdomain_mesh = createMesh(subdomain_list, indexing_parent_mesh->get_comm(), gm, S, vo, cache);
 
         // create maps to the reference mesh
         if (is_reference_mesh) {
           // construct map into the reference mesh
           if (subdomain_mesh_type == "extracted" ||
               subdomain_mesh_type == "column") {
-            reference_maps[full_subdomain_name] = AmanziMesh::createMapToParent(*subdomain_mesh);
+            reference_maps[full_subdomain_name] = getCachedMap(cache, full_subdomain_name,
+                    [&]() { return AmanziMesh::createMapToParent(*subdomain_mesh); });
           } else if (subdomain_mesh_type == "surface" ||
                      subdomain_mesh_type == "column surface") {
             AMANZI_ASSERT(reference_mesh != Teuchos::null);
-            reference_maps[full_subdomain_name] = AmanziMesh::createMapSurfaceToSurface(*subdomain_mesh, *reference_mesh);
+            reference_maps[full_subdomain_name] = getCachedMap(cache, full_subdomain_name,
+                    [&]() { return AmanziMesh::createMapSurfaceToSurface(*subdomain_mesh, *reference_mesh); });
           } else if (subdomain_mesh_type == "aliased") {
             // use the reference map from the target mesh, but first we have to determine the target mesh name
             alias_target = subdomain_param_list.get<std::string>("target");
@@ -614,7 +643,8 @@ createDomainSetRegions(const std::string& mesh_name_pristine,
                            Teuchos::ParameterList& mesh_plist,
                            const Teuchos::RCP<AmanziGeometry::GeometricModel>& gm,
                            State& S,
-                           VerboseObject& vo)
+                           VerboseObject& vo,
+                           SetupCache* cache)
 {
   // strip a :* from the end of the domain set name if needed
   std::string delim(1, Keys::dset_delimiter);
@@ -672,7 +702,7 @@ createDomainSetRegions(const std::string& mesh_name_pristine,
           subdomain_param_list.set("region", subdomain);
 
       // construct
-      auto subdomain_mesh = createMesh(subdomain_list, indexing_parent_mesh->get_comm(), gm, S, vo);
+      auto subdomain_mesh = createMesh(subdomain_list, indexing_parent_mesh->get_comm(), gm, S, vo, cache);
 
       if (subdomain_mesh != Teuchos::null) {
         subdomains.push_back(subdomain);
@@ -682,10 +712,12 @@ createDomainSetRegions(const std::string& mesh_name_pristine,
           // construct map into the reference mesh
           if (subdomain_mesh_type == "extracted" ||
               subdomain_mesh_type == "column") {
-            reference_maps[full_subdomain_name] = createMapToParent(*subdomain_mesh);
+            reference_maps[full_subdomain_name] = getCachedMap(cache, full_subdomain_name,
+                    [&]() { return createMapToParent(*subdomain_mesh); });
           } else if (subdomain_mesh_type == "surface") {
             AMANZI_ASSERT(reference_mesh != Teuchos::null);
-            reference_maps[full_subdomain_name] = createMapSurfaceToSurface(*subdomain_mesh, *reference_mesh);
+            reference_maps[full_subdomain_name] = getCachedMap(cache, full_subdomain_name,
+                    [&]() { return createMapSurfaceToSurface(*subdomain_mesh, *reference_mesh); });
           }
         }
       }
@@ -708,7 +740,8 @@ createMesh(Teuchos::ParameterList& mesh_plist,
            const Amanzi::Comm_ptr_type& comm,
            const Teuchos::RCP<Amanzi::AmanziGeometry::GeometricModel>& gm,
            Amanzi::State& S,
-           Amanzi::VerboseObject& vo)
+           Amanzi::VerboseObject& vo,
+           SetupCache* cache)
 {
   auto mesh_type = mesh_plist.get<std::string>("mesh type");
   auto mesh_name = Keys::cleanPListName(mesh_plist.name());
@@ -735,9 +768,9 @@ createMesh(Teuchos::ParameterList& mesh_plist,
   } else if (mesh_type == "column surface") {
     return createMeshColumnSurface(mesh_name, mesh_plist, gm, S, vo);
   } else if (mesh_type == "domain set indexed") {
-    createDomainSetIndexed(mesh_name, mesh_plist, gm, S, vo);
+    createDomainSetIndexed(mesh_name, mesh_plist, gm, S, vo, cache);
   } else if (mesh_type == "domain set regions") {
-    createDomainSetRegions(mesh_name, mesh_plist, gm, S, vo);
+    createDomainSetRegions(mesh_name, mesh_plist, gm, S, vo, cache);
   } else {
     Errors::Message msg;
     msg << "ATS Mesh Factory: unknown \"mesh type\" parameter \"" << mesh_type
@@ -810,14 +843,20 @@ createMeshes(Teuchos::ParameterList& global_list,
   Teuchos::ParameterList& meshes_list = global_list.sublist("mesh");
   VerboseObject vo(comm, "ATS Mesh Factory", meshes_list);
 
+  // optionally reuse setup work from a previous run
+  std::unique_ptr<SetupCache> cache;
+  if (meshes_list.isSublist("setup cache")) {
+    cache = std::make_unique<SetupCache>(global_list, comm);
+  }
+
   // always try to do the domain mesh first
   if (meshes_list.isSublist("domain")) {
-    createMesh(meshes_list.sublist("domain"), comm, gm, S, vo);
+    createMesh(meshes_list.sublist("domain"), comm, gm, S, vo, cache.get());
   }
 
   // always try to do the surface mesh second
   if (meshes_list.isSublist("surface")) {
-    createMesh(meshes_list.sublist("surface"), comm, gm, S, vo);
+    createMesh(meshes_list.sublist("surface"), comm, gm, S, vo, cache.get());
   }
 
   // now do the rest
@@ -825,11 +864,14 @@ createMeshes(Teuchos::ParameterList& global_list,
     if (sublist.first != "domain" &&
         sublist.first != "surface" &&
         sublist.first != "verbose object" &&
+        sublist.first != "setup cache" &&
         meshes_list.isSublist(sublist.first)) {
-      createMesh(meshes_list.sublist(sublist.first), comm, gm, S, vo);
+      createMesh(meshes_list.sublist(sublist.first), comm, gm, S, vo, cache.get());
     }
   }
 
+  if (cache) cache->Write(vo);
+
   // // FIXME --etc
   // // this should be dealt with somewhere else, and more generally
   // // generalize vis for columns
@@ -28,6 +28,9 @@ provided mesh and then flattening that mesh to a 2D surface.  `Column Meshes`_
 which split a base mesh into vertical columns of cells for use in 1D models
 may also be generated automatically.
 
+Region sets and domain-set maps computed here may be cached on disk and
+reused by later runs on the same mesh and partitioning, see `Setup Cache`_.
+
 Finally, mesh generation is hard and error-prone.  A mesh audit is provided,
 which checks for many common geometric and topologic errors in mesh
 generation.  This is reasonably fast, even for big meshes, and can be done
@@ -288,6 +291,12 @@ Example:
       </ParameterList>
     </ParameterList>
 
+
+Setup Cache
+===========
+
+See the SetupCache_ for a `"setup cache`" sublist of the `"mesh`" list.
+
 */
 
 #ifndef ATS_MESH_FACTORY_HH_
@@ -297,6 +306,8 @@ Example:
 #include "State.hh"
 #include "VerboseObject.hh"
 
+#include "ats_setup_cache.hh"
+
 
 namespace ATS {
 namespace Mesh {
@@ -376,21 +387,24 @@ createDomainSetIndexed(const std::string& mesh_name_pristine,
                        Teuchos::ParameterList& mesh_plist,
                        const Teuchos::RCP<Amanzi::AmanziGeometry::GeometricModel>& gm,
                        Amanzi::State& S,
-                       Amanzi::VerboseObject& vo);
+                       Amanzi::VerboseObject& vo,
+                       SetupCache* cache=nullptr);
 
 void
 createDomainSetRegions(const std::string& mesh_name_pristine,
                        Teuchos::ParameterList& mesh_plist,
                        const Teuchos::RCP<Amanzi::AmanziGeometry::GeometricModel>& gm,
                        Amanzi::State& S,
-                       Amanzi::VerboseObject& vo);
+                       Amanzi::VerboseObject& vo,
+                       SetupCache* cache=nullptr);
 
 Teuchos::RCP<const Amanzi::AmanziMesh::Mesh>
 createMesh(Teuchos::ParameterList& plist,
            const Amanzi::Comm_ptr_type& comm,
            const Teuchos::RCP<Amanzi::AmanziGeometry::GeometricModel>& gm,
            Amanzi::State& s,
-           Amanzi::VerboseObject& vo);
+           Amanzi::VerboseObject& vo,
+           SetupCache* cache=nullptr);
 
 void
 createMeshes(Teuchos::ParameterList& plist,
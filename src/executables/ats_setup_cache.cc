@@ -0,0 +1,328 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+//! An on-disk cache of mesh-derived setup data, reused across runs.
+
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+*/
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include "Teuchos_XMLParameterListHelpers.hpp"
+
+#include "dbc.hh"
+
+#include "ats_setup_cache.hh"
+
+namespace ATS {
+
+namespace {
+
+// File layout, all little-endian as written by this machine:
+//
+//   Header
+//   TOCEntry[num_entries]
+//   char names[]         (concatenated, padded to 8 bytes)
+//   int data[]           (each entry padded to 8 bytes)
+//
+const std::uint64_t SETUP_CACHE_MAGIC = 0x5055544553535441ULL; // "ATSSETUP"
+const std::uint32_t SETUP_CACHE_VERSION = 1;
+
+struct Header {
+  std::uint64_t magic;
+  std::uint64_t key;
+  std::uint32_t version;
+  std::uint32_t num_entries;
+};
+
+struct TOCEntry {
+  std::uint64_t name_offset;
+  std::uint64_t name_len;
+  std::uint64_t data_offset;
+  std::uint64_t data_count;
+};
+
+std::uint64_t pad8(std::uint64_t n) { return (n + 7) & ~std::uint64_t(7); }
+
+MPI_Comm rawComm(const Amanzi::Comm_ptr_type& comm) {
+  auto mpi_comm = Teuchos::rcp_dynamic_cast<const Amanzi::MpiComm_type>(comm);
+  AMANZI_ASSERT(mpi_comm.get());
+  return mpi_comm->Comm();
+}
+
+} // namespace
+
+
+SetupCache::SetupCache(Teuchos::ParameterList& global_list,
+                       const Amanzi::Comm_ptr_type& comm) :
+    comm_(comm),
+    loaded_(false),
+    key_(0),
+    map_(nullptr),
+    map_len_(0)
+{
+  Teuchos::ParameterList& meshes_list = global_list.sublist("mesh");
+  Teuchos::ParameterList& cache_list = meshes_list.sublist("setup cache");
+  directory_ = cache_list.get<std::string>("directory", "setup_cache");
+  read_ = cache_list.get<bool>("read", true);
+  write_ = cache_list.get<bool>("write", true);
+
+  // Compute the key on rank 0 and broadcast, so that all ranks agree even if
+  // the file system does not.
+  if (comm_->MyPID() == 0) {
+    std::uint64_t h = Hash(nullptr, 0);
+
+    // the domain mesh, by its tag or by its file's stamp
+    if (cache_list.isParameter("mesh tag")) {
+      std::string tag = cache_list.get<std::string>("mesh tag");
+      h = Hash(tag.data(), tag.size(), h);
+    } else if (meshes_list.isSublist("domain") &&
+        meshes_list.sublist("domain").isSublist("read mesh file parameters")) {
+      auto& file_list = meshes_list.sublist("domain").sublist("read mesh file parameters");
+      if (file_list.isParameter("file")) {
+        h = HashFileStamp(file_list.get<std::string>("file"), h);
+      }
+    }
+
+    // the mesh and region specs, minus things that do not change the result
+    Teuchos::ParameterList mesh_spec(meshes_list);
+    mesh_spec.remove("setup cache", false);
+    mesh_spec.remove("verbose object", false);
+    std::stringstream spec;
+    Teuchos::writeParameterListToXmlOStream(mesh_spec, spec);
+    if (global_list.isSublist("regions")) {
+      Teuchos::writeParameterListToXmlOStream(global_list.sublist("regions"), spec);
+    }
+    std::string spec_str = spec.str();
+    h = Hash(spec_str.data(), spec_str.size(), h);
+
+    // the partitioning
+    int nprocs = comm_->NumProc();
+    key_ = Hash(reinterpret_cast<const char*>(&nprocs), sizeof(int), h);
+  }
+  MPI_Bcast(&key_, 1, MPI_UINT64_T, 0, rawComm(comm_));
+
+  if (read_) {
+    int my_ok = Load_() ? 1 : 0;
+    int all_ok = 0;
+    comm_->MinAll(&my_ok, &all_ok, 1);
+    loaded_ = all_ok == 1;
+    if (!loaded_) Unmap_();
+  }
+}
+
+
+SetupCache::~SetupCache()
+{
+  Unmap_();
+}
+
+
+std::string
+SetupCache::Filename_() const
+{
+  std::stringstream fname;
+  fname << directory_ << "/ats_setup_" << std::hex << key_ << std::dec
+        << "." << comm_->NumProc() << "." << comm_->MyPID() << ".bin";
+  return fname.str();
+}
+
+
+bool
+SetupCache::Load_()
+{
+  std::string fname = Filename_();
+  int fd = open(fname.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < (off_t) sizeof(Header)) {
+    close(fd);
+    return false;
+  }
+
+  map_len_ = st.st_size;
+  map_ = mmap(nullptr, map_len_, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map_ == MAP_FAILED) {
+    map_ = nullptr;
+    map_len_ = 0;
+    return false;
+  }
+
+  const char* base = static_cast<const char*>(map_);
+  const Header* header = reinterpret_cast<const Header*>(base);
+  if (header->magic != SETUP_CACHE_MAGIC ||
+      header->version != SETUP_CACHE_VERSION ||
+      header->key != key_) return false;
+
+  std::uint64_t toc_end = sizeof(Header) + header->num_entries * sizeof(TOCEntry);
+  if (toc_end > map_len_) return false;
+
+  const TOCEntry* toc = reinterpret_cast<const TOCEntry*>(base + sizeof(Header));
+  for (std::uint32_t i=0; i!=header->num_entries; ++i) {
+    const TOCEntry& e = toc[i];
+    if (e.name_offset + e.name_len > map_len_ ||
+        e.data_offset + e.data_count * sizeof(int) > map_len_ ||
+        e.data_offset % sizeof(int) != 0) {
+      entries_.clear();
+      return false;
+    }
+    std::string name(base + e.name_offset, e.name_len);
+    entries_[name] = std::make_pair(reinterpret_cast<const int*>(base + e.data_offset),
+            (std::size_t) e.data_count);
+  }
+  return true;
+}
+
+
+void
+SetupCache::Unmap_()
+{
+  entries_.clear();
+  if (map_ != nullptr) {
+    munmap(map_, map_len_);
+    map_ = nullptr;
+    map_len_ = 0;
+  }
+}
+
+
+bool
+SetupCache::Get(const std::string& name, std::vector<int>& data) const
+{
+  if (!loaded_) return false;
+  auto entry = entries_.find(name);
+  if (entry == entries_.end()) return false;
+  data.assign(entry->second.first, entry->second.first + entry->second.second);
+  return true;
+}
+
+
+void
+SetupCache::Put(const std::string& name, const std::vector<int>& data)
+{
+  if (!loaded_ && write_) staged_[name] = data;
+}
+
+
+void
+SetupCache::Write(Amanzi::VerboseObject& vo)
+{
+  if (loaded_) {
+    if (vo.os_OK(Teuchos::VERB_LOW)) {
+      *vo.os() << "Setup cache: loaded " << entries_.size() << " entries from \""
+               << directory_ << "\"." << std::endl;
+    }
+    return;
+  }
+  if (!write_) return;
+
+  // lay out the file
+  Header header;
+  header.magic = SETUP_CACHE_MAGIC;
+  header.key = key_;
+  header.version = SETUP_CACHE_VERSION;
+  header.num_entries = staged_.size();
+
+  std::vector<TOCEntry> toc;
+  std::uint64_t offset = sizeof(Header) + staged_.size() * sizeof(TOCEntry);
+  for (const auto& entry : staged_) {
+    TOCEntry e;
+    e.name_offset = offset;
+    e.name_len = entry.first.size();
+    offset += e.name_len;
+    toc.push_back(e);
+  }
+  offset = pad8(offset);
+  int i = 0;
+  for (const auto& entry : staged_) {
+    toc[i].data_offset = offset;
+    toc[i].data_count = entry.second.size();
+    offset = pad8(offset + entry.second.size() * sizeof(int));
+    ++i;
+  }
+
+  // write to a temporary and rename, so that a concurrent reader never sees
+  // a partial file
+  std::string fname = Filename_();
+  std::string tmpname = fname + ".tmp";
+  int my_ok = 1;
+  {
+    std::ofstream fid(tmpname, std::ios::binary);
+    if (!fid.good()) my_ok = 0;
+
+    const char zeros[8] = {0,0,0,0,0,0,0,0};
+    if (my_ok) {
+      fid.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+      fid.write(reinterpret_cast<const char*>(toc.data()), toc.size() * sizeof(TOCEntry));
+      std::uint64_t pos = sizeof(Header) + toc.size() * sizeof(TOCEntry);
+      for (const auto& entry : staged_) {
+        fid.write(entry.first.data(), entry.first.size());
+        pos += entry.first.size();
+      }
+      fid.write(zeros, pad8(pos) - pos);
+      for (const auto& entry : staged_) {
+        std::uint64_t len = entry.second.size() * sizeof(int);
+        fid.write(reinterpret_cast<const char*>(entry.second.data()), len);
+        fid.write(zeros, pad8(len) - len);
+      }
+      my_ok = fid.good() ? 1 : 0;
+    }
+  }
+  if (my_ok) my_ok = std::rename(tmpname.c_str(), fname.c_str()) == 0 ? 1 : 0;
+
+  int all_ok = 0;
+  comm_->MinAll(&my_ok, &all_ok, 1);
+  if (vo.os_OK(Teuchos::VERB_LOW)) {
+    if (all_ok) {
+      *vo.os() << "Setup cache: wrote " << staged_.size() << " entries to \""
+               << directory_ << "\"." << std::endl;
+    } else {
+      *vo.os() << "Setup cache: WARNING, failed to write cache to \""
+               << directory_ << "\", does the directory exist?" << std::endl;
+    }
+  }
+  staged_.clear();
+}
+
+
+std::uint64_t
+SetupCache::Hash(const char* data, std::size_t len, std::uint64_t h)
+{
+  for (std::size_t i=0; i!=len; ++i) {
+    h ^= static_cast<unsigned char>(data[i]);
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+
+std::uint64_t
+SetupCache::HashFileStamp(const std::string& filename, std::uint64_t h)
+{
+  // Reading the file would cost as much as the setup saved on big meshes.
+  // Prepartitioned .par files do not exist under this name, and are
+  // identified by the name alone.
+  h = Hash(filename.data(), filename.size(), h);
+
+  struct stat st;
+  if (stat(filename.c_str(), &st) == 0) {
+    std::int64_t stamp[3] = { static_cast<std::int64_t>(st.st_size),
+                              static_cast<std::int64_t>(st.st_mtim.tv_sec),
+                              static_cast<std::int64_t>(st.st_mtim.tv_nsec) };
+    h = Hash(reinterpret_cast<const char*>(stamp), sizeof(stamp), h);
+  }
+  return h;
+}
+
+} // namespace ATS
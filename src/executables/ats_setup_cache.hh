@@ -0,0 +1,134 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+//! An on-disk cache of mesh-derived setup data, reused across runs.
+
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+*/
+
+/*!
+
+Some of the work done before the first timestep is identical from run to
+run: resolving the region sets which define the subdomains of domain sets,
+and building the maps from those subdomains to their parent meshes.
+Restarts and ensemble members repeat this work exactly.  The setup cache
+stores these results on disk, one file per rank, and reloads them on
+startup.
+
+Only these results of the ATS mesh factory are cached.  Mesh connectivity,
+partitioning and the column structures are built by the mesh framework, and
+are recomputed on every run; the cache pays off only when a simulation has
+many region-defined subdomains or columns, where their region sets and maps
+are a notable part of setup.
+
+A cache is valid only for the same mesh and the same partitioning, so it is
+keyed by the domain mesh file's name, size and modification time (or, if
+given, a `"mesh tag`"), the `"mesh`" and `"regions`" parameter lists, and
+the number of processes.  A mesh file which is replaced by one of identical
+size within the file system's time resolution must be given a new tag.  A
+cache whose key does not match is silently ignored and, if writing is
+enabled, replaced.  If any rank fails to load its cache file, all ranks
+recompute.
+
+Files are flat binary arrays of integers with a table of contents, and are
+memory-mapped on reading, so only the entries actually used are paged in.
+
+The cache is specified by a `"setup cache`" sublist of the `"mesh`" list.
+
+.. _setup-cache-spec:
+.. admonition:: setup-cache-spec
+
+    * `"directory`" ``[string]`` **setup_cache** Directory in which cache
+      files are stored.  It must exist.
+    * `"read`" ``[bool]`` **true** Load the cache if it exists and is valid.
+    * `"write`" ``[bool]`` **true** Write the cache if it was not loaded.
+    * `"mesh tag`" ``[string]`` **optional** If provided, identifies the
+      domain mesh in the key in place of its file's name, size and
+      modification time.
+
+Example:
+
+.. code-block:: xml
+
+   <ParameterList name="mesh">
+     <ParameterList name="setup cache">
+       <Parameter name="directory" type="string" value="../cache" />
+     </ParameterList>
+     ...
+   </ParameterList>
+
+*/
+
+#ifndef ATS_SETUP_CACHE_HH_
+#define ATS_SETUP_CACHE_HH_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Teuchos_ParameterList.hpp"
+#include "Teuchos_RCP.hpp"
+
+#include "AmanziComm.hh"
+#include "VerboseObject.hh"
+
+namespace ATS {
+
+class SetupCache {
+ public:
+  // Collective.  Computes the key and, if requested, loads the cache.
+  SetupCache(Teuchos::ParameterList& global_list,
+             const Amanzi::Comm_ptr_type& comm);
+  ~SetupCache();
+
+  SetupCache(const SetupCache& other) = delete;
+  SetupCache& operator=(const SetupCache& other) = delete;
+
+  // Was a valid cache loaded on all ranks?
+  bool loaded() const { return loaded_; }
+  std::uint64_t key() const { return key_; }
+
+  // Access to a loaded entry.  Returns false if the entry does not exist.
+  bool Get(const std::string& name, std::vector<int>& data) const;
+
+  // Stage an entry to be written.  No-op if the cache was loaded.
+  void Put(const std::string& name, const std::vector<int>& data);
+
+  // Collective.  Writes staged entries if the cache was not loaded and
+  // writing is enabled.
+  void Write(Amanzi::VerboseObject& vo);
+
+  // hash helpers, FNV-1a
+  static std::uint64_t Hash(const char* data, std::size_t len,
+                            std::uint64_t h = 14695981039346656037ULL);
+
+  // Hashes a file's name, size and modification time, not its contents.
+  static std::uint64_t HashFileStamp(const std::string& filename,
+          std::uint64_t h = 14695981039346656037ULL);
+
+ private:
+  bool Load_();
+  void Unmap_();
+  std::string Filename_() const;
+
+ private:
+  Amanzi::Comm_ptr_type comm_;
+  std::string directory_;
+  bool read_, write_;
+  bool loaded_;
+  std::uint64_t key_;
+
+  // read side, memory mapped
+  void* map_;
+  std::size_t map_len_;
+  std::map<std::string, std::pair<const int*, std::size_t>> entries_;
+
+  // write side
+  std::map<std::string, std::vector<int>> staged_;
+};
+
+} // namespace ATS
+
+#endif
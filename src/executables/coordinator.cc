@@ -12,6 +12,7 @@ including Vis and restart/checkpoint dumps.  It contains one and only one PK
 -- most likely this PK is an MPC of some type -- to do the actual work.
 ------------------------------------------------------------------------- */
 
+#include <algorithm>
 #include <iostream>
 #include <unistd.h>
 #include <sys/resource.h>
@@ -36,20 +37,56 @@ including Vis and restart/checkpoint dumps.  It contains one and only one PK
 #include "PK.hh"
 #include "TreeVector.hh"
 #include "PK_Factory.hh"
+#include "primary_variable_field_evaluator.hh"
+#include "pk_diagnostics.hh"
+#include "pk_bdf_default.hh"
 
+#include "spin_up.hh"
 #include "coordinator.hh"
 
 #define DEBUG_MODE 1
 
 namespace ATS {
 
+namespace {
+
+// the domain of a key, naming the default domain
+std::string
+domainOf(const std::string& key)
+{
+  std::string domain = Amanzi::Keys::getDomain(key);
+  return domain.empty() ? std::string("domain") : domain;
+}
+
+// the variables of an observation, which observes one or a list of quantities
+std::vector<std::string>
+observedFields(const Teuchos::ParameterList& obs_list)
+{
+  std::vector<std::string> fields;
+  if (obs_list.isSublist("observed quantities")) {
+    const Teuchos::ParameterList& quantities = obs_list.sublist("observed quantities");
+    for (const auto& entry : quantities) {
+      if (quantities.isSublist(entry.first) &&
+          quantities.sublist(entry.first).isParameter("variable")) {
+        fields.push_back(quantities.sublist(entry.first).get<std::string>("variable"));
+      }
+    }
+  } else if (obs_list.isParameter("variable")) {
+    fields.push_back(obs_list.get<std::string>("variable"));
+  }
+  return fields;
+}
+
+} // namespace
+
 Coordinator::Coordinator(Teuchos::ParameterList& parameter_list,
                          Teuchos::RCP<Amanzi::State>& S,
                          Amanzi::Comm_ptr_type comm ) :
     parameter_list_(Teuchos::rcp(new Teuchos::ParameterList(parameter_list))),
     S_(S),
     comm_(comm),
-    restart_(false) {
+    restart_(false),
+    fast_restart_(false) {
 
   // create and start the global timer
   timer_ = Teuchos::rcp(new Teuchos::Time("wallclock_monitor",true));
@@ -91,6 +128,7 @@ void Coordinator::coordinator_init() {
     if (observation_plist.isSublist(sublist.first)) {
       observations_.emplace_back(Teuchos::rcp(new Amanzi::UnstructuredObservations(
                 observation_plist.sublist(sublist.first), S_.ptr())));
+      obs_fields_.push_back(observedFields(observation_plist.sublist(sublist.first)));
     } else {
       Errors::Message msg("\"observations\" list must only include sublists.");
       Exceptions::amanzi_throw(msg);
@@ -123,6 +161,12 @@ void Coordinator::coordinator_init() {
 
   // create the time step manager
   tsm_ = Teuchos::rcp(new Amanzi::TimeStepManager());
+
+  // create the spin-up controller
+  if (coordinator_list_->isSublist("spin-up")) {
+    spinup_ = Teuchos::rcp(new SpinUp(coordinator_list_->sublist("spin-up"),
+            Teuchos::rcp(new Amanzi::VerboseObject("SpinUp", *coordinator_list_))));
+  }
 }
 
 void Coordinator::setup() {
@@ -140,27 +184,62 @@ void Coordinator::initialize() {
   int size = comm_->NumProc();
   int rank = comm_->MyPID();
 
+  // phase timers, only reported for a fast restart
+  Teuchos::RCP<Teuchos::Time> restart_read_timer, restart_init_timer,
+      restart_deform_timer, restart_eval_timer;
+  Teuchos::RCP<Amanzi::Checkpoint> restart_chkp;
+  if (fast_restart_) {
+    restart_read_timer = Teuchos::TimeMonitor::getNewCounter("restart: read checkpoint");
+    restart_init_timer = Teuchos::TimeMonitor::getNewCounter("restart: initialize");
+    restart_deform_timer = Teuchos::TimeMonitor::getNewCounter("restart: deform meshes");
+    restart_eval_timer = Teuchos::TimeMonitor::getNewCounter("restart: evaluate secondaries");
+  }
+
   // Restart from checkpoint part 1:
   //  - get the time prior to initializing anything else
   if (restart_) {
     S_->set_time(Amanzi::ReadCheckpointInitialTime(comm_, restart_filename_));
   }
 
-  // Initialize the state
-  *S_->GetScalarData("dt", "coordinator") = 0.;
-  S_->GetField("dt","coordinator")->set_initialized();
-  S_->InitializeFields();
+  // -- for a fast restart, read primary variables now, so that their initial
+  //    conditions are never evaluated
+  if (fast_restart_) {
+    Teuchos::TimeMonitor monitor(*restart_read_timer);
+    restart_chkp = Teuchos::rcp(new Amanzi::Checkpoint(restart_filename_, *S_));
+    read_restart_attributes(*restart_chkp);
+    read_restart_fields(*restart_chkp, true);
+  }
 
-  // Initialize the process kernels
-  pk_->Initialize(S_.ptr());
+  {
+    Teuchos::RCP<Teuchos::TimeMonitor> monitor;
+    if (fast_restart_) monitor = Teuchos::rcp(new Teuchos::TimeMonitor(*restart_init_timer));
+
+    // Initialize the state
+    *S_->GetScalarData("dt", "coordinator") = 0.;
+    S_->GetField("dt","coordinator")->set_initialized();
+    S_->InitializeFields();
+
+    // Initialize the process kernels
+    pk_->Initialize(S_.ptr());
+  }
 
   // Restart from checkpoint part 2:
   // -- load all other data
   if (restart_) {
-    Amanzi::ReadCheckpoint(*S_, restart_filename_);
+    if (fast_restart_) {
+      // -- only fields that are not computed by an evaluator
+      Teuchos::TimeMonitor monitor(*restart_read_timer);
+      read_restart_fields(*restart_chkp, false);
+      restart_chkp->Finalize();
+      restart_chkp = Teuchos::null;
+    } else {
+      Amanzi::ReadCheckpoint(*S_, restart_filename_);
+    }
     t0_ = S_->time();
     cycle0_ = S_->cycle();
-    
+
+    Teuchos::RCP<Teuchos::TimeMonitor> monitor;
+    if (fast_restart_) monitor = Teuchos::rcp(new Teuchos::TimeMonitor(*restart_deform_timer));
     for (Amanzi::State::mesh_iterator mesh=S_->mesh_begin();
          mesh!=S_->mesh_end(); ++mesh) {
       if (S_->IsDeformableMesh(mesh->first)) {
@@ -171,7 +250,25 @@ void Coordinator::initialize() {
 
   // Final checks.
   S_->CheckNotEvaluatedFieldsInitialized();
-  S_->InitializeEvaluators();
+  if (fast_restart_) {
+    // Secondary fields are left to be computed by their evaluators on first
+    // use, which is guaranteed as no evaluator has yet been asked for them.
+    // Those with copies are the exception, as the copies are made now.
+    Teuchos::TimeMonitor monitor(*restart_eval_timer);
+    std::vector<Amanzi::Key> copied;
+    for (Amanzi::State::field_iterator field=S_->field_begin(); field!=S_->field_end(); ++field) {
+      if (S_->HasFieldEvaluator(field->first)) {
+        field->second->set_initialized();
+        auto copies = field->second->GetCopies();
+        if (copies != Teuchos::null && !copies->empty()) copied.push_back(field->first);
+      }
+    }
+    for (const auto& key : copied) {
+      S_->GetFieldEvaluator(key)->HasFieldChanged(S_.ptr(), "coordinator");
+    }
+  } else {
+    S_->InitializeEvaluators();
+  }
   S_->InitializeFieldCopies();
   S_->CheckAllFieldsInitialized();
 
@@ -218,6 +315,8 @@ void Coordinator::initialize() {
       vis->CreateFiles(false);
 
       visualization_.push_back(vis);
+      vis_domains_.push_back(std::vector<std::string>(1,
+              domain_name.empty() ? std::string("domain") : domain_name));
 
     } else if (Amanzi::Keys::isDomainSet(domain_name)) {
       // visualize domain set
@@ -228,12 +327,14 @@ void Coordinator::initialize() {
         // visualize each subdomain
         for (const auto& subdomain : *dset) {
           Teuchos::ParameterList sublist = vis_list->sublist(subdomain);
-          sublist.set<std::string>("file name base", std::string("ats_vis_")+subdomain);
+          sublist.set<std::string>("file name base",
+                  sublist_p->get<std::string>("file name base", "ats_vis")+"_"+subdomain);
           auto vis = Teuchos::rcp(new Amanzi::Visualization(sublist));
           vis->set_name(subdomain);
           vis->set_mesh(S_->GetMesh(subdomain));
           vis->CreateFiles(false);
           visualization_.push_back(vis);
+          vis_domains_.push_back(std::vector<std::string>(1, subdomain));
         }
       } else {
         // visualize collectively
@@ -248,9 +349,26 @@ void Coordinator::initialize() {
         }
         vis->CreateFiles(false);
         visualization_.push_back(vis);
+        vis_domains_.push_back(std::vector<std::string>(dset->begin(), dset->end()));
       }
     }
   }
+  register_vis_fields();
+
+  // if anything is to be written at the restart time, secondary fields are
+  // needed now
+  if (fast_restart_) {
+    bool output_requested = checkpoint_->DumpRequested(S_->cycle(), S_->time());
+    for (const auto& vis : visualization_)
+      output_requested |= vis->DumpRequested(S_->cycle(), S_->time());
+    for (const auto& obs : observations_)
+      output_requested |= obs->DumpRequested(S_->cycle(), S_->time());
+
+    if (output_requested) {
+      Teuchos::TimeMonitor monitor(*restart_eval_timer);
+      evaluate_secondaries();
+    }
+  }
 
   // make observations
   for (const auto& obs : observations_) obs->MakeObservations(S_.ptr());
@@ -278,6 +396,16 @@ void Coordinator::initialize() {
     pause_times.RegisterWithTimeStepManager(tsm_.ptr());
   }
 
+  // -- register the ends of spin-up periods, and record the initial state
+  if (spinup_ != Teuchos::null) {
+    spinup_->Initialize(*S_, t1_, tsm_.ptr());
+    if (restart_ && vo_->os_OK(Teuchos::VERB_LOW)) {
+      Teuchos::OSTab tab = vo_->getOSTab();
+      *vo_->os() << "Spin-up is not restarted: a new spin-up begins, with a period starting at t = "
+                 << S_->time() << std::endl;
+    }
+  }
+
   // Create an intermediate state that will store the updated solution until
   // we know it has succeeded.
   S_next_ = Teuchos::rcp(new Amanzi::State(*S_));
@@ -300,6 +428,123 @@ void Coordinator::initialize() {
   pk_->set_states(S_, S_inter_, S_next_);
 }
 
+// -----------------------------------------------------------------------------
+// Read a subset of fields from a restart file.  If primary, read only primary
+// variables, otherwise read only fields that have no evaluator at all.
+// Secondary fields are never read, as they will be recomputed anyway.
+// -----------------------------------------------------------------------------
+void Coordinator::read_restart_attributes(Amanzi::Checkpoint& chkp) {
+  // As in Amanzi::ReadCheckpoint, fields are only readable on the number of
+  // processes on which they were written.
+  int num_procs = -1;
+  chkp.Read("mpi_num_procs", num_procs);
+  if (num_procs != comm_->NumProc()) {
+    Errors::Message msg;
+    msg << "Requested checkpoint file \"" << restart_filename_ << "\" was created on "
+        << num_procs << " processes, making it incompatible with this run on "
+        << comm_->NumProc() << " processes.";
+    Exceptions::amanzi_throw(msg);
+  }
+
+  double time = 0.;
+  chkp.Read("time", time);
+  S_->set_time(time);
+
+  int cycle = 0;
+  chkp.Read("cycle", cycle);
+  S_->set_cycle(cycle);
+}
+
+
+void Coordinator::read_restart_fields(const Amanzi::Checkpoint& chkp, bool primary) {
+  int nread = 0;
+  for (Amanzi::State::field_iterator field=S_->field_begin(); field!=S_->field_end(); ++field) {
+    // scalars too, e.g. PK state which is not a field on the mesh
+    if (!field->second->io_checkpoint()) continue;
+
+    bool is_primary = false;
+    bool is_evaluated = S_->HasFieldEvaluator(field->first);
+    if (is_evaluated) {
+      is_primary = Teuchos::rcp_dynamic_cast<Amanzi::PrimaryVariableFieldEvaluator>(
+          S_->GetFieldEvaluator(field->first)) != Teuchos::null;
+    }
+
+    if (primary ? is_primary : !is_evaluated) {
+      bool read_complete = field->second->ReadCheckpoint(chkp);
+      if (read_complete) {
+        field->second->set_initialized();
+        nread++;
+      }
+    }
+  }
+
+  if (vo_->os_OK(Teuchos::VERB_MEDIUM)) {
+    Teuchos::OSTab tab = vo_->getOSTab();
+    *vo_->os() << "Fast restart: read " << nread
+               << (primary ? " primary variables" : " non-evaluated fields")
+               << " from \"" << restart_filename_ << "\"" << std::endl;
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+// Force evaluation of all secondary fields.
+// -----------------------------------------------------------------------------
+void Coordinator::evaluate_secondaries() {
+  for (Amanzi::State::field_iterator field=S_->field_begin(); field!=S_->field_end(); ++field) {
+    if (S_->HasFieldEvaluator(field->first)) {
+      S_->GetFieldEvaluator(field->first)->HasFieldChanged(S_.ptr(), "coordinator");
+    }
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+// Register the fields written by each visualization: those of its domains
+// flagged for vis.
+// -----------------------------------------------------------------------------
+void Coordinator::register_vis_fields() {
+  vis_fields_.clear();
+  for (const auto& domains : vis_domains_) {
+    std::vector<std::string> fields;
+    for (Amanzi::State::field_iterator field=S_->field_begin(); field!=S_->field_end(); ++field) {
+      if (field->second->io_vis() &&
+          std::find(domains.begin(), domains.end(), domainOf(field->first)) != domains.end()) {
+        fields.push_back(field->first);
+      }
+    }
+    vis_fields_.push_back(fields);
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+// Calculate the diagnostics, and update the evaluators, of the fields consumed
+// by the visualization and observations due now.
+// -----------------------------------------------------------------------------
+void Coordinator::calculate_diagnostics(bool force) {
+  Amanzi::DiagnosticsDemand demand;
+  for (int i=0; i!=visualization_.size(); ++i) {
+    if (force || visualization_[i]->DumpRequested(S_next_->cycle(), S_next_->time())) {
+      for (const auto& key : vis_fields_[i]) demand.Require(key);
+    }
+  }
+  for (int i=0; i!=observations_.size(); ++i) {
+    if (observations_[i]->DumpRequested(S_next_->cycle(), S_next_->time())) {
+      for (const auto& key : obs_fields_[i]) demand.Require(key);
+    }
+  }
+  if (demand.empty()) return;
+
+  Amanzi::calculateDiagnostics(*pk_, S_next_, demand);
+  for (const auto& key : demand.keys()) {
+    if (S_next_->HasFieldEvaluator(key)) {
+      S_next_->GetFieldEvaluator(key)->HasFieldChanged(S_next_.ptr(), "coordinator");
+    }
+  }
+}
+
+
 void Coordinator::finalize() {
   // Force checkpoint at the end of simulation, and copy to checkpoint_final
   pk_->CalculateDiagnostics(S_next_);
@@ -427,6 +672,16 @@ void Coordinator::read_parameter_list() {
   // restart control
   restart_ = coordinator_list_->isParameter("restart from checkpoint file");
   if (restart_) restart_filename_ = coordinator_list_->get<std::string>("restart from checkpoint file");
+
+  std::string restart_mode = coordinator_list_->get<std::string>("restart mode", "full");
+  if (restart_mode == "fast") {
+    fast_restart_ = restart_;
+  } else if (restart_mode != "full") {
+    Errors::Message msg;
+    msg << "Coordinator: unknown \"restart mode\" \"" << restart_mode
+        << "\", valid are \"full\" and \"fast\".";
+    Exceptions::amanzi_throw(msg);
+  }
 }
 
 
@@ -446,6 +701,12 @@ double Coordinator::get_dt(bool after_fail) {
     Exceptions::amanzi_throw(message);
   }
 
+  // in spin-up, follow the previous period's steps
+  if (spinup_ != Teuchos::null && !after_fail) {
+    double dt_schedule = spinup_->ScheduledDt(S_next_->time());
+    if (dt_schedule > 0.) dt = dt_schedule;
+  }
+
   // cap the max step size
   if (dt > max_dt_) {
     dt = max_dt_;
@@ -472,10 +733,10 @@ bool Coordinator::advance(double t_old, double t_new) {
     // commit the state
     pk_->CommitStep(t_old, t_new, S_next_);
 
-    // make observations, vis, and checkpoints
-    for (const auto& obs : observations_) obs->MakeObservations(S_next_.ptr());
-    visualize();
-    checkpoint(dt);
+    // make observations, vis, and checkpoints, which at the end of a spin-up
+    // period follow the jump to the start of the next period
+    if (spinup_ == Teuchos::null || !spinup_->IsPeriodEnd(S_next_->time()))
+      write_output(dt);
 
     // we're done with this time step, copy the state
     *S_ = *S_next_;
@@ -503,41 +764,44 @@ bool Coordinator::advance(double t_old, double t_new) {
         vc_vec->ScatterMasterToGhosted();
         const Epetra_MultiVector& vc = *vc_vec->ViewComponent("node", true);
 
-        std::vector<int> node_ids(vc.MyLength());
-        Amanzi::AmanziGeometry::Point_List old_positions(vc.MyLength());
+        // Only nodes that moved during the failed step are restored.
+        // Typically this is a small set, or empty if the step failed before
+        // or without deforming.
+        int dim = mesh->second.first->space_dimension();
+        Amanzi::AmanziMesh::Entity_ID_List node_ids;
+        Amanzi::AmanziGeometry::Point_List old_positions;
+        Amanzi::AmanziGeometry::Point x(dim);
         for (int n=0; n!=vc.MyLength(); ++n) {
-          node_ids[n] = n;
-          if (mesh->second.first->space_dimension() == 2) {
-            old_positions[n] = Amanzi::AmanziGeometry::Point(vc[0][n], vc[1][n]);
-          } else {
-            old_positions[n] = Amanzi::AmanziGeometry::Point(vc[0][n], vc[1][n], vc[2][n]);
+          mesh->second.first->node_get_coordinates(n, &x);
+          bool moved = false;
+          for (int s=0; s!=dim; ++s) moved |= x[s] != vc[s][n];
+          if (moved) {
+            for (int s=0; s!=dim; ++s) x[s] = vc[s][n];
+            node_ids.push_back(n);
+            old_positions.push_back(x);
           }
         }
 
         // undeform the mesh
-        Amanzi::AmanziGeometry::Point_List final_positions;
-        mesh->second.first->deform(node_ids, old_positions, false, &final_positions);
+        if (node_ids.size() > 0) {
+          Amanzi::AmanziGeometry::Point_List final_positions;
+          mesh->second.first->deform(node_ids, old_positions, false, &final_positions);
+        }
       }
     }
   }
   return fail;
 }
 
-void Coordinator::visualize(bool force) {
-  // write visualization if requested
-  bool dump = force;
-  if (!dump) {
-    for (const auto& vis : visualization_) {
-      if (vis->DumpRequested(S_next_->cycle(), S_next_->time())) {
-        dump = true;
-      }
-    }
-  }
-
-  if (dump) {
-    pk_->CalculateDiagnostics(S_next_);
-  }
+void Coordinator::write_output(double dt) {
+  calculate_diagnostics();
+  for (const auto& obs : observations_) obs->MakeObservations(S_next_.ptr());
+  visualize();
+  checkpoint(dt);
+}
 
+void Coordinator::visualize(bool force) {
+  // write visualization if requested, following calculate_diagnostics()
   for (const auto& vis : visualization_) {
     if (force || vis->DumpRequested(S_next_->cycle(), S_next_->time())) {
       WriteVis(*vis, *S_next_);
@@ -573,6 +837,7 @@ void Coordinator::cycle_driver() {
   double dt = get_dt(false);
 
   // visualization at IC
+  calculate_diagnostics();
   visualize();
   checkpoint(dt);
 
@@ -609,6 +874,30 @@ void Coordinator::cycle_driver() {
       S_->set_intermediate_time(S_->time());
 
       fail = advance(S_->time(), S_->time() + dt);
+
+      if (spinup_ != Teuchos::null) {
+        if (fail) {
+          spinup_->RecordFailedStep();
+        } else {
+          spinup_->RecordStep(S_->time());
+          if (spinup_->IsPeriodEnd(S_->time())) {
+            // the next period may start from an accelerated state
+            bool converged = spinup_->EndPeriod(*S_next_);
+            *S_ = *S_next_;
+            *S_inter_ = *S_next_;
+            spinup_->SetChanged(*S_);
+            if (subcycled_ts_) spinup_->SetChanged(*S_inter_);
+
+            // the integrators' history predates the jump
+            pk_->State_to_Solution(S_next_, *soln_);
+            Amanzi::resetTimeSteppers(*pk_, S_next_->time());
+
+            write_output(dt);
+            if (converged && spinup_->stop_when_converged()) break;
+          }
+        }
+      }
+
       dt = get_dt(fail);
     } // while not finished
 
@@ -619,6 +908,7 @@ void Coordinator::cycle_driver() {
   catch (Amanzi::Exceptions::Amanzi_exception &e) {
     // write one more vis for help debugging
     S_next_->advance_cycle();
+    calculate_diagnostics(true);
     visualize(true); // force vis
 
     // flush observations to make sure they are saved
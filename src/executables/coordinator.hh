@@ -37,6 +37,20 @@ simulation, including starting and ending times and restart options.
       steps.
     * `"restart from checkpoint file`" ``[string]`` **optional** If provided,
       specifies a path to the checkpoint file to continue a stopped simulation.
+    * `"restart mode`" ``[string]`` **full** One of:
+
+      - `"full`" Initialize all fields from initial conditions and evaluators,
+        then overwrite every checkpointed field from the file.
+      - `"fast`" Read primary variables from the checkpoint before
+        initialization, so that their initial conditions are never
+        evaluated, read only those other fields which are not computed by an
+        evaluator, and leave secondary fields to be computed by their
+        evaluators on first use.  Secondary fields are evaluated eagerly only
+        if they have copies, which are initialized from them, or if
+        visualization, observation, or checkpoint output is requested at the
+        restart time.  As with a full restart, the checkpoint must have been
+        written on the same number of processes.  Each phase of the restart
+        is timed.
     * `"wallclock duration [hrs]`" ``[double]`` **optional** After this time, the
       simulation will checkpoint and end.
     * `"required times`" ``[io-event-spec]`` **optional** An IOEvent_ spec that
@@ -44,9 +58,18 @@ simulation, including starting and ending times and restart options.
       hit exactly.  This is useful for situations such as where data is provided at
       a regular interval, and interpolation error related to that data is to be
       minimized.
+    * `"spin-up`" ``[spin-up-spec]`` **optional** If provided, the
+      simulation is a spin-up of periodic forcing.  See SpinUp_.
     * `"PK tree`" ``[pk-typed-spec-list]`` List of length one, the top level
       PK_ spec.
 
+PK diagnostics, e.g. velocities, are calculated only for output.  Each
+visualization registers the fields it writes (those of its domains which are
+flagged for vis) and each observation the variables it observes.  When output
+is due, only PKs which compute one of the fields registered by the due output
+calculate their diagnostics, and only the evaluators of those fields are
+updated.
+
 Note: Either `"end cycle`" or `"end time`" are required, and if
 both are present, the simulation will stop with whichever arrives
 first.  An `"end cycle`" is commonly used to ensure that, in the case
@@ -100,6 +123,8 @@ class UnstructuredObservations;
 
 namespace ATS {
 
+class SpinUp;
+
 class Coordinator {
 
 public:
@@ -114,7 +139,9 @@ public:
   void finalize();
   void report_memory();
   bool advance(double t_old, double t_new);
+  void calculate_diagnostics(bool force=false);
   void visualize(bool force=false);
+  void write_output(double dt);  // diagnostics, observations, vis, checkpoint
   void checkpoint(double dt, bool force=false);
   double get_dt(bool after_fail=false);
   Teuchos::RCP<Amanzi::State> get_next_state() { return S_next_; }
@@ -126,6 +153,14 @@ private:
   void coordinator_init();
   void read_parameter_list();
 
+  // the fields consumed by each visualization
+  void register_vis_fields();
+
+  // restart helpers
+  void read_restart_attributes(Amanzi::Checkpoint& chkp);
+  void read_restart_fields(const Amanzi::Checkpoint& chkp, bool primary);
+  void evaluate_secondaries();
+
   // PK container and factory
   Teuchos::RCP<Amanzi::PK> pk_;
 
@@ -152,12 +187,19 @@ private:
   // vis and checkpointing
   std::vector<Teuchos::RCP<Amanzi::Visualization> > visualization_;
   std::vector<Teuchos::RCP<Amanzi::Visualization> > failed_visualization_;
+  std::vector<std::vector<std::string> > vis_domains_;
+  std::vector<std::vector<std::string> > vis_fields_;
   Teuchos::RCP<Amanzi::Checkpoint> checkpoint_;
   bool restart_;
+  bool fast_restart_;
   std::string restart_filename_;
 
   // observations
   std::vector<Teuchos::RCP<Amanzi::UnstructuredObservations>> observations_;
+  std::vector<std::vector<std::string> > obs_fields_;
+
+  // spin-up of periodic forcing
+  Teuchos::RCP<SpinUp> spinup_;
 
   // timers
   Teuchos::RCP<Teuchos::Time> setup_timer_;
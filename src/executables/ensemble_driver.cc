@@ -0,0 +1,244 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+/* -------------------------------------------------------------------------
+ATS
+
+License: see ATS_DIR/COPYRIGHT
+
+------------------------------------------------------------------------- */
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <Epetra_MpiComm.h>
+
+#include "Teuchos_ParameterList.hpp"
+#include "Teuchos_XMLParameterListHelpers.hpp"
+#include "Teuchos_TimeMonitor.hpp"
+
+#include "VerboseObject.hh"
+#include "AmanziComm.hh"
+#include "AmanziTypes.hh"
+
+#include "GeometricModel.hh"
+#include "coordinator.hh"
+#include "State.hh"
+
+#include "dbc.hh"
+#include "errors.hh"
+#include "exceptions.hh"
+
+#include "ats_mesh_factory.hh"
+#include "ensemble_driver.hh"
+
+namespace ATS {
+
+namespace {
+
+// Prefixes the names of all visualization, checkpoint and observation files.
+// Unset visualization names get the Coordinator's default, prefixed.
+void
+prefixOutput(Teuchos::ParameterList& plist, const std::string& prefix)
+{
+  if (plist.isSublist("visualization")) {
+    Teuchos::ParameterList& vis_list = plist.sublist("visualization");
+    for (auto& entry : vis_list) {
+      if (!vis_list.isSublist(entry.first)) continue;
+      const std::string& domain_name = entry.first;
+      Teuchos::ParameterList& sublist = vis_list.sublist(domain_name);
+
+      std::string name_base;
+      if (sublist.isParameter("file name base")) {
+        name_base = sublist.get<std::string>("file name base");
+      } else if (domain_name.empty() || domain_name == "domain") {
+        name_base = "ats_vis";
+      } else if (Amanzi::Keys::isDomainSet(domain_name)) {
+        // subdomains visualized individually append their own name
+        if (sublist.get("visualize individually", false)) name_base = "ats_vis";
+        else name_base = std::string("ats_vis_")+Amanzi::Keys::getDomainSetName(domain_name);
+      } else {
+        name_base = std::string("ats_vis_")+domain_name;
+      }
+      sublist.set<std::string>("file name base", prefix+name_base);
+    }
+  }
+
+  Teuchos::ParameterList& chkp_list = plist.sublist("checkpoint");
+  chkp_list.set<std::string>("file name base",
+          prefix+chkp_list.get<std::string>("file name base", "checkpoint"));
+
+  if (plist.isSublist("observations")) {
+    Teuchos::ParameterList& obs_list = plist.sublist("observations");
+    for (auto& entry : obs_list) {
+      if (!obs_list.isSublist(entry.first)) continue;
+      Teuchos::ParameterList& sublist = obs_list.sublist(entry.first);
+      if (sublist.isParameter("observation output filename")) {
+        sublist.set<std::string>("observation output filename",
+                prefix+sublist.get<std::string>("observation output filename"));
+      }
+    }
+  }
+}
+
+
+// The input list of a member: the top-level list with the member's
+// parameters laid over it.
+Teuchos::ParameterList
+memberList(const Teuchos::ParameterList& plist, const std::string& member_name)
+{
+  const Teuchos::ParameterList& overrides =
+    plist.sublist("ensemble").sublist("members").sublist(member_name);
+  if (overrides.isParameter("mesh") || overrides.isParameter("regions")) {
+    Errors::Message msg;
+    msg << "Ensemble member \"" << member_name << "\" may not change the \"mesh\" or \"regions\" lists, as these are shared by all members.";
+    Exceptions::amanzi_throw(msg);
+  }
+
+  Teuchos::ParameterList member_list(plist);
+  member_list.remove("ensemble");
+  member_list.setParameters(overrides);
+  prefixOutput(member_list, member_name+"_");
+  return member_list;
+}
+
+
+bool
+hasDeformableMesh(const Amanzi::State& S)
+{
+  for (Amanzi::State::mesh_iterator mesh=S.mesh_begin(); mesh!=S.mesh_end(); ++mesh) {
+    if (S.IsDeformableMesh(mesh->first)) return true;
+  }
+  return false;
+}
+
+
+// Registers, in S, the meshes and domain sets of S_shared.
+void
+shareMeshes(const Teuchos::ParameterList& plist, const Amanzi::State& S_shared, Amanzi::State& S)
+{
+  // meshes, then their aliases
+  std::vector<std::string> aliases;
+  for (Amanzi::State::mesh_iterator mesh=S_shared.mesh_begin();
+       mesh!=S_shared.mesh_end(); ++mesh) {
+    if (S_shared.IsAliasedMesh(mesh->first)) {
+      aliases.push_back(mesh->first);
+    } else {
+      S.RegisterMesh(mesh->first, mesh->second.first, false);
+    }
+  }
+  for (const auto& alias : aliases) {
+    auto mesh = S_shared.GetMesh(alias);
+    for (Amanzi::State::mesh_iterator target=S_shared.mesh_begin();
+         target!=S_shared.mesh_end(); ++target) {
+      if (!S_shared.IsAliasedMesh(target->first) && target->second.first == mesh) {
+        S.AliasMesh(target->first, alias);
+        break;
+      }
+    }
+  }
+
+  // domain sets
+  const Teuchos::ParameterList& meshes_list = plist.sublist("mesh");
+  for (const auto& entry : meshes_list) {
+    if (!meshes_list.isSublist(entry.first)) continue;
+    const Teuchos::ParameterList& mesh_list = meshes_list.sublist(entry.first);
+    if (!mesh_list.isParameter("mesh type")) continue;
+    std::string mesh_type = mesh_list.get<std::string>("mesh type");
+    if (mesh_type == "domain set indexed" || mesh_type == "domain set regions") {
+      S.RegisterDomainSet(entry.first, S_shared.GetDomainSet(entry.first));
+    }
+  }
+}
+
+} // namespace
+
+
+int
+EnsembleDriver::Run(const Teuchos::RCP<const Amanzi::Comm_type>& comm,
+                    Teuchos::ParameterList& plist)
+{
+  Amanzi::VerboseObject vo("Ensemble Driver", plist);
+  Teuchos::OSTab tab = vo.getOSTab();
+
+  // print header material
+  if (vo.os_OK(Teuchos::VERB_LOW)) {
+    // print parameter list
+    *vo.os() << "======================> dumping parameter list <======================" <<
+      std::endl;
+    Teuchos::writeParameterListToXmlOStream(plist, *vo.os());
+    *vo.os() << "======================> done dumping parameter list. <================" <<
+      std::endl;
+  }
+
+  Teuchos::ParameterList& ensemble_list = plist.sublist("ensemble");
+  Teuchos::ParameterList& members_list = ensemble_list.sublist("members");
+  std::vector<std::string> members;
+  for (const auto& entry : members_list) {
+    if (members_list.isSublist(entry.first)) members.push_back(entry.first);
+  }
+  if (members.empty()) {
+    Errors::Message msg("\"ensemble\" list must include at least one sublist of \"members\".");
+    Exceptions::amanzi_throw(msg);
+  }
+
+  int num_groups = ensemble_list.get<int>("number of groups", 1);
+  if (num_groups < 1 || num_groups > comm->NumProc()) {
+    Errors::Message msg;
+    msg << "\"ensemble\" \"number of groups\" must be between 1 and the number of processes, " << comm->NumProc() << ".";
+    Exceptions::amanzi_throw(msg);
+  }
+
+  // split the processes into contiguous groups
+  int group = comm->MyPID() * num_groups / comm->NumProc();
+  MPI_Comm group_mpi_comm = MPI_COMM_NULL;
+  Amanzi::Comm_ptr_type group_comm = comm;
+  if (num_groups > 1) {
+    auto mpi_comm = Teuchos::rcp_dynamic_cast<const Amanzi::MpiComm_type>(comm);
+    AMANZI_ASSERT(mpi_comm.get());
+    MPI_Comm_split(mpi_comm->Comm(), group, comm->MyPID(), &group_mpi_comm);
+    group_comm = Teuchos::rcp(new Amanzi::MpiComm_type(group_mpi_comm));
+  }
+
+  {
+    // create the geometric model, regions and meshes once for the group
+    Teuchos::ParameterList reg_params = plist.sublist("regions");
+    Teuchos::RCP<Amanzi::AmanziGeometry::GeometricModel> gm =
+      Teuchos::rcp(new Amanzi::AmanziGeometry::GeometricModel(3, reg_params, *group_comm) );
+
+    Teuchos::ParameterList state_plist = plist.sublist("state");
+    Teuchos::RCP<Amanzi::State> S_shared = Teuchos::rcp(new Amanzi::State(state_plist));
+    ATS::Mesh::createMeshes(plist, group_comm, gm, *S_shared);
+
+    // deforming meshes are modified by the member's PKs, and cannot be shared
+    bool share = !hasDeformableMesh(*S_shared);
+    if (!share && vo.os_OK(Teuchos::VERB_LOW)) {
+      *vo.os() << "Deformable meshes are not shared: each member builds its own." << std::endl;
+    }
+
+    for (int m=group; m < members.size(); m += num_groups) {
+      if (vo.os_OK(Teuchos::VERB_LOW)) {
+        *vo.os() << "======================> ensemble member \"" << members[m]
+                 << "\" (" << m+1 << " of " << members.size() << ") <================" << std::endl;
+      }
+
+      Teuchos::ParameterList member_plist = memberList(plist, members[m]);
+
+      Teuchos::ParameterList member_state_plist = member_plist.sublist("state");
+      Teuchos::RCP<Amanzi::State> S = Teuchos::rcp(new Amanzi::State(member_state_plist));
+      if (share) {
+        shareMeshes(plist, *S_shared, *S);
+      } else {
+        ATS::Mesh::createMeshes(member_plist, group_comm, gm, *S);
+      }
+
+      // create the top level Coordinator and run the member
+      ATS::Coordinator coordinator(member_plist, S, group_comm);
+      coordinator.cycle_driver();
+    }
+  }
+
+  if (group_mpi_comm != MPI_COMM_NULL) MPI_Comm_free(&group_mpi_comm);
+  return 0;
+}
+
+} // namespace
@@ -0,0 +1,58 @@
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+*/
+//! Runs an ensemble of simulations which share a mesh.
+
+
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+
+
+/*!
+
+Calibration and uncertainty quantification run many realizations of the same
+problem, differing only in parameters (e.g. water retention, permeability or
+forcing).  When the input list includes an `"ensemble`" sublist, ATS builds
+the geometric model, meshes and domain sets once and advances one State and
+PK tree per ensemble member on them.
+
+Each member's input list is the top-level list with that member's sublist of
+`"members`" laid over it, so a member need only list the parameters it
+changes.  Members may not change the `"mesh`" or `"regions`" lists, as these
+are shared.
+
+The processes are split into `"number of groups`" groups, each with its own
+communicator, and members are dealt to the groups in turn.  Each group builds
+the meshes once, on its communicator, and advances its members one after
+another.  With one group, all members run on all processes.  Meshes which
+deform are not shared; when any mesh is deformable, each member builds its
+own.
+
+Visualization, checkpoint and observation files of each member are prefixed
+by the member's name.
+
+.. _ensemble-spec:
+.. admonition:: ensemble-spec
+
+    * `"members`" ``[list]`` One sublist per member, named by the member and
+      including the parameters which differ from the top-level list.
+    * `"number of groups`" ``[int]`` **1** Number of communicators the
+      processes are split into.  Must not be larger than the number of
+      processes.
+
+ */
+
+#pragma once
+#include "Teuchos_ParameterList.hpp"
+#include "VerboseObject.hh"
+
+namespace ATS {
+
+struct EnsembleDriver {
+  int Run(const Teuchos::RCP<const Amanzi::Comm_type>& comm,
+          Teuchos::ParameterList&       input_parameter_list);
+
+};
+
+} // namespace
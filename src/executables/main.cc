@@ -20,6 +20,7 @@
 #include "dbc.hh"
 #include "errors.hh"
 #include "simulation_driver.hh"
+#include "ensemble_driver.hh"
 
 // registration files
 #include "state_evaluators_registration.hh"
@@ -176,10 +177,15 @@ int main(int argc, char *argv[])
     Amanzi::VerboseObject::global_default_level = opt_level;
 
   // -- create simulator object and run
-  ATS::SimulationDriver simulator;
   int ret = 0;
   try {
-    ret = simulator.Run(comm, *plist);
+    if (plist->isSublist("ensemble")) {
+      ATS::EnsembleDriver ensemble;
+      ret = ensemble.Run(comm, *plist);
+    } else {
+      ATS::SimulationDriver simulator;
+      ret = simulator.Run(comm, *plist);
+    }
   } catch (std::string& s) {
     if (rank == 0) {
       std::cerr << "ERROR:" << std::endl
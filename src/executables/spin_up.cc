@@ -0,0 +1,346 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+*/
+
+#include <algorithm>
+#include <cmath>
+
+#include "errors.hh"
+#include "CompositeVector.hh"
+#include "State.hh"
+#include "TimeStepManager.hh"
+#include "primary_variable_field_evaluator.hh"
+
+#include "spin_up.hh"
+
+namespace ATS {
+
+namespace {
+
+// Solves the small, dense system A x = b by Gaussian elimination with partial
+// pivoting.  A and b are overwritten.
+void
+solveDense(std::vector<std::vector<double> >& A, std::vector<double>& b)
+{
+  int n = b.size();
+  for (int k=0; k!=n; ++k) {
+    int p = k;
+    for (int i=k+1; i!=n; ++i)
+      if (std::abs(A[i][k]) > std::abs(A[p][k])) p = i;
+    std::swap(A[k], A[p]);
+    std::swap(b[k], b[p]);
+
+    if (A[k][k] == 0.) {
+      b[k] = 0.;
+      continue;
+    }
+    for (int i=k+1; i!=n; ++i) {
+      double l = A[i][k] / A[k][k];
+      for (int j=k; j!=n; ++j) A[i][j] -= l * A[k][j];
+      b[i] -= l * b[k];
+    }
+  }
+  for (int k=n-1; k>=0; --k) {
+    if (A[k][k] == 0.) continue;
+    for (int j=k+1; j!=n; ++j) b[k] -= A[k][j] * b[j];
+    b[k] /= A[k][k];
+  }
+}
+
+
+typedef std::vector<Teuchos::RCP<Amanzi::CompositeVector> > Fields;
+
+Fields
+copyFields(const Fields& other)
+{
+  Fields fields;
+  for (const auto& field : other) {
+    fields.push_back(Teuchos::rcp(new Amanzi::CompositeVector(*field)));
+  }
+  return fields;
+}
+
+} // namespace
+
+
+SpinUp::SpinUp(Teuchos::ParameterList& plist,
+               const Teuchos::RCP<Amanzi::VerboseObject>& vo) :
+    vo_(vo),
+    period_start_(0.),
+    period_count_(0),
+    converged_(false),
+    f_prev_norm_(0.),
+    use_schedule_(false)
+{
+  period_ = plist.get<double>("period [s]", 365.*86400.);
+  if (period_ <= 0.) {
+    Errors::Message msg("Coordinator spin-up: \"period [s]\" must be positive.");
+    Exceptions::amanzi_throw(msg);
+  }
+
+  acceleration_ = plist.get<std::string>("acceleration", "none");
+  if (acceleration_ != "none" && acceleration_ != "extrapolation" && acceleration_ != "Anderson") {
+    Errors::Message msg;
+    msg << "Coordinator spin-up: unknown \"acceleration\" \"" << acceleration_
+        << "\", valid are \"none\", \"extrapolation\", and \"Anderson\".";
+    Exceptions::amanzi_throw(msg);
+  }
+  depth_ = plist.get<int>("Anderson depth", 5);
+  max_extrapolation_ = plist.get<double>("maximum extrapolated periods", 50.);
+
+  tol_ = plist.get<double>("convergence tolerance", 1.e-6);
+  temp_key_ = plist.get<std::string>("temperature key", "temperature");
+  deep_region_ = plist.get<std::string>("deep temperature region", "");
+  drift_tol_ = plist.get<double>("deep temperature drift tolerance [K]", -1.);
+
+  reuse_dts_ = plist.get<bool>("reuse timestep history", false);
+  stop_when_converged_ = plist.get<bool>("stop when converged", true);
+}
+
+
+void
+SpinUp::Initialize(Amanzi::State& S, double t1,
+                   const Teuchos::Ptr<Amanzi::TimeStepManager>& tsm)
+{
+  // the primary variables
+  keys_.clear();
+  for (Amanzi::State::field_iterator field=S.field_begin(); field!=S.field_end(); ++field) {
+    if (field->second->type() != Amanzi::COMPOSITE_VECTOR_FIELD ||
+        !S.HasFieldEvaluator(field->first)) continue;
+    if (Teuchos::rcp_dynamic_cast<Amanzi::PrimaryVariableFieldEvaluator>(
+            S.GetFieldEvaluator(field->first)) != Teuchos::null) {
+      keys_.push_back(field->first);
+    }
+  }
+
+  if (drift_tol_ > 0. && std::find(keys_.begin(), keys_.end(), temp_key_) == keys_.end()) {
+    Errors::Message msg;
+    msg << "Coordinator spin-up: \"temperature key\" \"" << temp_key_ << "\" is not a primary variable.";
+    Exceptions::amanzi_throw(msg);
+  }
+
+  x_ = CopyFields_(S);
+  weights_.resize(keys_.size());
+  for (int i=0; i!=keys_.size(); ++i) {
+    double norm = 0.;
+    x_[i]->NormInf(&norm);
+    weights_[i] = norm > 0. ? 1. / norm : 1.;
+  }
+
+  period_start_ = S.time();
+  for (double t=period_start_ + period_; t < t1; t += period_) tsm->RegisterTimeEvent(t);
+}
+
+
+void
+SpinUp::RecordStep(double t_new)
+{
+  step_ends_.push_back(t_new - period_start_);
+}
+
+
+double
+SpinUp::ScheduledDt(double t) const
+{
+  if (!use_schedule_) return -1.;
+  double offset = t - period_start_;
+  auto next = std::upper_bound(prev_step_ends_.begin(), prev_step_ends_.end(),
+          offset + 1.e-8 * period_);
+  if (next == prev_step_ends_.end()) return -1.;
+  return *next - offset;
+}
+
+
+bool
+SpinUp::IsPeriodEnd(double t) const
+{
+  return t >= period_start_ + period_ * (1. - 1.e-8);
+}
+
+
+bool
+SpinUp::EndPeriod(Amanzi::State& S)
+{
+  period_count_++;
+
+  // the end-of-period state and its change over the period
+  Fields g = CopyFields_(S);
+  Fields f = CopyFields_(S);
+  double change = 0.;
+  for (int i=0; i!=keys_.size(); ++i) {
+    f[i]->Update(-1., *x_[i], 1.);
+    double norm = 0.;
+    f[i]->NormInf(&norm);
+    change = std::max(change, norm * weights_[i]);
+  }
+  double drift = drift_tol_ > 0. ? DeepDrift_(S, f) : 0.;
+  converged_ = change <= tol_ && (drift_tol_ <= 0. || drift <= drift_tol_);
+
+  if (!converged_) Accelerate_(g, f, x_);
+  else x_ = g;
+
+  if (vo_->os_OK(Teuchos::VERB_LOW)) {
+    Teuchos::OSTab tab = vo_->getOSTab();
+    *vo_->os() << "Spin-up period " << period_count_ << ": relative change = " << change;
+    if (drift_tol_ > 0.) *vo_->os() << ", deep temperature drift [K] = " << drift;
+    *vo_->os() << (converged_ ? ", converged" : "") << std::endl;
+  }
+
+  // the next period starts from x
+  if (!converged_ && acceleration_ != "none") {
+    for (int i=0; i!=keys_.size(); ++i) {
+      *S.GetFieldData(keys_[i], S.GetField(keys_[i])->owner()) = *x_[i];
+    }
+    SetChanged(S);
+  }
+
+  period_start_ = S.time();
+  prev_step_ends_.swap(step_ends_);
+  step_ends_.clear();
+  use_schedule_ = reuse_dts_;
+  return converged_;
+}
+
+
+void
+SpinUp::SetChanged(Amanzi::State& S) const
+{
+  for (const auto& key : keys_) {
+    auto eval = Teuchos::rcp_dynamic_cast<Amanzi::PrimaryVariableFieldEvaluator>(
+        S.GetFieldEvaluator(key));
+    eval->SetFieldAsChanged(Teuchos::ptr(&S));
+  }
+}
+
+
+SpinUp::Fields
+SpinUp::CopyFields_(const Amanzi::State& S) const
+{
+  Fields fields;
+  for (const auto& key : keys_) {
+    fields.push_back(Teuchos::rcp(new Amanzi::CompositeVector(*S.GetFieldData(key))));
+  }
+  return fields;
+}
+
+
+// weighted inner product, so that all primary variables count alike
+double
+SpinUp::Dot_(const Fields& x, const Fields& y) const
+{
+  double dot = 0.;
+  for (int i=0; i!=keys_.size(); ++i) {
+    double dot_i = 0.;
+    x[i]->Dot(*y[i], &dot_i);
+    dot += weights_[i] * weights_[i] * dot_i;
+  }
+  return dot;
+}
+
+
+// Computes the start of the next period, x, from the end-of-period state, g,
+// and its change over the period, f.
+void
+SpinUp::Accelerate_(const Fields& g, const Fields& f, Fields& x)
+{
+  // by default, the next period starts from the end of this one
+  x = copyFields(g);
+  double f_norm = std::sqrt(Dot_(f, f));
+
+  if (acceleration_ == "extrapolation") {
+    // If the change over a period shrinks by a factor r each period, the
+    // remaining changes sum to r/(1-r) times this one.  Following a jump, a
+    // plain period re-estimates r.
+    if (f_prev_norm_ > 0. && f_norm < f_prev_norm_) {
+      double r = f_norm / f_prev_norm_;
+      double n = std::min(r / (1. - r), max_extrapolation_);
+      for (int i=0; i!=keys_.size(); ++i) x[i]->Update(n, *f[i], 1.);
+      f_prev_norm_ = 0.;
+
+      if (vo_->os_OK(Teuchos::VERB_MEDIUM)) {
+        Teuchos::OSTab tab = vo_->getOSTab();
+        *vo_->os() << "  extrapolated over " << n << " periods (rate " << r << ")" << std::endl;
+      }
+    } else {
+      f_prev_norm_ = f_norm;
+    }
+
+  } else if (acceleration_ == "Anderson") {
+    if (f_prev_.size() > 0) {
+      if (f_norm > f_prev_norm_) {
+        // diverging, so restart from this period
+        dF_.clear();
+        dG_.clear();
+      } else {
+        Fields df = copyFields(f);
+        Fields dg = copyFields(g);
+        for (int i=0; i!=keys_.size(); ++i) {
+          df[i]->Update(-1., *f_prev_[i], 1.);
+          dg[i]->Update(-1., *g_prev_[i], 1.);
+        }
+        dF_.push_back(df);
+        dG_.push_back(dg);
+        if (dF_.size() > static_cast<std::size_t>(depth_)) {
+          dF_.pop_front();
+          dG_.pop_front();
+        }
+      }
+    }
+    f_prev_ = copyFields(f);
+    g_prev_ = copyFields(g);
+    f_prev_norm_ = f_norm;
+
+    // minimize |f - dF gamma| and take x = g - dG gamma
+    int m = dF_.size();
+    if (m > 0) {
+      std::vector<std::vector<double> > A(m, std::vector<double>(m, 0.));
+      std::vector<double> gamma(m, 0.);
+      double trace = 0.;
+      for (int j=0; j!=m; ++j) {
+        for (int k=0; k<=j; ++k) A[j][k] = A[k][j] = Dot_(dF_[j], dF_[k]);
+        gamma[j] = Dot_(dF_[j], f);
+        trace += A[j][j];
+      }
+      for (int j=0; j!=m; ++j) A[j][j] += 1.e-12 * trace;
+      solveDense(A, gamma);
+
+      for (int j=0; j!=m; ++j) {
+        for (int i=0; i!=keys_.size(); ++i) x[i]->Update(-gamma[j], *dG_[j][i], 1.);
+      }
+
+      if (vo_->os_OK(Teuchos::VERB_MEDIUM)) {
+        Teuchos::OSTab tab = vo_->getOSTab();
+        *vo_->os() << "  Anderson acceleration over " << m+1 << " periods" << std::endl;
+      }
+    }
+  }
+}
+
+
+// the largest change of the temperature in the deep region
+double
+SpinUp::DeepDrift_(const Amanzi::State& S, const Fields& f) const
+{
+  int i = std::find(keys_.begin(), keys_.end(), temp_key_) - keys_.begin();
+  const Epetra_MultiVector& dT = *f[i]->ViewComponent("cell", false);
+  auto mesh = f[i]->Mesh();
+
+  double drift_l = 0.;
+  if (deep_region_.empty()) {
+    for (int c=0; c!=dT.MyLength(); ++c) drift_l = std::max(drift_l, std::abs(dT[0][c]));
+  } else {
+    Amanzi::AmanziMesh::Entity_ID_List cells;
+    mesh->get_set_entities(deep_region_, Amanzi::AmanziMesh::CELL,
+                           Amanzi::AmanziMesh::Parallel_type::OWNED, &cells);
+    for (int c : cells) drift_l = std::max(drift_l, std::abs(dT[0][c]));
+  }
+
+  double drift = 0.;
+  mesh->get_comm()->MaxAll(&drift_l, &drift, 1);
+  return drift;
+}
+
+} // close namespace ATS
@@ -0,0 +1,171 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+//! Accelerated spin-up to the periodic steady state of periodic forcing.
+
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+*/
+
+/*!
+
+Spin-up, e.g. of permafrost, repeats a period (typically a year) of forcing
+until the state at the end of a period matches that at its start.  Each
+period is a map, G, from the start-of-period state of the primary variables
+to the end-of-period state, and spin-up is the fixed point iteration
+:math:`x_{k+1} = G(x_k)`, which may take hundreds of periods to converge.
+
+When the `"cycle driver`" list includes a `"spin-up`" sublist, the
+Coordinator ensures that steps end exactly at the end of each period and
+there checks for convergence.  Unless converged, the end-of-period state may
+be accelerated:
+
+- `"extrapolation`" estimates the rate of convergence from the last two
+  periods, and jumps ahead by the sum of the remaining (geometrically
+  shrinking) changes.
+- `"Anderson`" applies Anderson acceleration to G, combining the last few
+  periods to form the next start-of-period state.
+
+Changes are measured, per primary variable, relative to its maximum
+magnitude.  Spin-up is converged when the change over a period of every
+primary variable is below `"convergence tolerance`" and the drift over a
+period of the temperature in `"deep temperature region`" is below
+`"deep temperature drift tolerance [K]`".
+
+Each period may also take, as its initial step schedule, the steps of the
+previous period.  Following a failed step, the PK's step size is used for
+the rest of the period.
+
+After a jump, the time integrators of all BDF PKs are reset, as their
+history predates the jump, and output due at the end of a period is written
+after the jump, so that a checkpoint there holds the start of the next
+period.
+
+The state of spin-up itself, i.e. the start of the period and the history
+used by acceleration, is not checkpointed.  A restart begins a new spin-up,
+whose first period starts at the restart time, so restarts should be made
+from a checkpoint written at the end of a period.
+
+.. _spin-up-spec:
+.. admonition:: spin-up-spec
+
+    * `"period [s]`" ``[double]`` **31536000** Length of the forcing period.
+    * `"acceleration`" ``[string]`` **none** One of `"none`",
+      `"extrapolation`", or `"Anderson`".
+    * `"Anderson depth`" ``[int]`` **5** Number of previous periods combined
+      by Anderson acceleration.
+    * `"maximum extrapolated periods`" ``[double]`` **50** The largest
+      number of periods a single extrapolation may skip.
+    * `"convergence tolerance`" ``[double]`` **1.e-6** Relative change over a
+      period of each primary variable below which spin-up is converged.
+    * `"temperature key`" ``[string]`` **temperature**
+    * `"deep temperature region`" ``[string]`` **optional** Region of the
+      temperature's mesh in which the drift is measured.  Defaults to all
+      cells.
+    * `"deep temperature drift tolerance [K]`" ``[double]`` **optional** If
+      provided, spin-up is also required to have a temperature drift over a
+      period below this value.
+    * `"reuse timestep history`" ``[bool]`` **false** If true, each period
+      starts from the step schedule of the previous period.
+    * `"stop when converged`" ``[bool]`` **true** If true, the simulation
+      ends at the end of the first converged period.
+
+*/
+
+#ifndef ATS_SPIN_UP_HH_
+#define ATS_SPIN_UP_HH_
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "Teuchos_RCP.hpp"
+#include "Teuchos_ParameterList.hpp"
+
+#include "VerboseObject.hh"
+
+namespace Amanzi {
+class CompositeVector;
+class State;
+class TimeStepManager;
+};
+
+
+namespace ATS {
+
+class SpinUp {
+
+public:
+  SpinUp(Teuchos::ParameterList& plist,
+         const Teuchos::RCP<Amanzi::VerboseObject>& vo);
+
+  // Records the initial state, with time t0, and registers the ends of
+  // periods before t1.
+  void Initialize(Amanzi::State& S, double t1,
+                  const Teuchos::Ptr<Amanzi::TimeStepManager>& tsm);
+
+  // Records a successful step, or a failed one.
+  void RecordStep(double t_new);
+  void RecordFailedStep() { use_schedule_ = false; }
+
+  // The step, from t, of the previous period's schedule, or -1.
+  double ScheduledDt(double t) const;
+
+  bool IsPeriodEnd(double t) const;
+
+  // Checks the convergence of the period ending with S and, unless
+  // converged, overwrites the primary variables of S with the accelerated
+  // start of the next period.  Returns true if converged.
+  bool EndPeriod(Amanzi::State& S);
+
+  // Marks the primary variables of S as changed, following EndPeriod().
+  void SetChanged(Amanzi::State& S) const;
+
+  bool converged() const { return converged_; }
+  bool stop_when_converged() const { return stop_when_converged_; }
+
+private:
+  typedef std::vector<Teuchos::RCP<Amanzi::CompositeVector> > Fields;
+
+  Fields CopyFields_(const Amanzi::State& S) const;
+  double Dot_(const Fields& x, const Fields& y) const;
+  void Accelerate_(const Fields& g, const Fields& f, Fields& x);
+  double DeepDrift_(const Amanzi::State& S, const Fields& f) const;
+
+private:
+  Teuchos::RCP<Amanzi::VerboseObject> vo_;
+
+  double period_;
+  std::string acceleration_;
+  int depth_;
+  double max_extrapolation_;
+  double tol_;
+  std::string temp_key_;
+  std::string deep_region_;
+  double drift_tol_;
+  bool reuse_dts_;
+  bool stop_when_converged_;
+
+  // primary variables and their weights, the inverse of their magnitude
+  std::vector<std::string> keys_;
+  std::vector<double> weights_;
+
+  // start of the current period
+  double period_start_;
+  int period_count_;
+  Fields x_;
+  bool converged_;
+
+  // previous period's residual and end state, and Anderson's differences
+  Fields f_prev_, g_prev_;
+  double f_prev_norm_;
+  std::deque<Fields> dF_, dG_;
+
+  // step ends, relative to the period start, of this and the previous period
+  std::vector<double> step_ends_, prev_step_ends_;
+  bool use_schedule_;
+};
+
+} // close namespace ATS
+
+#endif
@@ -11,12 +11,14 @@
 #include <UnitTest++.h>
 
 #include <iostream>
+#include <map>
 
 #include "Teuchos_ParameterXMLFileReader.hpp"
 #include "Teuchos_XMLParameterListHelpers.hpp"
 
 #include "AmanziComm.hh"
 #include "ats_mesh_factory.hh"
+#include "ats_setup_cache.hh"
 
 using namespace Amanzi;
 
@@ -114,6 +116,44 @@ TEST_FIXTURE(Runner, EXTRACT_SUBDOMAINS) {
 }
 
 
+TEST_FIXTURE(Runner, SETUP_CACHE_MATCHES_FRESH) {
+  // a fresh run, which writes the cache
+  setup("test/executable_mesh_extract_subdomains.xml");
+  auto& cache_list = plist->sublist("mesh").sublist("setup cache");
+  cache_list.set<std::string>("directory", "test");
+  cache_list.set<std::string>("mesh tag", "setup_cache_matches_fresh");
+  cache_list.set<bool>("read", false);
+  go();
+  auto fresh_maps = S->GetDomainSet("watershed")->get_subdomain_maps();
+  std::map<std::string, int> fresh_ncells;
+  for (const auto& subdomain : *S->GetDomainSet("watershed")) {
+    fresh_ncells[subdomain] = S->GetMesh(subdomain)->num_entities(AmanziMesh::Entity_kind::CELL, AmanziMesh::Parallel_type::OWNED);
+  }
+
+  // a cached run, which must find and load it
+  cache_list.set<bool>("read", true);
+  {
+    ATS::SetupCache cache(*plist, comm);
+    CHECK(cache.loaded());
+  }
+  gm = Teuchos::rcp(new AmanziGeometry::GeometricModel(3, plist->sublist("regions"), *comm));
+  S = Teuchos::rcp(new State(plist->sublist("state")));
+  go();
+  auto cached_maps = S->GetDomainSet("watershed")->get_subdomain_maps();
+
+  CHECK_EQUAL(fresh_maps.size(), cached_maps.size());
+  for (const auto& fresh : fresh_maps) {
+    CHECK(cached_maps.count(fresh.first));
+    if (!cached_maps.count(fresh.first)) continue;
+    const auto& cached = cached_maps.at(fresh.first);
+    CHECK_EQUAL(fresh.second->size(), cached->size());
+    CHECK(*fresh.second == *cached);
+  }
+  for (const auto& subdomain : *S->GetDomainSet("watershed")) {
+    CHECK_EQUAL(fresh_ncells[subdomain], S->GetMesh(subdomain)->num_entities(AmanziMesh::Entity_kind::CELL, AmanziMesh::Parallel_type::OWNED));
+  }
+}
+
 TEST_FIXTURE(Runner, EXTRACT_SUBDOMAINS_SURFACE) {
   setup("test/executable_mesh_extract_subdomains_surface.xml");
   go();
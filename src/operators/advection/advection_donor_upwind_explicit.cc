@@ -0,0 +1,227 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+/* -------------------------------------------------------------------------
+   ATS
+
+   License: see $ATS_DIR/COPYRIGHT
+
+   Explicit, first-order donor upwind advection.
+   ------------------------------------------------------------------------- */
+
+#include <cmath>
+
+#include "dbc.hh"
+
+#include "advection_donor_upwind_explicit.hh"
+
+namespace Amanzi {
+namespace Operators {
+
+AdvectionDonorUpwindExplicit::AdvectionDonorUpwindExplicit(
+    const Teuchos::RCP<const AmanziMesh::Mesh>& mesh,
+    const ParallelFor& parallel_for) :
+    mesh_(mesh),
+    parallel_for_(parallel_for)
+{
+  ncells_owned_ = mesh_->num_entities(AmanziMesh::CELL, AmanziMesh::Parallel_type::OWNED);
+  ncells_wghost_ = mesh_->num_entities(AmanziMesh::CELL, AmanziMesh::Parallel_type::ALL);
+  nfaces_wghost_ = mesh_->num_entities(AmanziMesh::FACE, AmanziMesh::Parallel_type::ALL);
+
+  upwind_cell_ = Teuchos::rcp(new Epetra_IntVector(mesh_->face_map(true)));
+  downwind_cell_ = Teuchos::rcp(new Epetra_IntVector(mesh_->face_map(true)));
+
+  // Cache the topology, as the mesh may not be called from threads.  Cells
+  // are visited in order, so that a face's cells are stored in increasing
+  // order.
+  face_cells_.assign(2 * nfaces_wghost_, -1);
+  face_dirs_.assign(2 * nfaces_wghost_, 0);
+  cell_face_offsets_.resize(ncells_owned_ + 1, 0);
+
+  AmanziMesh::Entity_ID_List faces;
+  std::vector<int> dirs;
+  for (int c=0; c!=ncells_wghost_; ++c) {
+    mesh_->cell_get_faces_and_dirs(c, &faces, &dirs);
+    for (int i=0; i!=faces.size(); ++i) {
+      int f = faces[i];
+      int k = face_cells_[2*f] < 0 ? 0 : 1;
+      AMANZI_ASSERT(face_cells_[2*f+k] < 0);
+      face_cells_[2*f+k] = c;
+      face_dirs_[2*f+k] = dirs[i];
+    }
+
+    if (c < ncells_owned_) {
+      cell_faces_.insert(cell_faces_.end(), faces.begin(), faces.end());
+      cell_face_offsets_[c+1] = cell_faces_.size();
+    }
+  }
+
+  cell_upwind_faces_.resize(cell_faces_.size());
+  cell_upwind_others_.resize(cell_faces_.size());
+  cell_noutflow_.resize(ncells_owned_);
+}
+
+
+void
+AdvectionDonorUpwindExplicit::Run_(int n, const WorkFunction& work) const
+{
+  if (parallel_for_) {
+    parallel_for_(n, work);
+  } else {
+    work(0, n, 0);
+  }
+}
+
+
+void
+AdvectionDonorUpwindExplicit::IdentifyUpwindCells(const Epetra_MultiVector& flux)
+{
+  AMANZI_ASSERT(flux.MyLength() == nfaces_wghost_);
+  Epetra_IntVector& upwind = *upwind_cell_;
+  Epetra_IntVector& downwind = *downwind_cell_;
+
+  Run_(nfaces_wghost_, [&](int begin, int end, int thread_id) {
+      for (int f=begin; f!=end; ++f) {
+        upwind[f] = -1;
+        downwind[f] = -1;
+        for (int k=0; k!=2; ++k) {
+          int c = face_cells_[2*f+k];
+          if (c < 0) break;
+          double tmp = flux[0][f] * face_dirs_[2*f+k];
+          if (tmp > 0.0) {
+            upwind[f] = c;
+          } else if (tmp < 0.0) {
+            downwind[f] = c;
+          } else if (face_dirs_[2*f+k] > 0) {
+            upwind[f] = c;
+          } else {
+            downwind[f] = c;
+          }
+        }
+      }
+    });
+
+  Run_(ncells_owned_, [&](int begin, int end, int thread_id) {
+      for (int c=begin; c!=end; ++c) {
+        int first = cell_face_offsets_[c];
+        int last = cell_face_offsets_[c+1];
+
+        // outflow faces from the front, inflow faces from the back
+        int out = first, in = last;
+        for (int i=first; i!=last; ++i) {
+          int f = cell_faces_[i];
+          if (upwind[f] == c) {
+            cell_upwind_faces_[out] = f;
+            cell_upwind_others_[out] = downwind[f];
+            out++;
+          } else {
+            in--;
+            cell_upwind_faces_[in] = f;
+            cell_upwind_others_[in] = upwind[f];
+          }
+        }
+        cell_noutflow_[c] = out - first;
+      }
+    });
+
+  boundary_outflow_faces_.clear();
+  for (int f=0; f!=nfaces_wghost_; ++f) {
+    if (downwind[f] < 0 && upwind[f] >= 0 && upwind[f] < ncells_owned_)
+      boundary_outflow_faces_.push_back(f);
+  }
+}
+
+
+void
+AdvectionDonorUpwindExplicit::Advect(double dt, const Epetra_MultiVector& flux,
+        const Epetra_MultiVector& tcc, int num_advect,
+        Epetra_MultiVector& conserve,
+        std::vector<double>* bc_mass, int water_row)
+{
+  AMANZI_ASSERT(tcc.MyLength() == ncells_wghost_);
+  AMANZI_ASSERT(num_advect <= tcc.NumVectors() && num_advect <= conserve.NumVectors());
+  AMANZI_ASSERT(water_row < conserve.NumVectors());
+  if (num_advect <= 0 && water_row < 0) return;
+
+  int n = num_advect;
+  tcc_packed_.resize(ncells_wghost_ * n);
+  delta_packed_.resize(ncells_owned_ * n);
+  delta_water_.resize(ncells_owned_);
+
+  // pack the ghosted components cell-major
+  Run_(ncells_wghost_, [&](int begin, int end, int thread_id) {
+      for (int i=0; i!=n; ++i) {
+        const double* tcc_i = tcc[i];
+        for (int c=begin; c!=end; ++c) tcc_packed_[c*n + i] = tcc_i[c];
+      }
+    });
+
+  // accumulate the change in each owned cell
+  Run_(ncells_owned_, [&](int begin, int end, int thread_id) {
+      for (int c=begin; c!=end; ++c) {
+        double* delta = &delta_packed_[c*n];
+        for (int i=0; i!=n; ++i) delta[i] = 0.;
+        double delta_water = 0.;
+
+        int first = cell_face_offsets_[c];
+        int last = cell_face_offsets_[c+1];
+        int last_out = first + cell_noutflow_[c];
+
+        // outflow, of this cell's quantity
+        const double* tcc_c = &tcc_packed_[c*n];
+        double u_out = 0.;
+        for (int j=first; j!=last_out; ++j) {
+          u_out += std::abs(flux[0][cell_upwind_faces_[j]]);
+        }
+        for (int i=0; i!=n; ++i) delta[i] -= dt * u_out * tcc_c[i];
+        delta_water -= dt * u_out;
+
+        // inflow, of the donor's quantity -- inflow from boundaries is
+        // left to boundary conditions
+        for (int j=last_out; j!=last; ++j) {
+          double u = std::abs(flux[0][cell_upwind_faces_[j]]);
+          int donor = cell_upwind_others_[j];
+          if (donor >= 0) {
+            const double* tcc_d = &tcc_packed_[donor*n];
+            for (int i=0; i!=n; ++i) delta[i] += dt * u * tcc_d[i];
+          }
+          delta_water += dt * u;
+        }
+        delta_water_[c] = delta_water;
+      }
+    });
+
+  // unpack
+  Run_(ncells_owned_, [&](int begin, int end, int thread_id) {
+      for (int i=0; i!=n; ++i) {
+        double* conserve_i = conserve[i];
+        for (int c=begin; c!=end; ++c) conserve_i[c] += delta_packed_[c*n + i];
+      }
+      if (water_row >= 0) {
+        double* water = conserve[water_row];
+        for (int c=begin; c!=end; ++c) water[c] += delta_water_[c];
+      }
+    });
+
+  // mass leaving the domain
+  if (bc_mass != nullptr) {
+    AMANZI_ASSERT(bc_mass->size() >= n);
+    for (int f : boundary_outflow_faces_) {
+      int c = (*upwind_cell_)[f];
+      double u = std::abs(flux[0][f]);
+      for (int i=0; i!=n; ++i) (*bc_mass)[i] -= dt * u * tcc_packed_[c*n + i];
+    }
+  }
+}
+
+
+void
+AdvectionDonorUpwindExplicit::InterpolateCellVector(const Epetra_MultiVector& v0,
+        const Epetra_MultiVector& v1, double dt_int, double dt,
+        Epetra_MultiVector& v_int)
+{
+  double a = dt_int / dt;
+  double b = 1.0 - a;
+  v_int.Update(b, v0, a, v1, 0.);
+}
+
+} // namespace Operators
+} // namespace Amanzi
@@ -0,0 +1,107 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+/* -------------------------------------------------------------------------
+   ATS
+
+   License: see $ATS_DIR/COPYRIGHT
+
+   Explicit, first-order donor upwind advection of a multi-component cell
+   quantity by a face flux, shared by the transport PKs.
+
+   Upwinding is done once per flux: each face's upwind and downwind cells
+   are found, and each owned cell gets a list of its outflow faces followed
+   by its inflow faces and their donor cells.  The update then loops over
+   owned cells rather than faces, so that every write is to the cell being
+   visited and the loop can be split across threads without races.
+
+   Components are packed cell-major into preallocated buffers before the
+   update, so that the inner loop over components is contiguous, and no
+   memory is allocated per call once the sizes are known.
+   ------------------------------------------------------------------------- */
+
+#ifndef OPERATOR_ADVECTION_ADVECTION_DONOR_UPWIND_EXPLICIT_HH_
+#define OPERATOR_ADVECTION_ADVECTION_DONOR_UPWIND_EXPLICIT_HH_
+
+#include <functional>
+#include <vector>
+
+#include "Teuchos_RCP.hpp"
+#include "Epetra_IntVector.h"
+#include "Epetra_MultiVector.h"
+
+#include "Mesh.hh"
+
+namespace Amanzi {
+namespace Operators {
+
+class AdvectionDonorUpwindExplicit {
+ public:
+  // work(begin, end, thread_id) operates on [begin, end)
+  typedef std::function<void(int, int, int)> WorkFunction;
+
+  // Executes work over [0, n), for instance on a thread pool.
+  typedef std::function<void(int, const WorkFunction&)> ParallelFor;
+
+  // If parallel_for is empty, loops are executed serially.
+  AdvectionDonorUpwindExplicit(const Teuchos::RCP<const AmanziMesh::Mesh>& mesh,
+                               const ParallelFor& parallel_for=ParallelFor());
+
+  // Identifies upwind and downwind cells of each face from the sign of the
+  // (ghosted) flux, and builds the per-cell face lists.  A face with zero
+  // flux is upwinded in the direction of its normal.  Must be called
+  // whenever the flux changes.
+  void IdentifyUpwindCells(const Epetra_MultiVector& flux);
+
+  // Adds the donor upwind update over dt of components [0, num_advect) of
+  // the ghosted cell quantity tcc to the owned entries of conserve.
+  //
+  // Mass leaving through faces on the domain boundary is subtracted from
+  // bc_mass, if provided.  If water_row is non-negative, a unit quantity is
+  // also advected into conserve[water_row], including across boundary
+  // faces.
+  void Advect(double dt, const Epetra_MultiVector& flux,
+              const Epetra_MultiVector& tcc, int num_advect,
+              Epetra_MultiVector& conserve,
+              std::vector<double>* bc_mass=nullptr,
+              int water_row=-1);
+
+  // Linear interpolation in time between two values v0 and v1.  The time is
+  // measured relative to v0, so that v1 is at time dt.  The interpolated
+  // data are at time dt_int.
+  static void InterpolateCellVector(const Epetra_MultiVector& v0,
+          const Epetra_MultiVector& v1, double dt_int, double dt,
+          Epetra_MultiVector& v_int);
+
+  // negative values indicate a boundary
+  const Teuchos::RCP<Epetra_IntVector>& upwind_cell() const { return upwind_cell_; }
+  const Teuchos::RCP<Epetra_IntVector>& downwind_cell() const { return downwind_cell_; }
+
+ private:
+  void Run_(int n, const WorkFunction& work) const;
+
+ private:
+  Teuchos::RCP<const AmanziMesh::Mesh> mesh_;
+  ParallelFor parallel_for_;
+  int ncells_owned_, ncells_wghost_, nfaces_wghost_;
+
+  Teuchos::RCP<Epetra_IntVector> upwind_cell_;
+  Teuchos::RCP<Epetra_IntVector> downwind_cell_;
+
+  // topology, which is fixed: the (up to two) cells of each ghosted face
+  // with the face's direction relative to each, and the faces of each
+  // owned cell
+  std::vector<int> face_cells_, face_dirs_;
+  std::vector<int> cell_face_offsets_, cell_faces_;
+
+  // upwinding, which changes with the flux: per owned cell, outflow faces
+  // then inflow faces, and the cell on the other side of each
+  std::vector<int> cell_upwind_faces_, cell_upwind_others_, cell_noutflow_;
+  std::vector<int> boundary_outflow_faces_;
+
+  // packed, cell-major component buffers
+  std::vector<double> tcc_packed_, delta_packed_, delta_water_;
+};
+
+} // namespace Operators
+} // namespace Amanzi
+
+#endif
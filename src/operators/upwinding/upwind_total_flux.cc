@@ -30,7 +30,8 @@ UpwindTotalFlux::UpwindTotalFlux(std::string pkname,
     cell_coef_(cell_coef),
     face_coef_(face_coef),
     flux_(flux),
-    flux_eps_(flux_eps) {};
+    flux_eps_(flux_eps),
+    active_faces_(nullptr) {};
 
 
 void UpwindTotalFlux::Update(const Teuchos::Ptr<State>& S,
@@ -63,6 +64,33 @@ void UpwindTotalFlux::CalculateCoefficientsOnFaces(
   Epetra_MultiVector& coef_faces = *face_coef->ViewComponent("face",false);
   const Epetra_MultiVector& coef_cells = *cell_coef.ViewComponent("cell",true);
 
+  // Restricted to active faces, using the cached topology.
+  if (active_faces_ != nullptr) {
+    if (face_cells_.empty()) InitializeTopology_(*mesh);
+    if (face_coef->HasComponent("cell")) {
+      *face_coef->ViewComponent("cell", true) = coef_cells;
+    }
+
+    for (int f : *active_faces_) {
+      int uw = -1, dw = -1;
+      for (int k=0; k!=2; ++k) {
+        int c = face_cells_[2*f+k];
+        if (c < 0) break;
+        if (flux_v[0][f] * face_dirs_[2*f+k] > 0) {
+          uw = c;
+        } else if (flux_v[0][f] * face_dirs_[2*f+k] < 0) {
+          dw = c;
+        } else if (uw == -1) {
+          uw = c;
+        } else {
+          dw = c;
+        }
+      }
+      coef_faces[0][f] = FaceCoefficient_(f, uw, dw, flux_v, coef_cells, coef_faces);
+    }
+    return;
+  }
+
   // Identify upwind/downwind cells for each local face.  Note upwind/downwind
   // may be a ghost cell.
   Epetra_IntVector upwind_cell(*face_coef->ComponentMap("face",true));
@@ -107,69 +135,86 @@ void UpwindTotalFlux::CalculateCoefficientsOnFaces(
   }
 
   // Determine the face coefficient of local faces.
+  int nfaces = face_coef->size("face",false);
+  for (int f=0; f!=nfaces; ++f) {
+    coef_faces[0][f] = FaceCoefficient_(f, upwind_cell[f], downwind_cell[f],
+            flux_v, coef_cells, coef_faces);
+  }
+};
+
+
+double
+UpwindTotalFlux::FaceCoefficient_(int f, int uw, int dw,
+        const Epetra_MultiVector& flux_v,
+        const Epetra_MultiVector& coef_cells,
+        const Epetra_MultiVector& coef_faces) const {
+  AMANZI_ASSERT(!((uw == -1) && (dw == -1)));
+
   // These parameters may be key to a smooth convergence rate near zero flux.
   //  double flow_eps_factor = 1.;
   //  double min_flow_eps = 1.e-8;
   double coefs[2];
 
-  int nfaces = face_coef->size("face",false);
-  for (int f=0; f!=nfaces; ++f) {
-    int uw = upwind_cell[f];
-    int dw = downwind_cell[f];
-    AMANZI_ASSERT(!((uw == -1) && (dw == -1)));
+  // uw coef
+  if (uw == -1) {
+    coefs[0] = coef_faces[0][f];
+  } else {
+    coefs[0] = coef_cells[0][uw];
+  }
 
-   
-    // Teuchos::RCP<VerboseObject> dcvo_dw = Teuchos::null;
-    // Teuchos::RCP<VerboseObject> dcvo_uw = Teuchos::null;
+  // dw coef
+  if (dw == -1) {
+    coefs[1] = coef_faces[0][f];
+  } else {
+    coefs[1] = coef_cells[0][dw];
+  }
 
-    // if (uw >= 0)
-    //   dcvo_uw = db->GetVerboseObject(uw, face_coef->Mesh()->get_comm()->MyPID());
-    // if (dw >= 0)
-    //   dcvo_dw = db->GetVerboseObject(dw, face_coef->Mesh()->get_comm()->MyPID());
+  // Determine the size of the overlap region, a smooth transition region
+  // near zero flux
+  // double flow_eps = std::max(( 1.0 - std::abs(coefs[0] - coefs[1]) )
+  //         * std::sqrt(coefs[0] * coefs[1]) * flow_eps_factor,
+  //         min_flow_eps);
+  double flow_eps = flux_eps_;
 
-    // uw coef
-    if (uw == -1) {
-      coefs[0] = coef_faces[0][f];
-    } else {
-      coefs[0] = coef_cells[0][uw];
-    }
+  // Determine the coefficient
+  if (std::abs(flux_v[0][f]) >= flow_eps) {
+    return coefs[0];
+  }
 
-    // dw coef
-    if (dw == -1) {
-      coefs[1] = coef_faces[0][f];
-    } else {
-      coefs[1] = coef_cells[0][dw];
-    }
+  // Parameterization of a linear scaling between upwind and downwind.
+  double param = std::abs(flux_v[0][f]) / (2*flow_eps) + 0.5;
+  if (!(param >= 0.5) || !(param <= 1.0)) {
+    std::cout << "BAD FLUX! on face " << f << std::endl;
+    std::cout << "  flux = " << flux_v[0][f] << std::endl;
+    std::cout << "  param = " << param << std::endl;
+    std::cout << "  flow_eps = " << flow_eps << std::endl;
+  }
 
-    // Determine the size of the overlap region, a smooth transition region
-    // near zero flux
-    // double flow_eps = std::max(( 1.0 - std::abs(coefs[0] - coefs[1]) )
-    //         * std::sqrt(coefs[0] * coefs[1]) * flow_eps_factor,
-    //         min_flow_eps);
-    double flow_eps = flux_eps_;
+  AMANZI_ASSERT(param >= 0.5);
+  AMANZI_ASSERT(param <= 1.0);
 
-    // Determine the coefficient
-    if (std::abs(flux_v[0][f]) >= flow_eps) {
-      coef_faces[0][f] = coefs[0];
-    } else {
-      // Parameterization of a linear scaling between upwind and downwind.
-      double param = std::abs(flux_v[0][f]) / (2*flow_eps) + 0.5;
-      if (!(param >= 0.5) || !(param <= 1.0)) {
-        std::cout << "BAD FLUX! on face " << f << std::endl;
-        std::cout << "  flux = " << flux_v[0][f] << std::endl;
-        std::cout << "  param = " << param << std::endl;
-        std::cout << "  flow_eps = " << flow_eps << std::endl;
-      }
+  return coefs[0] * param + coefs[1] * (1. - param);
+};
 
-      // if (dcvo_uw != Teuchos::null)
-      //   *dcvo_uw->os() << "  AVG param = " << param << std::endl;
-      // if (dcvo_dw != Teuchos::null)
-      //   *dcvo_dw->os() << "  AVG param = " << param << std::endl;
 
-      AMANZI_ASSERT(param >= 0.5);
-      AMANZI_ASSERT(param <= 1.0);
+void
+UpwindTotalFlux::InitializeTopology_(const AmanziMesh::Mesh& mesh) {
+  // Cells are visited in order, matching the tie-breaking of the full
+  // update for faces with zero flux.
+  int ncells = mesh.num_entities(AmanziMesh::CELL, AmanziMesh::Parallel_type::ALL);
+  int nfaces = mesh.num_entities(AmanziMesh::FACE, AmanziMesh::Parallel_type::ALL);
+  face_cells_.assign(2 * nfaces, -1);
+  face_dirs_.assign(2 * nfaces, 0);
 
-      coef_faces[0][f] = coefs[0] * param + coefs[1] * (1. - param);
+  AmanziMesh::Entity_ID_List faces;
+  std::vector<int> fdirs;
+  for (int c=0; c!=ncells; ++c) {
+    mesh.cell_get_faces_and_dirs(c, &faces, &fdirs);
+    for (unsigned int n=0; n!=faces.size(); ++n) {
+      int f = faces[n];
+      int k = face_cells_[2*f] < 0 ? 0 : 1;
+      face_cells_[2*f+k] = c;
+      face_dirs_[2*f+k] = fdirs[n];
     }
   }
 };
@@ -13,6 +13,11 @@
 #ifndef AMANZI_UPWINDING_TOTALFLUX_SCHEME_
 #define AMANZI_UPWINDING_TOTALFLUX_SCHEME_
 
+#include <vector>
+
+#include "Epetra_MultiVector.h"
+
+#include "Mesh.hh"
 #include "upwinding.hh"
 
 namespace Amanzi {
@@ -52,7 +57,22 @@ public:
 
   virtual std::string
   CoefficientLocation() { return "upwind: face"; }
-  
+
+  virtual bool
+  set_active_faces(const std::vector<int>* faces) {
+    active_faces_ = faces;
+    return true;
+  }
+
+private:
+
+  double FaceCoefficient_(int f, int uw, int dw,
+                          const Epetra_MultiVector& flux_v,
+                          const Epetra_MultiVector& coef_cells,
+                          const Epetra_MultiVector& coef_faces) const;
+
+  void InitializeTopology_(const AmanziMesh::Mesh& mesh);
+
 private:
 
   std::string pkname_;
@@ -60,6 +80,11 @@ private:
   std::string face_coef_;
   std::string flux_;
   double flux_eps_;
+
+  // restriction to active faces, with the cells of each ghosted face and the
+  // face's direction relative to each, cached on first use
+  const std::vector<int>* active_faces_;
+  std::vector<int> face_cells_, face_dirs_;
 };
 
 } // namespace
@@ -57,6 +57,13 @@ class Upwinding {
 
   virtual std::string
   CoefficientLocation() = 0;
+
+  // Restricts Update() to the given owned faces, leaving the coefficients on
+  // all other faces untouched; nullptr updates all faces.  The list is held
+  // by pointer and may change between updates.  Returns false if the scheme
+  // does not support this, in which case all faces are always updated.
+  virtual bool
+  set_active_faces(const std::vector<int>* faces) { return false; }
   
 
 };
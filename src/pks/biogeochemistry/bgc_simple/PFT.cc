@@ -149,6 +149,73 @@ void PFT::Init(Teuchos::ParameterList& plist,double col_area)
 }
 
 
+// Pack the state variables.  Note these must be kept in sync with
+// NUM_STATE_VARIABLES and CopyStateFrom().
+void PFT::CopyStateTo(Epetra_MultiVector& state, int offset, int col) const {
+  AMANZI_ASSERT(offset + NUM_STATE_VARIABLES <= state.NumVectors());
+  double* const* s = state.Pointers();
+  int i = offset;
+  s[i++][col] = Bleaf;
+  s[i++][col] = Bleafmemory;
+  s[i++][col] = Broot;
+  s[i++][col] = Bstem;
+  s[i++][col] = Bstore;
+  s[i++][col] = GDD;
+  s[i++][col] = mResp;
+  s[i++][col] = gResp;
+  s[i++][col] = annNPP;
+  s[i++][col] = GPP;
+  s[i++][col] = NPP;
+  s[i++][col] = ET;
+  s[i++][col] = leafstatus;
+  s[i++][col] = lai;
+  s[i++][col] = laimemory;
+  s[i++][col] = totalBiomass;
+  s[i++][col] = rootD;
+  s[i++][col] = bleafon;
+  s[i++][col] = bleafoff;
+  s[i++][col] = leafondaysi;
+  s[i++][col] = leafoffdaysi;
+  s[i++][col] = CSinkLimit;
+  s[i++][col] = maxLAI;
+  for (int j=0; j!=10; ++j) s[i++][col] = annCBalance[j];
+  AMANZI_ASSERT(i == offset + NUM_STATE_VARIABLES);
+}
+
+
+// Unpack the state variables.
+void PFT::CopyStateFrom(const Epetra_MultiVector& state, int offset, int col) {
+  AMANZI_ASSERT(offset + NUM_STATE_VARIABLES <= state.NumVectors());
+  double* const* s = state.Pointers();
+  int i = offset;
+  Bleaf = s[i++][col];
+  Bleafmemory = s[i++][col];
+  Broot = s[i++][col];
+  Bstem = s[i++][col];
+  Bstore = s[i++][col];
+  GDD = s[i++][col];
+  mResp = s[i++][col];
+  gResp = s[i++][col];
+  annNPP = s[i++][col];
+  GPP = s[i++][col];
+  NPP = s[i++][col];
+  ET = s[i++][col];
+  leafstatus = (int) s[i++][col];
+  lai = s[i++][col];
+  laimemory = s[i++][col];
+  totalBiomass = s[i++][col];
+  rootD = s[i++][col];
+  bleafon = s[i++][col];
+  bleafoff = (int) s[i++][col];
+  leafondaysi = s[i++][col];
+  leafoffdaysi = s[i++][col];
+  CSinkLimit = s[i++][col];
+  maxLAI = (int) s[i++][col];
+  for (int j=0; j!=10; ++j) annCBalance[j] = s[i++][col];
+  AMANZI_ASSERT(i == offset + NUM_STATE_VARIABLES);
+}
+
+
 // Initialize the root distribution
 void PFT::InitRoots(const Epetra_SerialDenseVector& SoilTArr,
                     const Epetra_SerialDenseVector& SoilDArr,
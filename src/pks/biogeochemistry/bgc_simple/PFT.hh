@@ -37,6 +37,7 @@ Paramters for a plant functional type.
 #include "Teuchos_ParameterList.hpp"
 #include "Teuchos_RCP.hpp"
 #include "Epetra_SerialDenseVector.h"
+#include "Epetra_MultiVector.h"
 
 #include "dbc.hh"
 
@@ -64,6 +65,14 @@ class PFT {
                  const Epetra_SerialDenseVector& SoilDArr,
                  const Epetra_SerialDenseVector& SoilThicknessArr);
 
+  // The evolving state of a PFT, as opposed to its parameters, is stored in
+  // State as NUM_STATE_VARIABLES vectors starting at component offset, one
+  // entry per column.  Root biomass by cell, BRootSoil, is stored
+  // separately.
+  void CopyStateTo(Epetra_MultiVector& state, int offset, int col) const;
+  void CopyStateFrom(const Epetra_MultiVector& state, int offset, int col);
+  static const int NUM_STATE_VARIABLES = 33;
+
   bool AssertRootBalance_or_die() {
     double totalRootW = BRootSoil.Norm1();
     AMANZI_ASSERT(std::abs(totalRootW - Broot) < 1.e-6);
@@ -11,6 +11,7 @@
      1. parallel decomp not in the vertical
      2. fields are not ordered along the column, and so must be copied
      3. all columns have the same number of cells
+     4. columns are independent, and may be advanced concurrently
    ------------------------------------------------------------------------- */
 
 #include "MeshPartition.hh"
@@ -29,7 +30,8 @@ BGCSimple::BGCSimple(Teuchos::ParameterList& pk_tree,
                      const Teuchos::RCP<TreeVector>& solution):
   PK_Physical_Default(pk_tree, global_list, S, solution),
   PK(pk_tree, global_list, S, solution),
-  ncells_per_col_(-1) {
+  ncells_per_col_(-1),
+  npft_(0) {
 
   // set up additional primary variables -- this is very hacky...
   // -- surface energy source
@@ -54,6 +56,10 @@ BGCSimple::BGCSimple(Teuchos::ParameterList& pk_tree,
   Teuchos::ParameterList& lai_sublist =
       FElist.sublist(total_lai_key_);
   lai_sublist.set("field evaluator type", "primary variable");
+
+  // -- PFT state, owned by this PK
+  pft_state_key_ = Keys::readKey(*plist_, domain_surf_, "pft state", "pft_state");
+  root_biomass_key_ = Keys::readKey(*plist_, domain_, "pft root biomass", "pft_root_biomass");
 }
 
 // is a PK
@@ -91,8 +97,8 @@ void BGCSimple::Setup(const Teuchos::Ptr<State>& S) {
     pft_names.push_back(pft_name);
   }
 
+  npft_ = pft_names.size();
   int ncols = mesh_surf_->num_entities(AmanziMesh::CELL, AmanziMesh::Parallel_type::OWNED);
-  pfts_old_.resize(ncols);
   pfts_.resize(ncols);
   for (unsigned int col=0; col!=ncols; ++col) {
     int f = mesh_surf_->entity_get_parent(AmanziMesh::CELL, col);
@@ -111,32 +117,42 @@ void BGCSimple::Setup(const Teuchos::Ptr<State>& S) {
       AMANZI_ASSERT(ncol_cells == ncells_per_col_);
     }
 
-    pfts_old_[col].resize(pft_names.size());
-    pfts_[col].resize(pft_names.size());
-
-    for (int i=0; i!=pft_names.size(); ++i) {
+    pfts_[col].resize(npft_);
+    for (int i=0; i!=npft_; ++i) {
       std::string pft_name = pft_names[i];
       Teuchos::ParameterList& pft_plist = pft_params.sublist(pft_name);
-      pfts_old_[col][i] = Teuchos::rcp(new PFT(pft_name, ncol_cells));
-      pfts_old_[col][i]->Init(pft_plist,col_area);
-      pfts_[col][i] = Teuchos::rcp(new PFT(*pfts_old_[col][i]));
+      pfts_[col][i] = Teuchos::rcp(new PFT(pft_name, ncol_cells));
+      pfts_[col][i]->Init(pft_plist,col_area);
     }
   }
 
-  // -- soil carbon pools
+  // -- soil carbon pools, as views into a single, column-contiguous array
+  som_.resize(ncols * ncells_per_col_ * nPools, 0.);
   soil_carbon_pools_.resize(ncols);
   for (unsigned int col=0; col!=ncols; ++col) {
     soil_carbon_pools_[col].resize(ncells_per_col_);
 
     auto& col_iter = mesh_->cells_of_column(col);
-    ncells_per_col_ = col_iter.size();
-        
     for (std::size_t i=0; i!=col_iter.size(); ++i) {
       // col_iter[i] = cell id, mp[cell_id] = index into partition list, sc_params_[index] = correct params
-      soil_carbon_pools_[col][i] = Teuchos::rcp(new SoilCarbon(sc_params_[mp[col_iter[i]]]));
+      double* som = &som_[(col * ncells_per_col_ + i) * nPools];
+      soil_carbon_pools_[col][i] = Teuchos::rcp(new SoilCarbon(sc_params_[mp[col_iter[i]]], som));
     }
   }
 
+  // -- column geometry
+  UpdateColumnGeometry_();
+
+  // -- threads and their workspaces
+  thread_pool_ = Teuchos::rcp(new ThreadPool(plist_->get<int>("number of threads", 1)));
+  workspaces_.resize(thread_pool_->num_threads());
+  for (auto& ws : workspaces_) {
+    ws.temp.Size(ncells_per_col_);
+    ws.pres.Size(ncells_per_col_);
+    ws.co2_decomp.Size(ncells_per_col_);
+    ws.trans.Size(ncells_per_col_);
+  }
+
   // requirements: primary variable
   S->RequireField(key_, name_)->SetMesh(mesh_)
       ->SetComponent("cell", AmanziMesh::CELL, nPools);
@@ -172,6 +188,13 @@ void BGCSimple::Setup(const Teuchos::Ptr<State>& S) {
     Exceptions::amanzi_throw(message);
   }
   
+  // requirements: PFT state
+  S->RequireField(pft_state_key_, name_)->SetMesh(mesh_surf_)
+      ->SetComponent("cell", AmanziMesh::CELL, npft_ * PFT::NUM_STATE_VARIABLES);
+  S->GetField(pft_state_key_, name_)->set_io_vis(false);
+  S->RequireField(root_biomass_key_, name_)->SetMesh(mesh_)
+      ->SetComponent("cell", AmanziMesh::CELL, npft_);
+
   // requirement: diagnostics
   S->RequireField("co2_decomposition", name_)->SetMesh(mesh_)
       ->SetComponent("cell", AmanziMesh::CELL, 1);
@@ -258,83 +281,81 @@ void BGCSimple::Initialize(const Teuchos::Ptr<State>& S) {
       Teuchos::rcp_dynamic_cast<Field_CompositeVector>(leaf_biomass_field);
   AMANZI_ASSERT(leaf_biomass_field_cv != Teuchos::null);
 
-  int npft = pfts_old_[0].size();
   std::vector<std::vector<std::string> > names;
   names.resize(1);
-  names[0].resize(npft);
-  for (int i=0; i!=npft; ++i) names[0][i] = pfts_old_[0][i]->pft_type;
+  names[0].resize(npft_);
+  for (int i=0; i!=npft_; ++i) names[0][i] = pfts_[0][i]->pft_type;
   leaf_biomass_field_cv->set_subfield_names(names);
 
-  if (!leaf_biomass_field->initialized()) {
-    // -- Calculate the IC.
-    if (plist_->isSublist("leaf biomass initial condition")) {
-      Teuchos::ParameterList ic_plist = plist_->sublist("leaf biomass initial condition");
-      leaf_biomass_field->Initialize(ic_plist);
-
-      // -- copy into PFTs
-      Epetra_MultiVector& bio = *S->GetFieldData("surface-leaf_biomass", name_)
-          ->ViewComponent("cell", false);
-      
-      int ncols = mesh_surf_->num_entities(AmanziMesh::CELL, AmanziMesh::Parallel_type::OWNED);
-      for (int col=0; col!=ncols; ++col) {
-        for (int i=0; i!=npft; ++i) {
-          pfts_old_[col][i]->Bleaf = bio[i][col];
+  // PFT state, unless read from a checkpoint
+  Teuchos::RCP<Field> pft_state_field = S->GetField(pft_state_key_, name_);
+  Teuchos::RCP<Field> root_biomass_field = S->GetField(root_biomass_key_, name_);
+  int ncols = mesh_surf_->num_entities(AmanziMesh::CELL, AmanziMesh::Parallel_type::OWNED);
+
+  if (!pft_state_field->initialized()) {
+    if (!leaf_biomass_field->initialized()) {
+      // -- Calculate the IC.
+      if (plist_->isSublist("leaf biomass initial condition")) {
+        Teuchos::ParameterList ic_plist = plist_->sublist("leaf biomass initial condition");
+        leaf_biomass_field->Initialize(ic_plist);
+
+        // -- copy into PFTs
+        Epetra_MultiVector& bio = *S->GetFieldData("surface-leaf_biomass", name_)
+            ->ViewComponent("cell", false);
+
+        for (int col=0; col!=ncols; ++col) {
+          for (int i=0; i!=npft_; ++i) {
+            pfts_[col][i]->Bleaf = bio[i][col];
+          }
         }
+        leaf_biomass_field->set_initialized();
       }
-      leaf_biomass_field->set_initialized();
-    }
-    
-    if (!leaf_biomass_field->initialized()) {
-      S->GetFieldData("surface-leaf_biomass", name_)->PutScalar(0.);
-      leaf_biomass_field->set_initialized();
-    }
-  }
-  
-  // init root carbon
-  Teuchos::RCP<Epetra_SerialDenseVector> col_temp =
-      Teuchos::rcp(new Epetra_SerialDenseVector(ncells_per_col_));
-  Teuchos::RCP<Epetra_SerialDenseVector> col_depth =
-      Teuchos::rcp(new Epetra_SerialDenseVector(ncells_per_col_));
-  Teuchos::RCP<Epetra_SerialDenseVector> col_dz =
-      Teuchos::rcp(new Epetra_SerialDenseVector(ncells_per_col_));
-
-  S->GetFieldEvaluator("temperature")->HasFieldChanged(S, name_);
-  const Epetra_Vector& temp = *(*S->GetFieldData("temperature")
-				->ViewComponent("cell",false))(0);
-
-  int ncols = mesh_surf_->num_entities(AmanziMesh::CELL, AmanziMesh::Parallel_type::OWNED);
-  for (int col=0; col!=ncols; ++col) {
-    FieldToColumn_(col, temp, col_temp.ptr());
-    ColDepthDz_(col, col_depth.ptr(), col_dz.ptr());
 
-    for (int i=0; i!=npft; ++i) {
-      pfts_old_[col][i]->InitRoots(*col_temp, *col_depth, *col_dz);
+      if (!leaf_biomass_field->initialized()) {
+        S->GetFieldData("surface-leaf_biomass", name_)->PutScalar(0.);
+        leaf_biomass_field->set_initialized();
+      }
     }
-  }
 
-  // ensure all initialization in both PFTs?  Not sure this is
-  // necessary -- likely done in initial call to commit-state --etc
-  for (int col=0; col!=ncols; ++col) {
-    for (int i=0; i!=npft; ++i) {
-      *pfts_[col][i] = *pfts_old_[col][i];
+    // init root carbon
+    Epetra_SerialDenseVector col_temp(ncells_per_col_);
+    S->GetFieldEvaluator("temperature")->HasFieldChanged(S, name_);
+    const Epetra_Vector& temp = *(*S->GetFieldData("temperature")
+            ->ViewComponent("cell",false))(0);
+
+    Epetra_MultiVector& pft_state = *S->GetFieldData(pft_state_key_, name_)
+        ->ViewComponent("cell", false);
+    Epetra_MultiVector& root_biomass = *S->GetFieldData(root_biomass_key_, name_)
+        ->ViewComponent("cell", false);
+
+    for (int col=0; col!=ncols; ++col) {
+      FieldToColumn_(col, temp, col_temp.values(), ncells_per_col_);
+      Epetra_SerialDenseVector col_depth(View, &col_depth_[col * ncells_per_col_], ncells_per_col_);
+      Epetra_SerialDenseVector col_dz(View, &col_dz_[col * ncells_per_col_], ncells_per_col_);
+      const AmanziMesh::Entity_ID* cells = &col_cells_[col * ncells_per_col_];
+
+      for (int i=0; i!=npft_; ++i) {
+        pfts_[col][i]->InitRoots(col_temp, col_depth, col_dz);
+        pfts_[col][i]->CopyStateTo(pft_state, i * PFT::NUM_STATE_VARIABLES, col);
+        for (int c=0; c!=ncells_per_col_; ++c) {
+          root_biomass[i][cells[c]] = pfts_[col][i]->BRootSoil[c];
+        }
+      }
     }
+    pft_state_field->set_initialized();
+    root_biomass_field->set_initialized();
+
+  } else if (!leaf_biomass_field->initialized()) {
+    S->GetFieldData("surface-leaf_biomass", name_)->PutScalar(0.);
+    leaf_biomass_field->set_initialized();
   }
 }
 
-  
+
 // -- Commit any secondary (dependent) variables.
 void BGCSimple::CommitStep(double told, double tnew, const Teuchos::RCP<State>& S) {
-  // Copy the PFT over, which includes all additional state required, commit
-  // the step as succesful.
-  double dt = tnew - told;
-
-  int ncols = mesh_surf_->num_entities(AmanziMesh::CELL, AmanziMesh::Parallel_type::OWNED);
-  int npft = pfts_old_[0].size();
-  for (int col=0; col!=ncols; ++col) {
-    for (int i=0; i!=npft; ++i) {
-      *pfts_old_[col][i] = *pfts_[col][i];
-    }
-  }
+  // All state, including that of the PFTs, is in State, so the step is
+  // committed by copying State.
 }
 
 // -- advance the model
@@ -349,18 +370,21 @@ bool BGCSimple::AdvanceStep(double t_old, double t_new, bool reinit) {
                << " t1 = " << S_next_->time() << " h = " << dt << std::endl
                << "----------------------------------------------------------------" << std::endl;
 
-  // Copy the PFT from old to new, in case we failed the previous attempt at
-  // this timestep.  This is hackery to get around the fact that PFTs are not
-  // (but should be) in state.
   AmanziMesh::Entity_ID ncols = mesh_surf_->num_entities(AmanziMesh::CELL, AmanziMesh::Parallel_type::OWNED);
-  for (AmanziMesh::Entity_ID col=0; col!=ncols; ++col) {
-    int npft = pfts_old_[col].size();
-    for (int i=0; i!=npft; ++i) {
-      *pfts_[col][i] = *pfts_old_[col][i];
-    }
-  }
+  if (S_next_->IsDeformableMesh(domain_)) UpdateColumnGeometry_();
 
   // grab the required fields
+  // -- PFT state is read from the old time, so that a failed attempt at this
+  //    step needs no special treatment
+  const Epetra_MultiVector& pft_state_old = *S_inter_->GetFieldData(pft_state_key_)
+      ->ViewComponent("cell",false);
+  const Epetra_MultiVector& root_biomass_old = *S_inter_->GetFieldData(root_biomass_key_)
+      ->ViewComponent("cell",false);
+  Epetra_MultiVector& pft_state = *S_next_->GetFieldData(pft_state_key_, name_)
+      ->ViewComponent("cell",false);
+  Epetra_MultiVector& root_biomass = *S_next_->GetFieldData(root_biomass_key_, name_)
+      ->ViewComponent("cell",false);
+
   Epetra_MultiVector& sc_pools = *S_next_->GetFieldData(key_, name_)
       ->ViewComponent("cell",false);
   Epetra_MultiVector& co2_decomp = *S_next_->GetFieldData("co2_decomposition", name_)
@@ -418,87 +442,83 @@ bool BGCSimple::AdvanceStep(double t_old, double t_new, bool reinit) {
   const Epetra_MultiVector& scv = *S_inter_->GetFieldData("surface-cell_volume")
       ->ViewComponent("cell", false);
 
-  // Create workspace arrays (these should be removed when data is correctly oriented).
-  Teuchos::RCP<Epetra_SerialDenseVector> temp_c =
-      Teuchos::rcp(new Epetra_SerialDenseVector(ncells_per_col_));
-  Teuchos::RCP<Epetra_SerialDenseVector> pres_c =
-      Teuchos::rcp(new Epetra_SerialDenseVector(ncells_per_col_));
-  Teuchos::RCP<Epetra_SerialDenseVector> dz_c =
-      Teuchos::rcp(new Epetra_SerialDenseVector(ncells_per_col_));
-  Teuchos::RCP<Epetra_SerialDenseVector> depth_c =
-      Teuchos::rcp(new Epetra_SerialDenseVector(ncells_per_col_));
-
-  // Create a workspace array for the result
-  Epetra_SerialDenseVector co2_decomp_c(ncells_per_col_);
-  Epetra_SerialDenseVector trans_c(ncells_per_col_);
-  double sw_c(0.);
-
-  total_lai.PutScalar(0.);
-
-  // loop over columns and apply the model
-  for (AmanziMesh::Entity_ID col=0; col!=ncols; ++col) {
-    // update the various soil arrays
-    FieldToColumn_(col, *temp(0), temp_c.ptr());
-    FieldToColumn_(col, *pres(0), pres_c.ptr());
-    ColDepthDz_(col, depth_c.ptr(), dz_c.ptr());
-
-    // copy over the soil carbon arrays
-    auto& col_iter = mesh_->cells_of_column(col);
-    ncells_per_col_ = col_iter.size();
-    
-    // -- serious cache thrash... --etc
-    for (std::size_t i=0; i!=col_iter.size(); ++i) {
-      AmanziGeometry::Point centroid = mesh_->cell_centroid(col_iter[i]);
-	  //      std::cout << "Col iter col=" << col << ", index i=" << i << ", cell=" << col_iter[i] << " at " << centroid << std::endl;
-      for (int p=0; p!=soil_carbon_pools_[col][i]->nPools; ++p) {
-        soil_carbon_pools_[col][i]->SOM[p] = sc_pools[p][col_iter[i]];
+  double t = S_inter_->time();
+  int nz = ncells_per_col_;
+
+  // Loop over columns and apply the model.  Columns are independent, and
+  // each touches only its own entries of the above vectors, so they may be
+  // done concurrently.  Nothing in this loop may touch the mesh or State.
+  thread_pool_->ParallelFor(ncols, [&](int begin, int end, int thread) {
+    ColumnWorkspace& ws = workspaces_[thread];
+
+    for (AmanziMesh::Entity_ID col=begin; col!=end; ++col) {
+      const AmanziMesh::Entity_ID* cells = &col_cells_[col * nz];
+      Epetra_SerialDenseVector depth_c(View, &col_depth_[col * nz], nz);
+      Epetra_SerialDenseVector dz_c(View, &col_dz_[col * nz], nz);
+
+      // gather soil arrays and soil carbon
+      for (int i=0; i!=nz; ++i) {
+        ws.temp[i] = temp[0][cells[i]];
+        ws.pres[i] = pres[0][cells[i]];
+        for (int p=0; p!=soil_carbon_pools_[col][i]->nPools; ++p) {
+          soil_carbon_pools_[col][i]->SOM[p] = sc_pools[p][cells[i]];
+        }
       }
-    }
 
-    // Create the Met data struct
-    MetData met;
-    met.qSWin = qSWin[0][col];
-    met.tair = air_temp[0][col];
-    met.windv = wind_speed[0][col];
-    met.wind_ref_ht = wind_speed_ref_ht_;
-    met.relhum = rel_hum[0][col];
-    met.CO2a = co2[0][col];
-    met.lat = lat_;
-    sw_c = met.qSWin;
-
-    // call the model
-    BGCAdvance(S_inter_->time(), dt, scv[0][col], cryoturbation_coef_, met,
-               *temp_c, *pres_c, *depth_c, *dz_c,
-               pfts_[col], soil_carbon_pools_[col],
-               co2_decomp_c, trans_c, sw_c);
-
-    // copy back
-    // -- serious cache thrash... --etc
-    for (std::size_t i=0; i!=col_iter.size(); ++i) {
-      for (int p=0; p!=soil_carbon_pools_[col][i]->nPools; ++p) {
-        sc_pools[p][col_iter[i]] = soil_carbon_pools_[col][i]->SOM[p];
+      // gather the PFT state
+      for (int lcv_pft=0; lcv_pft!=npft_; ++lcv_pft) {
+        PFT& pft = *pfts_[col][lcv_pft];
+        pft.CopyStateFrom(pft_state_old, lcv_pft * PFT::NUM_STATE_VARIABLES, col);
+        for (int i=0; i!=nz; ++i) pft.BRootSoil[i] = root_biomass_old[lcv_pft][cells[i]];
       }
 
-      // and integrate the decomp
-      co2_decomp[0][col_iter[i]] += co2_decomp_c[i];
+      // Create the Met data struct
+      MetData met;
+      met.qSWin = qSWin[0][col];
+      met.tair = air_temp[0][col];
+      met.windv = wind_speed[0][col];
+      met.wind_ref_ht = wind_speed_ref_ht_;
+      met.relhum = rel_hum[0][col];
+      met.CO2a = co2[0][col];
+      met.lat = lat_;
+      double sw_c = met.qSWin;
+
+      // call the model
+      BGCAdvance(t, dt, scv[0][col], cryoturbation_coef_, met,
+                 ws.temp, ws.pres, depth_c, dz_c,
+                 pfts_[col], soil_carbon_pools_[col],
+                 ws.co2_decomp, ws.trans, sw_c);
+
+      // scatter back
+      for (int i=0; i!=nz; ++i) {
+        for (int p=0; p!=soil_carbon_pools_[col][i]->nPools; ++p) {
+          sc_pools[p][cells[i]] = soil_carbon_pools_[col][i]->SOM[p];
+        }
 
+        // and integrate the decomp
+        co2_decomp[0][cells[i]] += ws.co2_decomp[i];
 
-      // and pull in the transpiration, converting to mol/m^3/s, as a sink
-      trans[0][col_iter[i]] = trans_c[i] / .01801528;
+        // and pull in the transpiration, converting to mol/m^3/s, as a sink
+        trans[0][cells[i]] = ws.trans[i] / .01801528;
+      }
       sw[0][col] = sw_c;
-    }
 
-    for (int lcv_pft=0; lcv_pft!=pfts_[col].size(); ++lcv_pft) {
-      biomass[lcv_pft][col] = pfts_[col][lcv_pft]->totalBiomass;
-      leafbiomass[lcv_pft][col] = pfts_[col][lcv_pft]->Bleaf;
-      csink[lcv_pft][col] = pfts_[col][lcv_pft]->CSinkLimit;
-      lai[lcv_pft][col] = pfts_[col][lcv_pft]->lai;
+      total_lai[0][col] = 0.;
+      for (int lcv_pft=0; lcv_pft!=npft_; ++lcv_pft) {
+        const PFT& pft = *pfts_[col][lcv_pft];
+        pft.CopyStateTo(pft_state, lcv_pft * PFT::NUM_STATE_VARIABLES, col);
+        for (int i=0; i!=nz; ++i) root_biomass[lcv_pft][cells[i]] = pft.BRootSoil[i];
 
-      total_transpiration[lcv_pft][col] = pfts_[col][lcv_pft]->ET / 0.01801528;
-      total_lai[0][col] += pfts_[col][lcv_pft]->lai;
-    }
+        biomass[lcv_pft][col] = pft.totalBiomass;
+        leafbiomass[lcv_pft][col] = pft.Bleaf;
+        csink[lcv_pft][col] = pft.CSinkLimit;
+        lai[lcv_pft][col] = pft.lai;
 
-  } // end loop over columns
+        total_transpiration[lcv_pft][col] = pft.ET / 0.01801528;
+        total_lai[0][col] += pft.lai;
+      }
+    } // end loop over columns
+  });
 
   // mark primaries as changed
   trans_eval_->SetFieldAsChanged(S_next_.ptr());
@@ -577,6 +597,26 @@ void BGCSimple::ColDepthDz_(AmanziMesh::Entity_ID col,
 }
 
 
+// helper function for caching column geometry in column-contiguous order
+void BGCSimple::UpdateColumnGeometry_() {
+  int ncols = mesh_surf_->num_entities(AmanziMesh::CELL, AmanziMesh::Parallel_type::OWNED);
+  col_cells_.resize(ncols * ncells_per_col_);
+  col_depth_.resize(ncols * ncells_per_col_);
+  col_dz_.resize(ncols * ncells_per_col_);
+
+  Epetra_SerialDenseVector depth(ncells_per_col_), dz(ncells_per_col_);
+  for (int col=0; col!=ncols; ++col) {
+    auto& col_iter = mesh_->cells_of_column(col);
+    ColDepthDz_(col, Teuchos::ptr(&depth), Teuchos::ptr(&dz));
+    for (int i=0; i!=ncells_per_col_; ++i) {
+      col_cells_[col * ncells_per_col_ + i] = col_iter[i];
+      col_depth_[col * ncells_per_col_ + i] = depth[i];
+      col_dz_[col * ncells_per_col_ + i] = dz[i];
+    }
+  }
+}
+
+
 
 
 } // namespace
@@ -32,6 +32,13 @@ Note this works on both the surface (vegetation) and subsurface (decomposition)
 meshes.  **It is required** that the subsurface mesh is a "columnar" mesh, and
 that build_columns in the subsurface Mesh_ spec has been supplied.
 
+The evolving state of each PFT is stored in State, as the surface field
+`"SURFACE_DOMAIN-pft_state`" (one vector per PFT state variable) and the
+subsurface field `"DOMAIN-pft_root_biomass`" (one vector per PFT), so that
+it is checkpointed and restored on failed timesteps along with everything
+else.  Columns are independent, and may be advanced concurrently on a pool
+of threads.
+
 .. _bgc-simple-spec:
 .. admonition:: bgc-simple-spec
 
@@ -63,6 +70,12 @@ that build_columns in the subsurface Mesh_ spec has been supplied.
 
   * `"total leaf area index key`" ``[string]`` **SURFACE_DOMAIN-total_leaf_area_index** Total LAI across all PFTs.
 
+  * `"pft state key`" ``[string]`` **SURFACE_DOMAIN-pft_state** State variables of all PFTs.
+
+  * `"pft root biomass key`" ``[string]`` **DOMAIN-pft_root_biomass** Root biomass of each PFT in each cell.
+
+  * `"number of threads`" ``[int]`` **1** Number of threads over which columns are split.
+
   EVALUATORS:
 
   - `"temperature`" The soil temperature `[K]`
@@ -88,6 +101,7 @@ that build_columns in the subsurface Mesh_ spec has been supplied.
 
 #include "PK_Factory.hh"
 #include "pk_physical_default.hh"
+#include "thread_pool.hh"
 
 #include "SoilCarbonParameters.hh"
 #include "PFT.hh"
@@ -145,6 +159,10 @@ class BGCSimple : public PK_Physical_Default {
                    Teuchos::Ptr<Epetra_SerialDenseVector> depth,
                    Teuchos::Ptr<Epetra_SerialDenseVector> dz);
 
+  // Caches column cells, depths, and thicknesses in column-contiguous order,
+  // so that the column loop does not touch the mesh.
+  void UpdateColumnGeometry_();
+
 
  protected:
   double dt_;
@@ -153,9 +171,22 @@ class BGCSimple : public PK_Physical_Default {
   
   // physical structs needed by model
   std::vector<Teuchos::RCP<SoilCarbonParameters> > sc_params_;
-  std::vector<std::vector<Teuchos::RCP<PFT> > > pfts_;       // this also contains state data!
-  std::vector<std::vector<Teuchos::RCP<PFT> > > pfts_old_;   // need two copies for failed timesteps
-  std::vector<std::vector<Teuchos::RCP<SoilCarbon> > > soil_carbon_pools_;
+  std::vector<std::vector<Teuchos::RCP<PFT> > > pfts_;  // state is a workspace, stored in State
+  std::vector<std::vector<Teuchos::RCP<SoilCarbon> > > soil_carbon_pools_;  // views into som_
+  std::vector<double> som_;
+  int npft_;
+
+  // column-contiguous geometry, ncols x ncells_per_col_
+  std::vector<AmanziMesh::Entity_ID> col_cells_;
+  std::vector<double> col_depth_;
+  std::vector<double> col_dz_;
+
+  // per-thread workspace
+  struct ColumnWorkspace {
+    Epetra_SerialDenseVector temp, pres, co2_decomp, trans;
+  };
+  std::vector<ColumnWorkspace> workspaces_;
+  Teuchos::RCP<ThreadPool> thread_pool_;
 
   // evaluator for transpiration
   Teuchos::RCP<PrimaryVariableFieldEvaluator> trans_eval_;
@@ -173,6 +204,8 @@ class BGCSimple : public PK_Physical_Default {
   Key trans_key_;
   Key shaded_sw_key_;
   Key total_lai_key_;
+  Key pft_state_key_;
+  Key root_biomass_key_;
 
 
  private:
@@ -52,6 +52,7 @@ CarbonSimple::Setup(const Teuchos::Ptr<State>& S) {
     S->RequireField(div_diff_flux_key_)->SetMesh(mesh_)
         ->AddComponent("cell", AmanziMesh::CELL, npools_);
     S->RequireFieldEvaluator(div_diff_flux_key_);
+    diagnostic_keys_.push_back(div_diff_flux_key_);
   }
 
   // source terms
@@ -62,12 +63,14 @@ CarbonSimple::Setup(const Teuchos::Ptr<State>& S) {
     S->RequireField(source_key_)->SetMesh(mesh_)
         ->AddComponent("cell", AmanziMesh::CELL, npools_);
     S->RequireFieldEvaluator(source_key_);
+    diagnostic_keys_.push_back(source_key_);
   }
 
   // decomposition terms
   is_decomp_ = plist_->get<bool>("is decomposition", true);
   if (is_decomp_) {
     decomp_key_ = plist_->get<std::string>("decomposition rate", "carbon_decomposition_rate");
+    diagnostic_keys_.push_back(decomp_key_);
 
     S->RequireField(div_diff_flux_key_)->SetMesh(mesh_)
         ->AddComponent("cell", AmanziMesh::CELL, npools_);
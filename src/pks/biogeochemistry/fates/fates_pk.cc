@@ -248,23 +248,19 @@ void FATES_PK::Initialize(const Teuchos::Ptr<State>& S){
   }else{
     
     for (unsigned int col=0; col!=ncells_owned_; ++col) {
-
-      // FieldToColumn_(col, poro, col_poro.ptr());
-      // ColDepthDz_(col, col_depth.ptr(), col_dz.ptr());
-      
-      int f = mesh_surf_->entity_get_parent(AmanziMesh::CELL, col);
-
       auto& col_iter = mesh_->cells_of_column(col);
       std::size_t ncol_cells = col_iter.size();
       if (ncells_per_col_ < 0) {
         ncells_per_col_ = ncol_cells;
+        col_cells_.reserve(ncells_per_col_ * ncells_owned_);
       } else {
         AMANZI_ASSERT(ncol_cells == ncells_per_col_);
       }
-      
+      col_cells_.insert(col_cells_.end(), col_iter.begin(), col_iter.end());
     }
   }
 
+
   int array_size = ncells_per_col_*ncells_owned_;
   t_soil_.resize(array_size);
   vsm_.resize(array_size);
@@ -381,72 +377,62 @@ bool FATES_PK::AdvanceStep(double t_old, double t_new, bool reinit){
 
   if (run_photo){
 
-    for (unsigned int c=0; c<ncells_owned_; ++c){
-      
-      if (surface_only_){
+    // Gather all columns at once into contiguous buffers, in the layout
+    // expected by FATES.
+    if (surface_only_) {
+      for (unsigned int c=0; c<ncells_owned_; ++c){
         t_soil_[c] = air_temp[0][c];
         poro_[c] = 0.5;
         eff_poro_[c] = poro_[c];
         vsm_[c] = 1.*poro_[c];
         suc_[c] = 0.;
+      }
+    } else {
+      if (S_next_->HasField(soil_temp_key_)){
+        S_next_->GetFieldEvaluator(soil_temp_key_)->HasFieldChanged(S_next_.ptr(), name_);
+        const Epetra_Vector& temp_vec = *(*S_next_->GetFieldData(soil_temp_key_)->ViewComponent("cell", false))(0);
+        GatherColumns_(temp_vec, t_soil_);
+      }
+
+      if (S_next_->HasField(poro_key_)){
+        S_next_->GetFieldEvaluator(poro_key_)->HasFieldChanged(S_next_.ptr(), name_);
+        const Epetra_Vector& poro_vec = *(*S_next_->GetFieldData(poro_key_)->ViewComponent("cell", false))(0);
+        GatherColumns_(poro_vec, poro_);
+      }
+      eff_poro_.assign(poro_.begin(), poro_.end());
+
+      if (S_next_->HasField(sat_key_)){
+        S_next_->GetFieldEvaluator(sat_key_)->HasFieldChanged(S_next_.ptr(), name_);
+        const Epetra_Vector& sat_vec = *(*S_next_->GetFieldData(sat_key_)->ViewComponent("cell", false))(0);
+        GatherColumns_(sat_vec, vsm_);
+      }else{
+        vsm_.assign(poro_.begin(), poro_.end());  // No saturation in state. Fully saturated assumption;
+      }
+
+      if (S_next_->HasField(suc_key_)){
+        S_next_->GetFieldEvaluator(suc_key_)->HasFieldChanged(S_next_.ptr(), name_);
+        const Epetra_Vector& suc_vec = *(*S_next_->GetFieldData(suc_key_)->ViewComponent("cell", false))(0);
+        GatherColumns_(suc_vec, suc_);
       }else{
-        
-        if (S_next_->HasField(soil_temp_key_)){
-          S_next_->GetFieldEvaluator(soil_temp_key_)->HasFieldChanged(S_next_.ptr(), name_);
-          const Epetra_Vector& temp_vec = *(*S_next_->GetFieldData(soil_temp_key_)->ViewComponent("cell", false))(0);        
-          FieldToColumn_(c, temp_vec, t_soil_.data() + c*ncells_per_col_, ncells_per_col_);
-        }
-        
-        
-        if (S_next_->HasField(poro_key_)){
-          S_next_->GetFieldEvaluator(poro_key_)->HasFieldChanged(S_next_.ptr(), name_);
-          const Epetra_Vector& poro_vec = *(*S_next_->GetFieldData(poro_key_)->ViewComponent("cell", false))(0);        
-          FieldToColumn_(c, poro_vec, poro_.data() + c*ncells_per_col_, ncells_per_col_);
-        }
-        eff_poro_.assign(poro_.begin(), poro_.end());
-
-        if (S_next_->HasField(sat_key_)){
-          S_next_->GetFieldEvaluator(sat_key_)->HasFieldChanged(S_next_.ptr(), name_);
-          const Epetra_Vector& sat_vec = *(*S_next_->GetFieldData(sat_key_)->ViewComponent("cell", false))(0);        
-          FieldToColumn_(c, sat_vec, vsm_.data() + c*ncells_per_col_, ncells_per_col_);
-                   
-        }else{
-          vsm_.assign(poro_.begin(), poro_.end());  // No saturation in state. Fully saturated assumption;
-        }
-
-        if (S_next_->HasField(suc_key_)){          
-          S_next_->GetFieldEvaluator(suc_key_)->HasFieldChanged(S_next_.ptr(), name_);
-          const Epetra_Vector& suc_vec = *(*S_next_->GetFieldData(suc_key_)->ViewComponent("cell", false))(0);        
-          FieldToColumn_(c, suc_vec, suc_.data() + c*ncells_per_col_, ncells_per_col_);
-          
-        }else{
-          for(int i=0;i<suc_.size();i++) suc_[i] = 0.;  // No suction is defined in State;
-        }
-        
+        suc_.assign(suc_.size(), 0.);  // No suction is defined in State;
       }
     }
 
+    if (vo_->os_OK(Teuchos::VERB_EXTREME)) {
+      Teuchos::OSTab tab = vo_->getOSTab();
+      *vo_->os() << "t_soil_\n";
+      for (auto ent : t_soil_) *vo_->os() << ent << " ";
+      *vo_->os() << "\nporo\n";
+      for (auto ent : poro_) *vo_->os() << ent << " ";
+      *vo_->os() << "\neff_poro_\n";
+      for (auto ent : eff_poro_) *vo_->os() << ent << " ";
+      *vo_->os() << "\nvsm_\n";
+      for (auto ent : vsm_) *vo_->os() << ent << " ";
+      *vo_->os() << "\nsuc_\n";
+      for (auto ent : suc_) *vo_->os() << ent << " ";
+      *vo_->os() << std::endl;
+    }
 
-  // if (S_next_->cycle() == 1102){
-  //   std::cout<<"Reached cycle 1102\n";
-  // }  
-
-    std::cout<<"t_soil_\n";
-    for (auto ent : t_soil_) std::cout<<ent<<" ";
-    std::cout<<"\n";
-    std::cout<<"poro\n";
-    for (auto ent : poro_) std::cout<<ent<<" ";
-    std::cout<<"\n";
-    std::cout<<"eff_poro_\n";
-    for (auto ent : eff_poro_) std::cout<<ent<<" ";
-    std::cout<<"\n";
-    std::cout<<"vsm_\n";
-    for (auto ent : vsm_) std::cout<<ent<<" ";
-    std::cout<<"\n";
-    std::cout<<"suc_\n";
-    for (auto ent : suc_) std::cout<<ent<<" ";
-    std::cout<<"\n";
-    
     int array_size = t_soil_.size();
     wrap_btran(&array_size, t_soil_.data(), poro_.data(), eff_poro_.data(), vsm_.data(), suc_.data());
 
@@ -518,13 +504,14 @@ bool FATES_PK::AdvanceStep(double t_old, double t_new, bool reinit){
   }
 
   
-  std::vector<double> temp_veg24_patch(1);
-  std::vector<double> prec24_patch(1);
-  std::vector<double> rh24_patch(1);
-  std::vector<double> wind24_patch(1);
-  std::vector<double> h2osoi_vol_col;
-
   if (run_veg_dym){
+    // FATES keeps the state of a clump in module data, and all sites share
+    // the one clump, so sites are advanced one at a time.
+    std::vector<double> temp_veg24_patch(1);
+    std::vector<double> prec24_patch(1);
+    std::vector<double> rh24_patch(1);
+    std::vector<double> wind24_patch(1);
+
     for (int c=0; c<ncells_owned_; c++){
       int s=c+1;
 
@@ -534,24 +521,12 @@ bool FATES_PK::AdvanceStep(double t_old, double t_new, bool reinit){
       wind24_patch[0] = wind[0][c];
       rh24_patch[0] = humidity[0][c];
 
-
-      // if (surface_only_){
-      //   h2osoi_vol_col.resize(1);
-      //   h2osoi_vol_col[0] = 0.5;
-      // }else{
-      //   h2osoi_vol_col.resize(ncells_per_col_);        
-      //   S_next_->GetFieldEvaluator(poro_key_)->HasFieldChanged(S_next_.ptr(), name_);
-      //   const Epetra_Vector& poro_vec = *(*S_next_->GetFieldData(poro_key_)->ViewComponent("cell", false))(0);        
-      //   FieldToColumn_(c, poro_vec, h2osoi_vol_col.data(), ncells_per_col_);
-      // }      
-             
       dynamics_driv_per_site(&clump_, &s, &(site_[c]), &dtime,
                              vsm_.data() + c*ncells_per_col_,  // column data for volumetric soil moisture content
                              temp_veg24_patch.data(),
                              prec24_patch.data(),
                              rh24_patch.data(),
                              wind24_patch.data());
-    
     }
     t_site_dym_ = t_new;
   }
@@ -577,13 +552,11 @@ void FATES_PK::CommitStep(double t_old, double t_new, const Teuchos::RCP<State>&
 }
 
 
-// helper function for pushing field to column
-void FATES_PK::FieldToColumn_(AmanziMesh::Entity_ID col, const Epetra_Vector& vec,
-                               double* col_vec, int ncol) {
-
-  auto& col_iter = mesh_->cells_of_column(col);
-  for (std::size_t i=0; i!=col_iter.size(); ++i) {
-    col_vec[i] = vec[col_iter[i]];
+// helper function for gathering a field into all columns
+void FATES_PK::GatherColumns_(const Epetra_Vector& vec, std::vector<double>& buf) {
+  AMANZI_ASSERT(buf.size() == col_cells_.size());
+  for (std::size_t i=0; i!=col_cells_.size(); ++i) {
+    buf[i] = vec[col_cells_[i]];
   }
 }
 
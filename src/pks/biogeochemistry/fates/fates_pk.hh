@@ -117,8 +117,8 @@ namespace BGC {
   protected:
 
 
-    void FieldToColumn_(AmanziMesh::Entity_ID col, const Epetra_Vector& vec,
-                      double* col_vec, int ncol);
+    // gather a subsurface cell field into a column-contiguous buffer
+    void GatherColumns_(const Epetra_Vector& vec, std::vector<double>& buf);
     void ColDepthDz_(AmanziMesh::Entity_ID col,
                      Teuchos::Ptr<Epetra_SerialDenseVector> depth,
                      Teuchos::Ptr<Epetra_SerialDenseVector> dz);
@@ -146,6 +146,9 @@ namespace BGC {
     int ncells_owned_, ncells_per_col_, clump_;
     std::vector<site_info> site_;
 
+    // cells of all columns, column-contiguous
+    std::vector<AmanziMesh::Entity_ID> col_cells_;
+
   // factory registration
   static RegisteredPKFactory<FATES_PK> reg_;
 };
@@ -440,11 +440,23 @@ bool VolumetricDeformation::AdvanceStep(double t_old, double t_new, bool reinit)
   }
 
 
-  // only deform if needed
+  // only deform if needed -- the norm is global, so all ranks agree.  If
+  // nothing deforms, the mesh, vertex coordinates, and base porosity in
+  // S_next_ are already those of the previous step.
   double dcell_vol_norm(0.);
   dcell_vol_vec->Norm2(&dcell_vol_norm);
-  //  if (dcell_vol_norm > 0.) {
-  if (true) {
+  if (dcell_vol_norm == 0.) {
+    if (vo_->os_OK(Teuchos::VERB_HIGH))
+      *vo_->os() << "No volume change, skipping deformation." << std::endl;
+    return false;
+  }
+
+  // Nodes moved by this step, if known.  The MSTK strategy moves nodes
+  // internally, so all nodes are treated as moved.
+  bool moved_nodes_known = false;
+  Entity_ID_List moved_nodes;
+
+  {
 
     // Deform the subsurface mesh
     switch (strategy_) {
@@ -593,15 +605,20 @@ bool VolumetricDeformation::AdvanceStep(double t_old, double t_new, bool reinit)
 	}
       }
 
-      // deform the mesh
-      Entity_ID_List node_ids(nodal_dz.MyLength());
-      AmanziGeometry::Point_List new_positions(nodal_dz.MyLength());
+      // deform the mesh, passing only the nodes that move
+      Entity_ID_List& node_ids = moved_nodes;
+      AmanziGeometry::Point_List new_positions;
       for (int n=0; n!=nodal_dz.MyLength(); ++n) {
-	node_ids[n] = n;
-	mesh_->node_get_coordinates(n, &new_positions[n]);
 	AMANZI_ASSERT(nodal_dz[0][n] >= 0.);
-	new_positions[n][2] -= nodal_dz[0][n];
+        if (nodal_dz[0][n] > 0.) {
+          AmanziGeometry::Point x;
+          mesh_->node_get_coordinates(n, &x);
+          x[2] -= nodal_dz[0][n];
+          node_ids.push_back(n);
+          new_positions.push_back(x);
+        }
       }
+      moved_nodes_known = true;
       AmanziGeometry::Point_List final_positions;
 
       for (auto&& p : new_positions) {
@@ -662,6 +679,10 @@ bool VolumetricDeformation::AdvanceStep(double t_old, double t_new, bool reinit)
   // now we have to adapt the surface mesh to the new volume mesh
   // extract the correct new coordinates for the surface from the domain
   // mesh and update the surface mesh accordingly
+  int nnodes_all = mesh_->num_entities(AmanziMesh::NODE, AmanziMesh::Parallel_type::ALL);
+  std::vector<bool> node_moved(nnodes_all, !moved_nodes_known);
+  for (auto n : moved_nodes) node_moved[n] = true;
+
   if (surf_mesh_ != Teuchos::null && domain_surf_.find("column") == std::string::npos) {
     // WORKAROUND for non-communication in deform() by Mesh
     //    int nsurfnodes = surf_mesh_->num_entities(Amanzi::AmanziMesh::NODE,
@@ -673,9 +694,10 @@ bool VolumetricDeformation::AdvanceStep(double t_old, double t_new, bool reinit)
     AmanziGeometry::Point_List surface_newpos, surface3d_newpos;
 
     for (int i=0; i!=nsurfnodes; ++i) {
-      // get the coords of the node
+      // get the coords of the node, if it moved
       AmanziMesh::Entity_ID pnode =
           surf_mesh_->entity_get_parent(AmanziMesh::NODE, i);
+      if (!node_moved[pnode]) continue;
       int dim = mesh_->space_dimension();
       AmanziGeometry::Point coord_domain(dim);
       mesh_->node_get_coordinates(pnode, &coord_domain);
@@ -690,8 +712,10 @@ bool VolumetricDeformation::AdvanceStep(double t_old, double t_new, bool reinit)
       surface_newpos.push_back(coord_surface);
     }
     AmanziGeometry::Point_List surface_finpos;
-    surf_mesh_nc_->deform(surface_nodeids, surface_newpos, false, &surface_finpos);
-    surf3d_mesh_nc_->deform(surface3d_nodeids, surface3d_newpos, false, &surface_finpos);
+    if (surface_nodeids.size() > 0) {
+      surf_mesh_nc_->deform(surface_nodeids, surface_newpos, false, &surface_finpos);
+      surf3d_mesh_nc_->deform(surface3d_nodeids, surface3d_newpos, false, &surface_finpos);
+    }
   }
 
   {  // update vertex coordinates in state (for checkpointing and error recovery)
@@ -701,6 +725,7 @@ bool VolumetricDeformation::AdvanceStep(double t_old, double t_new, bool reinit)
     int dim = mesh_->space_dimension();
     int nnodes = vc.MyLength();
     for (int i=0; i!=nnodes; ++i) {
+      if (!node_moved[i]) continue;
       AmanziGeometry::Point coords(dim);
       mesh_->node_get_coordinates(i,&coords);
       for (int s=0; s!=dim; ++s) vc[s][i] = coords[s];
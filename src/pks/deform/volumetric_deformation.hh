@@ -58,6 +58,11 @@ node coordinate changes.  Three options are available:
   expensive if iterations don't work well.  This is not particularly robust
   either, but it seems to be the preferred method for now.
 
+Steps with no volume change anywhere do not touch the mesh.  For the
+"average" strategy, only nodes that actually move are passed to the mesh and
+copied into the vertex coordinate fields, as subsidence is usually confined
+to a few thawing columns.
+
 .. todo:: Check that "global optimization" even works? --etc
     
   
@@ -4,6 +4,7 @@ Energy for a three-phase, gas+liquid+ice evaluator.
   Generated via evaluator_generator.
 */
 
+#include "DependencyTangents.hh"
 #include "three_phase_energy_evaluator.hh"
 #include "three_phase_energy_model.hh"
 
@@ -17,6 +18,7 @@ ThreePhaseEnergyEvaluator::ThreePhaseEnergyEvaluator(Teuchos::ParameterList& pli
 {
   Teuchos::ParameterList& sublist = plist_.sublist("three_phase_energy parameters");
   model_ = Teuchos::rcp(new ThreePhaseEnergyModel(sublist));
+  forward_mode_ = plist_.get<bool>("forward mode derivatives", false);
   InitializeFromPlist_();
 }
 
@@ -38,6 +40,7 @@ ThreePhaseEnergyEvaluator::ThreePhaseEnergyEvaluator(const ThreePhaseEnergyEvalu
     rho_r_key_(other.rho_r_key_),
     ur_key_(other.ur_key_),
     cv_key_(other.cv_key_),    
+    forward_mode_(other.forward_mode_),
     model_(other.model_) {}
 
 
@@ -536,6 +539,34 @@ Teuchos::RCP<const CompositeVector> cv = S->GetFieldData(cv_key_);
 }
 
 
+// Total derivative, computed in a single pass over the mesh by evaluating the
+// model on tangents, each dependency carrying its total derivative with
+// respect to wrt_key.
+void
+ThreePhaseEnergyEvaluator::UpdateFieldDerivative_(const Teuchos::Ptr<State>& S, Key wrt_key)
+{
+  if (!forward_mode_) {
+    SecondaryVariableFieldEvaluator::UpdateFieldDerivative_(S, wrt_key);
+    return;
+  }
+
+  Teuchos::RCP<CompositeVector> dmy =
+      Amanzi::Relations::DependencyTangents::RequireDerivativeData(S, my_key_, wrt_key);
+  std::vector<Key> deps = { phi_key_, phi0_key_, sl_key_, nl_key_, ul_key_, si_key_, ni_key_, ui_key_, sg_key_, ng_key_, ug_key_, rho_r_key_, ur_key_, cv_key_ };
+
+  for (CompositeVector::name_iterator comp=dmy->begin();
+       comp!=dmy->end(); ++comp) {
+    Amanzi::Relations::DependencyTangents t(S, deps, wrt_key, *comp);
+    Epetra_MultiVector& dmy_v = *dmy->ViewComponent(*comp,false);
+
+    int ncomp = dmy->size(*comp, false);
+    for (int i=0; i!=ncomp; ++i) {
+      dmy_v[0][i] = model_->Energy(t(0,i), t(1,i), t(2,i), t(3,i), t(4,i), t(5,i), t(6,i), t(7,i), t(8,i), t(9,i), t(10,i), t(11,i), t(12,i), t(13,i)).d();
+    }
+  }
+}
+
+
 } //namespace
 } //namespace
 } //namespace
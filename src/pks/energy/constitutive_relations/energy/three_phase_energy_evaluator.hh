@@ -42,6 +42,10 @@ the larger, compressible value when used with the energy in the water.
      but must be consistent with the above density.
    - `"cell volume`" [m^3]
 
+   * `"forward mode derivatives`" ``[bool]`` **false** If true, total
+     derivatives are computed in a single pass by evaluating the model on
+     tangents, rather than once per dependency.
+
 */
 
 #pragma once
@@ -70,6 +74,9 @@ class ThreePhaseEnergyEvaluator : public SecondaryVariableFieldEvaluator {
   virtual void EvaluateFieldPartialDerivative_(const Teuchos::Ptr<State>& S,
           Key wrt_key, const Teuchos::Ptr<CompositeVector>& result);
 
+  // Forward-mode total derivative, see "forward mode derivatives"
+  virtual void UpdateFieldDerivative_(const Teuchos::Ptr<State>& S, Key wrt_key);
+
   Teuchos::RCP<ThreePhaseEnergyModel> get_model() { return model_; }
 
  protected:
@@ -90,6 +97,7 @@ class ThreePhaseEnergyEvaluator : public SecondaryVariableFieldEvaluator {
   Key ur_key_;
   Key cv_key_;
 
+  bool forward_mode_;
   Teuchos::RCP<ThreePhaseEnergyModel> model_;
 
  private:
@@ -30,13 +30,6 @@ ThreePhaseEnergyModel::InitializeFromPlist_(Teuchos::ParameterList& plist)
 }
 
 
-// main method
-double
-ThreePhaseEnergyModel::Energy(double phi, double phi0, double sl, double nl, double ul, double si, double ni, double ui, double sg, double ng, double ug, double rho_r, double ur, double cv) const
-{
-  return cv*(phi*(ng*sg*ug + ni*si*ui + nl*sl*ul) + rho_r*ur*(-phi0 + 1));
-}
-
 double
 ThreePhaseEnergyModel::DEnergyDPorosity(double phi, double phi0, double sl, double nl, double ul, double si, double ni, double ui, double sg, double ng, double ug, double rho_r, double ur, double cv) const
 {
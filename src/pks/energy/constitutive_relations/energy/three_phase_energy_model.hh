@@ -20,7 +20,11 @@ class ThreePhaseEnergyModel {
   explicit
   ThreePhaseEnergyModel(Teuchos::ParameterList& plist);
 
-  double Energy(double phi, double phi0, double sl, double nl, double ul, double si, double ni, double ui, double sg, double ng, double ug, double rho_r, double ur, double cv) const;
+  // main method, templated so that it may be evaluated on Tangent arguments
+  template<typename Scalar>
+  Scalar Energy(const Scalar& phi, const Scalar& phi0, const Scalar& sl, const Scalar& nl, const Scalar& ul, const Scalar& si, const Scalar& ni, const Scalar& ui, const Scalar& sg, const Scalar& ng, const Scalar& ug, const Scalar& rho_r, const Scalar& ur, const Scalar& cv) const {
+    return cv*(phi*(ng*sg*ug + ni*si*ui + nl*sl*ul) + rho_r*ur*(1. - phi0));
+  }
 
   double DEnergyDPorosity(double phi, double phi0, double sl, double nl, double ul, double si, double ni, double ui, double sg, double ng, double ug, double rho_r, double ur, double cv) const;
   double DEnergyDBasePorosity(double phi, double phi0, double sl, double nl, double ul, double si, double ni, double ui, double sg, double ng, double ug, double rho_r, double ur, double cv) const;
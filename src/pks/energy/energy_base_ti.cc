@@ -10,6 +10,8 @@ Author: Ethan Coon
 #include "boost/math/special_functions/fpclassify.hpp"
 #include "boost/test/floating_point_comparison.hpp"
 
+#include "Teuchos_TimeMonitor.hpp"
+
 #include "Debugger.hh"
 #include "BoundaryFunction.hh"
 #include "FieldEvaluator.hh"
@@ -132,7 +134,15 @@ int EnergyBase::ApplyPreconditioner(Teuchos::RCP<const TreeVector> u, Teuchos::R
 #endif
 
   // apply the preconditioner
-  int ierr = preconditioner_->ApplyInverse(*u->Data(), *Pu->Data());
+  int ierr = 0;
+  if (pc_reuse_->setup_pending()) {
+    // the inverse is computed on the first application after an update
+    Teuchos::TimeMonitor monitor(pc_reuse_->setup_timer());
+    ierr = preconditioner_->ApplyInverse(*u->Data(), *Pu->Data());
+    pc_reuse_->set_setup_pending(false);
+  } else {
+    ierr = preconditioner_->ApplyInverse(*u->Data(), *Pu->Data());
+  }
 
 #if DEBUG_FLAG
   db_->WriteVector("PC*T_res", Pu->Data().ptr(), true);
@@ -151,8 +161,16 @@ void EnergyBase::UpdatePreconditioner(double t, Teuchos::RCP<const TreeVector> u
   if (vo_->os_OK(Teuchos::VERB_HIGH))
     *vo_->os() << "Precon update at t = " << t << std::endl;
 
-  // update state with the solution up.
+  // lag the preconditioner if the reuse policy allows it
+  auto update = pc_reuse_->Decide(t, h);
+  if (update == PreconditionerReusePolicy::PC_REUSE) {
+    if (vo_->os_OK(Teuchos::VERB_HIGH))
+      *vo_->os() << "  reusing preconditioner" << std::endl;
+    return;
+  }
+  Teuchos::TimeMonitor monitor(pc_reuse_->setup_timer());
 
+  // update state with the solution up.
   AMANZI_ASSERT(std::abs(S_next_->time() - t) <= 1.e-4*t);
   PK_PhysicalBDF_Default::Solution_to_State(*up, S_next_);
 
@@ -268,6 +286,12 @@ void EnergyBase::UpdatePreconditioner(double t, Teuchos::RCP<const TreeVector> u
 
   // Apply boundary conditions.
   preconditioner_diff_->ApplyBCs(true, true, true);
+
+  // after a failed step, set up the inverse from scratch
+  if (update == PreconditionerReusePolicy::PC_REBUILD && precon_used_) {
+    preconditioner_->set_inverse_parameters(
+        plist_->sublist("diffusion preconditioner").sublist("inverse"));
+  }
 };
 
 // -----------------------------------------------------------------------------
@@ -382,6 +406,7 @@ double EnergyBase::ErrorNorm(Teuchos::RCP<const TreeVector> u,
   int ierr;
   ierr = MPI_Allreduce(&enorm_val_l, &enorm_val, 1, MPI_DOUBLE, MPI_MAX, comm);
   AMANZI_ASSERT(!ierr);
+  pc_reuse_->RecordResidualNorm(S_next_->time(), enorm_val);
   return enorm_val;
 };
 
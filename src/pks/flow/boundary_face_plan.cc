@@ -0,0 +1,88 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+*/
+
+#include "dbc.hh"
+#include "OperatorDefs.hh"
+#include "pk_helpers.hh"
+
+#include "boundary_face_plan.hh"
+
+namespace Amanzi {
+namespace Flow {
+
+BoundaryFacePlan::BoundaryFacePlan(const Teuchos::RCP<const AmanziMesh::Mesh>& mesh) :
+    mesh_(mesh),
+    built_(false),
+    nfaces_owned_(0)
+{}
+
+
+void
+BoundaryFacePlan::Build()
+{
+  int nfaces_owned = mesh_->num_entities(AmanziMesh::FACE, AmanziMesh::Parallel_type::OWNED);
+  int nfaces_wghost = mesh_->num_entities(AmanziMesh::FACE, AmanziMesh::Parallel_type::ALL);
+
+  faces_.clear();
+  nfaces_owned_ = 0;
+  face_cell_.assign(nfaces_wghost, -1);
+
+  // Ghosted faces on the edge of the ghost layer also have a single cell.
+  // They are never assigned a boundary condition, but including them is
+  // harmless and keeps the reset equivalent to clearing the full arrays on
+  // all faces which may carry one.
+  AmanziMesh::Entity_ID_List cells;
+  for (int f=0; f!=nfaces_wghost; ++f) {
+    mesh_->face_get_cells(f, AmanziMesh::Parallel_type::ALL, &cells);
+    if (cells.size() == 1) {
+      if (f < nfaces_owned) nfaces_owned_++;
+      faces_.push_back(f);
+      face_cell_[f] = cells[0];
+    }
+  }
+  built_ = true;
+}
+
+
+void
+BoundaryFacePlan::BuildGeometry(bool with_columns)
+{
+  AMANZI_ASSERT(built_);
+  int nfaces_wghost = mesh_->num_entities(AmanziMesh::FACE, AmanziMesh::Parallel_type::ALL);
+  int z_index = mesh_->space_dimension() - 1;
+
+  face_z_.assign(nfaces_wghost, 0.);
+  face_dir_.assign(nfaces_wghost, 0);
+  head_dz_.assign(with_columns ? nfaces_wghost : 0, 0.);
+  for (int f : faces_) {
+    face_z_[f] = mesh_->face_centroid(f)[z_index];
+    face_dir_[f] = getBoundaryDirection(*mesh_, f);
+
+    if (with_columns) {
+      int c = face_cell_[f];
+      int col = mesh_->column_ID(c);
+      if (col >= 0) {
+        double z_surf = mesh_->face_centroid(mesh_->faces_of_column(col)[0])[z_index];
+        head_dz_[f] = z_surf - mesh_->cell_centroid(c)[z_index];
+      }
+    }
+  }
+}
+
+
+void
+BoundaryFacePlan::Reset(std::vector<int>& markers, std::vector<double>& values) const
+{
+  AMANZI_ASSERT(built_);
+  for (int f : faces_) {
+    markers[f] = Operators::OPERATOR_BC_NONE;
+    values[f] = 0.0;
+  }
+}
+
+}  // namespace Flow
+}  // namespace Amanzi
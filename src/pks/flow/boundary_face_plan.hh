@@ -0,0 +1,92 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+//! Cached boundary faces and their cells, for updating boundary conditions.
+
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+*/
+
+/*!
+
+Boundary conditions are pushed into the operator's marker and value arrays at
+every residual and preconditioner evaluation.  Clearing the full face arrays
+and querying the mesh for the cell of each boundary face on every update
+costs far more than the handful of boundary faces that are written.  The plan
+caches, once, the ghosted faces with a single cell -- every face a boundary
+condition may be applied on -- together with that cell, so that an update
+resets and writes only those faces.
+
+The plan may also cache, by face, the geometry used by boundary conditions
+for every boundary face.  It is cached for all boundary faces, not only those
+of a given BC, as the faces of a BC are known only once its function is
+computed, and may change with time.  The topology depends only upon the mesh
+topology, but PKs which cache the geometry, e.g. Richards, rebuild it when
+the mesh deforms.
+
+*/
+
+#ifndef PK_FLOW_BOUNDARY_FACE_PLAN_HH_
+#define PK_FLOW_BOUNDARY_FACE_PLAN_HH_
+
+#include <vector>
+
+#include "Teuchos_RCP.hpp"
+
+#include "Mesh.hh"
+
+namespace Amanzi {
+namespace Flow {
+
+class BoundaryFacePlan {
+ public:
+  explicit BoundaryFacePlan(const Teuchos::RCP<const AmanziMesh::Mesh>& mesh);
+
+  // (Re-)caches the boundary faces.
+  void Build();
+
+  // (Re-)caches the geometry of the boundary faces.  The relation of each
+  // face's cell to the top of its column, used by head BCs, requires
+  // columns, so is cached only if with_columns.
+  void BuildGeometry(bool with_columns);
+
+  bool built() const { return built_; }
+  void Invalidate() { built_ = false; }
+
+  // ghosted faces with a single cell
+  const std::vector<int>& faces() const { return faces_; }
+
+  // the owned faces are the first nfaces_owned() entries of faces()
+  int nfaces_owned() const { return nfaces_owned_; }
+
+  // the cell of a boundary face, or -1 for an interior face
+  int cell(int f) const { return face_cell_[f]; }
+
+  // the elevation of a boundary face's centroid
+  double elevation(int f) const { return face_z_[f]; }
+
+  // the outward direction of a boundary face's normal, see getBoundaryDirection()
+  int direction(int f) const { return face_dir_[f]; }
+
+  // the elevation of the top of the column of a boundary face's cell, minus
+  // that of the cell, or 0 if the cell is not in a column
+  double head_dz(int f) const { return head_dz_[f]; }
+
+  // Sets the markers and values of all boundary faces to none and zero.
+  void Reset(std::vector<int>& markers, std::vector<double>& values) const;
+
+ private:
+  Teuchos::RCP<const AmanziMesh::Mesh> mesh_;
+  bool built_;
+  int nfaces_owned_;
+  std::vector<int> faces_;
+  std::vector<int> face_cell_;
+  std::vector<double> face_z_;
+  std::vector<int> face_dir_;
+  std::vector<double> head_dz_;
+};
+
+}  // namespace Flow
+}  // namespace Amanzi
+
+#endif
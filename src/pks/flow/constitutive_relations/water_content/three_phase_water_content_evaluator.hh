@@ -29,6 +29,10 @@ Specified with evaluator type: `"three phase water content`"
    - `"molar fraction gas`"
    - `"cell volume`"
 
+   * `"forward mode derivatives`" ``[bool]`` **false** If true, total
+     derivatives are computed in a single pass by evaluating the model on
+     tangents, rather than once per dependency.
+
 */
 
 #ifndef AMANZI_FLOW_THREE_PHASE_WATER_CONTENT_EVALUATOR_HH_
@@ -58,6 +62,9 @@ class ThreePhaseWaterContentEvaluator : public SecondaryVariableFieldEvaluator {
   virtual void EvaluateFieldPartialDerivative_(const Teuchos::Ptr<State>& S,
           Key wrt_key, const Teuchos::Ptr<CompositeVector>& result);
 
+  // Forward-mode total derivative, see "forward mode derivatives"
+  virtual void UpdateFieldDerivative_(const Teuchos::Ptr<State>& S, Key wrt_key);
+
   Teuchos::RCP<ThreePhaseWaterContentModel> get_model() { return model_; }
 
  protected:
@@ -73,6 +80,7 @@ class ThreePhaseWaterContentEvaluator : public SecondaryVariableFieldEvaluator {
   Key omega_key_;
   Key cv_key_;
 
+  bool forward_mode_;
   Teuchos::RCP<ThreePhaseWaterContentModel> model_;
 
  private:
@@ -30,13 +30,6 @@ ThreePhaseWaterContentModel::InitializeFromPlist_(Teuchos::ParameterList& plist)
 }
 
 
-// main method
-double
-ThreePhaseWaterContentModel::WaterContent(double phi, double sl, double nl, double si, double ni, double sg, double ng, double omega, double cv) const
-{
-  return cv*phi*(ng*omega*sg + ni*si + nl*sl);
-}
-
 double
 ThreePhaseWaterContentModel::DWaterContentDPorosity(double phi, double sl, double nl, double si, double ni, double sg, double ng, double omega, double cv) const
 {
@@ -20,7 +20,11 @@ class ThreePhaseWaterContentModel {
   explicit
   ThreePhaseWaterContentModel(Teuchos::ParameterList& plist);
 
-  double WaterContent(double phi, double sl, double nl, double si, double ni, double sg, double ng, double omega, double cv) const;
+  // main method, templated so that it may be evaluated on Tangent arguments
+  template<typename Scalar>
+  Scalar WaterContent(const Scalar& phi, const Scalar& sl, const Scalar& nl, const Scalar& si, const Scalar& ni, const Scalar& sg, const Scalar& ng, const Scalar& omega, const Scalar& cv) const {
+    return cv*phi*(ng*omega*sg + ni*si + nl*sl);
+  }
 
   double DWaterContentDPorosity(double phi, double sl, double nl, double si, double ni, double sg, double ng, double omega, double cv) const;
   double DWaterContentDSaturationLiquid(double phi, double sl, double nl, double si, double ni, double sg, double ng, double omega, double cv) const;
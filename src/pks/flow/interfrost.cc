@@ -65,6 +65,7 @@ Interfrost::UpdatePreconditioner(double t,
   bc_pressure_->Compute(S_next_->time());
   bc_flux_->Compute(S_next_->time());
   UpdateBoundaryConditions_(S_next_.ptr());
+  ghost_exchange_->Complete();
 
   Teuchos::RCP<const CompositeVector> rel_perm =
       S_next_->GetFieldData(uw_coef_key_);
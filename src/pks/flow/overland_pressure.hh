@@ -80,6 +80,15 @@ Solves the diffusion wave equation for overland flow with pressure as a primary
     * `"min ponded depth for tidal bc`" ``[double]`` **0.02** Control on the
       tidal boundary condition.  TODO: This should live in the BC spec?
 
+    * `"mask upwinding to wet cells`" ``[bool]`` **false** If true, only
+      faces adjacent to wet cells are upwinded.  Cells are wet if their
+      ponded depth is positive, they have a positive source, or they are on
+      a boundary that brings in water.  All other faces have zero upwinded
+      conductivity, so the results are unchanged.  Cell velocities are also
+      only computed on the masked cells.  The conductivity evaluator, the
+      flux update, and the assembly of the residual and preconditioner still
+      visit every cell and face.
+
     INCLUDES:
 
     - ``[pk-physical-bdf-default-spec]`` A `PK: Physical and BDF`_ spec.
@@ -149,6 +158,8 @@ namespace Flow {
 
 class OverlandConductivityModel;
 class HeightModel;
+class OverlandWetMask;
+class BoundaryFacePlan;
 
 //class OverlandPressureFlow : public PKPhysicalBDFBase {
 class OverlandPressureFlow : public PK_PhysicalBDF_Default {
@@ -207,6 +218,7 @@ protected:
   virtual void SetupPhysicalEvaluators_(const Teuchos::Ptr<State>& S);
 
   // boundary condition members
+  void ComputeBoundaryConditions_(const Teuchos::Ptr<State>& S);
   virtual void UpdateBoundaryConditions_(const Teuchos::Ptr<State>& S);
   virtual void ApplyBoundaryConditions_(const Teuchos::Ptr<CompositeVector>& u,
           const Teuchos::Ptr<const CompositeVector>& elev);
@@ -222,6 +234,10 @@ protected:
   virtual bool UpdatePermeabilityDerivativeData_(const Teuchos::Ptr<State>& S);
   virtual bool UpdatePermeabilityData_(const Teuchos::Ptr<State>& S);
 
+  // -- tracks wet cells and restricts upwinding to their faces
+  void UpdateWetMask_(const Teuchos::Ptr<State>& S,
+                      const Teuchos::RCP<const CompositeVector>& pd);
+
   // physical methods
   // -- diffusion term
   void ApplyDiffusion_(const Teuchos::Ptr<State>& S,const Teuchos::Ptr<CompositeVector>& g);
@@ -319,6 +335,15 @@ protected:
   Teuchos::RCP<Functions::BoundaryFunction> bc_tidal_;
   Teuchos::RCP<Functions::DynamicBoundaryFunction> bc_dynamic_;
   Teuchos::RCP<Functions::BoundaryFunction> bc_level_flux_lvl_, bc_level_flux_vel_ ;
+  double bc_time_; // time at which the BC functions were last computed
+
+  // boundary faces and their cells
+  Teuchos::RCP<BoundaryFacePlan> bc_plan_;
+
+  // mask of wet cells for upwinding
+  Teuchos::RCP<OverlandWetMask> wet_mask_;
+  bool wet_mask_upwinding_;
+  Teuchos::RCP<CompositeVector> forced_wet_;  // 1 on cells forced wet
 
   // needed physical models
   Teuchos::RCP<Flow::OverlandConductivityModel> cond_model_;
@@ -5,6 +5,8 @@ This is the overland flow component of ATS.
 License: BSD
 Author: Ethan Coon (ecoon@lanl.gov)
 ----------------------------------------------------------------------------- */
+#include <limits>
+
 #include "Teuchos_LAPACK.hpp"
 #include "Teuchos_SerialDenseMatrix.hpp"
 
@@ -27,6 +29,8 @@ Author: Ethan Coon (ecoon@lanl.gov)
 #include "upwind_total_flux.hh"
 #include "UpwindFluxFactory.hh"
 
+#include "boundary_face_plan.hh"
+#include "overland_wet_mask.hh"
 #include "overland_pressure.hh"
 
 namespace Amanzi {
@@ -51,6 +55,7 @@ OverlandPressureFlow::OverlandPressureFlow(Teuchos::ParameterList& pk_tree,
     source_only_if_unfrozen_(false),
     precon_used_(true),
     precon_scaled_(false),
+    wet_mask_upwinding_(false),
     jacobian_(false),
     jacobian_lag_(0),
     iter_(0),
@@ -193,12 +198,27 @@ void OverlandPressureFlow::SetupOverlandFlow_(const Teuchos::Ptr<State>& S)
 
   bc_level_flux_lvl_ = bc_factory.CreateFixedLevelFlux_Level();
   bc_level_flux_vel_ = bc_factory.CreateFixedLevelFlux_Velocity();
+  bc_time_ = std::numeric_limits<double>::quiet_NaN();
+  bc_plan_ = Teuchos::rcp(new BoundaryFacePlan(mesh_));
 
   // -- nonlinear coefficients and upwinding
   Teuchos::ParameterList upwind_plist = plist_->sublist("upwinding");
   Operators::UpwindFluxFactory upwfactory;
   upwinding_ = upwfactory.Create(upwind_plist, name_, cond_key_, uw_cond_key_, flux_dir_key_);
 
+  // -- mask of wet cells for upwinding
+  if (plist_->get<bool>("mask upwinding to wet cells", false)) {
+    wet_mask_ = Teuchos::rcp(new OverlandWetMask(mesh_));
+    CompositeVectorSpace forced_space;
+    forced_space.SetMesh(mesh_)->SetGhosted()->SetComponent("cell", AmanziMesh::CELL, 1);
+    forced_wet_ = Teuchos::rcp(new CompositeVector(forced_space));
+    wet_mask_upwinding_ = upwinding_->set_active_faces(&wet_mask_->active_faces());
+    if (!wet_mask_upwinding_) {
+      if (vo_->os_OK(Teuchos::VERB_LOW))
+        *vo_->os() << "Upwind type does not support a mask, all faces will be upwinded." << std::endl;
+    }
+  }
+
   // -- require the data on appropriate locations
   std::string coef_location = upwinding_->CoefficientLocation();
   if (coef_location == "upwind: face") {
@@ -290,6 +310,8 @@ void OverlandPressureFlow::SetupOverlandFlow_(const Teuchos::Ptr<State>& S)
 
       upwinding_dkdp_ = Teuchos::rcp(new Operators::UpwindTotalFlux(name_,
               dcond_key_, duw_cond_key_, flux_dir_key_, 1.e-12));
+      if (wet_mask_ != Teuchos::null && wet_mask_upwinding_)
+        upwinding_dkdp_->set_active_faces(&wet_mask_->active_faces());
     }
   }
 
@@ -332,6 +354,7 @@ void OverlandPressureFlow::SetupOverlandFlow_(const Teuchos::Ptr<State>& S)
   // velocity for diagnostics
   S->RequireField(velocity_key_, name_)->SetMesh(mesh_)->SetGhosted()
       ->SetComponent("cell", AmanziMesh::CELL, 3);
+  diagnostic_keys_.push_back(velocity_key_); // flux is current after CommitStep()
 };
 
 
@@ -485,19 +508,7 @@ void OverlandPressureFlow::Initialize(const Teuchos::Ptr<State>& S)
   }
 
   // Initialize BC values
-  bc_head_->Compute(S->time());
-  bc_pressure_->Compute(S->time());
-  bc_zero_gradient_->Compute(S->time());
-  bc_flux_->Compute(S->time());
-  bc_level_->Compute(S->time());
-  bc_level_flux_lvl_->Compute(S->time());
-  bc_level_flux_vel_->Compute(S->time());
-
-  bc_seepage_head_->Compute(S->time());
-  bc_seepage_pressure_->Compute(S->time());
-  bc_critical_depth_->Compute(S->time());
-  bc_dynamic_->Compute(S->time());
-  bc_tidal_->Compute(S->time());
+  ComputeBoundaryConditions_(S);
 
   // Set extra fields as initialized -- these don't currently have evaluators.
   S->GetFieldData(uw_cond_key_,name_)->PutScalar(0.0);
@@ -536,18 +547,7 @@ void OverlandPressureFlow::CommitStep(double t_old, double t_new,
   PK_PhysicalBDF_Default::CommitStep(t_old, t_new, S);
 
   // update boundary conditions
-  bc_head_->Compute(S->time());
-  bc_pressure_->Compute(S->time());
-  bc_flux_->Compute(S->time());
-  bc_level_->Compute(S->time());
-  bc_level_flux_lvl_->Compute(S->time());
-  bc_level_flux_vel_->Compute(S->time());
-
-  bc_seepage_head_->Compute(S->time());
-  bc_seepage_pressure_->Compute(S->time());
-  bc_critical_depth_->Compute(S->time());
-  bc_dynamic_->Compute(S->time());
-  bc_tidal_->Compute(S->time());
+  ComputeBoundaryConditions_(S.ptr());
   UpdateBoundaryConditions_(S.ptr());
 
   // Update flux if rel perm or h + Z has changed.
@@ -612,9 +612,18 @@ void OverlandPressureFlow::CalculateDiagnostics(const Teuchos::RCP<State>& S)
   Teuchos::SerialDenseMatrix<int, double> matrix(d, d);
   double rhs[d];
 
+  // velocity is zero on cells too shallow for the calculation, which are
+  // skipped.  Every other cell is wet, so only the masked cells need be
+  // visited.
+  velocity.PutScalar(0.);
   int ncells_owned = mesh_->num_entities(AmanziMesh::CELL, AmanziMesh::Parallel_type::OWNED);
+  bool visit_active = wet_mask_ != Teuchos::null && min_vel_ponded_depth_ >= 0.;
+  int nvisit = visit_active ? wet_mask_->active_cells().size() : ncells_owned;
   AmanziMesh::Entity_ID_List faces;
-  for (int c=0; c!=ncells_owned; ++c) {
+  for (int i=0; i!=nvisit; ++i) {
+    int c = visit_active ? wet_mask_->active_cells()[i] : i;
+    if (!(pd_c[0][c] > min_vel_ponded_depth_)) continue;
+
     mesh_->cell_get_faces(c, &faces);
     int nfaces = faces.size();
 
@@ -639,7 +648,7 @@ void OverlandPressureFlow::CalculateDiagnostics(const Teuchos::RCP<State>& S)
     lapack.POSV('U', d, 1, matrix.values(), d, rhs, d, &info);
 
     // NOTE this is probably wrong in the frozen case?  pd --> uf*pd?
-    for (int i=0; i!=d; ++i) velocity[i][c] = pd_c[0][c] > min_vel_ponded_depth_ ? rhs[i] / (nliq_c[0][c] * pd_c[0][c]) : 0.;
+    for (int i=0; i!=d; ++i) velocity[i][c] = rhs[i] / (nliq_c[0][c] * pd_c[0][c]);
   }
 };
 
@@ -701,6 +710,9 @@ bool OverlandPressureFlow::UpdatePermeabilityData_(const Teuchos::Ptr<State>& S)
       uw_cond_f.Export(cond_bf, vandelay, Insert);
     }
 
+    // -- mask upwinding to faces of wet cells
+    if (wet_mask_ != Teuchos::null) UpdateWetMask_(S, pd);
+
     // -- upwind
     upwinding_->Update(S);
     uw_cond->ScatterMasterToGhosted("face");
@@ -712,6 +724,66 @@ bool OverlandPressureFlow::UpdatePermeabilityData_(const Teuchos::Ptr<State>& S)
 }
 
 
+// -----------------------------------------------------------------------------
+// Update the mask of wet cells.
+//
+//   Faces leaving the mask have their upwinded conductivity zeroed, as their
+//   cells are dry; upwinding then only updates faces of wet cells.
+// -----------------------------------------------------------------------------
+void OverlandPressureFlow::UpdateWetMask_(const Teuchos::Ptr<State>& S,
+        const Teuchos::RCP<const CompositeVector>& pd)
+{
+  auto& markers = bc_markers();
+  auto& values = bc_values();
+
+  // -- cells forced wet by boundary conditions that bring in water
+  forced_wet_->PutScalar(0.);
+  Epetra_MultiVector& forced_c = *forced_wet_->ViewComponent("cell",false);
+  const Epetra_MultiVector& elevation_f = *S->GetFieldData(elev_key_)->ViewComponent("face",false);
+  const auto& bfaces = wet_mask_->boundary_faces();
+  const auto& bface_cells = wet_mask_->boundary_face_cells();
+  for (int i=0; i!=bfaces.size(); ++i) {
+    int f = bfaces[i];
+    if ((markers[f] == Operators::OPERATOR_BC_DIRICHLET && values[f] - elevation_f[0][f] > 0.)
+        || (markers[f] == Operators::OPERATOR_BC_NEUMANN && values[f] != 0.)) {
+      forced_c[0][bface_cells[i]] = 1.;
+    }
+  }
+
+  // -- cells forced wet by sources
+  if (is_source_term_) {
+    S->GetFieldEvaluator(source_key_)->HasFieldChanged(S.ptr(), name_);
+    const Epetra_MultiVector& source = *S->GetFieldData(source_key_)->ViewComponent("cell",false);
+    for (int c=0; c!=source.MyLength(); ++c) {
+      if (source[0][c] > 0.) forced_c[0][c] = 1.;
+    }
+  }
+  if (coupled_to_subsurface_via_head_) {
+    S->GetFieldEvaluator(ss_flux_key_)->HasFieldChanged(S.ptr(), name_);
+    const Epetra_MultiVector& source = *S->GetFieldData(ss_flux_key_)->ViewComponent("cell",false);
+    for (int c=0; c!=source.MyLength(); ++c) {
+      if (source[0][c] > 0.) forced_c[0][c] = 1.;
+    }
+  }
+
+  // -- wetness of ghost cells is that of their owners
+  ghost_exchange_->Require(pd, "cell");
+  ghost_exchange_->Require(forced_wet_, "cell");
+  ghost_exchange_->Complete();
+  bool changed = wet_mask_->Update(*pd->ViewComponent("cell",true),
+          *forced_wet_->ViewComponent("cell",true));
+
+  if (changed && wet_mask_upwinding_) {
+    Epetra_MultiVector& uw_cond_f = *S->GetFieldData(uw_cond_key_, name_)->ViewComponent("face",false);
+    for (int f : wet_mask_->deactivated_faces()) uw_cond_f[0][f] = 0.;
+  }
+  if (changed && vo_->os_OK(Teuchos::VERB_HIGH)) {
+    *vo_->os() << "  Upwinding mask: " << wet_mask_->active_cells().size() << " cells, "
+               << wet_mask_->active_faces().size() << " faces" << std::endl;
+  }
+}
+
+
 // -----------------------------------------------------------------------------
 // Derivatives of the overland conductivity, upwinded.
 // -----------------------------------------------------------------------------
@@ -751,6 +823,28 @@ bool OverlandPressureFlow::UpdatePermeabilityDerivativeData_(const Teuchos::Ptr<
 // -----------------------------------------------------------------------------
 // Evaluate boundary conditions at the current time.
 // -----------------------------------------------------------------------------
+void OverlandPressureFlow::ComputeBoundaryConditions_(const Teuchos::Ptr<State>& S) {
+  // these depend only upon time, so are evaluated once per time, not once per
+  // nonlinear iteration
+  if (S->time() == bc_time_) return;
+  bc_time_ = S->time();
+
+  bc_head_->Compute(S->time());
+  bc_pressure_->Compute(S->time());
+  bc_zero_gradient_->Compute(S->time());
+  bc_flux_->Compute(S->time());
+  bc_level_->Compute(S->time());
+  bc_level_flux_lvl_->Compute(S->time());
+  bc_level_flux_vel_->Compute(S->time());
+
+  bc_seepage_head_->Compute(S->time());
+  bc_seepage_pressure_->Compute(S->time());
+  bc_critical_depth_->Compute(S->time());
+  bc_dynamic_->Compute(S->time());
+  bc_tidal_->Compute(S->time());
+}
+
+
 void OverlandPressureFlow::UpdateBoundaryConditions_(const Teuchos::Ptr<State>& S) {
   Teuchos::OSTab tab = vo_->getOSTab();
   if (vo_->os_OK(Teuchos::VERB_EXTREME))
@@ -763,11 +857,16 @@ void OverlandPressureFlow::UpdateBoundaryConditions_(const Teuchos::Ptr<State>&
   const Epetra_MultiVector& elevation = *S->GetFieldData(elev_key_)
       ->ViewComponent("face",false);
 
-  // initialize all as null
-  for (unsigned int n=0; n!=markers.size(); ++n) {
-    markers[n] = Operators::OPERATOR_BC_NONE;
-    values[n] = 0.0;
+  // initialize all as null -- the boundary faces and their cells are cached
+  // once, after which only boundary faces are reset
+  if (!bc_plan_->built()) {
+    for (unsigned int n=0; n!=markers.size(); ++n) {
+      markers[n] = Operators::OPERATOR_BC_NONE;
+      values[n] = 0.0;
+    }
+    bc_plan_->Build();
   }
+  bc_plan_->Reset(markers, values);
 
 
   // Dirichlet-type Boundary conditions
@@ -796,9 +895,7 @@ void OverlandPressureFlow::UpdateBoundaryConditions_(const Teuchos::Ptr<State>&
 
       for (const auto& bc : *bc_pressure_) {
         int f = bc.first;
-        AmanziMesh::Entity_ID_List cells;
-        mesh_->face_get_cells(f, AmanziMesh::Parallel_type::ALL, &cells);
-        int c = cells[0];
+        int c = bc_plan_->cell(f);
 
         double p0 = bc.second > p_atm ? bc.second : p_atm;
         double h0 = (p0 - p_atm) / ((eta[0][c]*rho_l[0][c] + (1.-eta[0][c])*rho_i[0][c]) * gz);
@@ -811,9 +908,7 @@ void OverlandPressureFlow::UpdateBoundaryConditions_(const Teuchos::Ptr<State>&
       // non-thermal model
       for (const auto& bc : *bc_pressure_) {
         int f = bc.first;
-        AmanziMesh::Entity_ID_List cells;
-        mesh_->face_get_cells(f, AmanziMesh::Parallel_type::ALL, &cells);
-        int c = cells[0];
+        int c = bc_plan_->cell(f);
 
         double p0 = bc.second > p_atm ? bc.second : p_atm;
         double h0 = (p0 - p_atm) / (rho_l[0][c] * gz);
@@ -884,9 +979,7 @@ void OverlandPressureFlow::UpdateBoundaryConditions_(const Teuchos::Ptr<State>&
 
     for (const auto& bc : *bc_critical_depth_) {
       int f = bc.first;
-      AmanziMesh::Entity_ID_List cells;
-      mesh_->face_get_cells(f, AmanziMesh::Parallel_type::ALL, &cells);
-      int c = cells[0];
+      int c = bc_plan_->cell(f);
 
       markers[f] = Operators::OPERATOR_BC_NEUMANN;
       values[f] = std::sqrt(gz) * std::pow(h_c[0][c], 1.5) * nliq_c[0][c];
@@ -907,9 +1000,7 @@ void OverlandPressureFlow::UpdateBoundaryConditions_(const Teuchos::Ptr<State>&
 
     for (const auto& bc : *bc_seepage_head_) {
       int f = bc.first;
-      AmanziMesh::Entity_ID_List cells;
-      mesh_->face_get_cells(f, AmanziMesh::Parallel_type::ALL, &cells);
-      int c = cells[0];
+      int c = bc_plan_->cell(f);
 
       double hz_f = bc.second + elevation[0][f];
       double hz_c = h_c[0][c] + elevation_c[0][c];
@@ -941,9 +1032,7 @@ void OverlandPressureFlow::UpdateBoundaryConditions_(const Teuchos::Ptr<State>&
 
       for (const auto& bc : *bc_seepage_pressure_) {
         int f = bc.first;
-        AmanziMesh::Entity_ID_List cells;
-        mesh_->face_get_cells(f, AmanziMesh::Parallel_type::ALL, &cells);
-        int c = cells[0];
+        int c = bc_plan_->cell(f);
 
         double p0 = bc.second > p_atm ? bc.second : p_atm;
         double h0 = (p0 - p_atm) / ((eta[0][c]*rho_l[0][c] + (1.-eta[0][c])*rho_i[0][c]) * gz);
@@ -962,9 +1051,7 @@ void OverlandPressureFlow::UpdateBoundaryConditions_(const Teuchos::Ptr<State>&
       // non-thermal model
       for (const auto& bc : *bc_seepage_pressure_) {
         int f = bc.first;
-        AmanziMesh::Entity_ID_List cells;
-        mesh_->face_get_cells(f, AmanziMesh::Parallel_type::ALL, &cells);
-        int c = cells[0];
+        int c = bc_plan_->cell(f);
 
         double p0 = bc.second > p_atm ? bc.second : p_atm;
         double h0 = (p0 - p_atm) / (rho_l[0][c] * gz);
@@ -1037,16 +1124,14 @@ void OverlandPressureFlow::UpdateBoundaryConditions_(const Teuchos::Ptr<State>&
   // conditions as the default, zero flux conditions
   int nfaces_owned = mesh_->num_entities(AmanziMesh::FACE, AmanziMesh::Parallel_type::OWNED);
   for (int f = 0; f != nfaces_owned; ++f) {
-    AmanziMesh::Entity_ID_List cells;
-    mesh_->face_get_cells(f, AmanziMesh::Parallel_type::ALL, &cells);
-    int ncells = cells.size();
+    bool boundary = bc_plan_->cell(f) >= 0;
 
-    if ((markers[f] != Operators::OPERATOR_BC_NONE) && (ncells == 2)) {
+    if ((markers[f] != Operators::OPERATOR_BC_NONE) && !boundary) {
       Errors::Message msg("Tried to set a boundary condition on internal face GID ");
       msg << mesh_->face_map(false).GID(f);
       Exceptions::amanzi_throw(msg);
     }
-    if ((markers[f] == Operators::OPERATOR_BC_NONE) && (ncells == 1)) {
+    if ((markers[f] == Operators::OPERATOR_BC_NONE) && boundary) {
         markers[f] = Operators::OPERATOR_BC_NEUMANN;
         values[f] = 0.0;
     }
@@ -1093,9 +1178,7 @@ OverlandPressureFlow::ApplyBoundaryConditions_(const Teuchos::Ptr<CompositeVecto
         //  this simply makes the upwinded conductivities make more sense, and
         //  changes no answers as boundary faces and their resulting
         //  conductivity are not used in Neumann conditions.
-        AmanziMesh::Entity_ID_List cells;
-        mesh_->face_get_cells(f, AmanziMesh::Parallel_type::ALL, &cells);
-        u_bf[0][bf] = u_c[0][cells[0]];
+        u_bf[0][bf] = u_c[0][bc_plan_->cell(f)];
       }
     }
   }
@@ -1138,10 +1221,8 @@ void OverlandPressureFlow::FixBCsForOperator_(const Teuchos::Ptr<State>& S,
     for (const auto& bc : *bc_zero_gradient_) {
       int f = bc.first;
 
-      AmanziMesh::Entity_ID_List cells;
-      mesh_->face_get_cells(f, AmanziMesh::Parallel_type::ALL, &cells);
-      AMANZI_ASSERT(cells.size() == 1);
-      AmanziMesh::Entity_ID c = cells[0];
+      AmanziMesh::Entity_ID c = bc_plan_->cell(f);
+      AMANZI_ASSERT(c >= 0);
 
       if (f < nfaces_owned) {
         double dp = elevation_f[0][f] - elevation_c[0][c];
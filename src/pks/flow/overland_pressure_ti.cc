@@ -88,17 +88,7 @@ void OverlandPressureFlow::FunctionalResidual( double t_old,
   db_->WriteVectors(vnames, vecs, true);
 
   // update boundary conditions
-  bc_head_->Compute(S_next_->time());
-  bc_pressure_->Compute(S_next_->time());
-  bc_zero_gradient_->Compute(S_next_->time());
-  bc_flux_->Compute(S_next_->time());
-  bc_level_->Compute(S_next_->time());
-  bc_seepage_head_->Compute(S_next_->time());
-  bc_seepage_pressure_->Compute(S_next_->time());
-  bc_critical_depth_->Compute(S_next_->time());
-  bc_dynamic_->Compute(S_next_->time());
-  bc_tidal_->Compute(S_next_->time());
-
+  ComputeBoundaryConditions_(S_next_.ptr());
   UpdateBoundaryConditions_(S_next_.ptr());
 
   // diffusion term, treated implicitly
@@ -0,0 +1,108 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+*/
+
+#include "dbc.hh"
+
+#include "overland_wet_mask.hh"
+
+namespace Amanzi {
+namespace Flow {
+
+OverlandWetMask::OverlandWetMask(const Teuchos::RCP<const AmanziMesh::Mesh>& mesh) :
+    mesh_(mesh),
+    initialized_(false)
+{
+  ncells_owned_ = mesh_->num_entities(AmanziMesh::CELL, AmanziMesh::Parallel_type::OWNED);
+  ncells_wghost_ = mesh_->num_entities(AmanziMesh::CELL, AmanziMesh::Parallel_type::ALL);
+  nfaces_owned_ = mesh_->num_entities(AmanziMesh::FACE, AmanziMesh::Parallel_type::OWNED);
+  int nfaces_wghost = mesh_->num_entities(AmanziMesh::FACE, AmanziMesh::Parallel_type::ALL);
+
+  // cache the topology
+  cell_face_offsets_.resize(ncells_wghost_ + 1, 0);
+  face_cells_.assign(2 * nfaces_wghost, -1);
+  AmanziMesh::Entity_ID_List faces;
+  for (int c=0; c!=ncells_wghost_; ++c) {
+    mesh_->cell_get_faces(c, &faces);
+    for (int f : faces) {
+      int k = face_cells_[2*f] < 0 ? 0 : 1;
+      AMANZI_ASSERT(face_cells_[2*f+k] < 0);
+      face_cells_[2*f+k] = c;
+    }
+    cell_faces_.insert(cell_faces_.end(), faces.begin(), faces.end());
+    cell_face_offsets_[c+1] = cell_faces_.size();
+  }
+
+  // owned faces have all their cells in the ghosted mesh, so those with one
+  // cell are on the boundary
+  for (int f=0; f!=nfaces_owned_; ++f) {
+    if (face_cells_[2*f+1] < 0) {
+      boundary_faces_.push_back(f);
+      boundary_face_cells_.push_back(face_cells_[2*f]);
+    }
+  }
+
+  wet_.assign(ncells_wghost_, 0);
+  nwet_.assign(ncells_wghost_, 0);
+
+  // all faces start active, so that the first update deactivates dry faces
+  face_active_.assign(nfaces_owned_, 1);
+}
+
+
+bool
+OverlandWetMask::Update(const Epetra_MultiVector& depth, const Epetra_MultiVector& forced)
+{
+  AMANZI_ASSERT(depth.MyLength() == ncells_wghost_);
+  AMANZI_ASSERT(forced.MyLength() == ncells_wghost_);
+
+  bool changed = !initialized_;
+  for (int c=0; c!=ncells_wghost_; ++c) {
+    char wet = (forced[0][c] > 0. || depth[0][c] > 0.) ? 1 : 0;
+    if (wet != wet_[c]) {
+      AddWet_(c, wet ? 1 : -1);
+      wet_[c] = wet;
+      changed = true;
+    }
+  }
+
+  initialized_ = true;
+  if (!changed) return false;
+
+  active_cells_.clear();
+  for (int c=0; c!=ncells_owned_; ++c) {
+    if (nwet_[c] > 0) active_cells_.push_back(c);
+  }
+
+  active_faces_.clear();
+  deactivated_faces_.clear();
+  for (int f=0; f!=nfaces_owned_; ++f) {
+    int c1 = face_cells_[2*f+1];
+    char face_active = wet_[face_cells_[2*f]] || (c1 >= 0 && wet_[c1]);
+    if (face_active) {
+      active_faces_.push_back(f);
+    } else if (face_active_[f]) {
+      deactivated_faces_.push_back(f);
+    }
+    face_active_[f] = face_active;
+  }
+  return true;
+}
+
+
+void
+OverlandWetMask::AddWet_(int c, int delta)
+{
+  nwet_[c] += delta;
+  for (int i=cell_face_offsets_[c]; i!=cell_face_offsets_[c+1]; ++i) {
+    int f = cell_faces_[i];
+    int n = face_cells_[2*f] == c ? face_cells_[2*f+1] : face_cells_[2*f];
+    if (n >= 0) nwet_[n] += delta;
+  }
+}
+
+}  // namespace Flow
+}  // namespace Amanzi
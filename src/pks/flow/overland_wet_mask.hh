@@ -0,0 +1,89 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+//! Masks overland upwinding to the faces of wet cells.
+
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+*/
+
+/*!
+
+Manning conductivity vanishes with the ponded depth, so a face with no wet
+cell on either side has zero upwinded conductivity.  The mask is the set of
+wet cells (positive ponded depth), cells forced to be wet (e.g. by a source
+or a boundary condition), and their face neighbors, and the faces with a wet
+cell on either side.  Upwinding need only update the masked faces; every
+other face keeps a zero upwinded conductivity, so the mask does not change
+the solution.
+
+The mask is updated incrementally: a count of wet cells among each cell and
+its neighbors is kept, and only cells whose wetness changed update the
+counts of their neighbors.  The lists of masked cells and faces are rebuilt
+only when the mask changes.  Wetness is evaluated on ghosted cells, so that
+the halo is correct across process boundaries.
+
+*/
+
+#ifndef PK_FLOW_OVERLAND_WET_MASK_HH_
+#define PK_FLOW_OVERLAND_WET_MASK_HH_
+
+#include <vector>
+
+#include "Teuchos_RCP.hpp"
+#include "Epetra_MultiVector.h"
+
+#include "Mesh.hh"
+
+namespace Amanzi {
+namespace Flow {
+
+class OverlandWetMask {
+ public:
+  explicit OverlandWetMask(const Teuchos::RCP<const AmanziMesh::Mesh>& mesh);
+
+  // Updates the mask given the ghosted ponded depth on cells.  Cells where
+  // the ghosted forced is positive are treated as wet.  Returns true if the
+  // mask changed.
+  bool Update(const Epetra_MultiVector& depth, const Epetra_MultiVector& forced);
+
+  bool active(int c) const { return nwet_[c] > 0; }
+
+  // owned cells in the mask
+  const std::vector<int>& active_cells() const { return active_cells_; }
+
+  // owned faces with a wet cell on either side
+  const std::vector<int>& active_faces() const { return active_faces_; }
+
+  // owned faces that left the mask in the last change
+  const std::vector<int>& deactivated_faces() const { return deactivated_faces_; }
+
+  // owned boundary faces and their cells
+  const std::vector<int>& boundary_faces() const { return boundary_faces_; }
+  const std::vector<int>& boundary_face_cells() const { return boundary_face_cells_; }
+
+ private:
+  void AddWet_(int c, int delta);
+
+ private:
+  Teuchos::RCP<const AmanziMesh::Mesh> mesh_;
+  int ncells_owned_, ncells_wghost_, nfaces_owned_;
+  bool initialized_;
+
+  // topology -- faces of each ghosted cell, cells of each ghosted face
+  std::vector<int> cell_face_offsets_, cell_faces_;
+  std::vector<int> face_cells_;
+
+  std::vector<int> boundary_faces_, boundary_face_cells_;
+
+  // state
+  std::vector<char> wet_;
+  std::vector<int> nwet_;
+  std::vector<char> face_active_;
+  std::vector<int> active_cells_, active_faces_, deactivated_faces_;
+};
+
+}  // namespace Flow
+}  // namespace Amanzi
+
+#endif
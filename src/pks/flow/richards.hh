@@ -218,6 +218,8 @@ namespace WhetStone { class Tensor; }
 
 namespace Flow {
 
+class BoundaryFacePlan;
+
 class Richards : public PK_PhysicalBDF_Default {
 
 public:
@@ -275,6 +277,8 @@ protected:
   // boundary condition members
   void ComputeBoundaryConditions_(const Teuchos::Ptr<State>& S);
   virtual void UpdateBoundaryConditions_(const Teuchos::Ptr<State>& S, bool kr=true);
+  // -- caches the mesh data used in updating BCs, rebuilt if the mesh deforms
+  void UpdateBoundaryConditionPlan_(const Teuchos::Ptr<State>& S);
 
   // -- builds tensor K, along with faced-based Krel if needed by the rel-perm method
   virtual void SetAbsolutePermeabilityTensor_(const Teuchos::Ptr<State>& S);
@@ -379,6 +383,13 @@ protected:
   bool bc_seepage_infilt_explicit_;
   Teuchos::RCP<Functions::BoundaryFunction> bc_infiltration_;
   double bc_rho_water_;
+  double bc_time_; // time at which the BC functions were last computed
+
+  // boundary condition plan -- boundary faces, their cells, and geometry
+  Teuchos::RCP<BoundaryFacePlan> bc_plan_;
+  bool bc_head_used_; // head BCs require columns
+  std::vector<int> bc_surf_head_faces_, bc_surf_flux_faces_; // by surface cell
+  std::vector<double> bc_surf_flux_areas_;
 
   // delegates
   bool modify_predictor_bc_flux_;
@@ -27,11 +27,16 @@ void Richards::ApplyDiffusion_(const Teuchos::Ptr<State>& S,
   // update the rel perm according to the scheme of choice
   bool update = UpdatePermeabilityData_(S.ptr());
 
+  // ghost rel perm is in flight while density is evaluated
+  ghost_exchange_->Begin();
+
   // update the matrix
   matrix_->Init();
 
   S->GetFieldEvaluator(mass_dens_key_)->HasFieldChanged(S, name_);
   matrix_diff_->SetDensity(S->GetFieldData(mass_dens_key_));
+
+  ghost_exchange_->Complete();
   matrix_diff_->SetScalarCoefficient(S->GetFieldData(uw_coef_key_), Teuchos::null);
 
   Teuchos::RCP<const CompositeVector> pres = S->GetFieldData(key_, name_);
@@ -7,6 +7,8 @@ Authors: Neil Carlson (version 1)
          Konstantin Lipnikov (version 2) (lipnikov@lanl.gov)
          Ethan Coon (ATS version) (ecoon@lanl.gov)
 ------------------------------------------------------------------------- */
+#include <limits>
+
 #include "boost/math/special_functions/fpclassify.hpp"
 
 #include "boost/algorithm/string/predicate.hpp"
@@ -32,6 +34,7 @@ Authors: Neil Carlson (version 1)
 #include "OperatorDefs.hh"
 #include "BoundaryFlux.hh"
 #include "pk_helpers.hh"
+#include "boundary_face_plan.hh"
 
 #include "richards.hh"
 
@@ -129,6 +132,9 @@ void Richards::SetupRichardsFlow_(const Teuchos::Ptr<State>& S)
     bc_factory.CreateSeepageFacePressureWithInfiltration();
   bc_seepage_infilt_->Compute(0.); // compute at t=0 to set up
   bc_rho_water_ = bc_plist.get<double>("hydrostatic water density [kg m^-3]",1000.);
+  bc_time_ = std::numeric_limits<double>::quiet_NaN();
+  bc_plan_ = Teuchos::rcp(new BoundaryFacePlan(mesh_));
+  bc_head_used_ = bc_plist.isSublist("head");
 
   // scaling for permeability
   perm_scale_ = plist_->get<double>("permeability rescaling", 1.e7);
@@ -373,6 +379,7 @@ void Richards::SetupRichardsFlow_(const Teuchos::Ptr<State>& S)
   // -- also need a velocity, but only for vis/diagnostics
   S->RequireField(velocity_key_, name_)->SetMesh(mesh_)->SetGhosted()
                                 ->SetComponent("cell", AmanziMesh::CELL, 3);
+  diagnostic_keys_.push_back(velocity_key_); // flux is current after CommitStep()
 
   // Globalization and other timestep control flags
   // -- predictors
@@ -670,6 +677,7 @@ void Richards::CommitStep(double t_old, double t_new, const Teuchos::RCP<State>&
   // update BCs, rel perm
   UpdateBoundaryConditions_(S.ptr());
   bool update = UpdatePermeabilityData_(S.ptr());
+  ghost_exchange_->Complete();
   update |= S->GetFieldEvaluator(key_)->HasFieldChanged(S.ptr(), name_);
   update |= S->GetFieldEvaluator(mass_dens_key_)->HasFieldChanged(S.ptr(), name_);
 
@@ -909,8 +917,9 @@ bool Richards::UpdatePermeabilityData_(const Teuchos::Ptr<State>& S)
       }
     }
 
+    // ghosts are updated at the caller's completion point
     if (uw_rel_perm->HasComponent("face"))
-      uw_rel_perm->ScatterMasterToGhosted("face");
+      ghost_exchange_->Require(uw_rel_perm, "face");
   }
 
   // debugging
@@ -938,9 +947,9 @@ bool Richards::UpdatePermeabilityDerivativeData_(const Teuchos::Ptr<State>& S)
       // Upwind, only overwriting boundary faces if the wind says to do so.
       upwinding_deriv_->Update(S);
 
-      duw_rel_perm->ScatterMasterToGhosted("face");
+      ghost_exchange_->Require(duw_rel_perm, "face");
     } else {
-      drel_perm->ScatterMasterToGhosted("cell");
+      ghost_exchange_->Require(drel_perm, "cell");
     }
   }
 
@@ -954,9 +963,15 @@ bool Richards::UpdatePermeabilityDerivativeData_(const Teuchos::Ptr<State>& S)
 
 // -----------------------------------------------------------------------------
 // Compute boundary condition functions at the current time.
+//
+//   These depend only upon time, so are evaluated once per time, not once per
+//   nonlinear iteration.
 // -----------------------------------------------------------------------------
 void Richards::ComputeBoundaryConditions_(const Teuchos::Ptr<State>& S)
 {
+  if (S->time() == bc_time_) return;
+  bc_time_ = S->time();
+
   bc_pressure_->Compute(S->time());
   bc_head_->Compute(S->time());
   bc_level_->Compute(S->time());
@@ -966,6 +981,57 @@ void Richards::ComputeBoundaryConditions_(const Teuchos::Ptr<State>& S)
 }
 
 
+// -----------------------------------------------------------------------------
+// Cache the boundary faces and the mesh data used in pushing BCs.
+//
+//   This is done once, and again only if the mesh deforms.
+// -----------------------------------------------------------------------------
+void Richards::UpdateBoundaryConditionPlan_(const Teuchos::Ptr<State>& S)
+{
+  bool rebuild = !bc_plan_->built();
+  if (dynamic_mesh_) {
+    Key deformation_key = Keys::getKey(domain_, "deformation");
+    rebuild |= !S->HasFieldEvaluator(deformation_key) ||
+      S->GetFieldEvaluator(deformation_key)->HasFieldChanged(S, name_+" bc plan");
+  }
+  if (!rebuild) return;
+
+  if (!bc_plan_->built()) {
+    // the first update clears all faces, later updates only the boundary
+    auto& markers = bc_markers();
+    auto& values = bc_values();
+    for (unsigned int n=0; n!=markers.size(); ++n) {
+      markers[n] = Operators::OPERATOR_BC_NONE;
+      values[n] = 0.0;
+    }
+  }
+  bc_plan_->Build();
+  bc_plan_->BuildGeometry(bc_head_used_);
+
+  // faces coupled to the surface, by surface cell
+  bc_surf_head_faces_.clear();
+  if (coupled_to_surface_via_head_) {
+    Teuchos::RCP<const AmanziMesh::Mesh> surface = S->GetMesh("surface");
+    int ncells_surface = surface->num_entities(AmanziMesh::CELL, AmanziMesh::Parallel_type::OWNED);
+    for (int c=0; c!=ncells_surface; ++c) {
+      bc_surf_head_faces_.push_back(surface->entity_get_parent(AmanziMesh::CELL, c));
+    }
+  }
+
+  bc_surf_flux_faces_.clear();
+  bc_surf_flux_areas_.clear();
+  if (coupled_to_surface_via_flux_) {
+    Teuchos::RCP<const AmanziMesh::Mesh> surface = S->GetMesh(Keys::getDomain(ss_flux_key_));
+    int ncells_surface = surface->num_entities(AmanziMesh::CELL, AmanziMesh::Parallel_type::OWNED);
+    for (int c=0; c!=ncells_surface; ++c) {
+      AmanziMesh::Entity_ID f = surface->entity_get_parent(AmanziMesh::CELL, c);
+      bc_surf_flux_faces_.push_back(f);
+      bc_surf_flux_areas_.push_back(mesh_->face_area(f));
+    }
+  }
+}
+
+
 // -----------------------------------------------------------------------------
 // Push boundary conditions into the global array.
 // -----------------------------------------------------------------------------
@@ -978,11 +1044,9 @@ void Richards::UpdateBoundaryConditions_(const Teuchos::Ptr<State>& S, bool kr)
   auto& markers = bc_markers();
   auto& values = bc_values();
 
-  // initialize all to 0
-  for (unsigned int n=0; n!=markers.size(); ++n) {
-    markers[n] = Operators::OPERATOR_BC_NONE;
-    values[n] = 0.0;
-  }
+  // initialize all boundary faces to 0
+  UpdateBoundaryConditionPlan_(S);
+  bc_plan_->Reset(markers, values);
 
   // count for debugging
   std::vector<int> bc_counts;
@@ -1011,26 +1075,18 @@ void Richards::UpdateBoundaryConditions_(const Teuchos::Ptr<State>& S, bool kr)
     double p_atm = *S->GetScalarData("atmospheric_pressure");
     int z_index = mesh_->space_dimension() - 1;
     double g = -(*S->GetConstantVectorData("gravity"))[z_index];
+    AMANZI_ASSERT(bc_head_used_);
 
     for (const auto& bc : *bc_head_) {
       int f = bc.first;
 
-      AmanziMesh::Entity_ID_List cells;
-      mesh_->face_get_cells(f, AmanziMesh::Parallel_type::ALL, &cells);
-      AMANZI_ASSERT(cells.size() == 1);
-
       // we need to find the elevation of the surface, but finding the top edge
       // of this stack of faces is not possible currently.  The best approach
-      // is instead to work with the cell.
-      int col = mesh_->column_ID(cells[0]);
-      double z_surf = mesh_->face_centroid(mesh_->faces_of_column(col)[0])[z_index];
-      double z_wt = bc.second + z_surf;
-
+      // is instead to work with the cell.  Note, here the cell centroid's z
+      // is used to relate to the column's top face centroid, specifically NOT
+      // the boundary face's centroid.
       markers[f] = Operators::OPERATOR_BC_DIRICHLET;
-      // note, here the cell centroid's z is used to relate to the column's top
-      // face centroid, specifically NOT the boundary face's centroid.
-      values[f] = p_atm + bc_rho_water_ * g *
-        (z_wt - mesh_->cell_centroid(cells[0])[z_index]);
+      values[f] = p_atm + bc_rho_water_ * g * (bc.second + bc_plan_->head_dz(f));
     }
   }
 
@@ -1045,8 +1101,7 @@ void Richards::UpdateBoundaryConditions_(const Teuchos::Ptr<State>& S, bool kr)
     for (const auto& bc : *bc_level_) {
       int f = bc.first;
       markers[f] = Operators::OPERATOR_BC_DIRICHLET;
-      values[f] = p_atm + bc_rho_water_ * g *
-        (bc.second - mesh_->face_centroid(f)[z_index]);
+      values[f] = p_atm + bc_rho_water_ * g * (bc.second - bc_plan_->elevation(f));
     }
   }
 
@@ -1093,7 +1148,9 @@ void Richards::UpdateBoundaryConditions_(const Teuchos::Ptr<State>& S, bool kr)
   }
 
   // seepage face -- pressure <= specified value (usually 101325), outward mass flux >= 0
-  S->GetFieldData(flux_key_)->ScatterMasterToGhosted("face");
+  // completes, in the same message round, any ghosts required by the caller
+  ghost_exchange_->Require(S->GetFieldData(flux_key_), "face");
+  ghost_exchange_->Complete();
   const Epetra_MultiVector& flux = *S->GetFieldData(flux_key_)->ViewComponent("face", true);
 
   const double& p_atm = *S->GetScalarData("atmospheric_pressure");
@@ -1111,7 +1168,7 @@ void Richards::UpdateBoundaryConditions_(const Teuchos::Ptr<State>& S, bool kr)
 #endif
 
     double boundary_pressure = std::max(getFaceOnBoundaryValue(f, *u, *bc_), 101325.); // does not make sense to seep from nonsaturated cells
-    double boundary_flux = flux[0][f]*getBoundaryDirection(*mesh_, f);
+    double boundary_flux = flux[0][f]*bc_plan_->direction(f);
     if (boundary_pressure > bc.second) {
       markers[f] = Operators::OPERATOR_BC_DIRICHLET;
       values[f] = bc.second;
@@ -1150,7 +1207,7 @@ void Richards::UpdateBoundaryConditions_(const Teuchos::Ptr<State>& S, bool kr)
 
     double flux_seepage_tol = std::abs(bc.second) * .001;
     double boundary_pressure = getFaceOnBoundaryValue(f, *u, *bc_);
-    double boundary_flux = flux[0][f]*getBoundaryDirection(*mesh_, f);
+    double boundary_flux = flux[0][f]*bc_plan_->direction(f);
 
     if (i == 0)
       std::cout << "BFlux = " << boundary_flux << " with constraint = " << bc.second - flux_seepage_tol << std::endl;
@@ -1161,7 +1218,7 @@ void Richards::UpdateBoundaryConditions_(const Teuchos::Ptr<State>& S, bool kr)
       markers[f] = Operators::OPERATOR_BC_DIRICHLET;
       values[f] = p_atm;
       if (i == 0)
-        std::cout << "BC PRESSURE ON SEEPAGE = " << boundary_pressure << " with flux " << flux[0][f]*getBoundaryDirection(*mesh_, f) << " resulted in DIRICHLET pressure " << p_atm << std::endl;
+        std::cout << "BC PRESSURE ON SEEPAGE = " << boundary_pressure << " with flux " << boundary_flux << " resulted in DIRICHLET pressure " << p_atm << std::endl;
 
     } else if (boundary_flux >= bc.second - flux_seepage_tol &&
         boundary_pressure > p_atm - seepage_tol) {
@@ -1169,7 +1226,7 @@ void Richards::UpdateBoundaryConditions_(const Teuchos::Ptr<State>& S, bool kr)
       markers[f] = Operators::OPERATOR_BC_DIRICHLET;
       values[f] = p_atm;
     if (i == 0)
-      std::cout << "BC PRESSURE ON SEEPAGE = " << boundary_pressure << " with flux " << flux[0][f]*getBoundaryDirection(*mesh_, f) << " resulted in DIRICHLET pressure " << p_atm << std::endl;
+      std::cout << "BC PRESSURE ON SEEPAGE = " << boundary_pressure << " with flux " << boundary_flux << " resulted in DIRICHLET pressure " << p_atm << std::endl;
 
     } else if (boundary_flux < bc.second - flux_seepage_tol &&
         boundary_pressure <= p_atm + seepage_tol) {
@@ -1177,7 +1234,7 @@ void Richards::UpdateBoundaryConditions_(const Teuchos::Ptr<State>& S, bool kr)
       markers[f] = Operators::OPERATOR_BC_NEUMANN;
       values[f] = bc.second;
     if (i == 0)
-      std::cout << "BC PRESSURE ON SEEPAGE = " << boundary_pressure << " with flux " << flux[0][f]*getBoundaryDirection(*mesh_, f) << " resulted in NEUMANN flux " << bc.second << std::endl;
+      std::cout << "BC PRESSURE ON SEEPAGE = " << boundary_pressure << " with flux " << boundary_flux << " resulted in NEUMANN flux " << bc.second << std::endl;
 
     } else if (boundary_flux >= bc.second - flux_seepage_tol &&
         boundary_pressure <= p_atm - seepage_tol) {
@@ -1185,7 +1242,7 @@ void Richards::UpdateBoundaryConditions_(const Teuchos::Ptr<State>& S, bool kr)
       markers[f] = Operators::OPERATOR_BC_NEUMANN;
       values[f] = bc.second;
     if (i == 0)
-      std::cout << "BC PRESSURE ON SEEPAGE = " << boundary_pressure << " with flux " << flux[0][f]*getBoundaryDirection(*mesh_, f) << " resulted in NEUMANN flux " << bc.second << std::endl;
+      std::cout << "BC PRESSURE ON SEEPAGE = " << boundary_pressure << " with flux " << boundary_flux << " resulted in NEUMANN flux " << bc.second << std::endl;
 
     } else {
       AMANZI_ASSERT(0);
@@ -1200,16 +1257,16 @@ void Richards::UpdateBoundaryConditions_(const Teuchos::Ptr<State>& S, bool kr)
 
   if (coupled_to_surface_via_head_) {
     // Face is Dirichlet with value of surface head
-    Teuchos::RCP<const AmanziMesh::Mesh> surface = S->GetMesh("surface");
     const Epetra_MultiVector& head = *S->GetFieldData("surface_pressure")
         ->ViewComponent("cell",false);
 
     unsigned int ncells_surface = head.MyLength();
     bc_counts[bc_counts.size()-1] = ncells_surface;
+    AMANZI_ASSERT(bc_surf_head_faces_.size() == ncells_surface);
 
     for (unsigned int c=0; c!=ncells_surface; ++c) {
       // -- get the surface cell's equivalent subsurface face
-      AmanziMesh::Entity_ID f = surface->entity_get_parent(AmanziMesh::CELL, c);
+      AmanziMesh::Entity_ID f = bc_surf_head_faces_[c];
 #ifdef ENABLE_DBC
       AmanziMesh::Entity_ID_List cells;
       mesh_->face_get_cells(f, AmanziMesh::Parallel_type::ALL, &cells);
@@ -1226,13 +1283,13 @@ void Richards::UpdateBoundaryConditions_(const Teuchos::Ptr<State>& S, bool kr)
   bc_names.push_back("surface coupling (flux)");
   if (coupled_to_surface_via_flux_) {
     // Face is Neumann with value of surface residual
-    Teuchos::RCP<const AmanziMesh::Mesh> surface = S->GetMesh(Keys::getDomain(ss_flux_key_));
     const Epetra_MultiVector& ss_flux = *S->GetFieldData(ss_flux_key_)->ViewComponent("cell",false);
     unsigned int ncells_surface = ss_flux.MyLength();
     bc_counts[bc_counts.size()-1] = ncells_surface;
+    AMANZI_ASSERT(bc_surf_flux_faces_.size() == ncells_surface);
     for (unsigned int c=0; c!=ncells_surface; ++c) {
       // -- get the surface cell's equivalent subsurface face
-      AmanziMesh::Entity_ID f = surface->entity_get_parent(AmanziMesh::CELL, c);
+      AmanziMesh::Entity_ID f = bc_surf_flux_faces_[c];
 #ifdef ENABLE_DBC
       AmanziMesh::Entity_ID_List cells;
       mesh_->face_get_cells(f, AmanziMesh::Parallel_type::ALL, &cells);
@@ -1245,26 +1302,21 @@ void Richards::UpdateBoundaryConditions_(const Teuchos::Ptr<State>& S, bool kr)
       //       as Neumann BCs are in units of mols / s / A.  The right A must
       //       be chosen, as it is the subsurface mesh's face area, not the
       //       surface mesh's cell area.
-      values[f] = ss_flux[0][c] / mesh_->face_area(f);
+      values[f] = ss_flux[0][c] / bc_surf_flux_areas_[c];
 
       if (!kr && rel_perm[0][f] > 0.) values[f] /= rel_perm[0][f];
     }
   }
 
   // mark all remaining boundary conditions as zero flux conditions
-  AmanziMesh::Entity_ID_List cells;
   int n_default = 0;
-  int nfaces_owned = mesh_->num_entities(AmanziMesh::FACE, AmanziMesh::Parallel_type::OWNED);
-  for (int f = 0; f < nfaces_owned; f++) {
+  const auto& boundary_faces = bc_plan_->faces();
+  for (int i = 0; i != bc_plan_->nfaces_owned(); ++i) {
+    int f = boundary_faces[i];
     if (markers[f] == Operators::OPERATOR_BC_NONE) {
-      mesh_->face_get_cells(f, AmanziMesh::Parallel_type::ALL, &cells);
-      int ncells = cells.size();
-
-      if (ncells == 1) {
-        n_default++;
-        markers[f] = Operators::OPERATOR_BC_NEUMANN;
-        values[f] = 0.0;
-      }
+      n_default++;
+      markers[f] = Operators::OPERATOR_BC_NEUMANN;
+      values[f] = 0.0;
     }
   }
   bc_names.push_back("default (zero flux)");
@@ -1334,6 +1386,7 @@ bool Richards::ModifyPredictorFluxBCs_(double h, Teuchos::RCP<TreeVector> u)
   }
 
   UpdatePermeabilityData_(S_next_.ptr());
+  ghost_exchange_->Complete();
   Teuchos::RCP<const CompositeVector> rel_perm =
     S_next_->GetFieldData(uw_coef_key_);
 
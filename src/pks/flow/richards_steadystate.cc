@@ -1,4 +1,11 @@
+#include <cmath>
+#include <deque>
+
 #include "EpetraExt_RowMatrixOut.h"
+#include "Teuchos_SerialDenseMatrix.hpp"
+#include "Teuchos_SerialDenseSolver.hpp"
+#include "Teuchos_Time.hpp"
+
 #include "richards_steadystate.hh"
 
 namespace Amanzi {
@@ -13,13 +20,169 @@ namespace Flow {
                                            const Teuchos::RCP<State>& S,
                                            const Teuchos::RCP<TreeVector>& solution) :
     PK(pk_tree, glist, S, solution),
-    Richards(pk_tree, glist, S, solution) {}
+    Richards(pk_tree, glist, S, solution),
+    ptc_(false),
+    pseudo_dt_(0.) {}
 
 void RichardsSteadyState::Setup(const Teuchos::Ptr<State>& S) {
   max_iters_ = plist_->sublist("time integrator").get<int>("max iterations", 10);
+
+  ptc_ = plist_->isSublist("pseudo-transient continuation");
+  if (ptc_) {
+    Teuchos::ParameterList& ptc_list = plist_->sublist("pseudo-transient continuation");
+    ptc_dt_init_ = ptc_list.get<double>("initial pseudo time step [s]", 86400.);
+    ptc_dt_max_ = ptc_list.get<double>("maximum pseudo time step [s]", 1.e10);
+    ptc_ser_exponent_ = ptc_list.get<double>("SER exponent", 1.);
+    ptc_growth_max_ = ptc_list.get<double>("maximum growth factor", 10.);
+    ptc_depth_ = ptc_list.get<int>("Anderson depth", 3);
+    ptc_max_its_ = ptc_list.get<int>("maximum iterations", 500);
+    ptc_tol_ = ptc_list.get<double>("tolerance", 1.);
+  }
   Richards::Setup(S);
 }
 
+
+// -----------------------------------------------------------------------------
+// Advance to steady state.
+// -----------------------------------------------------------------------------
+bool RichardsSteadyState::AdvanceStep(double t_old, double t_new, bool reinit) {
+  if (ptc_) return AdvanceStepPseudoTransient_(t_old, t_new);
+  return Richards::AdvanceStep(t_old, t_new, reinit);
+}
+
+
+// -----------------------------------------------------------------------------
+// Solve for steady state by pseudo-transient continuation, with SER growth of
+// the pseudo time step and Anderson mixing of the corrections.
+//
+// Following the time integrator's convention, the correction du is
+// subtracted: each iteration maps u to q = u - du, and Anderson mixing seeks
+// a fixed point of that map.
+// -----------------------------------------------------------------------------
+bool RichardsSteadyState::AdvanceStepPseudoTransient_(double t_old, double t_new) {
+  Teuchos::OSTab tab = vo_->getOSTab();
+  Teuchos::Time timer("pseudo-transient continuation", true);
+
+  if (vo_->os_OK(Teuchos::VERB_LOW))
+    *vo_->os() << "----------------------------------------------------------------" << std::endl
+               << "Pseudo-transient solve to steady state at t = " << t_new << std::endl
+               << "----------------------------------------------------------------" << std::endl;
+
+  State_to_Solution(S_next_, *solution_);
+  Teuchos::RCP<TreeVector> u = solution_;
+  Teuchos::RCP<TreeVector> res = Teuchos::rcp(new TreeVector(*u));
+  Teuchos::RCP<TreeVector> du = Teuchos::rcp(new TreeVector(*u));
+
+  // Anderson history: differences of successive corrections and of
+  // successive updated iterates
+  std::deque<Teuchos::RCP<TreeVector> > d_du, d_q;
+  Teuchos::RCP<TreeVector> du_prev, q_prev;
+
+  ChangedSolution();
+  FunctionalResidual(t_old, t_new, u, u, res);
+  double enorm = ErrorNorm(u, res);
+  double res_norm = 0.;
+  res->Norm2(&res_norm);
+
+  double tau = ptc_dt_init_;
+  double res_norm_prev = -1.;
+  int its = 0;
+  while (enorm > ptc_tol_ && its < ptc_max_its_) {
+    // SER: grow the pseudo time step as the residual falls
+    if (res_norm_prev > 0. && res_norm > 0.) {
+      double growth = std::pow(res_norm_prev / res_norm, ptc_ser_exponent_);
+      tau = std::min(ptc_dt_max_, tau * std::min(growth, ptc_growth_max_));
+    }
+
+    // linearized pseudo time step
+    pseudo_dt_ = tau;
+    UpdatePreconditioner(t_new, u, tau);
+    ApplyPreconditioner(res, du);
+    ModifyCorrection(tau, res, u, du);
+
+    Teuchos::RCP<TreeVector> q = Teuchos::rcp(new TreeVector(*u));
+    q->Update(-1., *du, 1.);
+
+    // Anderson mixing, restarted if the residual grew
+    if (du_prev != Teuchos::null) {
+      if (res_norm_prev > 0. && res_norm > res_norm_prev) {
+        d_du.clear();
+        d_q.clear();
+      } else {
+        Teuchos::RCP<TreeVector> ddu = Teuchos::rcp(new TreeVector(*du));
+        ddu->Update(-1., *du_prev, 1.);
+        d_du.push_back(ddu);
+        Teuchos::RCP<TreeVector> dq = Teuchos::rcp(new TreeVector(*q));
+        dq->Update(-1., *q_prev, 1.);
+        d_q.push_back(dq);
+        if (d_du.size() > static_cast<std::size_t>(ptc_depth_)) {
+          d_du.pop_front();
+          d_q.pop_front();
+        }
+      }
+    }
+
+    Teuchos::RCP<TreeVector> u_next = q;
+    int m = d_du.size();
+    if (m > 0) {
+      // minimize |du - d_du gamma| and take u = q - d_q gamma
+      Teuchos::SerialDenseMatrix<int,double> A(m, m);
+      Teuchos::SerialDenseMatrix<int,double> gamma(m, 1), b(m, 1);
+      for (int j=0; j!=m; ++j) {
+        for (int k=0; k<=j; ++k) {
+          double dot = 0.;
+          d_du[j]->Dot(*d_du[k], &dot);
+          A(j,k) = dot;
+          A(k,j) = dot;
+        }
+        d_du[j]->Dot(*du, &b(j,0));
+      }
+      Teuchos::SerialDenseSolver<int,double> solver;
+      solver.setMatrix(Teuchos::rcpFromRef(A));
+      solver.setVectors(Teuchos::rcpFromRef(gamma), Teuchos::rcpFromRef(b));
+      solver.factorWithEquilibration(true);
+
+      if (solver.solve() == 0) {
+        u_next = Teuchos::rcp(new TreeVector(*q));
+        for (int j=0; j!=m; ++j) u_next->Update(-gamma(j,0), *d_q[j], 1.);
+
+        // mixing may leave the admissible set, in which case do not mix
+        if (!IsAdmissible(u_next)) {
+          u_next = q;
+          d_du.clear();
+          d_q.clear();
+        }
+      }
+    }
+    *u = *u_next;
+    ChangedSolution();
+
+    du_prev = du;
+    q_prev = q;
+    du = Teuchos::rcp(new TreeVector(*du));
+
+    // evaluate the residual at the new iterate
+    res_norm_prev = res_norm;
+    FunctionalResidual(t_old, t_new, u, u, res);
+    enorm = ErrorNorm(u, res);
+    res->Norm2(&res_norm);
+    its++;
+
+    if (vo_->os_OK(Teuchos::VERB_MEDIUM))
+      *vo_->os() << "  iteration " << its << ": pseudo dt = " << tau
+                 << ", error norm = " << enorm << ", mixed over " << m << std::endl;
+  }
+  pseudo_dt_ = 0.;
+
+  bool fail = !(enorm <= ptc_tol_);
+  if (vo_->os_OK(Teuchos::VERB_LOW))
+    *vo_->os() << "Pseudo-transient solve " << (fail ? "failed" : "converged")
+               << " in " << its << " iterations and " << timer.totalElapsedTime(true)
+               << " s, error norm = " << enorm << std::endl;
+  if (fail) dt_ = 0.5 * dt_;
+  return fail;
+}
+
 // -----------------------------------------------------------------------------
 // Update the preconditioner at time t and u = up
 // -----------------------------------------------------------------------------
@@ -43,6 +206,7 @@ void RichardsSteadyState::UpdatePreconditioner(double t, Teuchos::RCP<const Tree
 
   // update the rel perm according to the scheme of choice
   UpdatePermeabilityData_(S_next_.ptr());
+  ghost_exchange_->Complete();
 
   // Create the preconditioner
   Teuchos::RCP<const CompositeVector> rel_perm =
@@ -57,6 +221,15 @@ void RichardsSteadyState::UpdatePreconditioner(double t, Teuchos::RCP<const Tree
 
   // Assemble and precompute the Schur complement for inversion.
   preconditioner_diff_->ApplyBCs(true, true, true);
+
+  // pseudo time term of pseudo-transient continuation
+  if (pseudo_dt_ > 0.) {
+    S_next_->GetFieldEvaluator(conserved_key_)
+        ->HasFieldDerivativeChanged(S_next_.ptr(), name_, key_);
+    Key dwc_dp_key = Keys::getDerivKey(conserved_key_, key_);
+    Teuchos::RCP<const CompositeVector> dwc_dp = S_next_->GetFieldData(dwc_dp_key);
+    preconditioner_acc_->AddAccumulationTerm(*dwc_dp, pseudo_dt_, "cell", false);
+  }
   
   // // TEST
   // if (S_next_->cycle() == 0 && niter_ == 0) {
@@ -11,9 +11,39 @@
 
 This is the same as Richards equation, but turns off the accumulation term.
 
+By default, steady state is reached through the time integrator, one
+nonlinear solve per (pseudo) time step.  When a `"pseudo-transient
+continuation`" sublist is provided, each step instead solves directly for
+steady state by pseudo-transient continuation: each iteration is a single
+linearized solve of
+
+.. math::
+   \left( \frac{1}{\tau} \frac{\partial \Theta}{\partial p} + J \right) \delta p = -F(p)
+
+where the pseudo time step :math:`\tau` grows by switched evolution
+relaxation (SER) as the residual falls, :math:`\tau_{k+1} = \tau_k
+(\|F_{k-1}\| / \|F_k\|)^\alpha`.  The corrections are limited as in the
+time integrator, then mixed by Anderson acceleration over the last few
+iterations.  Convergence uses the time integrator's error norm.  The initial
+iterate is the initial condition, which may be hydrostatic.
+
 .. _richards-steadystate-spec:
 .. admonition:: richards-steadystate-spec
 
+    * `"pseudo-transient continuation`" ``[list]`` **optional** If provided,
+      use the dedicated steady-state solver.
+
+      * `"initial pseudo time step [s]`" ``[double]`` **86400**
+      * `"maximum pseudo time step [s]`" ``[double]`` **1.e10**
+      * `"SER exponent`" ``[double]`` **1** The exponent, :math:`\alpha`.
+      * `"maximum growth factor`" ``[double]`` **10** The largest increase
+        of the pseudo time step in one iteration.
+      * `"Anderson depth`" ``[int]`` **3** Number of previous iterations
+        mixed into each update.  0 turns mixing off.
+      * `"maximum iterations`" ``[int]`` **500**
+      * `"tolerance`" ``[double]`` **1** Error norm below which the solve
+        has converged.
+
     INCLUDES:
 
     - ``[richards-spec]`` See `Richards PK`_
@@ -50,6 +80,9 @@ public:
   // Virtual destructor
   virtual ~RichardsSteadyState() {}
 
+  // Advance to steady state, possibly by pseudo-transient continuation.
+  virtual bool AdvanceStep(double t_old, double t_new, bool reinit);
+
 protected:
   virtual void Setup(const Teuchos::Ptr<State>& S);
 
@@ -61,9 +94,22 @@ protected:
   // updates the preconditioner
   virtual void UpdatePreconditioner(double t, Teuchos::RCP<const TreeVector> up, double h);
 
+ protected:
+  bool AdvanceStepPseudoTransient_(double t_old, double t_new);
+
  protected:
   int max_iters_;
 
+  // pseudo-transient continuation
+  bool ptc_;
+  double ptc_dt_init_, ptc_dt_max_;
+  double ptc_ser_exponent_, ptc_growth_max_;
+  int ptc_depth_, ptc_max_its_;
+  double ptc_tol_;
+
+  // the current pseudo time step, or 0 outside of a pseudo-transient solve
+  double pseudo_dt_;
+
  private:
   // factory registration
   static RegisteredPKFactory<RichardsSteadyState> reg_;
@@ -10,6 +10,8 @@ Authors: Ethan Coon (ATS version) (ecoon@lanl.gov)
 #include "EpetraExt_RowMatrixOut.h"
 #include "boost/math/special_functions/fpclassify.hpp"
 
+#include "Teuchos_TimeMonitor.hpp"
+
 #include "Op.hh"
 #include "richards.hh"
 
@@ -116,7 +118,15 @@ int Richards::ApplyPreconditioner(Teuchos::RCP<const TreeVector> u, Teuchos::RCP
   db_->WriteVector("p_res", u->Data().ptr(), true);
 
   // Apply the preconditioner
-  int ierr = preconditioner_->ApplyInverse(*u->Data(), *Pu->Data());
+  int ierr = 0;
+  if (pc_reuse_->setup_pending()) {
+    // the inverse is computed on the first application after an update
+    Teuchos::TimeMonitor monitor(pc_reuse_->setup_timer());
+    ierr = preconditioner_->ApplyInverse(*u->Data(), *Pu->Data());
+    pc_reuse_->set_setup_pending(false);
+  } else {
+    ierr = preconditioner_->ApplyInverse(*u->Data(), *Pu->Data());
+  }
 
   db_->WriteVector("PC*p_res", Pu->Data().ptr(), true);
   
@@ -144,6 +154,17 @@ void Richards::UpdatePreconditioner(double t, Teuchos::RCP<const TreeVector> up,
     iter_ = 0;
     iter_counter_time_ = t;
   }
+
+  // lag the preconditioner if the reuse policy allows it
+  auto update = pc_reuse_->Decide(t, h);
+  if (update == PreconditionerReusePolicy::PC_REUSE) {
+    if (vo_->os_OK(Teuchos::VERB_HIGH))
+      *vo_->os() << "  reusing preconditioner" << std::endl;
+    iter_++;
+    return;
+  }
+  Teuchos::TimeMonitor monitor(pc_reuse_->setup_timer());
+
   AMANZI_ASSERT(std::abs(S_next_->time() - t) <= 1.e-4*t);
   PK_PhysicalBDF_Default::Solution_to_State(*up, S_next_);
 
@@ -151,9 +172,11 @@ void Richards::UpdatePreconditioner(double t, Teuchos::RCP<const TreeVector> up,
   UpdatePermeabilityData_(S_next_.ptr());
   if (jacobian_ && iter_ >= jacobian_lag_) UpdatePermeabilityDerivativeData_(S_next_.ptr());
 
-  // update boundary conditions
+  // update boundary conditions, whose flux ghosts are exchanged in the same
+  // message round as the ghosts of rel perm and its derivative
   ComputeBoundaryConditions_(S_next_.ptr());
   UpdateBoundaryConditions_(S_next_.ptr());
+  ghost_exchange_->Complete();
 
   Teuchos::RCP<const CompositeVector> rel_perm =
       S_next_->GetFieldData(uw_coef_key_);
@@ -203,7 +226,12 @@ void Richards::UpdatePreconditioner(double t, Teuchos::RCP<const TreeVector> up,
 
   // -- update preconditioner with source term derivatives if needed
   AddSourcesToPrecon_(S_next_.ptr(), h);
-  
+
+  // -- after a failed step, set up the inverse from scratch
+  if (update == PreconditionerReusePolicy::PC_REBUILD && precon_used_) {
+    preconditioner_->set_inverse_parameters(
+        plist_->sublist("diffusion preconditioner").sublist("inverse"));
+  }
 
   // increment the iterator count
   iter_++;
@@ -0,0 +1,100 @@
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+*/
+
+#include <cmath>
+#include "UnitTest++.h"
+
+#include "Teuchos_Array.hpp"
+#include "Teuchos_ParameterList.hpp"
+#include "Teuchos_RCP.hpp"
+
+#include "AmanziComm.hh"
+#include "GeometricModel.hh"
+#include "MeshFactory.hh"
+
+#include "flow_bc_factory.hh"
+#include "boundary_face_plan.hh"
+
+using namespace Amanzi;
+
+namespace {
+
+// A static mesh of 2x2 columns of 5 cells, with the surface at z = 0, and a
+// region on its west side.
+Teuchos::RCP<AmanziMesh::Mesh>
+createMesh()
+{
+  auto comm = getDefaultComm();
+  Teuchos::ParameterList region_list;
+  auto& west = region_list.sublist("west").sublist("region: plane");
+  west.set<Teuchos::Array<double> >("point", Teuchos::Array<double>(3, 0.));
+  Teuchos::Array<double> normal(3, 0.);
+  normal[0] = -1.;
+  west.set<Teuchos::Array<double> >("normal", normal);
+  auto gm = Teuchos::rcp(new AmanziGeometry::GeometricModel(3, region_list, *comm));
+
+  AmanziMesh::MeshFactory factory(comm, gm);
+  auto mesh = factory.create(0., 0., -5., 2., 2., 0., 2, 2, 5);
+  mesh->build_columns();
+  return mesh;
+}
+
+} // namespace
+
+
+SUITE(BOUNDARY_FACE_PLAN) {
+
+// The plan is built before the head BC is ever computed, as in the first
+// update of a PK's BCs, and must still cover all of its faces.
+TEST(HEAD_BC_STATIC_MESH) {
+  auto mesh = createMesh();
+  Flow::BoundaryFacePlan plan(mesh);
+  plan.Build();
+  plan.BuildGeometry(true);
+
+  Teuchos::ParameterList bc_plist;
+  auto& bc = bc_plist.sublist("head").sublist("BC west");
+  bc.set<Teuchos::Array<std::string> >("regions", Teuchos::Array<std::string>(1, "west"));
+  bc.sublist("boundary head").sublist("function-constant").set<double>("value", 0.5);
+  Flow::FlowBCFactory bc_factory(mesh, bc_plist);
+  auto bc_head = bc_factory.CreateHead();
+  bc_head->Compute(0.);
+
+  int nfaces = 0;
+  for (const auto& f_head : *bc_head) {
+    int f = f_head.first;
+    nfaces++;
+    int c = plan.cell(f);
+    CHECK(c >= 0);
+    if (c < 0) continue;
+
+    // the surface is at z = 0
+    CHECK_CLOSE(-mesh->cell_centroid(c)[2], plan.head_dz(f), 1.e-10);
+    CHECK_CLOSE(mesh->face_centroid(f)[2], plan.elevation(f), 1.e-10);
+    CHECK_EQUAL(-1, plan.direction(f) * (mesh->face_normal(f)[0] > 0. ? 1 : -1));
+    CHECK_CLOSE(0.5, f_head.second, 1.e-10);
+  }
+
+  int nfaces_g = 0;
+  mesh->get_comm()->SumAll(&nfaces, &nfaces_g, 1);
+  CHECK_EQUAL(2 * 5, nfaces_g);
+}
+
+
+// Without columns, the geometry used by all other BCs is still cached.
+TEST(GEOMETRY_WITHOUT_COLUMNS) {
+  auto mesh = createMesh();
+  Flow::BoundaryFacePlan plan(mesh);
+  plan.Build();
+  plan.BuildGeometry(false);
+
+  for (int f : plan.faces()) {
+    CHECK_CLOSE(mesh->face_centroid(f)[2], plan.elevation(f), 1.e-10);
+    CHECK(std::abs(plan.direction(f)) == 1);
+  }
+}
+
+}
@@ -0,0 +1,119 @@
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+*/
+
+#include <cmath>
+#include "UnitTest++.h"
+
+#include "Teuchos_Array.hpp"
+#include "Teuchos_ParameterList.hpp"
+#include "Teuchos_RCP.hpp"
+
+#include "AmanziComm.hh"
+#include "GeometricModel.hh"
+#include "MeshFactory.hh"
+#include "State.hh"
+#include "primary_variable_field_evaluator.hh"
+
+#include "MultiplicativeEvaluator.hh"
+#include "three_phase_water_content_evaluator.hh"
+
+using namespace Amanzi;
+
+namespace {
+
+// Water content, computed twice, through the chain rule assembled by the
+// framework and in forward mode, on a small State.  Liquid saturation and gas
+// density depend on pressure, porosity and temperature, so that derivatives
+// are carried through intermediate evaluators as well as directly.
+Teuchos::RCP<State>
+createState()
+{
+  auto comm = getDefaultComm();
+  Teuchos::ParameterList region_list;
+  auto gm = Teuchos::rcp(new AmanziGeometry::GeometricModel(3, region_list, *comm));
+  AmanziMesh::MeshFactory factory(comm, gm);
+  auto mesh = factory.create(0., 0., -4., 2., 2., 0., 2, 2, 4);
+
+  Teuchos::ParameterList state_list;
+  auto S = Teuchos::rcp(new State(state_list));
+  S->RegisterDomainMesh(mesh);
+
+  std::vector<Key> primaries = { "pressure", "temperature", "porosity",
+    "molar_density_liquid", "saturation_ice", "molar_density_ice", "saturation_gas",
+    "mol_frac_gas", "cell_volume" };
+  for (const auto& key : primaries) {
+    S->RequireField(key, key)->SetMesh(mesh)->SetGhosted()
+        ->SetComponent("cell", AmanziMesh::CELL, 1);
+    Teuchos::ParameterList plist;
+    plist.set("evaluator name", key);
+    S->SetFieldEvaluator(key, Teuchos::rcp(new PrimaryVariableFieldEvaluator(plist)));
+  }
+
+  auto require_product = [&](const Key& key, const Key& dep, double coef) {
+    Teuchos::ParameterList plist;
+    plist.set("evaluator name", key);
+    plist.set("evaluator dependencies", Teuchos::Array<std::string>(
+        std::vector<std::string>{ "pressure", dep }));
+    plist.set("coefficient", coef);
+    S->RequireField(key)->SetMesh(mesh)->SetGhosted()
+        ->SetComponent("cell", AmanziMesh::CELL, 1);
+    S->SetFieldEvaluator(key, Teuchos::rcp(new Relations::MultiplicativeEvaluator(plist)));
+  };
+  require_product("saturation_liquid", "porosity", 1.e-5);
+  require_product("molar_density_gas", "temperature", 1.e-7);
+
+  for (bool forward : { false, true }) {
+    Key key = forward ? "water_content_forward" : "water_content";
+    Teuchos::ParameterList plist;
+    plist.set("evaluator name", key);
+    plist.set("forward mode derivatives", forward);
+    S->RequireField(key)->SetMesh(mesh)->SetGhosted()
+        ->SetComponent("cell", AmanziMesh::CELL, 1);
+    S->SetFieldEvaluator(key, Teuchos::rcp(new Flow::Relations::ThreePhaseWaterContentEvaluator(plist)));
+  }
+
+  S->Setup();
+
+  // distinct values in each field and cell
+  int i = 0;
+  for (const auto& key : primaries) {
+    Epetra_MultiVector& vec = *S->GetFieldData(key, key)->ViewComponent("cell", true);
+    for (int c=0; c!=vec.MyLength(); ++c) vec[0][c] = 0.1 + 0.03 * ((i + 3*c) % 17);
+    S->GetField(key, key)->set_initialized();
+    i++;
+  }
+  (*S->GetFieldData("pressure", "pressure")->ViewComponent("cell", true)).Shift(101325.);
+  (*S->GetFieldData("temperature", "temperature")->ViewComponent("cell", true)).Shift(270.);
+  S->InitializeEvaluators();
+  return S;
+}
+
+} // namespace
+
+
+SUITE(THREE_PHASE_WATER_CONTENT_DERIVATIVES) {
+
+TEST(FORWARD_MODE_MATCHES_CHAIN_RULE) {
+  auto S = createState();
+
+  std::vector<Key> wrt_keys = { "pressure", "temperature", "porosity",
+    "molar_density_liquid", "cell_volume" };
+  for (const auto& wrt : wrt_keys) {
+    S->GetFieldEvaluator("water_content")->HasFieldDerivativeChanged(S.ptr(), "test", wrt);
+    S->GetFieldEvaluator("water_content_forward")->HasFieldDerivativeChanged(S.ptr(), "test", wrt);
+
+    const Epetra_MultiVector& chain = *S->GetFieldData(Keys::getDerivKey("water_content", wrt))
+        ->ViewComponent("cell", false);
+    const Epetra_MultiVector& forward = *S->GetFieldData(Keys::getDerivKey("water_content_forward", wrt))
+        ->ViewComponent("cell", false);
+    for (int c=0; c!=chain.MyLength(); ++c) {
+      CHECK(std::abs(chain[0][c]) > 0.);
+      CHECK_CLOSE(chain[0][c], forward[0][c], 1.e-12 * std::abs(chain[0][c]));
+    }
+  }
+}
+
+}
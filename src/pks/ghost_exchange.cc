@@ -0,0 +1,143 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+*/
+
+#include <algorithm>
+
+#include "Epetra_Distributor.h"
+
+#include "dbc.hh"
+#include "ghost_exchange.hh"
+
+namespace Amanzi {
+
+namespace {
+
+// Ranks with nothing to send or receive take no part in a batch's messages.
+bool
+isActive(const Epetra_Import& importer)
+{
+  return importer.NumExportIDs() > 0 || importer.NumRemoteIDs() > 0;
+}
+
+} // namespace
+
+
+GhostExchange::~GhostExchange()
+{
+  if (posted_) {
+    for (auto& b : batches_) {
+      if (!b.second.entries.empty() && isActive(*b.second.importer))
+        b.second.importer->Distributor().DoWaits();
+    }
+  }
+  for (auto& b : batches_) delete [] b.second.imports;
+}
+
+
+void
+GhostExchange::Require(const Teuchos::RCP<const CompositeVector>& vec,
+                       const std::string& comp)
+{
+  AMANZI_ASSERT(!posted_);
+  AMANZI_ASSERT(vec->Ghosted());
+  for (const auto& req : required_) {
+    if (req.second.vec == vec && req.second.comp == comp) return;
+  }
+
+  Entry entry;
+  entry.vec = vec;
+  entry.comp = comp;
+  required_.push_back(std::make_pair(BatchKey(vec->Mesh().get(), comp), entry));
+}
+
+
+void
+GhostExchange::Begin()
+{
+  if (posted_ || required_.empty()) return;
+
+  // group by mesh and entity kind, which share maps
+  for (const auto& req : required_) {
+    Batch& batch = batches_[req.first];
+    const Entry& entry = req.second;
+    if (batch.importer == Teuchos::null) {
+      batch.importer = Teuchos::rcp(new Epetra_Import(*entry.vec->ComponentMap(entry.comp, true),
+              *entry.vec->ComponentMap(entry.comp, false)));
+    }
+    batch.entries.push_back(entry);
+    batch.nvecs += entry.vec->NumVectors(entry.comp);
+  }
+
+  // pack each batch in the importer's export order and post it
+  for (auto& b : batches_) {
+    Batch& batch = b.second;
+    if (batch.entries.empty() || !isActive(*batch.importer)) continue;
+
+    const Epetra_Import& importer = *batch.importer;
+    int nexports = importer.NumExportIDs();
+    const int* export_lids = importer.ExportLIDs();
+    batch.exports.resize(std::max(nexports * batch.nvecs, 1));
+
+    int offset = 0;
+    for (const auto& entry : batch.entries) {
+      const Epetra_MultiVector& master = *entry.vec->ViewComponent(entry.comp, false);
+      for (int k=0; k!=master.NumVectors(); ++k) {
+        for (int i=0; i!=nexports; ++i) {
+          batch.exports[i*batch.nvecs + offset + k] = master[k][export_lids[i]];
+        }
+      }
+      offset += master.NumVectors();
+    }
+
+    importer.Distributor().DoPosts(reinterpret_cast<char*>(&batch.exports[0]),
+            batch.nvecs * sizeof(double), batch.len_imports, batch.imports);
+  }
+  posted_ = true;
+}
+
+
+void
+GhostExchange::Complete()
+{
+  if (required_.empty()) return;
+  Begin();
+
+  for (auto& b : batches_) {
+    Batch& batch = b.second;
+    if (batch.entries.empty()) continue;
+
+    const Epetra_Import& importer = *batch.importer;
+    if (isActive(importer)) {
+      importer.Distributor().DoWaits();
+
+      // received values arrive in the order of the importer's remote entries
+      int nremotes = importer.NumRemoteIDs();
+      const int* remote_lids = importer.RemoteLIDs();
+      const double* imports = reinterpret_cast<const double*>(batch.imports);
+
+      int offset = 0;
+      for (const auto& entry : batch.entries) {
+        Epetra_MultiVector& ghosted =
+          *Teuchos::rcp_const_cast<CompositeVector>(entry.vec)->ViewComponent(entry.comp, true);
+        for (int k=0; k!=ghosted.NumVectors(); ++k) {
+          for (int i=0; i!=nremotes; ++i) {
+            ghosted[k][remote_lids[i]] = imports[i*batch.nvecs + offset + k];
+          }
+        }
+        offset += ghosted.NumVectors();
+      }
+    }
+
+    batch.entries.clear();
+    batch.nvecs = 0;
+  }
+
+  required_.clear();
+  posted_ = false;
+}
+
+}  // namespace Amanzi
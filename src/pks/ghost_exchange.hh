@@ -0,0 +1,90 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+//! Batches the ghost updates of several vectors into one message round.
+
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+*/
+
+/*!
+
+A single residual evaluation scatters master values to ghosts for several
+vectors -- upwinded relative permeability, its derivative, fluxes -- and each
+call to `ScatterMasterToGhosted()` is its own round of messages.  On many
+processes these rounds are dominated by latency, not volume.
+
+A PK instead registers, with `Require()`, the components it needs ghosted
+for the next phase.  All registered components of the same entity kind on
+the same mesh are packed together and sent in one non-blocking message per
+neighbor, and the batches of different kinds are in flight at the same time.
+`Begin()` packs and posts the messages, and `Complete()`, the completion
+point which must precede any use of the ghost entries, waits for them and
+unpacks.  Work independent of the ghosts may be done between the two.
+
+The messages carry the master values as of `Begin()`, so registered vectors
+must not be modified until `Complete()`.
+
+*/
+
+#ifndef ATS_GHOST_EXCHANGE_HH_
+#define ATS_GHOST_EXCHANGE_HH_
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Teuchos_RCP.hpp"
+#include "Epetra_Import.h"
+
+#include "CompositeVector.hh"
+
+namespace Amanzi {
+
+class GhostExchange {
+ public:
+  GhostExchange() : posted_(false) {}
+  ~GhostExchange();
+
+  // Registers a component whose ghost entries are needed.  As with
+  // ScatterMasterToGhosted(), ghosts are updated through a const vector.
+  void Require(const Teuchos::RCP<const CompositeVector>& vec,
+               const std::string& comp);
+
+  // Packs and posts all registered components.
+  void Begin();
+
+  // Waits for and unpacks all registered components, posting them first if
+  // Begin() was not called.  A no-op if nothing is registered.
+  void Complete();
+
+  bool pending() const { return !required_.empty(); }
+
+ private:
+  typedef std::pair<const AmanziMesh::Mesh*, std::string> BatchKey;
+
+  struct Entry {
+    Teuchos::RCP<const CompositeVector> vec;
+    std::string comp;
+  };
+
+  struct Batch {
+    Batch() : nvecs(0), imports(NULL), len_imports(0) {}
+
+    Teuchos::RCP<Epetra_Import> importer;
+    std::vector<Entry> entries;
+    int nvecs;
+    std::vector<double> exports;
+    char* imports;
+    int len_imports;
+  };
+
+  std::vector<std::pair<BatchKey, Entry> > required_;
+  std::map<BatchKey, Batch> batches_;
+  bool posted_;
+};
+
+}  // namespace Amanzi
+
+#endif
@@ -9,6 +9,12 @@ A DomainSet coupler, couples a bunch of domains of the same structure.
 
 ------------------------------------------------------------------------- */
 
+#include <algorithm>
+#include <cctype>
+#include <numeric>
+
+#include "Teuchos_Time.hpp"
+
 #include "DomainSetMPC.hh"
 
 namespace Amanzi {
@@ -35,16 +41,57 @@ DomainSetMPC::DomainSetMPC(Teuchos::ParameterList& pk_tree,
 
   // add for the various sub-pks based on IDs
   auto ds = S->GetDomainSet(std::get<0>(triple));
+  int n_coupled = subpks.size();
   for (auto& subdomain : *ds) {
     subpks.push_back(Keys::getKey(subdomain, std::get<2>(triple)));
   }
   this->plist_->template set("PKs order", subpks);
 
+  // Subdomains are named by the global ID of their entity in the indexing
+  // parent; subdomain costs are stored on that entity.
+  cost_mesh_ = ds->get_indexing_parent();
+  std::string parent_name = "domain";
+  for (State::mesh_iterator mesh=S->mesh_begin(); mesh!=S->mesh_end(); ++mesh) {
+    if (mesh->second.first == cost_mesh_) {
+      parent_name = mesh->first;
+      break;
+    }
+  }
+  cost_key_ = Keys::readKey(*this->plist_, parent_name, "subdomain cost", "column_cost");
+  cost_window_ = std::max(1, this->plist_->template get<int>("subdomain cost window", 10));
+
+  const auto& cell_map = cost_mesh_->cell_map(false);
+  cost_lids_.assign(n_coupled, -1);
+  for (auto& subdomain : *ds) {
+    KeyTriple subdomain_triple;
+    Keys::splitDomainSet(subdomain, subdomain_triple);
+    const std::string& id = std::get<1>(subdomain_triple);
+    bool is_gid = !id.empty() && std::all_of(id.begin(), id.end(), ::isdigit);
+    cost_lids_.push_back(is_gid ? cell_map.LID(std::stoi(id)) : -1);
+  }
+
   // construct the sub-PKs on COMM_SELF
   MPC<PK>::init_(S, getCommSelf());
 }
 
 
+void DomainSetMPC::Setup(const Teuchos::Ptr<State>& S) {
+  MPC<PK>::Setup(S);
+
+  S->RequireField(cost_key_, name_)->SetMesh(cost_mesh_)
+      ->SetComponent("cell", AmanziMesh::CELL, 1);
+}
+
+
+void DomainSetMPC::Initialize(const Teuchos::Ptr<State>& S) {
+  MPC<PK>::Initialize(S);
+
+  // on restart, this is overwritten by the checkpointed cost
+  S->GetFieldData(cost_key_, name_)->PutScalar(0.);
+  S->GetField(cost_key_, name_)->set_initialized();
+}
+
+
 // must communicate dts since columns are serial
 double DomainSetMPC::get_dt() {
   double dt = 1.0e99;
@@ -73,18 +120,56 @@ void DomainSetMPC::set_dt( double dt) {
 // Semi coupled thermal hydrology
 bool 
 DomainSetMPC::AdvanceStep(double t_old, double t_new, bool reinit) {
+  Epetra_MultiVector& cost = *S_next_->GetFieldData(cost_key_, name_)
+      ->ViewComponent("cell", false);
+
   int nfailed = 0;
-  for (const auto& pk : sub_pks_) {
-    bool fail = pk->AdvanceStep(t_old, t_new, reinit);
+  double step_cost = 0.;
+  Teuchos::Time timer("subdomain advance");
+  for (int i=0; i!=sub_pks_.size(); ++i) {
+    timer.start(true);
+    bool fail = sub_pks_[i]->AdvanceStep(t_old, t_new, reinit);
+    double elapsed = timer.stop();
+    step_cost += elapsed;
+    if (cost_lids_[i] >= 0) cost[0][cost_lids_[i]] += elapsed;
+
     if (fail) {
       nfailed++;
       break;
     }
   }
 
-  int nfailed_global(0);
-  solution_->Comm()->SumAll(&nfailed, &nfailed_global, 1);
-  if (nfailed_global) return true;
+  // the window includes this step only if it succeeds everywhere
+  double window_cost = std::accumulate(step_costs_.begin(), step_costs_.end(), 0.);
+  if ((int) step_costs_.size() == cost_window_) window_cost -= step_costs_.front();
+  window_cost += step_cost;
+
+  // a single gather provides the failure count and both costs' max and mean
+  const auto& comm = *solution_->Comm();
+  int nprocs = comm.NumProc();
+  double local[3] = { static_cast<double>(nfailed), step_cost, window_cost };
+  std::vector<double> global(3 * nprocs, 0.);
+  comm.GatherAll(local, global.data(), 3);
+
+  double total[3] = { 0., 0., 0. };
+  double max[3] = { 0., 0., 0. };
+  for (int p=0; p!=nprocs; ++p) {
+    for (int j=0; j!=3; ++j) {
+      total[j] += global[3*p + j];
+      max[j] = std::max(max[j], global[3*p + j]);
+    }
+  }
+  if (total[0] > 0.) return true;
+
+  step_costs_.push_back(step_cost);
+  if ((int) step_costs_.size() > cost_window_) step_costs_.pop_front();
+
+  if (total[1] > 0. && total[2] > 0. && vo_->os_OK(Teuchos::VERB_HIGH)) {
+    Teuchos::OSTab tab = vo_->getOSTab();
+    *vo_->os() << "subdomain cost imbalance (max/mean): step = "
+               << max[1] * nprocs / total[1] << ", last " << step_costs_.size()
+               << " steps = " << max[2] * nprocs / total[2] << std::endl;
+  }
   return false;
 }
   
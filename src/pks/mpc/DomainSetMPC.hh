@@ -9,11 +9,42 @@
 */
 
 /*!
-  
+
+Each subdomain PK is advanced on its own process, so the cost of a step on
+a process is the sum of the costs of its subdomains.  These vary by orders
+of magnitude, e.g. thawing or wet columns cost far more than frozen or dry
+ones, while the partitioning of the indexing parent mesh balances only the
+number of subdomains.  This PK measures, but does not correct, that
+imbalance.
+
+The wall time of every subdomain's successful steps is accumulated, per
+entity of the indexing parent, in a cell field.  The field is checkpointed,
+so the cost survives restarts, and visualized, so that it can inform a
+cost-weighted partitioning that keeps columns whole.  Each step reports the
+imbalance across processes, the ratio of the largest to the mean cost, both
+of that step and of the last `"subdomain cost window`" steps.
+
+Repartitioning is not done here: meshes are partitioned once, by the mesh
+factory, and column meshes are serial views of their parent's cells, so a
+column cannot change process without rebuilding the meshes and State.
+
+.. _domain-set-mpc-spec:
+.. admonition:: domain-set-mpc-spec
+
+    * `"PKs order`" ``[Array(string)]`` Any coupled PKs, followed by the
+      domain set PK, in the form `"DOMAIN_*-PK_NAME`".
+    * `"subdomain cost key`" ``[string]`` **DOMAIN-column_cost** Cell field,
+      on the domain set's indexing parent DOMAIN, of the accumulated wall time
+      [s] of each subdomain.
+    * `"subdomain cost window`" ``[int]`` **10** Number of steps over which
+      the windowed imbalance is reported.
+
  */
 
 #pragma once
 
+#include <deque>
+
 #include "Key.hh"
 #include "PK.hh"
 #include "mpc.hh"
@@ -30,6 +61,8 @@ class DomainSetMPC : public MPC<PK> {
   virtual ~DomainSetMPC() = default;
   
   // PK methods
+  virtual void Setup(const Teuchos::Ptr<State>& S);
+  virtual void Initialize(const Teuchos::Ptr<State>& S);
   virtual double get_dt();
   virtual void set_dt(double dt);
   virtual bool AdvanceStep(double t_old, double t_new, bool reinit);
@@ -37,6 +70,15 @@ class DomainSetMPC : public MPC<PK> {
  protected:
   std::string pks_set_;
 
+  // accumulated cost of each subdomain
+  Key cost_key_;
+  Teuchos::RCP<const AmanziMesh::Mesh> cost_mesh_;
+  std::vector<int> cost_lids_;
+
+  // this process's cost of each of the last cost_window_ steps
+  int cost_window_;
+  std::deque<double> step_costs_;
+
  private:
   // factory registration
   static RegisteredPKFactory<DomainSetMPC> reg_;
@@ -0,0 +1,378 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+#include "dbc.hh"
+#include "errors.hh"
+#include "PreconditionerFactory.hh"
+
+#include "column_line_preconditioner.hh"
+
+namespace Amanzi {
+
+ColumnLinePreconditioner::ColumnLinePreconditioner(Teuchos::ParameterList& plist,
+        const Teuchos::RCP<const AmanziMesh::Mesh>& mesh) :
+    plist_(plist),
+    mesh_(mesh),
+    nrows_(0),
+    ncoarse_(0)
+{
+  single_ = plist_.get<bool>("single precision factors", false);
+  coarse_ = plist_.get<bool>("coarse surface correction", false);
+  if (coarse_) {
+    if (!plist_.isSublist("coarse preconditioner")) {
+      Errors::Message msg("ColumnLinePreconditioner: \"coarse surface correction\" requires a \"coarse preconditioner\" sublist.");
+      Exceptions::amanzi_throw(msg);
+    }
+    AmanziPreconditioners::PreconditionerFactory fac;
+    coarse_pc_ = fac.Create(plist_.sublist("coarse preconditioner"));
+  }
+}
+
+
+void
+ColumnLinePreconditioner::InitializeInverse(const Operators::SuperMap& smap, int num_blocks)
+{
+  bool has_faces = smap.HasComponent(0, "face");
+  for (int b=0; b!=num_blocks; ++b) {
+    if (!smap.HasComponent(b, "cell") || smap.HasComponent(b, "face") != has_faces) {
+      Errors::Message msg("ColumnLinePreconditioner: all blocks must use the same discretization.");
+      Exceptions::amanzi_throw(msg);
+    }
+  }
+  int ncells_owned = mesh_->num_entities(AmanziMesh::CELL, AmanziMesh::Parallel_type::OWNED);
+  int nfaces_owned = mesh_->num_entities(AmanziMesh::FACE, AmanziMesh::Parallel_type::OWNED);
+  int ncols = mesh_->num_columns(false);
+
+  nrows_ = smap.Map()->NumMyElements();
+  row_line_.assign(nrows_, -1);
+  row_pos_.assign(nrows_, -1);
+  row_aggregate_.assign(nrows_, -1);
+  line_offsets_.assign(1, 0);
+  line_rows_.clear();
+
+  // all unknowns of an entity are adjacent in the line
+  auto add_entity = [&](const std::string& comp, int lid, int col) {
+    for (int b=0; b!=num_blocks; ++b) {
+      int row = smap.Indices(b, comp, 0)[lid];
+      row_line_[row] = col;
+      row_pos_[row] = line_rows_.size() - line_offsets_[col];
+      row_aggregate_[row] = col * num_blocks + b;
+      line_rows_.push_back(row);
+    }
+  };
+
+  std::vector<int> cell_column(ncells_owned, -1);
+  for (int col=0; col!=ncols; ++col) {
+    const auto& cells = mesh_->cells_of_column(col);
+    const auto& faces = mesh_->faces_of_column(col);
+    if (has_faces) {
+      if (faces[0] >= nfaces_owned) {
+        Errors::Message msg("ColumnLinePreconditioner: columns may not be split across processes.");
+        Exceptions::amanzi_throw(msg);
+      }
+      add_entity("face", faces[0], col);
+    }
+
+    for (int i=0; i!=cells.size(); ++i) {
+      if (cells[i] >= ncells_owned || (has_faces && faces[i+1] >= nfaces_owned)) {
+        Errors::Message msg("ColumnLinePreconditioner: columns may not be split across processes.");
+        Exceptions::amanzi_throw(msg);
+      }
+      cell_column[cells[i]] = col;
+      add_entity("cell", cells[i], col);
+      if (has_faces) add_entity("face", faces[i+1], col);
+    }
+    line_offsets_.push_back(line_rows_.size());
+  }
+
+  // lateral faces are aggregated with the column of their first owned cell
+  if (has_faces) {
+    AmanziMesh::Entity_ID_List cells;
+    for (int f=0; f!=nfaces_owned; ++f) {
+      if (row_line_[smap.Indices(0, "face", 0)[f]] >= 0) continue;
+      mesh_->face_get_cells(f, AmanziMesh::Parallel_type::ALL, &cells);
+      int col = -1;
+      for (int c : cells) {
+        if (c < ncells_owned) {
+          col = cell_column[c];
+          break;
+        }
+      }
+      if (col < 0) continue;
+      for (int b=0; b!=num_blocks; ++b) {
+        row_aggregate_[smap.Indices(b, "face", 0)[f]] = col * num_blocks + b;
+      }
+    }
+  }
+
+  point_rows_.clear();
+  for (int row=0; row!=nrows_; ++row) {
+    if (row_line_[row] < 0) point_rows_.push_back(row);
+  }
+
+  if (coarse_) {
+    ncoarse_ = ncols * num_blocks;
+    coarse_map_ = Teuchos::rcp(new Epetra_Map(-1, ncoarse_, 0, *mesh_->get_comm()));
+  }
+}
+
+
+void
+ColumnLinePreconditioner::UpdateInverse(const Teuchos::RCP<const Epetra_CrsMatrix>& A)
+{
+  AMANZI_ASSERT(A->RowMap().NumMyElements() == nrows_);
+  A_ = A;
+
+  // the column map may change with the symbolic assembly
+  const Epetra_Map& row_map = A_->RowMap();
+  const Epetra_Map& col_map = A_->ColMap();
+  col_to_row_.resize(col_map.NumMyElements());
+  for (int j=0; j!=col_map.NumMyElements(); ++j) {
+    col_to_row_[j] = row_map.LID(col_map.GID(j));
+  }
+
+  // find the bandwidth of each line
+  int nlines = line_offsets_.size() - 1;
+  line_bandwidths_.assign(nlines, 0);
+  band_offsets_.assign(nlines + 1, 0);
+  int nnz;
+  double* vals;
+  int* inds;
+  int max_length = 0;
+  for (int l=0; l!=nlines; ++l) {
+    int& bw = line_bandwidths_[l];
+    for (int i=line_offsets_[l]; i!=line_offsets_[l+1]; ++i) {
+      int row = line_rows_[i];
+      A_->ExtractMyRowView(row, nnz, vals, inds);
+      for (int k=0; k!=nnz; ++k) {
+        int r = col_to_row_[inds[k]];
+        if (r >= 0 && row_line_[r] == l) bw = std::max(bw, std::abs(row_pos_[r] - row_pos_[row]));
+      }
+    }
+    int n = line_offsets_[l+1] - line_offsets_[l];
+    band_offsets_[l+1] = band_offsets_[l] + n * (2*bw + 1);
+    max_length = std::max(max_length, n);
+  }
+  work_.resize(max_length);
+
+  // extract and factor the bands, without pivoting, in double precision.  In
+  // single precision, each line is factored in a reused double precision
+  // buffer and rounded into the factors, so no double copy of all factors
+  // is held.
+  if (single_) {
+    bands_single_.resize(band_offsets_[nlines]);
+  } else {
+    bands_.resize(band_offsets_[nlines]);
+  }
+  for (int l=0; l!=nlines; ++l) {
+    int bw = line_bandwidths_[l];
+    int w = 2*bw + 1;
+    int n = line_offsets_[l+1] - line_offsets_[l];
+    double* band;
+    if (single_) {
+      line_work_.assign(n * w, 0.);
+      band = line_work_.data();
+    } else {
+      band = &bands_[band_offsets_[l]];
+      std::fill(band, band + n*w, 0.);
+    }
+    auto a = [=](int i, int j) -> double& { return band[i*w + j - i + bw]; };
+
+    for (int i=0; i!=n; ++i) {
+      A_->ExtractMyRowView(line_rows_[line_offsets_[l] + i], nnz, vals, inds);
+      for (int k=0; k!=nnz; ++k) {
+        int r = col_to_row_[inds[k]];
+        if (r >= 0 && row_line_[r] == l) a(i, row_pos_[r]) += vals[k];
+      }
+    }
+
+    for (int k=0; k!=n; ++k) {
+      double pivot = a(k,k);
+      if (pivot == 0.) {
+        Errors::Message msg("ColumnLinePreconditioner: zero pivot in the column block.");
+        Exceptions::amanzi_throw(msg);
+      }
+      int last = std::min(n-1, k+bw);
+      for (int i=k+1; i<=last; ++i) {
+        double& lik = a(i,k);
+        if (lik == 0.) continue;
+        lik /= pivot;
+        for (int j=k+1; j<=last; ++j) a(i,j) -= lik * a(k,j);
+      }
+    }
+
+    if (single_) {
+      std::copy(band, band + n*w, &bands_single_[band_offsets_[l]]);
+    }
+  }
+
+  // unknowns on no line get their diagonal
+  if (single_) {
+    point_inv_diag_single_.resize(point_rows_.size());
+  } else {
+    point_inv_diag_.resize(point_rows_.size());
+  }
+  for (int i=0; i!=point_rows_.size(); ++i) {
+    int row = point_rows_[i];
+    A_->ExtractMyRowView(row, nnz, vals, inds);
+    double diag = 0.;
+    for (int k=0; k!=nnz; ++k) {
+      if (col_to_row_[inds[k]] == row) diag += vals[k];
+    }
+    double inv_diag = (diag == 0.) ? 1. : 1. / diag;
+    if (single_) {
+      point_inv_diag_single_[i] = inv_diag;
+    } else {
+      point_inv_diag_[i] = inv_diag;
+    }
+  }
+
+  if (coarse_) {
+    UpdateCoarseOperator_();
+    if (r_ == Teuchos::null || !r_->Map().SameAs(A_->RowMap())) {
+      r_ = Teuchos::rcp(new Epetra_Vector(A_->RowMap()));
+      dx_ = Teuchos::rcp(new Epetra_Vector(A_->RowMap()));
+      rc_ = Teuchos::rcp(new Epetra_Vector(*coarse_map_));
+      ec_ = Teuchos::rcp(new Epetra_Vector(*coarse_map_));
+    }
+  }
+}
+
+
+void
+ColumnLinePreconditioner::UpdateCoarseOperator_()
+{
+  // aggregate the fine matrix, Ac = R A P with piecewise constant P
+  std::vector<std::map<int,double> > coarse_rows(ncoarse_);
+  int nnz;
+  double* vals;
+  int* inds;
+  for (int row=0; row!=nrows_; ++row) {
+    int ai = row_aggregate_[row];
+    if (ai < 0) continue;
+    A_->ExtractMyRowView(row, nnz, vals, inds);
+    for (int k=0; k!=nnz; ++k) {
+      int r = col_to_row_[inds[k]];
+      if (r < 0 || row_aggregate_[r] < 0) continue;
+      coarse_rows[ai][row_aggregate_[r]] += vals[k];
+    }
+  }
+
+  Ac_ = Teuchos::rcp(new Epetra_CrsMatrix(Copy, *coarse_map_, 0));
+  std::vector<int> gids;
+  std::vector<double> values;
+  for (int ai=0; ai!=ncoarse_; ++ai) {
+    gids.clear();
+    values.clear();
+    for (const auto& entry : coarse_rows[ai]) {
+      gids.push_back(coarse_map_->GID(entry.first));
+      values.push_back(entry.second);
+    }
+    Ac_->InsertGlobalValues(coarse_map_->GID(ai), gids.size(), &values[0], &gids[0]);
+  }
+  Ac_->FillComplete();
+  coarse_pc_->Update(Ac_);
+}
+
+
+void
+ColumnLinePreconditioner::ApplySmoother_(const Epetra_Vector& b, Epetra_Vector& x) const
+{
+  if (single_) {
+    SolveLines_(bands_single_.data(), point_inv_diag_single_.data(), b, x);
+  } else {
+    SolveLines_(bands_.data(), point_inv_diag_.data(), b, x);
+  }
+}
+
+
+template<typename Scalar>
+void
+ColumnLinePreconditioner::SolveLines_(const Scalar* bands, const Scalar* point_inv_diag,
+        const Epetra_Vector& b, Epetra_Vector& x) const
+{
+  int nlines = line_offsets_.size() - 1;
+  for (int l=0; l!=nlines; ++l) {
+    int bw = line_bandwidths_[l];
+    int w = 2*bw + 1;
+    int first = line_offsets_[l];
+    int n = line_offsets_[l+1] - first;
+    const Scalar* band = bands + band_offsets_[l];
+    auto a = [=](int i, int j) { return static_cast<double>(band[i*w + j - i + bw]); };
+
+    // forward and back substitution, accumulated in double precision
+    for (int i=0; i!=n; ++i) {
+      double y = b[line_rows_[first + i]];
+      for (int j=std::max(0, i-bw); j!=i; ++j) y -= a(i,j) * work_[j];
+      work_[i] = y;
+    }
+    for (int i=n-1; i>=0; --i) {
+      double y = work_[i];
+      int last = std::min(n-1, i+bw);
+      for (int j=i+1; j<=last; ++j) y -= a(i,j) * work_[j];
+      work_[i] = y / a(i,i);
+    }
+    for (int i=0; i!=n; ++i) x[line_rows_[first + i]] = work_[i];
+  }
+
+  for (int i=0; i!=point_rows_.size(); ++i) {
+    x[point_rows_[i]] = point_inv_diag[i] * b[point_rows_[i]];
+  }
+}
+
+
+std::size_t
+ColumnLinePreconditioner::bytes() const
+{
+  return bands_.size() * sizeof(double) + point_inv_diag_.size() * sizeof(double)
+      + bands_single_.size() * sizeof(float) + point_inv_diag_single_.size() * sizeof(float);
+}
+
+
+void
+ColumnLinePreconditioner::Residual_(const Epetra_Vector& b, const Epetra_Vector& x,
+        Epetra_Vector& r) const
+{
+  A_->Multiply(false, x, r);
+  r.Update(1., b, -1.);
+}
+
+
+int
+ColumnLinePreconditioner::ApplyInverse(const Epetra_Vector& b, Epetra_Vector& x) const
+{
+  AMANZI_ASSERT(A_ != Teuchos::null);
+  ApplySmoother_(b, x);
+  if (!coarse_) return 0;
+
+  // coarse correction on the residual of the smoothed solution
+  Epetra_Vector& r = *r_;
+  Epetra_Vector& rc = *rc_;
+  Epetra_Vector& ec = *ec_;
+  Residual_(b, x, r);
+
+  rc.PutScalar(0.);
+  for (int row=0; row!=nrows_; ++row) {
+    if (row_aggregate_[row] >= 0) rc[row_aggregate_[row]] += r[row];
+  }
+  int ierr = coarse_pc_->ApplyInverse(rc, ec);
+  for (int row=0; row!=nrows_; ++row) {
+    if (row_aggregate_[row] >= 0) x[row] += ec[row_aggregate_[row]];
+  }
+
+  // post-smooth
+  Residual_(b, x, r);
+  ApplySmoother_(r, *dx_);
+  x.Update(1., *dx_, 1.);
+  return ierr;
+}
+
+} // namespace Amanzi
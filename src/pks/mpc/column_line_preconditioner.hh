@@ -0,0 +1,147 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+//! A line preconditioner which exactly inverts the vertical coupling in each column.
+
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+*/
+
+/*!
+
+On meshes with large aspect ratios, the vertical coupling in the subsurface is
+orders of magnitude stronger than the lateral coupling, and generic point
+smoothers (ILU, AMG with point relaxation) converge poorly.  This
+preconditioner instead orders the unknowns of each column of the mesh from
+the top down -- the top face (which, in coupled surface/subsurface flow, is
+the surface cell), then each cell followed by the face below it -- and
+exactly inverts the resulting banded block of the assembled matrix.  All
+unknowns of an entity (e.g. pressure and temperature) are kept together, so
+the block is tridiagonal for finite volume flow and block-banded otherwise.
+Couplings that leave the column are dropped, and unknowns on lateral faces
+are preconditioned by their diagonal.
+
+Optionally, the line solve is used as the smoother of a two-level scheme,
+where the coarse space has one unknown per column (and per block), i.e. is
+the 2D surface.  The coarse operator is the aggregated matrix, and is
+inverted with any preconditioner; lateral faces are aggregated with the
+column of their first cell.  Coarse couplings between columns on different
+processes are dropped.
+
+The factors may be stored in single precision.  They are computed in double
+precision and rounded, and substitution accumulates in double precision, so
+the preconditioner remains a fixed linear operator inside the double
+precision Krylov and Newton iterations.  This halves the memory of the
+factors.  On a serial, synthetic problem of 2000 columns of 50 cells with
+faces, CG iteration counts were unchanged, but applying the preconditioner
+was only about 5% faster, as the indirect reads and writes of the vectors
+cost as much as reading the factors.  The coarse operator and the residuals
+of the two-level scheme remain in double precision.
+
+Columns must be built on the mesh (see `"build columns from set`") and may not
+be split across processes.
+
+.. _column-line-preconditioner-spec:
+.. admonition:: column-line-preconditioner-spec
+
+    * `"single precision factors`" ``[bool]`` **false** If true, store the
+      column factors in single precision.
+
+    * `"coarse surface correction`" ``[bool]`` **false** If true, use the line
+      solve as a smoother, and add a coarse correction on the columns.
+
+    * `"coarse preconditioner`" ``[preconditioner-typed-spec]`` The
+      preconditioner used to invert the coarse operator, e.g. `"boomer amg`".
+      Required if the coarse correction is used.
+
+*/
+
+#ifndef PKS_MPC_COLUMN_LINE_PRECONDITIONER_HH_
+#define PKS_MPC_COLUMN_LINE_PRECONDITIONER_HH_
+
+#include <vector>
+
+#include "Teuchos_RCP.hpp"
+#include "Teuchos_ParameterList.hpp"
+#include "Epetra_CrsMatrix.h"
+#include "Epetra_Vector.h"
+
+#include "Mesh.hh"
+#include "SuperMap.hh"
+#include "Preconditioner.hh"
+
+namespace Amanzi {
+
+class ColumnLinePreconditioner {
+ public:
+  ColumnLinePreconditioner(Teuchos::ParameterList& plist,
+                           const Teuchos::RCP<const AmanziMesh::Mesh>& mesh);
+
+  // Builds the column ordering of the owned rows of smap.  Each of the
+  // num_blocks blocks of smap must live on mesh, with a "cell" and optionally
+  // a "face" component.
+  void InitializeInverse(const Operators::SuperMap& smap, int num_blocks);
+
+  // Extracts and factors the column blocks of the assembled matrix, and
+  // forms the coarse operator if requested.
+  void UpdateInverse(const Teuchos::RCP<const Epetra_CrsMatrix>& A);
+
+  // Applies the inverse to a vector on the row map of A.
+  int ApplyInverse(const Epetra_Vector& b, Epetra_Vector& x) const;
+
+  // memory held by the factors, in bytes
+  std::size_t bytes() const;
+  bool single_precision() const { return single_; }
+
+ private:
+  // one pass of the line solve, x = S(b)
+  void ApplySmoother_(const Epetra_Vector& b, Epetra_Vector& x) const;
+
+  template<typename Scalar>
+  void SolveLines_(const Scalar* bands, const Scalar* point_inv_diag,
+                   const Epetra_Vector& b, Epetra_Vector& x) const;
+
+  // r = b - A x
+  void Residual_(const Epetra_Vector& b, const Epetra_Vector& x, Epetra_Vector& r) const;
+
+  void UpdateCoarseOperator_();
+
+ private:
+  Teuchos::ParameterList plist_;
+  Teuchos::RCP<const AmanziMesh::Mesh> mesh_;
+  Teuchos::RCP<const Epetra_CrsMatrix> A_;
+  bool coarse_;
+  bool single_;
+
+  // the rows of each line, top down, and the line and position of each row;
+  // rows on no line have line -1
+  int nrows_;
+  std::vector<int> line_offsets_, line_rows_;
+  std::vector<int> row_line_, row_pos_;
+  std::vector<int> point_rows_;
+
+  // local column index of A to local row index, or -1 if not owned
+  std::vector<int> col_to_row_;
+
+  // factored banded blocks, stored row-major as (2*bw+1) diagonals per row,
+  // in double or single precision
+  std::vector<int> line_bandwidths_, band_offsets_;
+  std::vector<double> bands_, point_inv_diag_;
+  std::vector<float> bands_single_, point_inv_diag_single_;
+  std::vector<double> line_work_;  // one line's factors, before rounding
+  mutable std::vector<double> work_;
+
+  // coarse space: the aggregate of each row, or -1
+  int ncoarse_;
+  std::vector<int> row_aggregate_;
+  Teuchos::RCP<Epetra_Map> coarse_map_;
+  Teuchos::RCP<Epetra_CrsMatrix> Ac_;
+  Teuchos::RCP<AmanziPreconditioners::Preconditioner> coarse_pc_;
+
+  // work vectors of the coarse correction, on the fine and coarse maps
+  mutable Teuchos::RCP<Epetra_Vector> r_, dx_, rc_, ec_;
+};
+
+} // namespace Amanzi
+
+#endif
@@ -0,0 +1,203 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+/* -------------------------------------------------------------------------
+ATS
+
+License: see $ATS_DIR/COPYRIGHT
+
+EWCInverseTable tabulates the inverse of an EWCModel, (energy, water content)
+--> (temperature, pressure), for a single material.
+
+------------------------------------------------------------------------- */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "dbc.hh"
+#include "ewc_inverse_table.hh"
+
+namespace Amanzi {
+
+EWCInverseTable::EWCInverseTable(Teuchos::ParameterList& plist)
+{
+  T_min_ = plist.get<double>("minimum temperature [K]", 243.15);
+  T_max_ = plist.get<double>("maximum temperature [K]", 303.15);
+  p_min_ = plist.get<double>("minimum pressure [Pa]", 1.e4);
+  p_max_ = plist.get<double>("maximum pressure [Pa]", 1.e6);
+  coarse_.ne = plist.get<int>("number of energy points", 65);
+  coarse_.nwc = plist.get<int>("number of water content points", 65);
+  refinement_ = plist.get<int>("refinement factor", 4);
+  tol_ = plist.get<double>("refinement tolerance", 1.e-4);
+
+  AMANZI_ASSERT(T_max_ > T_min_);
+  AMANZI_ASSERT(p_max_ > p_min_);
+  AMANZI_ASSERT(coarse_.ne > 1 && coarse_.nwc > 1);
+}
+
+
+void
+EWCInverseTable::Build(const ForwardFunction& forward, const InverseFunction& inverse)
+{
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+
+  // find the image of the (T,p) box by sampling it
+  double e_min = std::numeric_limits<double>::max();
+  double e_max = -std::numeric_limits<double>::max();
+  double wc_min = std::numeric_limits<double>::max();
+  double wc_max = -std::numeric_limits<double>::max();
+  int nsample = std::max(coarse_.ne, coarse_.nwc);
+  for (int i=0; i!=nsample; ++i) {
+    double T = T_min_ + (T_max_ - T_min_) * i / (nsample - 1);
+    for (int j=0; j!=nsample; ++j) {
+      double p = p_min_ + (p_max_ - p_min_) * j / (nsample - 1);
+      double e, wc;
+      if (forward(T, p, e, wc)) continue;
+      e_min = std::min(e_min, e); e_max = std::max(e_max, e);
+      wc_min = std::min(wc_min, wc); wc_max = std::max(wc_max, wc);
+    }
+  }
+  AMANZI_ASSERT(e_max > e_min && wc_max > wc_min);
+  e_scale_ = e_max - e_min;
+  wc_scale_ = wc_max - wc_min;
+
+  // solve on the coarse grid
+  coarse_.e_min = e_min;
+  coarse_.wc_min = wc_min;
+  coarse_.de = e_scale_ / (coarse_.ne - 1);
+  coarse_.dwc = wc_scale_ / (coarse_.nwc - 1);
+  coarse_.T.assign(coarse_.ne * coarse_.nwc, nan);
+  coarse_.p.assign(coarse_.ne * coarse_.nwc, nan);
+  Solve_(coarse_, inverse);
+
+  // refine cells whose midpoint is poorly approximated
+  patches_.clear();
+  for (int j=0; j!=coarse_.nwc-1; ++j) {
+    for (int i=0; i!=coarse_.ne-1; ++i) {
+      if (!coarse_.ValidCell(i,j)) continue;
+
+      double e_mid = coarse_.e_min + (i + 0.5) * coarse_.de;
+      double wc_mid = coarse_.wc_min + (j + 0.5) * coarse_.dwc;
+      double T_mid, p_mid;
+      coarse_.Interpolate(e_mid, wc_mid, T_mid, p_mid);
+
+      double e, wc;
+      bool refine = forward(T_mid, p_mid, e, wc) != 0;
+      if (!refine) {
+        double err = std::abs(e - e_mid) / e_scale_ + std::abs(wc - wc_mid) / wc_scale_;
+        refine = err > tol_;
+      }
+
+      if (refine && refinement_ > 1) {
+        Grid patch;
+        patch.ne = refinement_ + 1;
+        patch.nwc = refinement_ + 1;
+        patch.e_min = coarse_.e_min + i * coarse_.de;
+        patch.wc_min = coarse_.wc_min + j * coarse_.dwc;
+        patch.de = coarse_.de / refinement_;
+        patch.dwc = coarse_.dwc / refinement_;
+        patch.T.assign(patch.ne * patch.nwc, nan);
+        patch.p.assign(patch.ne * patch.nwc, nan);
+
+        // initial guesses from the coarse interpolant
+        for (int jj=0; jj!=patch.nwc; ++jj) {
+          for (int ii=0; ii!=patch.ne; ++ii) {
+            coarse_.Interpolate(patch.e_min + ii * patch.de, patch.wc_min + jj * patch.dwc,
+                                patch.T[patch.index(ii,jj)], patch.p[patch.index(ii,jj)]);
+          }
+        }
+        Solve_(patch, inverse);
+        patches_[coarse_.index(i,j)] = std::move(patch);
+      }
+    }
+  }
+}
+
+
+bool
+EWCInverseTable::Lookup(double energy, double wc, double& T, double& p) const
+{
+  double fi = (energy - coarse_.e_min) / coarse_.de;
+  double fj = (wc - coarse_.wc_min) / coarse_.dwc;
+  if (!(fi >= 0. && fi <= coarse_.ne - 1 && fj >= 0. && fj <= coarse_.nwc - 1)) return false;
+
+  int i = std::min((int) fi, coarse_.ne - 2);
+  int j = std::min((int) fj, coarse_.nwc - 2);
+  auto patch = patches_.find(coarse_.index(i,j));
+  if (patch != patches_.end()) {
+    return patch->second.Interpolate(energy, wc, T, p);
+  }
+  return coarse_.Interpolate(energy, wc, T, p);
+}
+
+
+void
+EWCInverseTable::Solve_(Grid& grid, const InverseFunction& inverse) const
+{
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  for (int j=0; j!=grid.nwc; ++j) {
+    for (int i=0; i!=grid.ne; ++i) {
+      int n = grid.index(i,j);
+
+      // initial guess by continuation from a solved neighbor, else any
+      // provided guess, else the center of the box
+      double T, p;
+      if (i > 0 && !std::isnan(grid.T[n-1])) {
+        T = grid.T[n-1]; p = grid.p[n-1];
+      } else if (j > 0 && !std::isnan(grid.T[grid.index(i,j-1)])) {
+        T = grid.T[grid.index(i,j-1)]; p = grid.p[grid.index(i,j-1)];
+      } else if (!std::isnan(grid.T[n])) {
+        T = grid.T[n]; p = grid.p[n];
+      } else {
+        T = 0.5 * (T_min_ + T_max_); p = 0.5 * (p_min_ + p_max_);
+      }
+
+      int ierr = inverse(grid.e_min + i * grid.de, grid.wc_min + j * grid.dwc, T, p);
+      if (!ierr && InBox_(T, p)) {
+        grid.T[n] = T;
+        grid.p[n] = p;
+      } else {
+        grid.T[n] = nan;
+        grid.p[n] = nan;
+      }
+    }
+  }
+}
+
+
+bool
+EWCInverseTable::InBox_(double T, double p) const
+{
+  // allow a small slack, as the box's image is sampled
+  double T_slack = 0.01 * (T_max_ - T_min_);
+  double p_slack = 0.01 * (p_max_ - p_min_);
+  return T > T_min_ - T_slack && T < T_max_ + T_slack &&
+      p > p_min_ - p_slack && p < p_max_ + p_slack;
+}
+
+
+bool
+EWCInverseTable::Grid::ValidCell(int i, int j) const
+{
+  return !std::isnan(T[index(i,j)]) && !std::isnan(T[index(i+1,j)]) &&
+      !std::isnan(T[index(i,j+1)]) && !std::isnan(T[index(i+1,j+1)]);
+}
+
+
+bool
+EWCInverseTable::Grid::Interpolate(double energy, double wc, double& T_out, double& p_out) const
+{
+  double fi = (energy - e_min) / de;
+  double fj = (wc - wc_min) / dwc;
+  int i = std::max(0, std::min((int) fi, ne - 2));
+  int j = std::max(0, std::min((int) fj, nwc - 2));
+  if (!ValidCell(i,j)) return false;
+
+  double s = fi - i;
+  double t = fj - j;
+  double w00 = (1-s)*(1-t), w10 = s*(1-t), w01 = (1-s)*t, w11 = s*t;
+  T_out = w00*T[index(i,j)] + w10*T[index(i+1,j)] + w01*T[index(i,j+1)] + w11*T[index(i+1,j+1)];
+  p_out = w00*p[index(i,j)] + w10*p[index(i+1,j)] + w01*p[index(i,j+1)] + w11*p[index(i+1,j+1)];
+  return true;
+}
+
+} // namespace
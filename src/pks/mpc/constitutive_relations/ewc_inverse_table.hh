@@ -0,0 +1,96 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+/* -------------------------------------------------------------------------
+ATS
+
+License: see $ATS_DIR/COPYRIGHT
+
+EWCInverseTable tabulates the inverse of an EWCModel, (energy, water content)
+--> (temperature, pressure), for a single material.
+
+The table is a uniform grid in (energy, water content) space, spanning the
+image of a box in (temperature, pressure) space.  Each node is solved for
+with the full inverse, using neighboring nodes as the initial guess.  Nodes
+whose (e, wc) lies outside of the image of the box, or for which the inverse
+fails, are marked invalid.
+
+The grid is adapted to the model: each coarse cell is checked at its midpoint
+by forward-evaluating the interpolated (T, p), and cells whose relative error
+exceeds a tolerance are refined into a finer local grid.  This concentrates
+resolution in the freeze-thaw and saturation transitions, where the inverse
+varies rapidly.
+
+Lookups bilinearly interpolate from the four nodes of the (possibly refined)
+cell containing the point, and fail if any of them is invalid or the point
+is off the table, in which case the caller is expected to fall back to the
+full inverse.
+
+Parameters:
+
+  * `"minimum temperature [K]`" ``[double]`` **243.15**
+  * `"maximum temperature [K]`" ``[double]`` **303.15**
+  * `"minimum pressure [Pa]`" ``[double]`` **1.e4**
+  * `"maximum pressure [Pa]`" ``[double]`` **1.e6** Covers saturated cells
+    up to roughly 90m below the water table.
+  * `"number of energy points`" ``[int]`` **65**
+  * `"number of water content points`" ``[int]`` **65**
+  * `"refinement factor`" ``[int]`` **4** Each refined cell is split into this
+    many cells in each direction.
+  * `"refinement tolerance`" ``[double]`` **1.e-4** Relative error in (e, wc)
+    at a cell's midpoint above which the cell is refined.
+
+------------------------------------------------------------------------- */
+
+#ifndef AMANZI_EWC_INVERSE_TABLE_HH_
+#define AMANZI_EWC_INVERSE_TABLE_HH_
+
+#include <functional>
+#include <map>
+#include <vector>
+
+#include "Teuchos_ParameterList.hpp"
+
+namespace Amanzi {
+
+class EWCInverseTable {
+ public:
+  typedef std::function<int(double T, double p, double& energy, double& wc)> ForwardFunction;
+  typedef std::function<int(double energy, double wc, double& T, double& p)> InverseFunction;
+
+  EWCInverseTable(Teuchos::ParameterList& plist);
+
+  // Builds the table.  The model is assumed to be updated to the material
+  // being tabulated.
+  void Build(const ForwardFunction& forward, const InverseFunction& inverse);
+
+  // Interpolates T, p, returning false if off the table.
+  bool Lookup(double energy, double wc, double& T, double& p) const;
+
+  int num_refined() const { return patches_.size(); }
+
+ protected:
+  struct Grid {
+    int ne, nwc;
+    double e_min, wc_min, de, dwc;
+    std::vector<double> T, p;   // NaN where invalid
+
+    bool Interpolate(double energy, double wc, double& T_out, double& p_out) const;
+    bool ValidCell(int i, int j) const;
+    int index(int i, int j) const { return i + j*ne; }
+  };
+
+  void Solve_(Grid& grid, const InverseFunction& inverse) const;
+  bool InBox_(double T, double p) const;
+
+ protected:
+  double T_min_, T_max_, p_min_, p_max_;
+  int refinement_;
+  double tol_;
+
+  Grid coarse_;
+  double e_scale_, wc_scale_;
+  std::map<int, Grid> patches_;
+};
+
+} // namespace
+
+#endif
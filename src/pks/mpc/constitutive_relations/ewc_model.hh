@@ -34,6 +34,15 @@ class EWCModel {
   virtual int InverseEvaluate(double energy, double wc, double& T, double& p, bool verbose=false) = 0;
   virtual int InverseEvaluateEnergy(double energy, double p, double& T) = 0;
 
+  // An inverse that may be approximated from precomputed tables, if enabled.
+  // Tables are built for the materials of cells [0,ncells) when enabled, and
+  // returns false if they are not.  By default this is the full inverse.
+  virtual bool EnableInverseTables(const Teuchos::Ptr<State>& S, int ncells,
+          Teuchos::ParameterList& plist) { return false; }
+  virtual int InverseEvaluateTabulated(double energy, double wc, double& T, double& p) {
+    return InverseEvaluate(energy, wc, T, p);
+  }
+
   virtual int EvaluateSaturations(double T, double p, double& s_gas, double& s_liq, double& s_ice) = 0;
 };
 
@@ -10,6 +10,9 @@ evaluating.
 
 ------------------------------------------------------------------------- */
 
+#include <algorithm>
+#include <cmath>
+
 #include "ewc_model_base.hh"
 
 #define DEBUG_FLAG 0
@@ -45,6 +48,12 @@ Error codes:
 ---------------------------------------------------------------------- */
 int EWCModelBase::InverseEvaluate(double energy, double wc,
         double& T, double& p, bool verbose) {
+  return InverseEvaluateNewton_(energy, wc, T, p, verbose, true);
+}
+
+
+int EWCModelBase::InverseEvaluateNewton_(double energy, double wc,
+        double& T, double& p, bool verbose, bool report_failure) {
 
   // -- scaling for the norms
   double wc_scale = 1.;
@@ -60,7 +69,7 @@ int EWCModelBase::InverseEvaluate(double energy, double wc,
   WhetStone::Tensor jac(2,2);
   int ierr = EvaluateEnergyAndWaterContentAndJacobian_(T,p,res,jac);
   if (ierr) {
-    std::cout << "Error in evaluation: " << ierr << std::endl;
+    if (report_failure) std::cout << "Error in evaluation: " << ierr << std::endl;
     return ierr + 10;
   }
 
@@ -93,11 +102,13 @@ int EWCModelBase::InverseEvaluate(double energy, double wc,
     AmanziGeometry::Point correction;
 
     if (std::abs(detJ) < 1.e-20) {
-      std::cout << " Zero determinant of Jacobian:" << std::endl;
-      std::cout << "   [" << jac(0,0) << "," << jac(0,1) << "]" << std::endl;
-      std::cout << "   [" << jac(1,0) << "," << jac(1,1) << "]" << std::endl;
-      std::cout << "  at T,p = " << x_tmp[0] << ", " << x_tmp[1] << std::endl;
-      std::cout << "  with res(e,wc) = " << res[0] << ", " << res[1] << std::endl;
+      if (report_failure) {
+        std::cout << " Zero determinant of Jacobian:" << std::endl;
+        std::cout << "   [" << jac(0,0) << "," << jac(0,1) << "]" << std::endl;
+        std::cout << "   [" << jac(1,0) << "," << jac(1,1) << "]" << std::endl;
+        std::cout << "  at T,p = " << x_tmp[0] << ", " << x_tmp[1] << std::endl;
+        std::cout << "  with res(e,wc) = " << res[0] << ", " << res[1] << std::endl;
+      }
       return 1;
     }
 
@@ -120,7 +131,7 @@ int EWCModelBase::InverseEvaluate(double energy, double wc,
     x_tmp = x - correction;
     ierr = EvaluateEnergyAndWaterContentAndJacobian_(x_tmp[0],x_tmp[1],res,jac);
     if (ierr) {
-      std::cout << "Error in evaluation: " << ierr << std::endl;
+      if (report_failure) std::cout << "Error in evaluation: " << ierr << std::endl;
       return ierr + 10;
     }
     res = res - f;
@@ -147,7 +158,7 @@ int EWCModelBase::InverseEvaluate(double energy, double wc,
       // evaluate the damped value
       ierr = EvaluateEnergyAndWaterContent_(x_tmp[0],x_tmp[1],res);
       if (ierr) {
-        std::cout << "Error in evaluation: " << ierr << std::endl;
+        if (report_failure) std::cout << "Error in evaluation: " << ierr << std::endl;
         return ierr + 10;
       }
       res = res - f;
@@ -168,7 +179,7 @@ int EWCModelBase::InverseEvaluate(double energy, double wc,
       // must recalculate the Jacobian at the new value
       ierr = EvaluateEnergyAndWaterContentAndJacobian_(x_tmp[0],x_tmp[1],res,jac);
       if (ierr) {
-        std::cout << "Error in evaluation: " << ierr << std::endl;
+        if (report_failure) std::cout << "Error in evaluation: " << ierr << std::endl;
         return ierr + 10;
       }
       res = res - f;
@@ -184,8 +195,9 @@ int EWCModelBase::InverseEvaluate(double energy, double wc,
 
     stepnum++;
     if (stepnum > max_steps && !converged) {
-      std::cout << " Nonconverged after " << max_steps << " steps with norm (tol) "
-                << norm << " (" << tol << ")" << std::endl;
+      if (report_failure)
+        std::cout << " Nonconverged after " << max_steps << " steps with norm (tol) "
+                  << norm << " (" << tol << ")" << std::endl;
       return 2;
     }
   }
@@ -336,6 +348,188 @@ int EWCModelBase::InverseEvaluateEnergy(double energy, double p,
 }
 
 
+namespace {
+
+// Values spanning [lo, hi], a single value if the range is empty.
+std::vector<double>
+spanRange(double lo, double hi, int n)
+{
+  if (hi - lo <= 1.e-10 * std::max(1., std::abs(lo))) return std::vector<double>(1, lo);
+  n = std::max(n, 2);
+  std::vector<double> values(n);
+  for (int k=0; k!=n; ++k) values[k] = lo + (hi - lo) * k / (n - 1);
+  return values;
+}
+
+// The interval [xs[k], xs[k+1]] containing x and the weight s of xs[k+1],
+// returning false if x is outside of xs.  A single value is matched exactly.
+bool
+bracket(const std::vector<double>& xs, double x, int& k, double& s)
+{
+  double tol = 1.e-10 * std::max(1., std::abs(xs.front()));
+  k = 0;
+  s = 0.;
+  if (xs.size() == 1) return std::abs(x - xs[0]) < tol;
+  if (x < xs.front() - tol || x > xs.back() + tol) return false;
+  k = std::upper_bound(xs.begin(), xs.end(), x) - xs.begin() - 1;
+  k = std::max(0, std::min(k, (int) xs.size() - 2));
+  s = (x - xs[k]) / (xs[k+1] - xs[k]);
+  return true;
+}
+
+} // namespace
+
+
+// ----------------------------------------------------------------------
+// Enable tabulated inverse evaluation, building the tables of every material
+// of cells [0,ncells).  Returns false if there are too many materials, or
+// the model cannot be tabulated.
+// ----------------------------------------------------------------------
+bool EWCModelBase::EnableInverseTables(const Teuchos::Ptr<State>& S, int ncells,
+        Teuchos::ParameterList& plist) {
+  polish_ = plist.get<bool>("Newton polish", true);
+  accept_tol_ = plist.get<double>("acceptance tolerance", 1.e-6);
+  int nporo = plist.get<int>("number of porosity points", 5);
+  int nrho = plist.get<int>("number of rock density points", 3);
+  int max_materials = plist.get<int>("maximum number of materials", 16);
+  AMANZI_ASSERT(nporo > 0 && nrho > 0);
+  tables_.clear();
+  tabulated_ = false;
+
+  // find the materials, the range of their porosities and rock densities,
+  // and a cell of each
+  struct Range {
+    double poro_min, poro_max, rho_min, rho_max;
+    int c;
+  };
+  std::map<MaterialKey, Range> ranges;
+  for (int c=0; c!=ncells; ++c) {
+    UpdateModel(S, c);
+    MaterialKey key;
+    double poro, rho_rock;
+    if (!Material_(key, poro, rho_rock)) return false;
+
+    auto range = ranges.find(key);
+    if (range == ranges.end()) {
+      if (ranges.size() == (std::size_t) max_materials) return false;
+      ranges[key] = Range{ poro, poro, rho_rock, rho_rock, c };
+    } else {
+      range->second.poro_min = std::min(range->second.poro_min, poro);
+      range->second.poro_max = std::max(range->second.poro_max, poro);
+      range->second.rho_min = std::min(range->second.rho_min, rho_rock);
+      range->second.rho_max = std::max(range->second.rho_max, rho_rock);
+    }
+  }
+
+  // tabulate each material at porosities and rock densities spanning those
+  // ranges
+  for (const auto& range : ranges) {
+    UpdateModel(S, range.second.c);
+    MaterialTables& mat = tables_[range.first];
+    mat.poro = spanRange(range.second.poro_min, range.second.poro_max, nporo);
+    mat.rho_rock = spanRange(range.second.rho_min, range.second.rho_max, nrho);
+
+    for (double rho_rock : mat.rho_rock) {
+      for (double poro : mat.poro) {
+        SetParameters_(poro, rho_rock);
+        auto table = Teuchos::rcp(new EWCInverseTable(plist));
+        table->Build(
+            [this](double T, double p, double& e, double& wc) {
+              return Evaluate(T, p, e, wc); },
+            [this](double e, double wc, double& T, double& p) {
+              return InverseEvaluateNewton_(e, wc, T, p, false, false); });
+        mat.tables.push_back(table);
+      }
+    }
+  }
+  tabulated_ = true;
+  return true;
+}
+
+
+// ----------------------------------------------------------------------
+// Interpolates from the tables of the material the model is updated to,
+// returning false if the material or point is not tabulated.
+// ----------------------------------------------------------------------
+bool EWCModelBase::LookupTabulated_(double energy, double wc, double& T, double& p) {
+  MaterialKey key;
+  double poro, rho_rock;
+  if (!Material_(key, poro, rho_rock)) return false;
+
+  auto mat = tables_.find(key);
+  if (mat == tables_.end()) return false;
+  const MaterialTables& tables = mat->second;
+
+  // bilinearly interpolate between the bracketing porosities and densities
+  int i, j;
+  double s, r;
+  if (!bracket(tables.poro, poro, i, s) ||
+      !bracket(tables.rho_rock, rho_rock, j, r)) return false;
+
+  int nporo = tables.poro.size();
+  T = 0.;
+  p = 0.;
+  for (int dj=0; dj!=(tables.rho_rock.size() > 1 ? 2 : 1); ++dj) {
+    for (int di=0; di!=(nporo > 1 ? 2 : 1); ++di) {
+      double w = (di ? s : 1 - s) * (dj ? r : 1 - r);
+      double T_k, p_k;
+      if (!tables.tables[(i+di) + (j+dj) * nporo]->Lookup(energy, wc, T_k, p_k)) return false;
+      T += w * T_k;
+      p += w * p_k;
+    }
+  }
+  return true;
+}
+
+
+/* ----------------------------------------------------------------------
+Approximates the inverse by interpolating from the tables of the current
+material, accepting the (optionally polished) value only if its residual is
+within tolerance.  Otherwise, falls back to the full inverse, starting from
+the interpolated value if there is one.  Error codes are as in
+InverseEvaluate().
+---------------------------------------------------------------------- */
+int EWCModelBase::InverseEvaluateTabulated(double energy, double wc,
+        double& T, double& p) {
+  double T_tab, p_tab;
+  if (!tabulated_ || !LookupTabulated_(energy, wc, T_tab, p_tab)) {
+    return InverseEvaluate(energy, wc, T, p);
+  }
+
+  AmanziGeometry::Point res(2);
+  WhetStone::Tensor jac(2,2);
+  if (polish_) {
+    // a single, capped Newton step from the interpolated value
+    if (!EvaluateEnergyAndWaterContentAndJacobian_(T_tab, p_tab, res, jac)) {
+      res[0] -= energy;
+      res[1] -= wc;
+      if (std::abs(jac.Det()) > 1.e-20) {
+        jac.Inverse();
+        AmanziGeometry::Point correction = jac * res;
+        double scale = 1.;
+        if (std::abs(correction[0]) > 2.) scale = 2. / std::abs(correction[0]);
+        if (std::abs(correction[1]) > 200000.) scale = std::min(scale, 200000. / std::abs(correction[1]));
+        T_tab -= scale * correction[0];
+        p_tab -= scale * correction[1];
+      }
+    }
+  }
+
+  // accept only a converged value
+  int ierr = EvaluateEnergyAndWaterContent_(T_tab, p_tab, res);
+  if (!ierr) {
+    res[0] -= energy;
+    res[1] -= wc;
+    ierr = AmanziGeometry::norm(res) < accept_tol_ ? 0 : 1;
+  }
+
+  T = T_tab;
+  p = p_tab;
+  if (ierr) return InverseEvaluate(energy, wc, T, p);
+  return 0;
+}
+
+
 int EWCModelBase::EvaluateEnergyAndWaterContentAndJacobian_(double T, double p,
         AmanziGeometry::Point& result, WhetStone::Tensor& jac) {
   return EvaluateEnergyAndWaterContentAndJacobian_FD_(T, p, result, jac);
@@ -8,28 +8,82 @@ Author: Ethan Coon
 EWCModelBase provides some of the functionality of EWCModel for inverse
 evaluating.
 
+Optionally, inverse evaluations may be approximated by interpolating from
+tables.  When enabled, tables are built for each material present, where a
+material is everything but porosity and rock density that the model depends
+upon, e.g. a region's WRM.  Each material is tabulated at several porosities
+and rock densities spanning those of its cells, and lookups interpolate
+bilinearly between them, so that heterogeneous fields of either do not
+multiply the number of materials.  The interpolated value may be polished by
+a single Newton step, and is accepted only if its residual is within
+tolerance.  Otherwise, and off the table, the full Newton solve is used,
+starting from the interpolated value if there is one.  Tables are specified
+by the parameters of EWCInverseTable, and:
+
+  * `"Newton polish`" ``[bool]`` **true** Take one Newton step from the
+    interpolated value.
+  * `"acceptance tolerance`" ``[double]`` **1.e-6** Residual norm, as in the
+    full Newton solve, below which a tabulated value is accepted.
+  * `"number of porosity points`" ``[int]`` **5** Porosities per material,
+    spanning the range of its cells' porosities.
+  * `"number of rock density points`" ``[int]`` **3** Rock densities per
+    material, spanning the range of its cells' rock densities.
+  * `"maximum number of materials`" ``[int]`` **16** If more materials are
+    present, nothing is tabulated and the full inverse is used.
+
+Only models that can identify their material, by implementing Material_(),
+can be tabulated.
+
 ------------------------------------------------------------------------- */
 
 #ifndef AMANZI_EWC_MODEL_BASE_HH_
 #define AMANZI_EWC_MODEL_BASE_HH_
 
+#include <map>
+#include <tuple>
+#include <vector>
+
 #include "Tensor.hh"
 #include "Point.hh"
 
 #include "ewc_model.hh"
+#include "ewc_inverse_table.hh"
 
 namespace Amanzi {
 
 class EWCModelBase : public EWCModel {
  public:
-  EWCModelBase() {}
+  EWCModelBase() : tabulated_(false) {}
   virtual ~EWCModelBase() = default;
   
   virtual int Evaluate(double T, double p, double& energy, double& wc);
   virtual int InverseEvaluate(double energy, double wc, double& T, double& p, bool verbose=false);
   virtual int InverseEvaluateEnergy(double energy, double p, double& T);
 
+  virtual bool EnableInverseTables(const Teuchos::Ptr<State>& S, int ncells,
+          Teuchos::ParameterList& plist);
+  virtual int InverseEvaluateTabulated(double energy, double wc, double& T, double& p);
+
  protected:
+  // Full Newton solve for the inverse.
+  int InverseEvaluateNewton_(double energy, double wc, double& T, double& p,
+                             bool verbose, bool report_failure);
+
+  // Identifies the material the model is currently updated to: the WRM and
+  // porosity models, and atmospheric pressure.
+  typedef std::tuple<const void*, const void*, double> MaterialKey;
+
+  // Gets the material, porosity, and rock density the model is currently
+  // updated to, i.e. everything other than (T,p) that the model depends
+  // upon.  Returns false if the model cannot be tabulated.
+  virtual bool Material_(MaterialKey& key, double& poro, double& rho_rock) { return false; }
+
+  // Sets the porosity and rock density of the current material.
+  virtual void SetParameters_(double poro, double rho_rock) {}
+
+  // Interpolates from the tables of the current material.
+  bool LookupTabulated_(double energy, double wc, double& T, double& p);
+
 
   virtual int EvaluateEnergyAndWaterContent_(double T, double p,
           AmanziGeometry::Point& result) = 0;
@@ -39,6 +93,20 @@ class EWCModelBase : public EWCModel {
 
   int EvaluateEnergyAndWaterContentAndJacobian_FD_(double T, double p,
           AmanziGeometry::Point& result, WhetStone::Tensor& jac);
+
+ protected:
+  // a material's tables, at increasing porosity and rock density, indexed
+  // by i_poro + i_rho * poro.size()
+  struct MaterialTables {
+    std::vector<double> poro;
+    std::vector<double> rho_rock;
+    std::vector<Teuchos::RCP<EWCInverseTable> > tables;
+  };
+
+  std::map<MaterialKey, MaterialTables> tables_;
+  bool tabulated_;
+  bool polish_;
+  double accept_tol_;
 };
 
 } // namespace
@@ -168,6 +168,34 @@ void PermafrostModel::UpdateModel(const Teuchos::Ptr<State>& S, int c) {
   AMANZI_ASSERT(IsSetUp_());
 }
 
+// The fields identifying each cell's material are needed before their
+// evaluators are otherwise first updated.
+bool PermafrostModel::EnableInverseTables(const Teuchos::Ptr<State>& S, int ncells,
+        Teuchos::ParameterList& plist) {
+  for (const auto& name : { "base_porosity", "density_rock" }) {
+    Key key = Keys::getKey(domain, name);
+    if (S->HasFieldEvaluator(key)) S->GetFieldEvaluator(key)->HasFieldChanged(S, "ewc");
+  }
+  return EWCModelBase::EnableInverseTables(S, ncells, plist);
+}
+
+// The model depends upon the cell through its region's WRM and porosity
+// models, its porosity, and its rock density.  The latter two are tabulated
+// over, not part of the material.
+bool PermafrostModel::Material_(MaterialKey& key, double& poro, double& rho_rock) {
+  const void* poro_model = poro_leij_ ? (const void*) poro_leij_model_.get()
+      : (const void*) poro_model_.get();
+  key = MaterialKey(wrm_.get(), poro_model, p_atm_);
+  poro = poro_;
+  rho_rock = rho_rock_;
+  return true;
+}
+
+void PermafrostModel::SetParameters_(double poro, double rho_rock) {
+  poro_ = poro;
+  rho_rock_ = rho_rock;
+}
+
 bool PermafrostModel::IsSetUp_() {
   if (wrm_ == Teuchos::null) return false;
   if (!poro_leij_) {
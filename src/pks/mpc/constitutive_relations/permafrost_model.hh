@@ -40,12 +40,16 @@ class PermafrostModel : public EWCModelBase {
   virtual void InitializeModel(const Teuchos::Ptr<State>& S,
                                Teuchos::ParameterList& plist);
   virtual void UpdateModel(const Teuchos::Ptr<State>& S, int c);
+  virtual bool EnableInverseTables(const Teuchos::Ptr<State>& S, int ncells,
+          Teuchos::ParameterList& plist);
   virtual bool Freezing(double T, double p);
   virtual int EvaluateSaturations(double T, double p,
                                   double& s_gas, double& s_liq, double& s_ice);
   
  protected:
   bool IsSetUp_();
+  virtual bool Material_(MaterialKey& key, double& poro, double& rho_rock);
+  virtual void SetParameters_(double poro, double rho_rock);
 
   int EvaluateEnergyAndWaterContent_(double T, double p,
           AmanziGeometry::Point& result);
@@ -0,0 +1,93 @@
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+*/
+
+#include <cmath>
+#include <iostream>
+#include "UnitTest++.h"
+
+#include "Teuchos_ParameterList.hpp"
+
+#include "ewc_inverse_table.hh"
+
+namespace {
+
+// A model with a latent heat cliff at freezing, and water content linear in
+// pressure, whose inverse is known.
+double liquidFraction(double T) {
+  return 0.5 * (1. + std::tanh((T - 273.15) / 0.5));
+}
+
+int forward(double T, double p, double& energy, double& wc) {
+  energy = 2000. * (T - 273.15) + 3.e5 * liquidFraction(T);
+  wc = 0.3 + 1.e-7 * p;
+  return 0;
+}
+
+int inverse(double energy, double wc, double& T, double& p) {
+  // energy is monotonic in T
+  double T_lo = 200., T_hi = 350.;
+  for (int i=0; i!=100; ++i) {
+    T = 0.5 * (T_lo + T_hi);
+    double e, w;
+    forward(T, 0., e, w);
+    if (e < energy) T_lo = T;
+    else T_hi = T;
+  }
+  p = (wc - 0.3) / 1.e-7;
+  return 0;
+}
+
+Teuchos::ParameterList tableList() {
+  Teuchos::ParameterList plist;
+  plist.set<double>("minimum temperature [K]", 263.15);
+  plist.set<double>("maximum temperature [K]", 283.15);
+  plist.set<double>("minimum pressure [Pa]", 1.e4);
+  plist.set<double>("maximum pressure [Pa]", 1.e6);
+  plist.set<int>("number of energy points", 33);
+  plist.set<int>("number of water content points", 17);
+  return plist;
+}
+
+} // namespace
+
+
+TEST(EWC_INVERSE_TABLE_LOOKUP) {
+  auto plist = tableList();
+  Amanzi::EWCInverseTable table(plist);
+  table.Build(forward, inverse);
+
+  // the freezing cliff is poorly resolved by the coarse grid
+  CHECK(table.num_refined() > 0);
+
+  // lookups recover (T,p) across the box, including through the cliff
+  for (int i=1; i!=20; ++i) {
+    double T0 = 263.15 + i;
+    for (int j=1; j!=10; ++j) {
+      double p0 = 1.e4 + j * 9.9e4;
+      double e, wc;
+      forward(T0, p0, e, wc);
+
+      double T, p;
+      CHECK(table.Lookup(e, wc, T, p));
+      CHECK_CLOSE(T0, T, 0.05);
+      CHECK_CLOSE(p0, p, 1.e-6 * p0);
+    }
+  }
+}
+
+
+TEST(EWC_INVERSE_TABLE_OFF_TABLE) {
+  auto plist = tableList();
+  Amanzi::EWCInverseTable table(plist);
+  table.Build(forward, inverse);
+
+  // points outside the image of the box are not tabulated
+  double e, wc, T, p;
+  forward(300., 5.e5, e, wc);
+  CHECK(!table.Lookup(e, wc, T, p));
+  forward(270., 2.e6, e, wc);
+  CHECK(!table.Lookup(e, wc, T, p));
+}
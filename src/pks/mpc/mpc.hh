@@ -49,11 +49,14 @@ respective methods.
 
 #include "PK.hh"
 #include "PK_Factory.hh"
+#include "pk_diagnostics.hh"
+#include "pk_bdf_default.hh"
 
 namespace Amanzi {
 
 template <class PK_t>
-class MPC : virtual public PK {
+class MPC : virtual public PK, virtual public PK_Diagnostics,
+            virtual public PK_BDF_Tree {
 
 public:
 
@@ -106,8 +109,11 @@ public:
   // -- loops over sub-PKs
   virtual void CommitStep(double t_old, double t_new, const Teuchos::RCP<State>& S);
   virtual void CalculateDiagnostics(const Teuchos::RCP<State>& S);
+  virtual void CalculateDemandedDiagnostics(const Teuchos::RCP<State>& S,
+          const DiagnosticsDemand& demand);
   virtual bool ValidStep();
   virtual void ChangedSolutionPK(const Teuchos::Ptr<State>& S);
+  virtual void ResetTimeSteppers(double time);
   
   // set States
   virtual void set_states(const Teuchos::RCP<State>& S,
@@ -227,6 +233,31 @@ void MPC<PK_t>::CalculateDiagnostics(const Teuchos::RCP<State>& S) {
 };
 
 
+// -----------------------------------------------------------------------------
+// loop over sub-PKs, passing on the fields consumed by output
+// -----------------------------------------------------------------------------
+template <class PK_t>
+void MPC<PK_t>::CalculateDemandedDiagnostics(const Teuchos::RCP<State>& S,
+        const DiagnosticsDemand& demand) {
+  for (typename SubPKList::iterator pk = sub_pks_.begin();
+       pk != sub_pks_.end(); ++pk) {
+    calculateDiagnostics(**pk, S, demand);
+  }
+};
+
+
+// -----------------------------------------------------------------------------
+// loop over sub-PKs, resetting their time integrators
+// -----------------------------------------------------------------------------
+template <class PK_t>
+void MPC<PK_t>::ResetTimeSteppers(double time) {
+  for (typename SubPKList::iterator pk = sub_pks_.begin();
+       pk != sub_pks_.end(); ++pk) {
+    resetTimeSteppers(**pk, time);
+  }
+};
+
+
 // -----------------------------------------------------------------------------
 // loop over sub-PKs, calling their ValidStep() method
 // -----------------------------------------------------------------------------
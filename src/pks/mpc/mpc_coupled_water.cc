@@ -2,7 +2,10 @@
 #include "EpetraExt_RowMatrixOut.h"
 
 
+#include "OperatorUtils.hh"
+
 #include "mpc_surface_subsurface_helpers.hh"
+#include "column_line_preconditioner.hh"
 #include "mpc_coupled_water.hh"
 
 namespace Amanzi {
@@ -12,7 +15,8 @@ MPCCoupledWater::MPCCoupledWater(Teuchos::ParameterList& FElist,
                   const Teuchos::RCP<State>& S,
                   const Teuchos::RCP<TreeVector>& soln) :
     PK(FElist, plist,  S, soln),
-    StrongMPC<PK_PhysicalBDF_Default>(FElist, plist,  S, soln) {}
+    StrongMPC<PK_PhysicalBDF_Default>(FElist, plist,  S, soln),
+    line_pc_initialized_(false) {}
 
 
 
@@ -52,11 +56,16 @@ MPCCoupledWater::Setup(const Teuchos::Ptr<State>& S) {
   precon_ = domain_flow_pk_->preconditioner();
   precon_surf_ = surf_flow_pk_->preconditioner();
 
-  // -- set parameters for an inverse
-  Teuchos::ParameterList inv_list = plist_->sublist("inverse");
-  inv_list.setParameters(plist_->sublist("preconditioner"));
-  inv_list.setParameters(plist_->sublist("linear solver"));
-  precon_->set_inverse_parameters(inv_list);
+  // -- set parameters for an inverse, or for the line preconditioner
+  if (plist_->isSublist("line preconditioner")) {
+    line_pc_ = Teuchos::rcp(new ColumnLinePreconditioner(plist_->sublist("line preconditioner"),
+            domain_mesh_));
+  } else {
+    Teuchos::ParameterList inv_list = plist_->sublist("inverse");
+    inv_list.setParameters(plist_->sublist("preconditioner"));
+    inv_list.setParameters(plist_->sublist("linear solver"));
+    precon_->set_inverse_parameters(inv_list);
+  }
 
   // -- push the surface local ops into the subsurface global operator
   for (Operators::Operator::op_iterator op = precon_surf_->begin();
@@ -142,7 +151,16 @@ int MPCCoupledWater::ApplyPreconditioner(Teuchos::RCP<const TreeVector> u,
   // call the precon's inverse
   if (vo_->os_OK(Teuchos::VERB_EXTREME))
     *vo_->os() << "Precon applying subsurface operator." << std::endl;
-  int ierr = precon_->ApplyInverse(*u->SubVector(0)->Data(), *Pu->SubVector(0)->Data());
+  int ierr = 0;
+  if (line_pc_ != Teuchos::null) {
+    const Operators::SuperMap& smap = *precon_->get_supermap();
+    Operators::CopyCompositeVectorToSuperVector(smap, *u->SubVector(0)->Data(), *line_b_);
+    // positive is success, as for the operator's inverse
+    ierr = (line_pc_->ApplyInverse(*line_b_, *line_x_) == 0) ? 1 : -1;
+    Operators::CopySuperVectorToCompositeVector(smap, *line_x_, *Pu->SubVector(0)->Data());
+  } else {
+    ierr = precon_->ApplyInverse(*u->SubVector(0)->Data(), *Pu->SubVector(0)->Data());
+  }
 
   if (vo_->os_OK(Teuchos::VERB_EXTREME))
     *vo_->os() << "Precon applying  CopySubsurfaceToSurface." << std::endl;
@@ -188,6 +206,23 @@ MPCCoupledWater::UpdatePreconditioner(double t,
   // doing the subsurface 2nd re-inits the surface matrices (and doesn't
   // refill them).  This is why subsurface is first
   StrongMPC<PK_PhysicalBDF_Default>::UpdatePreconditioner(t, up, h);
+
+  // the line preconditioner is factored from the assembled matrix, where the
+  // surface cells are the top faces of the columns
+  if (line_pc_ != Teuchos::null) {
+    if (!line_pc_initialized_) {
+      precon_->SymbolicAssembleMatrix();
+      line_pc_->InitializeInverse(*precon_->get_supermap(), 1);
+      line_b_ = Teuchos::rcp(new Epetra_Vector(*precon_->get_supermap()->Map()));
+      line_x_ = Teuchos::rcp(new Epetra_Vector(line_b_->Map()));
+      line_pc_initialized_ = true;
+    }
+    precon_->AssembleMatrix();
+    line_pc_->UpdateInverse(precon_->A());
+    if (vo_->os_OK(Teuchos::VERB_HIGH))
+      *vo_->os() << "  line preconditioner factors: " << line_pc_->bytes() << " bytes, "
+                 << (line_pc_->single_precision() ? "single" : "double") << " precision" << std::endl;
+  }
 }
 
 // -- Modify the predictor.
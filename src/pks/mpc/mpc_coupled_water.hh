@@ -30,6 +30,11 @@ surface equations are directly assembled into the subsurface discrete operator.
    * `"water delegate`" ``[mpc-delegate-water-spec]`` A `Coupled Water
      Globalization Delegate`_ spec.
 
+   * `"line preconditioner`" ``[column-line-preconditioner-spec]`` If
+     provided, the coupled preconditioner is inverted by exact solves along
+     each subsurface column, including its surface cell, instead of by the
+     `"inverse`" list.
+
    INCLUDES:
 
    - ``[strong-mpc-spec]`` *Is a* StrongMPC_
@@ -39,6 +44,8 @@ surface equations are directly assembled into the subsurface discrete operator.
 #ifndef PKS_MPC_COUPLED_WATER_HH_
 #define PKS_MPC_COUPLED_WATER_HH_
 
+#include "Epetra_Vector.h"
+
 #include "Operator.hh"
 #include "mpc_delegate_water.hh"
 #include "pk_physical_bdf_default.hh"
@@ -47,6 +54,8 @@ surface equations are directly assembled into the subsurface discrete operator.
 
 namespace Amanzi {
 
+class ColumnLinePreconditioner;
+
 class MPCCoupledWater : public StrongMPC<PK_PhysicalBDF_Default> {
  public:
 
@@ -102,6 +111,9 @@ class MPCCoupledWater : public StrongMPC<PK_PhysicalBDF_Default> {
   // coupled preconditioner
   Teuchos::RCP<Operators::Operator> precon_;
   Teuchos::RCP<Operators::Operator> precon_surf_;
+  Teuchos::RCP<ColumnLinePreconditioner> line_pc_;
+  bool line_pc_initialized_;
+  Teuchos::RCP<Epetra_Vector> line_b_, line_x_;
 
   // Water delegate
   Teuchos::RCP<MPCDelegateWater> water_;
@@ -127,6 +127,18 @@ void MPCDelegateEWC::initialize(const Teuchos::Ptr<State>& S) {
 
   // initialize the model, which grabs all needed models from state
   model_->InitializeModel(S, *plist_);
+
+  // optionally tabulate the inverse used by the predictor, for the materials
+  // of all owned cells
+  if (plist_->isSublist("inverse table")) {
+    int ncells = mesh_->num_entities(AmanziMesh::CELL, AmanziMesh::Parallel_type::OWNED);
+    if (!model_->EnableInverseTables(S, ncells, plist_->sublist("inverse table")) &&
+        vo_->os_OK(Teuchos::VERB_LOW)) {
+      Teuchos::OSTab tab = vo_->getOSTab();
+      *vo_->os() << "WARNING: the EWC inverse is not tabulated, as the model cannot be or has"
+                 << " more than \"maximum number of materials\"; using the full inverse." << std::endl;
+    }
+  }
 }
 
 
@@ -66,6 +66,15 @@ provides the initial guess to the nonlinear solve.
       over which to assume we are close to the latent heat cliff as we get
       warmer, and begins applying the EWC algorithm in `"ewc smarter`".
         
+    * `"inverse table`" ``[list]`` If provided, the smart EWC predictor
+      (subsurface only) interpolates the inverse map (energy, water content)
+      --> (temperature, pressure) from tables built at initialization for
+      each material, optionally polished by a single Newton step, rather than
+      doing a full Newton solve in every cell.  Points off the table, or
+      whose interpolated value does not meet the tolerance, fall back to the
+      full solve, as do all cells, with a warning, if there are too many
+      materials.  See EWCModelBase and EWCInverseTable for parameters.
+
     * `"pressure key`" ``[string]`` **DOMAIN-pressure**
     * `"temperature key`" ``[string]`` **DOMAIN-temperature**
     * `"water content key`" ``[string]`` **DOMAIN-water_content**
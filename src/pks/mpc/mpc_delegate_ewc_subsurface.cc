@@ -145,7 +145,7 @@ bool MPCDelegateEWCSubsurface::modify_predictor_smart_ewc_(double h, Teuchos::RC
 
       } else {
         // -- invert for T,p at the projected ewc
-        ierr = model_->InverseEvaluate(e2[0][c]/cv[0][c], wc2[0][c]/cv[0][c], T, p);
+        ierr = model_->InverseEvaluateTabulated(e2[0][c]/cv[0][c], wc2[0][c]/cv[0][c], T, p);
         ewc_completed = true;
         if (ierr) {
           if (dcvo != Teuchos::null && dcvo->os_OK(Teuchos::VERB_EXTREME))
@@ -182,7 +182,7 @@ bool MPCDelegateEWCSubsurface::modify_predictor_smart_ewc_(double h, Teuchos::RC
 
       } else {
         // in the transition zone of latent heat exchange
-        ierr = model_->InverseEvaluate(e2[0][c]/cv[0][c], wc2[0][c]/cv[0][c], T, p);
+        ierr = model_->InverseEvaluateTabulated(e2[0][c]/cv[0][c], wc2[0][c]/cv[0][c], T, p);
         ewc_completed = true;
         if (ierr) {
           if (dcvo != Teuchos::null && dcvo->os_OK(Teuchos::VERB_EXTREME))
@@ -229,7 +229,7 @@ bool MPCDelegateEWCSubsurface::modify_predictor_smart_ewc_(double h, Teuchos::RC
 
         } else {
           // -- invert for T,p at the projected ewc
-          ierr = model_->InverseEvaluate(e2[0][c]/cv[0][c], wc2[0][c]/cv[0][c], T, p);
+          ierr = model_->InverseEvaluateTabulated(e2[0][c]/cv[0][c], wc2[0][c]/cv[0][c], T, p);
           if (ierr) {
             if (dcvo != Teuchos::null && dcvo->os_OK(Teuchos::VERB_EXTREME))
               *dcvo->os() << "FAILED EWC PREDICTOR" << std::endl;
@@ -266,7 +266,7 @@ bool MPCDelegateEWCSubsurface::modify_predictor_smart_ewc_(double h, Teuchos::RC
 
         } else {
           // in the transition zone of latent heat exchange
-          ierr = model_->InverseEvaluate(e2[0][c]/cv[0][c], wc2[0][c]/cv[0][c], T, p);
+          ierr = model_->InverseEvaluateTabulated(e2[0][c]/cv[0][c], wc2[0][c]/cv[0][c], T, p);
           if (ierr) {
             if (dcvo != Teuchos::null && dcvo->os_OK(Teuchos::VERB_EXTREME))
               *dcvo->os() << "FAILED EWC PREDICTOR" << std::endl;
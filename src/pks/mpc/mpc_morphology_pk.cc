@@ -8,6 +8,10 @@
 
 */
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 #include "mpc_morphology_pk.hh"
 #include "Mesh.hh"
 
@@ -58,6 +62,16 @@ void Morphology_PK::Setup(const Teuchos::Ptr<State>& S){
 
   dt_MPC_ = plist_->get<double>("dt MPC", 31557600);
   MSF_ = plist_->get<double>("morphological scaling factor", 1);
+
+  // morphological acceleration, off unless the sublist is provided
+  accelerate_ = plist_->isSublist("morphological acceleration");
+  if (accelerate_) {
+    Teuchos::ParameterList& accel_list = plist_->sublist("morphological acceleration");
+    quasi_steady_tol_ = accel_list.get<double>("quasi-steady tolerance [-]", 1.e-3);
+    max_extrapolated_steps_ = accel_list.get<int>("maximum extrapolated steps", 10);
+    dz_tol_ = accel_list.get<double>("elevation change tolerance [m]", 0.01);
+    msl_tol_ = accel_list.get<double>("sea level change tolerance [m]", dz_tol_);
+  }
   
   Amanzi::PK_MPCSubcycled_ATS::Setup(S);
   
@@ -139,6 +153,33 @@ void Morphology_PK::Setup(const Teuchos::Ptr<State>& S){
 
   if (!S->HasField("msl"))
     S->RequireScalar("msl");
+
+  if (accelerate_) {
+    flow_key_ = Keys::readKey(*plist_, domain_, "pressure", "pressure");
+    sed_key_ = Keys::readKey(*plist_, domain_, "sediment", "sediment");
+
+    dz_rate_key_ = Keys::getKey(domain_, "deformation_rate");
+    dz_pending_key_ = Keys::getKey(domain_, "deformation_pending");
+    for (const auto& key : { dz_rate_key_, dz_pending_key_ }) {
+      S->RequireField(key, name_)->SetMesh(mesh_)->SetGhosted(false)
+          ->SetComponent("cell", AmanziMesh::CELL, 1);
+      S->GetField(key, name_)->set_io_vis(false);
+    }
+
+    flow_prev_key_ = Keys::getKey(domain_, "morphology_previous_pressure");
+    S->RequireField(flow_prev_key_, name_)->Update(*S->RequireField(flow_key_))->SetGhosted(false);
+    S->GetField(flow_prev_key_, name_)->set_io_vis(false);
+    sed_prev_key_ = Keys::getKey(domain_, "morphology_previous_sediment");
+    S->RequireField(sed_prev_key_, name_)->Update(*S->RequireField(sed_key_))->SetGhosted(false);
+    S->GetField(sed_prev_key_, name_)->set_io_vis(false);
+
+    n_extrapolated_key_ = Keys::getKey(domain_, "morphology_extrapolated_steps");
+    n_simulated_key_ = Keys::getKey(domain_, "morphology_simulated_steps");
+    msl_prev_key_ = Keys::getKey(domain_, "morphology_previous_msl");
+    for (const auto& key : { n_extrapolated_key_, n_simulated_key_, msl_prev_key_ }) {
+      S->RequireScalar(key, name_);
+    }
+  }
  
 }
 
@@ -170,6 +211,20 @@ void Morphology_PK::Initialize(const Teuchos::Ptr<State>& S){
 
   dz_accumul_ = Teuchos::rcp(new Epetra_MultiVector(dz));
   dz_accumul_->PutScalar(0.);
+
+  // overwritten by the checkpoint on restart
+  if (accelerate_) {
+    for (const auto& key : { dz_rate_key_, dz_pending_key_, flow_prev_key_, sed_prev_key_ }) {
+      S->GetFieldData(key, name_)->PutScalar(0.);
+      S->GetField(key, name_)->set_initialized();
+    }
+    *S->GetScalarData(n_extrapolated_key_, name_) = -1.;
+    *S->GetScalarData(n_simulated_key_, name_) = 0.;
+    *S->GetScalarData(msl_prev_key_, name_) = 0.;
+    for (const auto& key : { n_extrapolated_key_, n_simulated_key_, msl_prev_key_ }) {
+      S->GetField(key, name_)->set_initialized();
+    }
+  }
 }
 
 void Morphology_PK::CommitStep(double t_old, double t_new, const Teuchos::RCP<State>& S) {
@@ -220,11 +275,34 @@ bool Morphology_PK::AdvanceStep(double t_old, double t_new, bool reinit) {
   
   Teuchos::RCP<Field_Scalar> msl_rcp = Teuchos::rcp_dynamic_cast<Field_Scalar>(S_inter_->GetField("msl", "state"));
   msl_rcp->Compute(t_old);
+  double msl = *S_inter_->GetScalarData("msl");
 
   Key elev_key = Keys::readKey(*plist_, domain_, "elevation", "elevation");
   Epetra_MultiVector& dz = *S_next_->GetFieldData(elevation_increase_key_, "state")->ViewComponent("cell",false);
   dz.PutScalar(0.);
 
+  // If the flow and sediment were quasi-steady over the last simulated
+  // steps, and the sea level forcing has not since changed, skip the direct
+  // simulation and extrapolate the bed elevation rate.
+  if (accelerate_) {
+    double& n_extrapolated = *S_next_->GetScalarData(n_extrapolated_key_, name_);
+    double msl_prev = *S_next_->GetScalarData(msl_prev_key_, name_);
+    bool forcing_steady = std::abs(msl - msl_prev) <= msl_tol_;
+
+    if (n_extrapolated >= 0 && n_extrapolated < max_extrapolated_steps_ && forcing_steady) {
+      const Epetra_MultiVector& dz_rate = *S_next_->GetFieldData(dz_rate_key_)->ViewComponent("cell", false);
+      dz.Update(dt_step, dz_rate, 0.);
+      n_extrapolated++;
+      if (vo_->getVerbLevel() >= Teuchos::VERB_HIGH)
+        *vo_->os()<<"Extrapolated morphology step "<<n_extrapolated<<" of "
+                  <<max_extrapolated_steps_<<"\n";
+
+      dz_accumul_->Update(1, dz, 1);
+      AccumulateMeshVertices_(S_next_.ptr());
+      return false;
+    }
+  }
+
   flow_pk_ -> ResetTimeStepper(t_old);
   
   S_inter_->set_intermediate_time(t_old);
@@ -297,7 +375,13 @@ bool Morphology_PK::AdvanceStep(double t_old, double t_new, bool reinit) {
   dz.Scale(MSF_);
   
   dz_accumul_->Update(1, dz, 1);  
-  Update_MeshVertices_(S_next_.ptr() );
+  if (accelerate_) {
+    bool steady = !fail && IsQuasiSteady_(S_next_.ptr(), dt_step, msl);
+    *S_next_->GetScalarData(n_extrapolated_key_, name_) = steady ? 0. : -1.;
+    AccumulateMeshVertices_(S_next_.ptr());
+  } else {
+    Update_MeshVertices_(S_next_.ptr() );
+  }
 
   
   bool chg = S_next_ -> GetFieldEvaluator(elev_key)->HasFieldChanged(S_next_.ptr(), elev_key);
@@ -357,6 +441,77 @@ bool Morphology_PK::AdvanceStep(double t_old, double t_new, bool reinit) {
 
 }
 
+// -----------------------------------------------------------------------------
+// Compare the flow and sediment states, and the bed elevation rate, at the end
+// of this simulated step to those at the end of the previous one, and record
+// this step's states.
+// -----------------------------------------------------------------------------
+bool Morphology_PK::IsQuasiSteady_(const Teuchos::Ptr<State>& S, double dt, double msl){
+
+  double& n_simulated = *S->GetScalarData(n_simulated_key_, name_);
+  bool has_prev = n_simulated > 0;
+  n_simulated++;
+
+  // the relative change in a cell vector, then stored as the previous value
+  auto relChange = [this,&S](const Key& key, const Key& prev_key) {
+    const Epetra_MultiVector& now = *S->GetFieldData(key)->ViewComponent("cell", false);
+    Epetra_MultiVector& prev = *S->GetFieldData(prev_key, name_)->ViewComponent("cell", false);
+    prev.Update(1., now, -1.);
+    std::vector<double> change(now.NumVectors()), norm(now.NumVectors());
+    prev.NormInf(&change[0]);
+    now.NormInf(&norm[0]);
+    prev = now;
+
+    double rel_change = 0.;
+    for (int k=0; k!=change.size(); ++k)
+      rel_change = std::max(rel_change, change[k] / std::max(norm[k], 1.e-12));
+    return rel_change;
+  };
+  double flow_change = relChange(flow_key_, flow_prev_key_);
+  double sed_change = relChange(sed_key_, sed_prev_key_);
+
+  // the bed elevation rate, whose previous value is that of the last
+  // simulated step
+  const Epetra_MultiVector& dz = *S->GetFieldData(elevation_increase_key_)->ViewComponent("cell", false);
+  Epetra_MultiVector& dz_rate = *S->GetFieldData(dz_rate_key_, name_)->ViewComponent("cell", false);
+  dz_rate.Update(1. / dt, dz, -1.);
+  double rate_change, rate_norm;
+  dz_rate.NormInf(&rate_change);
+  dz_rate.Update(1. / dt, dz, 0.);
+  dz_rate.NormInf(&rate_norm);
+  rate_change /= std::max(rate_norm, 1.e-12);
+
+  *S->GetScalarData(msl_prev_key_, name_) = msl;
+
+  bool steady = has_prev && flow_change < quasi_steady_tol_ &&
+      sed_change < quasi_steady_tol_ && rate_change < quasi_steady_tol_;
+  if (has_prev && vo_->getVerbLevel() >= Teuchos::VERB_HIGH)
+    *vo_->os()<<"Relative change in flow "<<flow_change<<", sediment "<<sed_change
+              <<", elevation rate "<<rate_change<<(steady ? ", quasi-steady" : "")<<"\n";
+  return steady;
+}
+
+
+// -----------------------------------------------------------------------------
+// Add this step's elevation change to the pending change, moving the mesh
+// vertices only once the pending change exceeds the tolerance.
+// -----------------------------------------------------------------------------
+void Morphology_PK::AccumulateMeshVertices_(const Teuchos::Ptr<State>& S){
+
+  Epetra_MultiVector& dz = *S->GetFieldData(elevation_increase_key_, "state")->ViewComponent("cell",false);
+  Epetra_MultiVector& dz_pending = *S->GetFieldData(dz_pending_key_, name_)->ViewComponent("cell",false);
+  dz_pending.Update(1., dz, 1.);
+
+  double max_pending;
+  dz_pending.NormInf(&max_pending);
+  if (max_pending >= dz_tol_) {
+    dz = dz_pending;
+    Update_MeshVertices_(S);
+    dz_pending.PutScalar(0.);
+  }
+}
+
+
 void Morphology_PK::Initialize_MeshVertices_(const Teuchos::Ptr<State>& S,
                                              Teuchos::RCP<const AmanziMesh::Mesh> mesh,
                                              Key vert_field_key){
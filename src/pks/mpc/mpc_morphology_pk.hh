@@ -55,6 +55,10 @@ namespace Amanzi {
     void Update_MeshVertices_(const Teuchos::Ptr<State>& S);
     
     void FlowAnalyticalSolution_(const Teuchos::Ptr<State>& S, double time);
+
+    // morphological acceleration
+    bool IsQuasiSteady_(const Teuchos::Ptr<State>& S, double dt, double msl);
+    void AccumulateMeshVertices_(const Teuchos::Ptr<State>& S);
     
     Key domain_, domain_3d_, domain_ss_;
     Key vertex_coord_key_, vertex_coord_key_3d_, vertex_coord_key_ss_;
@@ -69,6 +73,24 @@ namespace Amanzi {
     double dt_MPC_, dt_sample_;
     double MSF_;  // morphology scaling factor
 
+    // Morphological acceleration: once the flow and sediment are
+    // quasi-steady between outer steps, the bed elevation rate of the last
+    // simulated step is extrapolated over up to max_extrapolated_steps_
+    // outer steps without running flow or sediment transport, as long as the
+    // sea level forcing stays within msl_tol_ of its value at that step.
+    // Mesh vertices are only moved once the accumulated elevation change
+    // exceeds dz_tol_.  All of this state is kept in State, so that it is
+    // checkpointed.
+    bool accelerate_;
+    double quasi_steady_tol_;
+    double dz_tol_, msl_tol_;
+    int max_extrapolated_steps_;
+    Key flow_key_, sed_key_;
+    Key dz_rate_key_, dz_pending_key_;
+    Key flow_prev_key_, sed_prev_key_;
+    Key n_extrapolated_key_;  // -1 if not quasi-steady
+    Key n_simulated_key_, msl_prev_key_;
+
     Teuchos::RCP<AmanziMesh::Mesh> mesh_, mesh_3d_, mesh_ss_;
     Teuchos::RCP<PrimaryVariableFieldEvaluator> deform_eval_;
     Key erosion_rate_;
@@ -10,6 +10,7 @@ with freezing.
 
 ------------------------------------------------------------------------- */
 #include "EpetraExt_RowMatrixOut.h"
+#include "Teuchos_TimeMonitor.hpp"
 
 #include "MultiplicativeEvaluator.hh"
 #include "TreeOperator.hh"
@@ -17,6 +18,7 @@ with freezing.
 #include "PDE_Advection.hh"
 #include "PDE_Accumulation.hh"
 #include "Operator.hh"
+#include "OperatorUtils.hh"
 #include "upwind_total_flux.hh"
 #include "upwind_arithmetic_mean.hh"
 
@@ -24,6 +26,7 @@ with freezing.
 #include "liquid_ice_model.hh"
 #include "richards.hh"
 #include "mpc_delegate_ewc_subsurface.hh"
+#include "column_line_preconditioner.hh"
 #include "mpc_subsurface.hh"
 
 #define DEBUG_FLAG 1
@@ -36,7 +39,8 @@ MPCSubsurface::MPCSubsurface(Teuchos::ParameterList& pk_tree_list,
                              const Teuchos::RCP<TreeVector>& soln) :
   PK(pk_tree_list, global_list, S, soln),
   StrongMPC<PK_PhysicalBDF_Default>(pk_tree_list, global_list, S, soln),
-  update_pcs_(0)
+  update_pcs_(0),
+  line_pc_initialized_(false)
 {
   dump_ = plist_->get<bool>("dump preconditioner", false);
 
@@ -130,6 +134,12 @@ void MPCSubsurface::Setup(const Teuchos::Ptr<State>& S)
     Exceptions::amanzi_throw(message);
   }
 
+  // optionally invert the coupled system along columns
+  if (plist_->isSublist("line preconditioner") &&
+      (precon_type_ == PRECON_PICARD || precon_type_ == PRECON_EWC)) {
+    line_pc_ = Teuchos::rcp(new ColumnLinePreconditioner(plist_->sublist("line preconditioner"), mesh_));
+  }
+
   // create offdiagonal blocks
   if (precon_type_ != PRECON_NONE && precon_type_ != PRECON_BLOCK_DIAGONAL) {
     std::vector<AmanziMesh::Entity_kind> locations2(2);
@@ -342,7 +352,9 @@ void MPCSubsurface::Setup(const Teuchos::Ptr<State>& S)
     preconditioner_->set_operator_block(1, 0, dE_dp_block_);
 
     // set up sparsity structure
-    preconditioner_->set_inverse_parameters(plist_->sublist("inverse"));
+    if (line_pc_ == Teuchos::null) {
+      preconditioner_->set_inverse_parameters(plist_->sublist("inverse"));
+    }
 
 
   }
@@ -478,6 +490,15 @@ void MPCSubsurface::UpdatePreconditioner(double t, Teuchos::RCP<const TreeVector
 {
   Teuchos::OSTab tab = vo_->getOSTab();
 
+  // lag the preconditioner if the reuse policy allows it
+  auto update = pc_reuse_->Decide(t, h);
+  if (update == PreconditionerReusePolicy::PC_REUSE) {
+    if (vo_->os_OK(Teuchos::VERB_HIGH))
+      *vo_->os() << "  reusing preconditioner" << std::endl;
+    return;
+  }
+  Teuchos::TimeMonitor monitor(pc_reuse_->setup_timer());
+
   if (precon_type_ == PRECON_NONE) {
     // nothing to do
   } else if (precon_type_ == PRECON_BLOCK_DIAGONAL) {
@@ -673,6 +694,26 @@ void MPCSubsurface::UpdatePreconditioner(double t, Teuchos::RCP<const TreeVector
   if (precon_type_ == PRECON_EWC) {
     ewc_->UpdatePreconditioner(t,up,h);
   }
+
+  if (line_pc_ != Teuchos::null) {
+    // the line preconditioner is factored from the assembled matrix
+    if (!line_pc_initialized_) {
+      preconditioner_->SymbolicAssembleMatrix();
+      line_pc_->InitializeInverse(*preconditioner_->get_supermap(), 2);
+      line_b_ = Teuchos::rcp(new Epetra_Vector(*preconditioner_->get_supermap()->Map()));
+      line_x_ = Teuchos::rcp(new Epetra_Vector(line_b_->Map()));
+      line_pc_initialized_ = true;
+    }
+    preconditioner_->AssembleMatrix();
+    line_pc_->UpdateInverse(preconditioner_->A());
+    if (vo_->os_OK(Teuchos::VERB_HIGH))
+      *vo_->os() << "  line preconditioner factors: " << line_pc_->bytes() << " bytes, "
+                 << (line_pc_->single_precision() ? "single" : "double") << " precision" << std::endl;
+  } else if (update == PreconditionerReusePolicy::PC_REBUILD &&
+      (precon_type_ == PRECON_PICARD || precon_type_ == PRECON_EWC)) {
+    // after a failed step, set up the inverse from scratch
+    preconditioner_->set_inverse_parameters(plist_->sublist("inverse"));
+  }
   update_pcs_++;
 }
 
@@ -704,10 +745,20 @@ int MPCSubsurface::ApplyPreconditioner(Teuchos::RCP<const TreeVector> u,
     ierr = 1;
   } else if (precon_type_ == PRECON_BLOCK_DIAGONAL) {
     ierr = StrongMPC::ApplyPreconditioner(u,Pu);
-  } else if (precon_type_ == PRECON_PICARD) {
-    ierr = preconditioner_->ApplyInverse(*u, *Pu);
-  } else if (precon_type_ == PRECON_EWC) {
-    ierr = preconditioner_->ApplyInverse(*u, *Pu);
+  } else if (line_pc_ != Teuchos::null) {
+    Operators::CopyTreeVectorToSuperVector(*preconditioner_->get_supermap(), *u, *line_b_);
+    // positive is success, as for the operator's inverse
+    ierr = (line_pc_->ApplyInverse(*line_b_, *line_x_) == 0) ? 1 : -1;
+    Operators::CopySuperVectorToTreeVector(*preconditioner_->get_supermap(), *line_x_, *Pu);
+  } else if (precon_type_ == PRECON_PICARD || precon_type_ == PRECON_EWC) {
+    if (pc_reuse_->setup_pending()) {
+      // the inverse is computed on the first application after an update
+      Teuchos::TimeMonitor monitor(pc_reuse_->setup_timer());
+      ierr = preconditioner_->ApplyInverse(*u, *Pu);
+      pc_reuse_->set_setup_pending(false);
+    } else {
+      ierr = preconditioner_->ApplyInverse(*u, *Pu);
+    }
   }
 
   if (vo_->os_OK(Teuchos::VERB_HIGH)) {
@@ -126,6 +126,11 @@ algorithms are supported by the `EWC Globalization Delegate`_ object.
 
     * `"ewc delegate`" ``[mpc-delegate-ewc-spec]`` A `EWC Globalization Delegate`_ spec.
 
+    * `"line preconditioner`" ``[column-line-preconditioner-spec]`` If
+      provided, and using picard or ewc, the assembled preconditioner is
+      inverted by exact solves along each column, with an optional coarse
+      surface correction, instead of by the `"inverse`" list.
+
     INCLUDES:
 
     - ``[strong-mpc-spec]`` *Is a* StrongMPC_.
@@ -135,6 +140,8 @@ algorithms are supported by the `EWC Globalization Delegate`_ object.
 #ifndef MPC_SUBSURFACE_HH_
 #define MPC_SUBSURFACE_HH_
 
+#include "Epetra_Vector.h"
+
 #include "TreeOperator.hh"
 #include "pk_physical_bdf_default.hh"
 #include "strong_mpc.hh"
@@ -142,6 +149,7 @@ algorithms are supported by the `EWC Globalization Delegate`_ object.
 namespace Amanzi {
 
 class MPCDelegateEWCSubsurface;
+class ColumnLinePreconditioner;
 
 namespace Operators {
 class PDE_Diffusion;
@@ -201,6 +209,9 @@ class MPCSubsurface : public StrongMPC<PK_PhysicalBDF_Default> {
 
   // preconditioner methods
   PreconditionerType precon_type_;
+  Teuchos::RCP<ColumnLinePreconditioner> line_pc_;
+  bool line_pc_initialized_;
+  Teuchos::RCP<Epetra_Vector> line_b_, line_x_;
 
   // Additional precon terms
   //   equations are given by:
@@ -286,6 +286,7 @@ double StrongMPC<PK_t>::ErrorNorm(Teuchos::RCP<const TreeVector> u,
     double tmp_norm = sub_pks_[i]->ErrorNorm(pk_u, pk_du);
     norm = std::max(norm, tmp_norm);
   }
+  pc_reuse_->RecordResidualNorm(S_next_->time(), norm);
   return norm;
 };
 
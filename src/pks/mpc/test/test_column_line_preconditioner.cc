@@ -0,0 +1,260 @@
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+*/
+
+#include <cmath>
+#include <map>
+#include <vector>
+#include "UnitTest++.h"
+
+#include "Teuchos_ParameterList.hpp"
+#include "Teuchos_RCP.hpp"
+#include "Epetra_CrsMatrix.h"
+#include "Epetra_SerialDenseMatrix.h"
+#include "Epetra_SerialDenseSolver.h"
+#include "Epetra_SerialDenseVector.h"
+#include "Epetra_Vector.h"
+
+#include "AmanziComm.hh"
+#include "GeometricModel.hh"
+#include "MeshFactory.hh"
+#include "CompositeVectorSpace.hh"
+#include "SuperMap.hh"
+
+#include "column_line_preconditioner.hh"
+
+using namespace Amanzi;
+
+namespace {
+
+// 2x2 columns of 4 cells, on one process
+Teuchos::RCP<AmanziMesh::Mesh>
+createMesh()
+{
+  auto comm = getDefaultComm();
+  Teuchos::ParameterList region_list;
+  auto gm = Teuchos::rcp(new AmanziGeometry::GeometricModel(3, region_list, *comm));
+
+  AmanziMesh::MeshFactory factory(comm, gm);
+  auto mesh = factory.create(0., 0., -4., 2., 2., 0., 2, 2, 4);
+  mesh->build_columns();
+  return mesh;
+}
+
+
+Teuchos::RCP<Operators::SuperMap>
+createSuperMap(const Teuchos::RCP<const AmanziMesh::Mesh>& mesh, bool faces)
+{
+  CompositeVectorSpace space;
+  space.SetMesh(mesh)->SetGhosted()->AddComponent("cell", AmanziMesh::CELL, 1);
+  if (faces) space.AddComponent("face", AmanziMesh::FACE, 1);
+  return Operators::createSuperMap(space);
+}
+
+
+// A symmetric, diagonally dominant diffusion-like matrix, whose couplings
+// through vertical faces have weight k_vert and through lateral faces
+// k_lat.  With faces, cells are coupled to their faces, as in the mimetic
+// discretizations; without, cells are coupled to their neighbors.
+Teuchos::RCP<Epetra_CrsMatrix>
+createMatrix(const AmanziMesh::Mesh& mesh, const Operators::SuperMap& smap,
+             bool faces, double k_vert, double k_lat)
+{
+  int ncells = mesh.num_entities(AmanziMesh::CELL, AmanziMesh::Parallel_type::OWNED);
+  int nfaces = mesh.num_entities(AmanziMesh::FACE, AmanziMesh::Parallel_type::OWNED);
+  const auto& cell_rows = smap.Indices(0, "cell", 0);
+
+  auto weight = [&](int f) {
+    const auto& normal = mesh.face_normal(f);
+    return std::abs(normal[2]) > 0.5 * AmanziGeometry::norm(normal) ? k_vert : k_lat;
+  };
+
+  std::vector<std::map<int,double> > rows(smap.Map()->NumMyElements());
+  for (int c=0; c!=ncells; ++c) rows[cell_rows[c]][cell_rows[c]] += 0.5;
+
+  AmanziMesh::Entity_ID_List cells;
+  if (faces) {
+    const auto& face_rows = smap.Indices(0, "face", 0);
+    for (int f=0; f!=nfaces; ++f) {
+      int rf = face_rows[f];
+      rows[rf][rf] += 0.01;
+      double w = weight(f);
+      mesh.face_get_cells(f, AmanziMesh::Parallel_type::ALL, &cells);
+      for (int c : cells) {
+        int rc = cell_rows[c];
+        rows[rc][rc] += w;
+        rows[rc][rf] -= w;
+        rows[rf][rc] -= w;
+        rows[rf][rf] += w;
+      }
+    }
+  } else {
+    for (int f=0; f!=nfaces; ++f) {
+      mesh.face_get_cells(f, AmanziMesh::Parallel_type::ALL, &cells);
+      if (cells.size() != 2) continue;
+      double w = weight(f);
+      int r0 = cell_rows[cells[0]];
+      int r1 = cell_rows[cells[1]];
+      rows[r0][r0] += w;
+      rows[r0][r1] -= w;
+      rows[r1][r0] -= w;
+      rows[r1][r1] += w;
+    }
+  }
+
+  const Epetra_Map& map = *smap.Map();
+  auto A = Teuchos::rcp(new Epetra_CrsMatrix(Copy, map, 0));
+  for (int r=0; r!=rows.size(); ++r) {
+    for (const auto& entry : rows[r]) {
+      int gid = map.GID(entry.first);
+      A->InsertGlobalValues(map.GID(r), 1, &entry.second, &gid);
+    }
+  }
+  A->FillComplete();
+  return A;
+}
+
+
+// x = A^-1 b, by a dense factorization
+void
+directSolve(const Epetra_CrsMatrix& A, const Epetra_Vector& b, Epetra_Vector& x)
+{
+  int n = A.NumMyRows();
+  Epetra_SerialDenseMatrix dense(n, n);
+  int nnz;
+  double* vals;
+  int* inds;
+  for (int r=0; r!=n; ++r) {
+    A.ExtractMyRowView(r, nnz, vals, inds);
+    for (int k=0; k!=nnz; ++k) dense(r, A.RowMap().LID(A.ColMap().GID(inds[k]))) += vals[k];
+  }
+
+  Epetra_SerialDenseVector rhs(n), sol(n);
+  for (int r=0; r!=n; ++r) rhs(r) = b[r];
+  Epetra_SerialDenseSolver solver;
+  solver.SetMatrix(dense);
+  solver.SetVectors(sol, rhs);
+  CHECK_EQUAL(0, solver.Solve());
+  for (int r=0; r!=n; ++r) x[r] = sol(r);
+}
+
+
+// Solves A x = b by conjugate gradients preconditioned with pc, and returns
+// the number of iterations, or -1 if it does not converge.
+int
+solvePCG(const Epetra_CrsMatrix& A, const ColumnLinePreconditioner& pc,
+         const Epetra_Vector& b, Epetra_Vector& x)
+{
+  const Epetra_Map& map = A.RowMap();
+  Epetra_Vector r(b), z(map), p(map), Ap(map);
+  x.PutScalar(0.);
+  double norm_b;
+  b.Norm2(&norm_b);
+
+  pc.ApplyInverse(r, z);
+  p = z;
+  double rz;
+  r.Dot(z, &rz);
+  for (int it=1; it<=map.NumGlobalElements(); ++it) {
+    A.Multiply(false, p, Ap);
+    double pAp;
+    p.Dot(Ap, &pAp);
+    double alpha = rz / pAp;
+    x.Update(alpha, p, 1.);
+    r.Update(-alpha, Ap, 1.);
+
+    double norm_r;
+    r.Norm2(&norm_r);
+    if (norm_r < 1.e-12 * norm_b) return it;
+
+    pc.ApplyInverse(r, z);
+    double rz_new;
+    r.Dot(z, &rz_new);
+    p.Update(1., z, rz_new / rz);
+    rz = rz_new;
+  }
+  return -1;
+}
+
+
+Teuchos::ParameterList
+createPList(bool coarse)
+{
+  Teuchos::ParameterList plist;
+  plist.set("coarse surface correction", coarse);
+  if (coarse) plist.sublist("coarse preconditioner").set("preconditioner type", "diagonal");
+  return plist;
+}
+
+
+void
+fillRHS(Epetra_Vector& b)
+{
+  for (int r=0; r!=b.MyLength(); ++r) b[r] = std::sin(r + 1.);
+}
+
+} // namespace
+
+
+SUITE(COLUMN_LINE_PRECONDITIONER) {
+
+// Without lateral coupling, the line solve is an exact inverse, with or
+// without the coarse correction.
+TEST(DECOUPLED_COLUMNS_EXACT) {
+  auto mesh = createMesh();
+  for (bool faces : { false, true }) {
+    auto smap = createSuperMap(mesh, faces);
+    auto A = createMatrix(*mesh, *smap, faces, 100., 0.);
+    Epetra_Vector b(*smap->Map()), x(b.Map()), x_direct(b.Map());
+    fillRHS(b);
+    directSolve(*A, b, x_direct);
+
+    for (bool coarse : { false, true }) {
+      auto plist = createPList(coarse);
+      ColumnLinePreconditioner pc(plist, mesh);
+      pc.InitializeInverse(*smap, 1);
+      pc.UpdateInverse(A);
+      CHECK_EQUAL(0, pc.ApplyInverse(b, x));
+
+      for (int r=0; r!=b.MyLength(); ++r) {
+        CHECK_CLOSE(x_direct[r], x[r], 1.e-10 * std::abs(x_direct[r]) + 1.e-14);
+      }
+    }
+  }
+}
+
+// With lateral coupling, it is a symmetric preconditioner with which CG
+// converges to the direct solution, with or without the coarse correction.
+TEST(LATERAL_COUPLING_PCG) {
+  auto mesh = createMesh();
+  for (bool faces : { false, true }) {
+    auto smap = createSuperMap(mesh, faces);
+    auto A = createMatrix(*mesh, *smap, faces, 100., 1.);
+    Epetra_Vector b(*smap->Map()), x(b.Map()), x_direct(b.Map());
+    fillRHS(b);
+    directSolve(*A, b, x_direct);
+
+    for (bool coarse : { false, true }) {
+      auto plist = createPList(coarse);
+      ColumnLinePreconditioner pc(plist, mesh);
+      pc.InitializeInverse(*smap, 1);
+      pc.UpdateInverse(A);
+
+      // applied repeatedly, the cached work vectors do not carry state
+      Epetra_Vector x0(b.Map()), x1(b.Map());
+      pc.ApplyInverse(b, x0);
+      pc.ApplyInverse(b, x1);
+      for (int r=0; r!=b.MyLength(); ++r) CHECK_EQUAL(x0[r], x1[r]);
+
+      int its = solvePCG(*A, pc, b, x);
+      CHECK(its > 0);
+      for (int r=0; r!=b.MyLength(); ++r) {
+        CHECK_CLOSE(x_direct[r], x[r], 1.e-8 * std::abs(x_direct[r]) + 1.e-12);
+      }
+    }
+  }
+}
+
+}
@@ -10,6 +10,8 @@ Default base with default implementations of methods for a PK integrated using
 BDF.
 ------------------------------------------------------------------------- */
 
+#include <cmath>
+
 #include "Teuchos_TimeMonitor.hpp"
 #include "BDF1_TI.hh"
 #include "pk_bdf_default.hh"
@@ -17,6 +19,38 @@ BDF.
 
 namespace Amanzi {
 
+namespace {
+
+// Max over entries of |lte| / (atol + rtol * |u|), over all leaves of the
+// tree and all components.  Local to this process.
+double
+TruncationErrorNormLocal(const TreeVector& u, const TreeVector& lte,
+                         double atol, double rtol)
+{
+  double norm = 0.;
+  if (u.Data() != Teuchos::null) {
+    const CompositeVector& u_cv = *u.Data();
+    const CompositeVector& lte_cv = *lte.Data();
+    for (const auto& comp : u_cv) {
+      const Epetra_MultiVector& u_v = *u_cv.ViewComponent(comp, false);
+      const Epetra_MultiVector& lte_v = *lte_cv.ViewComponent(comp, false);
+      for (int k=0; k!=u_v.NumVectors(); ++k) {
+        for (int i=0; i!=u_v.MyLength(); ++i) {
+          norm = std::max(norm, std::abs(lte_v[k][i]) / (atol + rtol*std::abs(u_v[k][i])));
+        }
+      }
+    }
+  } else {
+    for (int i=0; i!=u.size(); ++i) {
+      norm = std::max(norm, TruncationErrorNormLocal(*u.SubVector(i), *lte.SubVector(i), atol, rtol));
+    }
+  }
+  return norm;
+}
+
+} // namespace
+
+
 
 // -----------------------------------------------------------------------------
 // Setup
@@ -29,6 +63,15 @@ void PK_BDF_Default::Setup(const Teuchos::Ptr<State>& S)
   // preconditioner assembly
   assemble_preconditioner_ = plist_->get<bool>("assemble preconditioner", true);
 
+  // preconditioner lagging, only for the PK that owns the inverse
+  if (plist_->isSublist("preconditioner reuse") &&
+      !plist_->get<bool>("strongly coupled PK", false)) {
+    pc_reuse_ = Teuchos::rcp(new PreconditionerReusePolicy(name_,
+            plist_->sublist("preconditioner reuse")));
+  } else {
+    pc_reuse_ = Teuchos::rcp(new PreconditionerReusePolicy(name_));
+  }
+
   if (!plist_->get<bool>("strongly coupled PK", false)) {
     Teuchos::ParameterList& bdf_plist = plist_->sublist("time integrator");
     // -- check if continuation method
@@ -36,6 +79,21 @@ void PK_BDF_Default::Setup(const Teuchos::Ptr<State>& S)
     if (bdf_plist.isSublist("continuation parameters")) {
       S->RequireScalar("continuation_parameter", name_);
     }
+
+    // -- check if truncation error based timestep control
+    lte_control_ = bdf_plist.isSublist("truncation error control");
+    if (lte_control_) {
+      Teuchos::ParameterList& lte_plist = bdf_plist.sublist("truncation error control");
+      lte_atol_ = lte_plist.get<double>("absolute tolerance", 1.);
+      lte_rtol_ = lte_plist.get<double>("relative tolerance", 1.e-4);
+      lte_safety_ = lte_plist.get<double>("safety factor", 0.9);
+      lte_kI_ = lte_plist.get<double>("integral exponent", 0.35);
+      lte_kP_ = lte_plist.get<double>("proportional exponent", 0.2);
+      lte_max_growth_ = lte_plist.get<double>("max growth factor", 5.);
+      lte_min_reduction_ = lte_plist.get<double>("min reduction factor", 0.2);
+      lte_dt_max_ = lte_plist.get<double>("max time step [s]", 1.e10);
+      AMANZI_ASSERT(lte_atol_ > 0. || lte_rtol_ > 0.);
+    }
   }
 };
 
@@ -66,20 +124,53 @@ void PK_BDF_Default::Initialize(const Teuchos::Ptr<State>& S)
 
     // -- set initial state
     time_stepper_->SetInitialState(S->time(), solution_, solution_dot);
+
+    // -- history for truncation error control
+    if (lte_control_) {
+      lte_u_old_ = Teuchos::rcp(new TreeVector(*solution_));
+      lte_u_prev_ = Teuchos::rcp(new TreeVector(*solution_));
+      lte_work_ = Teuchos::rcp(new TreeVector(*solution_));
+      lte_dt_prev_ = -1.;
+    }
   }
 };
 
 void PK_BDF_Default::ResetTimeStepper(double time)
 {
+    // sub-PKs of a strongly coupled MPC have no integrator of their own
+    if (time_stepper_ == Teuchos::null) return;
+
     // -- initialize time derivative
     Teuchos::RCP<TreeVector> solution_dot = Teuchos::rcp(new TreeVector(*solution_));
     solution_dot->PutScalar(0.0);
 
     // -- set initial state
     time_stepper_->SetInitialState(time, solution_, solution_dot);
+
+    // -- history is no longer valid for an error estimate
+    if (lte_control_) {
+      *lte_u_old_ = *solution_;
+      *lte_u_prev_ = *solution_;
+      lte_err_prev_ = 1.;
+    }
+    lte_dt_prev_ = -1.;
     return;
 }
 
+
+// -----------------------------------------------------------------------------
+// Resets every BDF integrator in the tree rooted at pk.
+// -----------------------------------------------------------------------------
+void
+resetTimeSteppers(PK& pk, double time)
+{
+  PK_BDF_Default* pk_bdf = dynamic_cast<PK_BDF_Default*>(&pk);
+  if (pk_bdf) pk_bdf->ResetTimeStepper(time);
+
+  PK_BDF_Tree* pk_tree = dynamic_cast<PK_BDF_Tree*>(&pk);
+  if (pk_tree) pk_tree->ResetTimeSteppers(time);
+}
+
 // -----------------------------------------------------------------------------
 // Initialization of timestepper.
 // -----------------------------------------------------------------------------
@@ -91,8 +182,15 @@ void PK_BDF_Default::set_dt(double dt) {dt_ = dt;}
 void PK_BDF_Default::CommitStep(double t_old, double t_new, const Teuchos::RCP<State>& S) \
 {
   double dt = t_new -t_old;
-  if (dt > 0. && time_stepper_ != Teuchos::null)
+  if (dt > 0. && time_stepper_ != Teuchos::null) {
     time_stepper_->CommitSolution(dt, solution_, true);
+
+    // rotate the history used in the truncation error estimate
+    if (lte_control_) {
+      std::swap(lte_u_prev_, lte_u_old_);
+      lte_dt_prev_ = dt;
+    }
+  }
 }
 
 void PK_BDF_Default::set_states(const Teuchos::RCP<State>& S,
@@ -120,6 +218,7 @@ bool PK_BDF_Default::AdvanceStep(double t_old, double t_new, bool reinit)
                << "----------------------------------------------------------------" << std::endl;
 
   State_to_Solution(S_next_, *solution_);
+  if (lte_control_) *lte_u_old_ = *solution_;
 
   // take a bdf timestep
   double dt_solver;
@@ -137,7 +236,12 @@ bool PK_BDF_Default::AdvanceStep(double t_old, double t_new, bool reinit)
       if (vo_->os_OK(Teuchos::VERB_LOW))
         *vo_->os() << "successful timestep" << std::endl;
       // update the timestep size
-      if (dt_solver < dt_ && dt_solver >= dt) {
+      if (lte_control_) {
+        // accept or reject on the estimated truncation error, and set dt_
+        fail = !TruncationErrorControl_(dt, dt_solver);
+        if (fail) time_stepper_->CommitSolution(dt, solution_, false);
+
+      } else if (dt_solver < dt_ && dt_solver >= dt) {
         // We took a smaller step than we recommended, and it worked fine (not
         // suprisingly).  Likely this was due to constraints from other PKs or
         // vis.  Do not reduce our recommendation.
@@ -157,10 +261,70 @@ bool PK_BDF_Default::AdvanceStep(double t_old, double t_new, bool reinit)
     dt_ = dt_solver;
   }
 
+  pc_reuse_->WriteStatistics(*vo_);
   return fail;
 };
 
 
+// -----------------------------------------------------------------------------
+// Truncation error estimate and PI control of the timestep size.
+//
+// The BDF1 solution is compared to the linear extrapolation of the previous
+// two accepted solutions.  Returns true if the step is accepted.
+// -----------------------------------------------------------------------------
+bool PK_BDF_Default::TruncationErrorControl_(double dt, double dt_solver)
+{
+  Teuchos::OSTab out = vo_->getOSTab();
+
+  if (lte_dt_prev_ <= 0.) {
+    // no history yet, so no estimate -- accept and use the solver's
+    // recommendation
+    dt_ = dt_solver;
+    lte_accepted_++;
+    return true;
+  }
+
+  // predictor: u_pred = u_old + dt/dt_prev * (u_old - u_prev)
+  double r = dt / lte_dt_prev_;
+  lte_work_->Update(1. + r, *lte_u_old_, -r, *lte_u_prev_, 0.);
+
+  // error estimate: dt / (dt + dt_prev) * (u_new - u_pred)
+  double c = dt / (dt + lte_dt_prev_);
+  lte_work_->Update(c, *solution_, -c);
+  double err_l = TruncationErrorNormLocal(*solution_, *lte_work_, lte_atol_, lte_rtol_);
+  double err = 0.;
+  solution_->Comm()->MaxAll(&err_l, &err, 1);
+
+  bool accept = err <= 1.;
+  double err_reg = std::max(err, 1.e-10);
+  double dt_next;
+  if (accept) {
+    double fac = lte_safety_ * std::pow(1./err_reg, lte_kI_)
+                 * std::pow(lte_err_prev_/err_reg, lte_kP_);
+    fac = std::min(lte_max_growth_, std::max(lte_min_reduction_, fac));
+    dt_next = std::min(fac * dt, lte_dt_max_);
+
+    // the nonlinear solver may still need a smaller step
+    if (dt_solver < dt) dt_next = std::min(dt_next, dt_solver);
+    lte_err_prev_ = err_reg;
+    lte_accepted_++;
+  } else {
+    double fac = lte_safety_ * std::pow(1./err_reg, 1./2.);
+    dt_next = std::max(lte_min_reduction_, fac) * dt;
+    lte_rejected_++;
+  }
+  dt_ = dt_next;
+
+  if (vo_->os_OK(Teuchos::VERB_MEDIUM))
+    *vo_->os() << "truncation error control: err = " << err
+               << (accept ? ", accepted" : ", REJECTED")
+               << ", next dt = " << dt_
+               << " (accepted/rejected: " << lte_accepted_ << "/" << lte_rejected_ << ")"
+               << std::endl;
+  return accept;
+}
+
+
 // update the continuation parameter
 void PK_BDF_Default::UpdateContinuationParameter(double lambda)
 {
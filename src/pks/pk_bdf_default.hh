@@ -29,14 +29,59 @@ PKs.
       A TimeIntegrator_.  Note that this is only required if this PK is not
       strongly coupled to other PKs.
 
+      The time integrator list may additionally include:
+
+      * `"truncation error control`" ``[truncation-error-control-spec]``
+        **optional** If provided, the time step size is chosen by an
+        estimate of the local truncation error rather than by nonlinear
+        iteration counts alone.  See below.
+
     * `"inverse`" ``[inverse-typed-spec]`` **optional** A Preconditioner_.
       Note that this is only used if this PK is not strongly coupled to other PKs.
 
+    * `"preconditioner reuse`" ``[preconditioner-reuse-spec]`` **optional**
+      If provided, the preconditioner is lagged across Newton iterations and
+      timesteps while convergence is good.  See PreconditionerReusePolicy_.
+      Note that this is only used if this PK is not strongly coupled to other PKs.
+
     INCLUDES:
 
     - ``[pk-spec]`` This *is a* PK_.
 
 
+The truncation error controller estimates the local truncation error of each
+BDF1 step by comparing the solution to a linear extrapolation (predictor)
+from the previous two accepted solutions, which is the BDF2-order estimate of
+the BDF1 error:
+
+  LTE ~ dt / (dt + dt_prev) * (u_new - u_pred)
+
+The error is normed by a mixed absolute/relative tolerance on the primary
+variable, and the next step size is chosen by a PI controller.  Steps whose
+error norm exceeds 1 are rejected and retried with a smaller step.  The
+nonlinear-iteration heuristic of the time integrator still limits the step
+when the solver struggles.  This is particularly useful during long, smooth
+periods (e.g. midwinter frozen ground) in which iteration counts are always
+small but accuracy would allow much larger steps.
+
+.. _truncation-error-control-spec:
+.. admonition:: truncation-error-control-spec
+
+    * `"absolute tolerance`" ``[double]`` **1.** Absolute tolerance on the
+      primary variable, in its units.
+    * `"relative tolerance`" ``[double]`` **1.e-4** Relative tolerance on the
+      primary variable.
+    * `"safety factor`" ``[double]`` **0.9** Multiplies the optimal step size.
+    * `"integral exponent`" ``[double]`` **0.35** Exponent on the current error.
+    * `"proportional exponent`" ``[double]`` **0.2** Exponent on the ratio of
+      the previous to the current error.
+    * `"max growth factor`" ``[double]`` **5.** Maximum factor by which the
+      step may grow.
+    * `"min reduction factor`" ``[double]`` **0.2** Minimum factor by which a
+      rejected step is reduced.
+    * `"max time step [s]`" ``[double]`` **1.e10** Largest step the controller
+      will recommend.
+
 */
 
 
@@ -49,6 +94,8 @@ PKs.
 #include "BDF1_TI.hh"
 #include "PK_BDF.hh"
 
+#include "preconditioner_reuse_policy.hh"
+
 
 
 namespace Amanzi {
@@ -60,7 +107,12 @@ class PK_BDF_Default : public PK_BDF {
                  const Teuchos::RCP<State>& S,
                  const Teuchos::RCP<TreeVector>& solution) :
     PK(pk_tree, glist, S, solution),
-    PK_BDF(pk_tree, glist, S, solution) {}
+    PK_BDF(pk_tree, glist, S, solution),
+    lte_control_(false),
+    lte_dt_prev_(-1.),
+    lte_err_prev_(1.),
+    lte_accepted_(0),
+    lte_rejected_(0) {}
 
   // Virtual destructor
   virtual ~PK_BDF_Default() {}
@@ -113,6 +165,10 @@ class PK_BDF_Default : public PK_BDF {
 
   virtual void ResetTimeStepper(double time);
 
+  // -- Statistics of the truncation error controller
+  int num_steps_accepted_by_error_control() const { return lte_accepted_; }
+  int num_steps_rejected_by_error_control() const { return lte_rejected_; }
+
   // experimental approach -- calling this indicates that the time
   // integration scheme is changing the value of the solution in
   // state.
@@ -127,11 +183,48 @@ class PK_BDF_Default : public PK_BDF {
   double dt_;
   Teuchos::RCP<BDF1_TI<TreeVector, TreeVectorSpace> > time_stepper_;
 
+  // truncation error timestep control
+  // -- returns true if the step is accepted, and sets dt_
+  bool TruncationErrorControl_(double dt, double dt_solver);
+
+  bool lte_control_;
+  double lte_atol_, lte_rtol_;
+  double lte_safety_, lte_kI_, lte_kP_;
+  double lte_max_growth_, lte_min_reduction_, lte_dt_max_;
+  Teuchos::RCP<TreeVector> lte_u_old_;   // solution at the start of this step
+  Teuchos::RCP<TreeVector> lte_u_prev_;  // solution at the start of the previous step
+  Teuchos::RCP<TreeVector> lte_work_;
+  double lte_dt_prev_;                   // size of the previous accepted step, <= 0 if none
+  double lte_err_prev_;                  // error norm of the previous accepted step
+  int lte_accepted_, lte_rejected_;
+
+  // preconditioner lagging
+  Teuchos::RCP<PreconditionerReusePolicy> pc_reuse_;
+
   // timing
   Teuchos::RCP<Teuchos::Time> step_walltime_;
 
 };
 
+
+// PKs with sub-PKs implement this so that a reset reaches every BDF
+// integrator in the tree.
+class PK_BDF_Tree {
+ public:
+  virtual ~PK_BDF_Tree() = default;
+
+  // Resets the time integrators of all sub-PKs.
+  virtual void ResetTimeSteppers(double time) = 0;
+};
+
+
+// -----------------------------------------------------------------------------
+// Resets the time integrator of pk, if it is a BDF PK, and of all BDF PKs
+// below it, e.g. after the solution is changed outside of time integration.
+// -----------------------------------------------------------------------------
+void
+resetTimeSteppers(PK& pk, double time);
+
 } // namespace
 
 #endif
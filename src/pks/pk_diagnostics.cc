@@ -0,0 +1,39 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+*/
+
+#include "PK.hh"
+#include "State.hh"
+
+#include "pk_diagnostics.hh"
+
+namespace Amanzi {
+
+bool
+DiagnosticsDemand::RequiresAny(const std::vector<Key>& keys) const
+{
+  for (const auto& key : keys) {
+    if (Requires(key)) return true;
+  }
+  return false;
+}
+
+
+void
+calculateDiagnostics(PK& pk, const Teuchos::RCP<State>& S,
+                     const DiagnosticsDemand& demand)
+{
+  if (demand.empty()) return;
+
+  PK_Diagnostics* pk_diag = dynamic_cast<PK_Diagnostics*>(&pk);
+  if (pk_diag) {
+    pk_diag->CalculateDemandedDiagnostics(S, demand);
+  } else {
+    pk.CalculateDiagnostics(S);
+  }
+}
+
+}  // namespace Amanzi
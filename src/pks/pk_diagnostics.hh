@@ -0,0 +1,75 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+//! Calculates only those PK diagnostics consumed by output.
+
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+*/
+
+/*!
+
+Diagnostics are fields, e.g. Darcy velocities, which a PK computes only for
+output.  Rather than calculating the diagnostics of the whole PK tree
+whenever any output is due, the Coordinator collects the fields consumed by
+the visualization and observations due now into a `DiagnosticsDemand`, and
+only PKs which compute one of those fields calculate their diagnostics.
+
+PKs which support this implement `PK_Diagnostics`.  MPCs pass the demand on
+to their sub-PKs, and physical PKs list the fields computed by their
+`CalculateDiagnostics()`.  PKs which do not implement it calculate their
+diagnostics whenever any field is in demand.
+
+*/
+
+#ifndef ATS_PK_DIAGNOSTICS_HH_
+#define ATS_PK_DIAGNOSTICS_HH_
+
+#include <set>
+#include <vector>
+
+#include "Teuchos_RCP.hpp"
+
+#include "Key.hh"
+
+namespace Amanzi {
+
+class PK;
+class State;
+
+class DiagnosticsDemand {
+ public:
+  void Require(const Key& key) { keys_.insert(key); }
+
+  bool empty() const { return keys_.empty(); }
+  const std::set<Key>& keys() const { return keys_; }
+
+  bool Requires(const Key& key) const { return keys_.count(key) > 0; }
+  bool RequiresAny(const std::vector<Key>& keys) const;
+
+ private:
+  std::set<Key> keys_;
+};
+
+
+class PK_Diagnostics {
+ public:
+  virtual ~PK_Diagnostics() = default;
+
+  // Calculates the diagnostics of this PK and its sub-PKs which are in demand.
+  virtual void CalculateDemandedDiagnostics(const Teuchos::RCP<State>& S,
+          const DiagnosticsDemand& demand) = 0;
+};
+
+
+// -----------------------------------------------------------------------------
+// Calculates the diagnostics of a PK which are in demand, or, if the PK does
+// not support demand, all of its diagnostics.
+// -----------------------------------------------------------------------------
+void
+calculateDiagnostics(PK& pk, const Teuchos::RCP<State>& S,
+                     const DiagnosticsDemand& demand);
+
+}  // namespace Amanzi
+
+#endif
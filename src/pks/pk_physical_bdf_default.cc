@@ -165,6 +165,7 @@ double PK_PhysicalBDF_Default::ErrorNorm(Teuchos::RCP<const TreeVector> u,
   int ierr;
   ierr = MPI_Allreduce(&enorm_val_l, &enorm_val, 1, MPI_DOUBLE, MPI_MAX, comm);
   AMANZI_ASSERT(!ierr);
+  pc_reuse_->RecordResidualNorm(S_next_->time(), enorm_val);
   return enorm_val;
 };
 
@@ -31,6 +31,8 @@ PK_Physical_Default::PK_Physical_Default(Teuchos::ParameterList& pk_tree,
   // primary variable max change
   max_valid_change_ = plist_->get<double>("max valid change", -1.0);
 
+  ghost_exchange_ = Teuchos::rcp(new GhostExchange());
+
   // verbose object
   if (plist_->isSublist(name_ + " verbose object"))
     plist_->set("verbose object", plist_->sublist(name_ + " verbose object"));
@@ -99,6 +101,15 @@ void PK_Physical_Default::ChangedSolutionPK(const Teuchos::Ptr<State>& S) {
 }
 
 
+// -----------------------------------------------------------------------------
+// Calculate diagnostics only if output consumes one of them.
+// -----------------------------------------------------------------------------
+void PK_Physical_Default::CalculateDemandedDiagnostics(const Teuchos::RCP<State>& S,
+        const DiagnosticsDemand& demand) {
+  if (demand.RequiresAny(diagnostic_keys_)) CalculateDiagnostics(S);
+}
+
+
 // -----------------------------------------------------------------------------
 // Initialization of the PK data.
 // -----------------------------------------------------------------------------
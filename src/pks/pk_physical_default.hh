@@ -44,6 +44,8 @@ all leaves of the PK tree will inherit from `PKPhysicalBase`.
 #include "TreeVector.hh"
 
 #include "Debugger.hh"
+#include "ghost_exchange.hh"
+#include "pk_diagnostics.hh"
 
 #include "primary_variable_field_evaluator.hh"
 #include "PK.hh"
@@ -51,7 +53,7 @@ all leaves of the PK tree will inherit from `PKPhysicalBase`.
 
 namespace Amanzi {
 
-class PK_Physical_Default : public PK_Physical {
+class PK_Physical_Default : public PK_Physical, virtual public PK_Diagnostics {
 
   public:
     PK_Physical_Default(Teuchos::ParameterList& pk_tree,
@@ -67,6 +69,10 @@ class PK_Physical_Default : public PK_Physical {
   // Tag the primary variable as changed in the DAG
   virtual void ChangedSolutionPK(const Teuchos::Ptr<State>& S);
 
+  // Calculates diagnostics if any of diagnostic_keys_ is in demand.
+  virtual void CalculateDemandedDiagnostics(const Teuchos::RCP<State>& S,
+          const DiagnosticsDemand& demand) override;
+
   // -- setup
   virtual void Setup(const Teuchos::Ptr<State>& S);
 
@@ -78,6 +84,12 @@ class PK_Physical_Default : public PK_Physical {
   // step validity
   double max_valid_change_;
 
+  // batched ghost updates of the vectors needed by the next phase
+  Teuchos::RCP<GhostExchange> ghost_exchange_;
+
+  // fields computed by CalculateDiagnostics(), set by PKs which have any
+  std::vector<Key> diagnostic_keys_;
+
   // ENORM struct
   typedef struct ENorm_t {
     double value;
@@ -0,0 +1,123 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+//! Decides when a PK's preconditioner may be reused, refreshed, or rebuilt.
+
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+*/
+
+#include <cmath>
+
+#include "Teuchos_TimeMonitor.hpp"
+
+#include "dbc.hh"
+
+#include "preconditioner_reuse_policy.hh"
+
+namespace Amanzi {
+
+PreconditionerReusePolicy::PreconditionerReusePolicy(const std::string& name) :
+    name_(name),
+    enabled_(false),
+    built_(false),
+    setup_pending_(false),
+    max_contraction_(0.5),
+    max_reuses_(0),
+    max_dt_ratio_(1.),
+    t_last_(-1.e99),
+    h_built_(-1.),
+    t_norm_(-1.e99),
+    norm_prev_(-1.),
+    contraction_(0.),
+    n_since_refresh_(0),
+    n_reused_(0),
+    n_refreshed_(0),
+    n_rebuilt_(0)
+{
+  setup_timer_ = Teuchos::TimeMonitor::getNewCounter(name_ + ": preconditioner setup");
+}
+
+
+PreconditionerReusePolicy::PreconditionerReusePolicy(const std::string& name,
+        Teuchos::ParameterList& plist) :
+    PreconditionerReusePolicy(name)
+{
+  enabled_ = true;
+  max_contraction_ = plist.get<double>("refresh contraction ratio", 0.5);
+  max_reuses_ = plist.get<int>("max reuses", 10);
+  max_dt_ratio_ = plist.get<double>("max dt ratio", 2.);
+  AMANZI_ASSERT(max_dt_ratio_ >= 1.);
+}
+
+
+PreconditionerReusePolicy::Update
+PreconditionerReusePolicy::Decide(double t, double h)
+{
+  Update decision = PC_REFRESH;
+
+  if (enabled_) {
+    // Time moving backwards means a step failed and is being retried, and
+    // the lagged preconditioner is a likely culprit.
+    bool failed = t < t_last_ - 1.e-10 * std::max(std::abs(t), 1.);
+    double dt_ratio = h_built_ > 0. ? std::max(h / h_built_, h_built_ / h) : 1.e99;
+
+    if (!built_ || failed) {
+      decision = PC_REBUILD;
+    } else if (contraction_ > max_contraction_
+               || dt_ratio > max_dt_ratio_
+               || n_since_refresh_ >= max_reuses_) {
+      decision = PC_REFRESH;
+    } else {
+      decision = PC_REUSE;
+    }
+  }
+  t_last_ = t;
+
+  switch (decision) {
+    case PC_REUSE:
+      n_reused_++;
+      n_since_refresh_++;
+      break;
+    case PC_REBUILD:
+      n_rebuilt_++;
+      built_ = true;
+      // fall through
+    case PC_REFRESH:
+      if (decision == PC_REFRESH) n_refreshed_++;
+      h_built_ = h;
+      n_since_refresh_ = 0;
+      contraction_ = 0.;
+      setup_pending_ = true;
+      break;
+  }
+  return decision;
+}
+
+
+void
+PreconditionerReusePolicy::RecordResidualNorm(double t, double norm)
+{
+  // contraction is only meaningful between iterates of the same step
+  if (t != t_norm_) {
+    t_norm_ = t;
+    norm_prev_ = -1.;
+  }
+  if (norm_prev_ > 0.) contraction_ = std::max(contraction_, norm / norm_prev_);
+  norm_prev_ = norm;
+}
+
+
+void
+PreconditionerReusePolicy::WriteStatistics(VerboseObject& vo) const
+{
+  if (enabled_ && vo.os_OK(Teuchos::VERB_MEDIUM)) {
+    Teuchos::OSTab tab = vo.getOSTab();
+    *vo.os() << "preconditioner: reused " << n_reused_
+             << ", refreshed " << n_refreshed_
+             << ", rebuilt " << n_rebuilt_
+             << ", setup time " << setup_timer_->totalElapsedTime() << " [s]" << std::endl;
+  }
+}
+
+} // namespace Amanzi
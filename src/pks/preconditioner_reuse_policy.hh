@@ -0,0 +1,121 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+//! Decides when a PK's preconditioner may be reused, refreshed, or rebuilt.
+
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+*/
+
+/*!
+
+Assembling local matrices and setting up the inverse (AMG hierarchy, ILU
+factors) on every preconditioner update is often the dominant cost of a
+nonlinear solve, yet successive Newton iterates, and even successive
+timesteps, frequently have nearly identical Jacobians.  This policy allows a
+PK to lag its preconditioner:
+
+- *reuse*: the previous operator and its inverse are kept as is, and the
+  update is skipped entirely.
+- *refresh*: local matrices are recomputed and the inverse is recomputed
+  numerically on the existing symbolic structure / hierarchy.
+- *rebuild*: as refresh, but the inverse is also re-initialized from
+  scratch.
+
+The preconditioner is reused while Newton converges well, refreshed when the
+residual contraction per iteration degrades, the timestep size changes
+significantly, or too many reuses have accumulated, and rebuilt after a failed
+step (detected by the time at which the update is requested moving
+backwards).
+
+This should be set on the PK that owns the inverse, i.e. not on a PK that is
+strongly coupled within an MPC, where it is ignored.
+
+Time spent in preconditioner setup, including the first application of the
+inverse after an update (which is where the inverse is computed), is
+reported in the timer summary as "NAME: preconditioner setup".
+
+.. _preconditioner-reuse-spec:
+.. admonition:: preconditioner-reuse-spec
+
+    * `"refresh contraction ratio`" ``[double]`` **0.5** Refresh the
+      preconditioner if the ratio of successive nonlinear residual norms
+      exceeds this.
+    * `"max reuses`" ``[int]`` **10** Refresh after this many consecutive
+      reuses, regardless of convergence.
+    * `"max dt ratio`" ``[double]`` **2.** Refresh if the timestep size
+      differs from that used at the last refresh by more than this factor.
+
+*/
+
+#ifndef ATS_PRECONDITIONER_REUSE_POLICY_HH_
+#define ATS_PRECONDITIONER_REUSE_POLICY_HH_
+
+#include <string>
+
+#include "Teuchos_ParameterList.hpp"
+#include "Teuchos_RCP.hpp"
+#include "Teuchos_Time.hpp"
+
+#include "VerboseObject.hh"
+
+namespace Amanzi {
+
+class PreconditionerReusePolicy {
+ public:
+  enum Update {
+    PC_REUSE = 0,
+    PC_REFRESH,
+    PC_REBUILD
+  };
+
+  // A disabled policy always refreshes, which is the default behavior.
+  PreconditionerReusePolicy(const std::string& name);
+  PreconditionerReusePolicy(const std::string& name,
+                            Teuchos::ParameterList& plist);
+
+  bool enabled() const { return enabled_; }
+
+  // Decide what to do on a preconditioner update at time t with step h.
+  Update Decide(double t, double h);
+
+  // Inform the policy of the nonlinear residual norm of each iterate at time t.
+  void RecordResidualNorm(double t, double norm);
+
+  // Setup timing, which covers both the update and the first application
+  // of the inverse after an update.
+  Teuchos::Time& setup_timer() { return *setup_timer_; }
+  bool setup_pending() const { return setup_pending_; }
+  void set_setup_pending(bool pending) { setup_pending_ = pending; }
+
+  // Statistics
+  int num_reused() const { return n_reused_; }
+  int num_refreshed() const { return n_refreshed_; }
+  int num_rebuilt() const { return n_rebuilt_; }
+  void WriteStatistics(VerboseObject& vo) const;
+
+ private:
+  std::string name_;
+  bool enabled_;
+  bool built_;
+  bool setup_pending_;
+
+  double max_contraction_;
+  int max_reuses_;
+  double max_dt_ratio_;
+
+  double t_last_;
+  double h_built_;
+  double t_norm_;
+  double norm_prev_;
+  double contraction_;
+  int n_since_refresh_;
+
+  int n_reused_, n_refreshed_, n_rebuilt_;
+
+  Teuchos::RCP<Teuchos::Time> setup_timer_;
+};
+
+} // namespace Amanzi
+
+#endif
@@ -13,6 +13,50 @@
 namespace ATS {
 namespace CLM {
 
+namespace {
+
+//
+// Exchange buffers between ATS and CLM.
+// ------------------------------------------------------------------
+// CLM stores the cells of each column contiguously, top down.  ATS cells
+// need not be ordered this way, so cell-based data is packed into (and
+// unpacked from) buffers in CLM's order.  The map and buffers are built once
+// in init(); if ATS's order is already CLM's, no packing is done.
+//
+struct Exchange {
+  bool identity = true;
+  std::vector<int> clm_to_ats;  // the ATS cell of each CLM cell
+  std::vector<double> cells[2];
+  std::vector<double> precip, wind_y, patm;
+};
+
+Exchange exchange;
+
+// Returns v in CLM order, using buffer b if needed.
+double* pack(const Epetra_MultiVector& v, int b) {
+  if (exchange.identity) return v[0];
+  std::vector<double>& buf = exchange.cells[b];
+  int ncells = exchange.clm_to_ats.size();
+  for (int i=0; i!=ncells; ++i) buf[i] = v[0][exchange.clm_to_ats[i]];
+  return buf.data();
+}
+
+// Returns the array into which CLM writes v, using buffer b if needed.
+double* unpack_buffer(Epetra_MultiVector& v, int b) {
+  if (exchange.identity) return v[0];
+  return exchange.cells[b].data();
+}
+
+// Moves the CLM-ordered buffer b into v.
+void unpack(Epetra_MultiVector& v, int b) {
+  if (exchange.identity) return;
+  const std::vector<double>& buf = exchange.cells[b];
+  int ncells = exchange.clm_to_ats.size();
+  for (int i=0; i!=ncells; ++i) v[0][exchange.clm_to_ats[i]] = buf[i];
+}
+
+} // namespace
+
 
 //
 // Begin initialization, allocating space for driver, grid.
@@ -27,15 +71,52 @@ namespace CLM {
 //   verbosity  | 0 (None) - 1 (Low) - 2 (High) - 3 (Extreme)
 //   
 int init(int ncells, int ncolumns, int startcode, int rank, int verbosity) {
-  int col_inds[ncolumns][2];
-  int count = 0;
+  std::vector<int> column_offsets(ncolumns+1);
+  std::vector<int> column_cells(ncells);
   int ncells_per = ncells / ncolumns;
+  for (int i=0; i!=ncolumns+1; ++i) column_offsets[i] = i * ncells_per;
+  for (int c=0; c!=ncells; ++c) column_cells[c] = c;
+  return init(column_offsets, column_cells, startcode, rank, verbosity);
+}
+
+
+//
+// Begin initialization, given the cells of each column.
+// ------------------------------------------------------------------
+// Input:
+//   column_offsets | cells of column i are column_cells[column_offsets[i]
+//                  |  : column_offsets[i+1]].  Size ncolumns+1.
+//   column_cells   | ATS cell indices, each column top down.  Size ncells.
+//
+int init(const std::vector<int>& column_offsets, const std::vector<int>& column_cells,
+         int startcode, int rank, int verbosity) {
+  int ncolumns = column_offsets.size() - 1;
+  int ncells = column_cells.size();
+
+  // CLM's first and last cell of each column, 1-based, in Fortran order
+  std::vector<int> col_inds(2*ncolumns);
   for (int i=0; i!=ncolumns; ++i) {
-    col_inds[i][0] = count+1;
-    count += ncells_per;
-    col_inds[i][1] = count;
+    col_inds[i] = column_offsets[i] + 1;
+    col_inds[ncolumns + i] = column_offsets[i+1];
   }
-  ats_clm_init(&ncells, &ncolumns, &col_inds[0][0], &startcode, &rank, &verbosity);
+
+  exchange.clm_to_ats = column_cells;
+  exchange.identity = true;
+  for (int i=0; i!=ncells; ++i) {
+    if (column_cells[i] != i) {
+      exchange.identity = false;
+      break;
+    }
+  }
+  if (!exchange.identity) {
+    exchange.cells[0].resize(ncells);
+    exchange.cells[1].resize(ncells);
+  }
+  exchange.precip.resize(ncolumns);
+  exchange.wind_y.assign(ncolumns, 0.);
+  exchange.patm.resize(ncolumns);
+
+  ats_clm_init(&ncells, &ncolumns, col_inds.data(), &startcode, &rank, &verbosity);
   return 0;
 }
 
@@ -86,7 +167,7 @@ int set_ground_properties(double* latlon,
                           const Epetra_MultiVector& sand, const Epetra_MultiVector& clay,
                           const std::vector<int>& color_index,
                           double* fractional_ground) {
-  ats_to_clm_ground_properties(latlon, sand[0], clay[0],
+  ats_to_clm_ground_properties(latlon, pack(sand, 0), pack(clay, 1),
           color_index.data(), fractional_ground);
   return 0;
 }
@@ -99,23 +180,23 @@ int set_ground_properties(double* latlon,
 //   dz         | vector of cell dz [m]
 //
 int set_dz(const Epetra_MultiVector& dz) {
-  ats_to_clm_dz(dz[0]);
+  ats_to_clm_dz(pack(dz, 0));
   return 0;
 }
 
 
 int set_wc(const Epetra_MultiVector& porosity, const Epetra_MultiVector& saturation) {
-  ats_to_clm_wc(porosity[0], saturation[0]);
+  ats_to_clm_wc(pack(porosity, 0), pack(saturation, 1));
   return 0;
 }
 
 int set_tksat_from_porosity(const Epetra_MultiVector& porosity) {
-  ats_to_clm_tksat_from_porosity(porosity[0]);
+  ats_to_clm_tksat_from_porosity(pack(porosity, 0));
   return 0;
 }
 
 int set_pressure(const Epetra_MultiVector& pressure, double patm) {
-  ats_to_clm_pressure(pressure[0], &patm);
+  ats_to_clm_pressure(pack(pressure, 0), &patm);
   return 0;
 }
 
@@ -132,14 +213,14 @@ int set_met_data(const Epetra_MultiVector& qSW, const Epetra_MultiVector& qLW,
                  const Epetra_MultiVector& air_temp, const Epetra_MultiVector& rel_hum,
                  const Epetra_MultiVector& wind_u, double patm) {
   // MOVE the unit conversions here to ats_clm.F90 to be consistent with everything else FIXME
-  Epetra_MultiVector precip(pRain);
-  precip.Update(1000.,pSnow,1000.); // converts m/s --> mm/s 
-  Epetra_MultiVector wind_y(wind_u);
-  wind_y.PutScalar(0.);
-  Epetra_MultiVector patm_v(rel_hum);
-  patm_v.PutScalar(patm);
-  
-  ats_to_clm_met_data(qSW[0], qLW[0], precip[0], air_temp[0], rel_hum[0], wind_u[0], wind_y[0], patm_v[0]);
+  int ncolumns = exchange.precip.size();
+  for (int i=0; i!=ncolumns; ++i) {
+    exchange.precip[i] = 1000. * (pRain[0][i] + pSnow[0][i]); // converts m/s --> mm/s
+    exchange.patm[i] = patm;
+  }
+
+  ats_to_clm_met_data(qSW[0], qLW[0], exchange.precip.data(), air_temp[0], rel_hum[0],
+                      wind_u[0], exchange.wind_y.data(), exchange.patm.data());
   return 0;
 }
 
@@ -182,8 +263,10 @@ int get_mass_fluxes(Epetra_MultiVector& evap_total, Epetra_MultiVector& evap_gro
                     Epetra_MultiVector& irrigation_flag, Epetra_MultiVector& tran_soil) {
   clm_to_ats_mass_fluxes(evap_total[0], evap_ground[0], evap_soil[0], evap_canopy[0],
                          tran_veg[0], influx[0],
-                         irrigation[0], inst_irrigation[0], irrigation_flag[0],
-                         tran_soil[0]);
+                         irrigation[0], unpack_buffer(inst_irrigation, 0), irrigation_flag[0],
+                         unpack_buffer(tran_soil, 1));
+  unpack(inst_irrigation, 0);
+  unpack(tran_soil, 1);
   evap_total.Scale(1.e-3); // to m/s
   evap_ground.Scale(1.e-3); // to m/s
   evap_soil.Scale(1.e-3); // to m/s
@@ -200,7 +283,8 @@ int get_diagnostics(Epetra_MultiVector& swe, Epetra_MultiVector& snow_depth,
                     Epetra_MultiVector& canopy_storage, Epetra_MultiVector& Tskin,
                     Epetra_MultiVector& Tveg, Epetra_MultiVector& Tsoil) {
   clm_to_ats_diagnostics(swe[0], snow_depth[0], canopy_storage[0],
-                         Tskin[0], Tveg[0], Tsoil[0]);
+                         Tskin[0], Tveg[0], unpack_buffer(Tsoil, 0));
+  unpack(Tsoil, 0);
 
   // swe, canopy storage in mm, convert to m
   swe.Scale(1.e-3);
@@ -212,7 +296,8 @@ int get_diagnostics(Epetra_MultiVector& swe, Epetra_MultiVector& snow_depth,
 }
 
 int get_total_mass_fluxes(Epetra_MultiVector& qW_surf, Epetra_MultiVector& qW_subsurf) {
-  clm_to_ats_total_mass_fluxes(qW_surf[0], qW_subsurf[0]);
+  clm_to_ats_total_mass_fluxes(qW_surf[0], unpack_buffer(qW_subsurf, 0));
+  unpack(qW_subsurf, 0);
   qW_surf.Scale(1.e-3); // convert to [m/s]
   qW_subsurf.Scale(1.e-3); // convert to [1/s]
   return 0;
@@ -80,6 +80,22 @@ namespace CLM {
 int init(int ncells, int ncolumns, int startcode,
          int rank, int verbosity);
 
+//
+// Begin initialization, given the cells of each column.
+// ------------------------------------------------------------------
+// Input:
+//   column_offsets | cells of column i are column_cells[column_offsets[i]
+//                  |  : column_offsets[i+1]].  Size ncolumns+1.
+//   column_cells   | ATS cell indices, each column top down.  Size ncells.
+//                  |  Cell-based data is exchanged with CLM in this order,
+//                  |  through buffers allocated once, so ATS cells need not
+//                  |  be ordered by column and columns may differ in length.
+//   startcode, rank, verbosity
+//                  | as above
+//
+int init(const std::vector<int>& column_offsets, const std::vector<int>& column_cells,
+         int startcode, int rank, int verbosity);
+
 
 //
 // Set the reference, time 0, in years.
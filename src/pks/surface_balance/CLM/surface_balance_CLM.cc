@@ -188,10 +188,18 @@ SurfaceBalanceCLM::Setup(const Teuchos::Ptr<State>& S) {
       ->AddComponent("cell", AmanziMesh::CELL, 1);
   
   
-  // Set up the CLM object
-  ATS::CLM::init(subsurf_mesh_->num_entities(AmanziMesh::CELL, AmanziMesh::Parallel_type::OWNED),
-                 mesh_->num_entities(AmanziMesh::CELL, AmanziMesh::Parallel_type::OWNED),
-                 2, mesh_->get_comm()->MyPID(), 3);
+  // Set up the CLM object, which stores the cells of each column contiguously
+  int ncols = mesh_->num_entities(AmanziMesh::CELL, AmanziMesh::Parallel_type::OWNED);
+  std::vector<int> column_offsets(1, 0);
+  std::vector<int> column_cells;
+  for (int col=0; col!=ncols; ++col) {
+    auto& cells = subsurf_mesh_->cells_of_column(col);
+    column_cells.insert(column_cells.end(), cells.begin(), cells.end());
+    column_offsets.push_back(column_cells.size());
+  }
+  AMANZI_ASSERT(column_cells.size() ==
+                subsurf_mesh_->num_entities(AmanziMesh::CELL, AmanziMesh::Parallel_type::OWNED));
+  ATS::CLM::init(column_offsets, column_cells, 2, mesh_->get_comm()->MyPID(), 3);
 }
 
 // -- Initialize owned (dependent) variables.
@@ -37,6 +37,8 @@ https://github.com/landlab/landlab/blob/master/landlab/components/radiation/radi
 
 */
 
+#include <limits>
+
 #include "incident_shortwave_radiation_evaluator.hh"
 #include "incident_shortwave_radiation_model.hh"
 
@@ -50,6 +52,7 @@ IncidentShortwaveRadiationEvaluator::IncidentShortwaveRadiationEvaluator(Teuchos
 {
   Teuchos::ParameterList& sublist = plist_.sublist("incident shortwave radiation parameters");
   model_ = Teuchos::rcp(new IncidentShortwaveRadiationModel(sublist));
+  cache_.time = std::numeric_limits<double>::quiet_NaN();
   InitializeFromPlist_();
 }
 
@@ -60,7 +63,11 @@ IncidentShortwaveRadiationEvaluator::IncidentShortwaveRadiationEvaluator(const I
     slope_key_(other.slope_key_),
     aspect_key_(other.aspect_key_),
     qSWin_key_(other.qSWin_key_),    
-    model_(other.model_) {}
+    model_(other.model_)
+{
+  // the copy computes its own geometric factor on its first evaluation
+  cache_.time = std::numeric_limits<double>::quiet_NaN();
+}
 
 
 // Virtual copy constructor
@@ -98,22 +105,64 @@ void
 IncidentShortwaveRadiationEvaluator::EvaluateField_(const Teuchos::Ptr<State>& S,
         const Teuchos::Ptr<CompositeVector>& result)
 {
-  Teuchos::RCP<const CompositeVector> slope = S->GetFieldData(slope_key_);
-  Teuchos::RCP<const CompositeVector> aspect = S->GetFieldData(aspect_key_);
+  UpdateGeometricFactor_(S, result);
   Teuchos::RCP<const CompositeVector> qSWin = S->GetFieldData(qSWin_key_);
 
   for (CompositeVector::name_iterator comp=result->begin();
        comp!=result->end(); ++comp) {
-    const Epetra_MultiVector& slope_v = *slope->ViewComponent(*comp, false);
-    const Epetra_MultiVector& aspect_v = *aspect->ViewComponent(*comp, false);
     const Epetra_MultiVector& qSWin_v = *qSWin->ViewComponent(*comp, false);
     Epetra_MultiVector& result_v = *result->ViewComponent(*comp,false);
-    double time = S->time();
+    const std::vector<double>& factor = cache_.factor[*comp];
 
     int ncomp = result->size(*comp, false);
     for (int i=0; i!=ncomp; ++i) {
-      result_v[0][i] = model_->IncidentShortwaveRadiation(slope_v[0][i], aspect_v[0][i], qSWin_v[0][i], time);
+      result_v[0][i] = qSWin_v[0][i] * factor[i];
+    }
+  }
+}
+
+
+void
+IncidentShortwaveRadiationEvaluator::UpdateGeometricFactor_(const Teuchos::Ptr<State>& S,
+        const Teuchos::Ptr<CompositeVector>& result)
+{
+  // slope and aspect are static unless the mesh deforms -- note both must be
+  // asked, as asking clears the flag
+  bool changed = S->GetFieldEvaluator(slope_key_)->HasFieldChanged(S, my_key_+" geometric factor");
+  changed |= S->GetFieldEvaluator(aspect_key_)->HasFieldChanged(S, my_key_+" geometric factor");
+
+  if (changed || cache_.terms.empty()) {
+    Teuchos::RCP<const CompositeVector> slope = S->GetFieldData(slope_key_);
+    Teuchos::RCP<const CompositeVector> aspect = S->GetFieldData(aspect_key_);
+    for (CompositeVector::name_iterator comp=result->begin();
+         comp!=result->end(); ++comp) {
+      const Epetra_MultiVector& slope_v = *slope->ViewComponent(*comp, false);
+      const Epetra_MultiVector& aspect_v = *aspect->ViewComponent(*comp, false);
+      std::vector<SlopeAspectTerms>& terms = cache_.terms[*comp];
+
+      int ncomp = result->size(*comp, false);
+      terms.resize(ncomp);
+      for (int i=0; i!=ncomp; ++i) {
+        terms[i] = IncidentShortwaveRadiationModel::ComputeSlopeAspectTerms(slope_v[0][i], aspect_v[0][i]);
+      }
+    }
+    cache_.time = std::numeric_limits<double>::quiet_NaN();
+  }
+
+  if (S->time() != cache_.time) {
+    SolarGeometry sun = model_->ComputeSolarGeometry(S->time());
+    for (CompositeVector::name_iterator comp=result->begin();
+         comp!=result->end(); ++comp) {
+      const std::vector<SlopeAspectTerms>& terms = cache_.terms[*comp];
+      std::vector<double>& factor = cache_.factor[*comp];
+
+      int ncomp = terms.size();
+      factor.resize(ncomp);
+      for (int i=0; i!=ncomp; ++i) {
+        factor[i] = IncidentShortwaveRadiationModel::GeometricFactor(sun, terms[i]);
+      }
     }
+    cache_.time = S->time();
   }
 }
 
@@ -156,16 +205,15 @@ IncidentShortwaveRadiationEvaluator::EvaluateFieldPartialDerivative_(const Teuch
     }
 
   } else if (wrt_key == qSWin_key_) {
+    UpdateGeometricFactor_(S, result);
     for (CompositeVector::name_iterator comp=result->begin();
          comp!=result->end(); ++comp) {
-      const Epetra_MultiVector& slope_v = *slope->ViewComponent(*comp, false);
-      const Epetra_MultiVector& aspect_v = *aspect->ViewComponent(*comp, false);
-      const Epetra_MultiVector& qSWin_v = *qSWin->ViewComponent(*comp, false);
       Epetra_MultiVector& result_v = *result->ViewComponent(*comp,false);
+      const std::vector<double>& factor = cache_.factor[*comp];
 
       int ncomp = result->size(*comp, false);
       for (int i=0; i!=ncomp; ++i) {
-        result_v[0][i] = model_->DIncidentShortwaveRadiationDIncomingShortwaveRadiation(slope_v[0][i], aspect_v[0][i], qSWin_v[0][i], time);
+        result_v[0][i] = factor[i];
       }
     }
 
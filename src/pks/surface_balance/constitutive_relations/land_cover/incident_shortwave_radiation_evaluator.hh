@@ -28,15 +28,17 @@ https://github.com/landlab/landlab/blob/master/landlab/components/radiation/radi
 
 #pragma once
 
+#include <map>
+#include <vector>
+
 #include "Factory.hh"
 #include "secondary_variable_field_evaluator.hh"
+#include "incident_shortwave_radiation_model.hh"
 
 namespace Amanzi {
 namespace SurfaceBalance {
 namespace Relations {
 
-class IncidentShortwaveRadiationModel;
-
 class IncidentShortwaveRadiationEvaluator : public SecondaryVariableFieldEvaluator {
 
  public:
@@ -57,12 +59,27 @@ class IncidentShortwaveRadiationEvaluator : public SecondaryVariableFieldEvaluat
  protected:
   void InitializeFromPlist_();
 
+  // Updates the cached geometric factor on the components of result.
+  void UpdateGeometricFactor_(const Teuchos::Ptr<State>& S,
+          const Teuchos::Ptr<CompositeVector>& result);
+
   Key slope_key_;
   Key aspect_key_;
   Key qSWin_key_;
 
   Teuchos::RCP<IncidentShortwaveRadiationModel> model_;
 
+  // The geometric factor depends only upon time and the static slope and
+  // aspect, so is computed once per time rather than once per evaluation.
+  // Each copy of this evaluator, e.g. in each state, keeps its own cache, as
+  // the states may differ in time and, on deforming meshes, slope/aspect.
+  struct Cache {
+    double time;
+    std::map<std::string, std::vector<SlopeAspectTerms> > terms;
+    std::map<std::string, std::vector<double> > factor;
+  };
+  Cache cache_;
+
  private:
   static Utils::RegisteredFactory<FieldEvaluator,IncidentShortwaveRadiationEvaluator> reg_;
 
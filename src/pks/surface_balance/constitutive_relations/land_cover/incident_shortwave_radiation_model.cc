@@ -61,6 +61,14 @@ IncidentShortwaveRadiationModel::InitializeFromPlist_(Teuchos::ParameterList& pl
 // main method
 double
 IncidentShortwaveRadiationModel::IncidentShortwaveRadiation(double slope, double aspect, double qSWin, double time) const
+{
+  return qSWin * GeometricFactor(ComputeSolarGeometry(time), ComputeSlopeAspectTerms(slope, aspect));
+}
+
+
+// Position of the sun, for all cells.
+SolarGeometry
+IncidentShortwaveRadiationModel::ComputeSolarGeometry(double time) const
 {
   double time_days = time / 86400.0;
   double doy = std::fmod((double)doy0_ + time_days, (double)365);
@@ -72,29 +80,76 @@ IncidentShortwaveRadiationModel::IncidentShortwaveRadiation(double slope, double
     doy = doy - 365.0;
   }
 
-  double rad = 0.0;
+  int days[2];
+  double hour;
+  SolarGeometry sun;
   if (daily_avg_) {
-    double hour = 12;
+    hour = 12;
     // to keep this function smooth, we interpolate between neighboring days
+    sun.ndays = 2;
+    days[0] = doy_i;
+    sun.weight[0] = 1.0;
     if (doy_i < doy) {
-      double rad_i = Impl::Radiation(slope, aspect, doy_i, hour, lat_, qSWin);
-      int doy_ii = doy_i + 1;
-      if (doy_ii > 364) doy_ii = 0;
-      double rad_ii = Impl::Radiation(slope, aspect, doy_ii, hour, lat_, qSWin);
-      rad = rad_i + (doy - doy_i) * rad_ii;
+      days[1] = doy_i + 1;
+      if (days[1] > 364) days[1] = 0;
+      sun.weight[1] = doy - doy_i;
     } else {
-      double rad_i = Impl::Radiation(slope, aspect, doy_i, hour, lat_, qSWin);
-      int doy_ii = doy_i - 1;
-      if (doy_ii < 0) doy_ii = 364;
-      double rad_ii = Impl::Radiation(slope, aspect, doy_ii, hour, lat_, qSWin);
-      rad = rad_i + (doy_i - doy) * rad_ii;
+      days[1] = doy_i - 1;
+      if (days[1] < 0) days[1] = 364;
+      sun.weight[1] = doy_i - doy;
     }
   } else {
-    double hour = 12.0 + 24 * (doy - doy_i);
-    rad = Impl::Radiation(slope, aspect, doy_i, hour, lat_, qSWin);
+    hour = 12.0 + 24 * (doy - doy_i);
+    sun.ndays = 1;
+    days[0] = doy_i;
+    sun.weight[0] = 1.0;
   }
 
-  return rad;
+  double lat_r = M_PI / 180. * lat_;
+  double tau = Impl::HourAngle(hour);
+  for (int i=0; i!=sun.ndays; ++i) {
+    double delta = Impl::DeclinationAngle(days[i]);
+    double alpha = Impl::SolarAltitude(delta, lat_r, tau);
+    double phi_sun = Impl::SolarAzhimuth(delta, lat_r, tau);
+    sun.sin_alpha[i] = std::sin(alpha);
+    sun.cos_alpha[i] = std::cos(alpha);
+    sun.sin_phi_sun[i] = std::sin(phi_sun);
+    sun.cos_phi_sun[i] = std::cos(phi_sun);
+  }
+  return sun;
+}
+
+
+// Slope and aspect terms, for a cell.
+SlopeAspectTerms
+IncidentShortwaveRadiationModel::ComputeSlopeAspectTerms(double slope, double aspect)
+{
+  SlopeAspectTerms cell;
+  double slope_r = std::atan(slope);
+  cell.cos_slope = std::cos(slope_r);
+  cell.sin_slope = std::sin(slope_r);
+  cell.cos_aspect = std::cos(aspect);
+  cell.sin_aspect = std::sin(aspect);
+  return cell;
+}
+
+
+// The ratio of radiation incident on the slope to that on a flat surface,
+// see Impl::Radiation().
+double
+IncidentShortwaveRadiationModel::GeometricFactor(const SolarGeometry& sun, const SlopeAspectTerms& cell)
+{
+  double factor = 0.;
+  for (int i=0; i!=sun.ndays; ++i) {
+    // cos(phi_sun - aspect), expanded to separate sun and cell
+    double cos_rel = sun.cos_phi_sun[i] * cell.cos_aspect + sun.sin_phi_sun[i] * cell.sin_aspect;
+    double fac_slope = cell.cos_slope * sun.sin_alpha[i] + cell.sin_slope * sun.cos_alpha[i] * cos_rel;
+    double fac = fac_slope / sun.sin_alpha[i];
+    if (fac > 6.) fac = 6.;
+    else if (fac < 0.) fac = 0.;
+    factor += sun.weight[i] * fac;
+  }
+  return factor;
 }
 
 double
@@ -114,7 +169,7 @@ IncidentShortwaveRadiationModel::DIncidentShortwaveRadiationDAspect(double slope
 double
 IncidentShortwaveRadiationModel::DIncidentShortwaveRadiationDIncomingShortwaveRadiation(double slope, double aspect, double qSWin, double time) const
 {
-  return IncidentShortwaveRadiation(slope, aspect, qSWin, time) / qSWin;
+  return GeometricFactor(ComputeSolarGeometry(time), ComputeSlopeAspectTerms(slope, aspect));
 }
 
 namespace Impl {
@@ -51,6 +51,22 @@ namespace Impl {
   std::pair<double,double> GeometricRadiationFactors(double slope, double aspect, int doy, double hour, double lat);
   double Radiation(double slope, double aspect, int doy, double hr, double lat, double qSWin);
 }
+
+
+// The position of the sun, which depends only upon time.  In daily averaged
+// mode, the radiation is a weighted sum over two neighboring days at noon.
+struct SolarGeometry {
+  int ndays;
+  double weight[2];
+  double sin_alpha[2], cos_alpha[2];
+  double sin_phi_sun[2], cos_phi_sun[2];
+};
+
+// Terms which depend only upon the slope and aspect of a cell.
+struct SlopeAspectTerms {
+  double cos_slope, sin_slope;
+  double cos_aspect, sin_aspect;
+};
   
 
 class IncidentShortwaveRadiationModel {
@@ -64,7 +80,14 @@ class IncidentShortwaveRadiationModel {
   double DIncidentShortwaveRadiationDSlope(double slope, double aspect, double qSWin, double time) const;
   double DIncidentShortwaveRadiationDAspect(double slope, double aspect, double qSWin, double time) const;
   double DIncidentShortwaveRadiationDIncomingShortwaveRadiation(double slope, double aspect, double qSWin, double time) const;
-  
+
+  // The radiation is qSWin times a geometric factor.  The factor is split
+  // into its time-varying solar and its static per-cell parts, so that each
+  // may be computed only when it changes.
+  SolarGeometry ComputeSolarGeometry(double time) const;
+  static SlopeAspectTerms ComputeSlopeAspectTerms(double slope, double aspect);
+  static double GeometricFactor(const SolarGeometry& sun, const SlopeAspectTerms& cell);
+
  protected:
   void InitializeFromPlist_(Teuchos::ParameterList& plist);
 
@@ -0,0 +1,147 @@
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+*/
+
+#include <string>
+#include <vector>
+#include "UnitTest++.h"
+
+#include "Teuchos_ParameterList.hpp"
+#include "Teuchos_RCP.hpp"
+
+#include "AmanziComm.hh"
+#include "GeometricModel.hh"
+#include "MeshFactory.hh"
+#include "CompositeVector.hh"
+#include "CompositeVectorSpace.hh"
+
+#include "ghost_exchange.hh"
+
+using namespace Amanzi;
+
+namespace {
+
+Teuchos::RCP<const AmanziMesh::Mesh>
+createMesh()
+{
+  auto comm = getDefaultComm();
+  Teuchos::ParameterList region_list;
+  auto gm = Teuchos::rcp(new AmanziGeometry::GeometricModel(3, region_list, *comm));
+  AmanziMesh::MeshFactory factory(comm, gm);
+  return factory.create(0., 0., 0., 1., 1., 1., 4, 4, 4);
+}
+
+
+Teuchos::RCP<CompositeVector>
+createVector(const Teuchos::RCP<const AmanziMesh::Mesh>& mesh,
+             const std::string& comp, AmanziMesh::Entity_kind kind, int ndofs)
+{
+  CompositeVectorSpace space;
+  space.SetMesh(mesh)->SetGhosted()->AddComponent(comp, kind, ndofs);
+  return Teuchos::rcp(new CompositeVector(space));
+}
+
+
+// Owned entries are a function of the global ID, so that each ghost has a
+// distinct, known value, and ghost entries are poisoned.
+void
+fill(CompositeVector& vec, const std::string& comp, double offset)
+{
+  const Epetra_BlockMap& map = *vec.ComponentMap(comp, false);
+  Epetra_MultiVector& vec_g = *vec.ViewComponent(comp, true);
+  for (int k=0; k!=vec_g.NumVectors(); ++k) {
+    for (int i=0; i!=vec_g.MyLength(); ++i) {
+      vec_g[k][i] = i < map.NumMyElements() ? offset + 10. * map.GID(i) + k : -1.;
+    }
+  }
+}
+
+
+// The number of entries, including ghosts, in which two components differ.
+int
+numDiffering(const CompositeVector& vec, const CompositeVector& ref,
+             const std::string& comp)
+{
+  const Epetra_MultiVector& vec_g = *vec.ViewComponent(comp, true);
+  const Epetra_MultiVector& ref_g = *ref.ViewComponent(comp, true);
+  int ndiff = 0;
+  for (int k=0; k!=vec_g.NumVectors(); ++k) {
+    for (int i=0; i!=vec_g.MyLength(); ++i) {
+      if (vec_g[k][i] != ref_g[k][i]) ndiff++;
+    }
+  }
+  int ndiff_g = 0;
+  vec.Comm()->SumAll(&ndiff, &ndiff_g, 1);
+  return ndiff_g;
+}
+
+
+struct Exchange {
+  Exchange() {
+    mesh = createMesh();
+    names = { "face", "face", "cell" };
+    std::vector<AmanziMesh::Entity_kind> kinds = { AmanziMesh::FACE, AmanziMesh::FACE,
+                                                   AmanziMesh::CELL };
+    std::vector<int> ndofs = { 1, 2, 1 };
+    for (int i=0; i!=names.size(); ++i) {
+      vecs.push_back(createVector(mesh, names[i], kinds[i], ndofs[i]));
+      refs.push_back(createVector(mesh, names[i], kinds[i], ndofs[i]));
+    }
+  }
+
+  // Fills all vectors and updates the reference ghosts one vector at a time.
+  void Fill(double offset) {
+    for (int i=0; i!=vecs.size(); ++i) {
+      fill(*vecs[i], names[i], offset + 1.e5 * i);
+      fill(*refs[i], names[i], offset + 1.e5 * i);
+      refs[i]->ScatterMasterToGhosted(names[i]);
+    }
+  }
+
+  void Check() {
+    for (int i=0; i!=vecs.size(); ++i) {
+      CHECK_EQUAL(0, numDiffering(*vecs[i], *refs[i], names[i]));
+    }
+  }
+
+  Teuchos::RCP<const AmanziMesh::Mesh> mesh;
+  std::vector<std::string> names;
+  std::vector<Teuchos::RCP<CompositeVector> > vecs, refs;
+};
+
+} // namespace
+
+
+SUITE(GHOST_EXCHANGE) {
+
+// Two face vectors, batched into one message, and a cell vector.
+TEST_FIXTURE(Exchange, MATCHES_SCATTER) {
+  Fill(0.);
+
+  GhostExchange exchange;
+  for (int i=0; i!=vecs.size(); ++i) exchange.Require(vecs[i], names[i]);
+  CHECK(exchange.pending());
+  exchange.Begin();
+  exchange.Complete();
+  CHECK(!exchange.pending());
+  Check();
+}
+
+
+// Complete() posts if Begin() was not called, and an exchange may be reused
+// after it completes.
+TEST_FIXTURE(Exchange, MATCHES_SCATTER_REUSED) {
+  GhostExchange exchange;
+  for (int round=0; round!=2; ++round) {
+    Fill(1.e3 * round);
+    for (int i=0; i!=vecs.size(); ++i) exchange.Require(vecs[i], names[i]);
+    exchange.Require(vecs[0], names[0]); // duplicates are ignored
+    if (round == 1) exchange.Begin();
+    exchange.Complete();
+    Check();
+  }
+}
+
+}
@@ -0,0 +1,114 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+//! A small, persistent pool of threads for independent, column-wise work.
+
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+*/
+
+#include <algorithm>
+
+#include "dbc.hh"
+
+#include "thread_pool.hh"
+
+namespace Amanzi {
+
+ThreadPool::ThreadPool(int nthreads) :
+    nthreads_(std::max(nthreads, 1)),
+    work_(nullptr),
+    n_(0),
+    generation_(0),
+    nrunning_(0),
+    shutdown_(false),
+    errors_(nthreads_)
+{
+  // the calling thread does the work of thread 0
+  for (int i=1; i<nthreads_; ++i) {
+    workers_.emplace_back(&ThreadPool::Worker_, this, i);
+  }
+}
+
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  start_cv_.notify_all();
+  for (auto& worker : workers_) worker.join();
+}
+
+
+void
+ThreadPool::ParallelFor(int n, const WorkFunction& work)
+{
+  if (nthreads_ == 1 || n < 2) {
+    work(0, n, 0);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    AMANZI_ASSERT(nrunning_ == 0);
+    work_ = &work;
+    n_ = n;
+    nrunning_ = nthreads_ - 1;
+    generation_++;
+    std::fill(errors_.begin(), errors_.end(), nullptr);
+  }
+  start_cv_.notify_all();
+
+  Run_(0);
+
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this]() { return nrunning_ == 0; });
+    work_ = nullptr;
+  }
+
+  for (const auto& error : errors_) {
+    if (error) std::rethrow_exception(error);
+  }
+}
+
+
+void
+ThreadPool::Run_(int thread_id)
+{
+  int chunk = (n_ + nthreads_ - 1) / nthreads_;
+  int begin = std::min(thread_id * chunk, n_);
+  int end = std::min(begin + chunk, n_);
+  try {
+    if (begin < end) (*work_)(begin, end, thread_id);
+  } catch (...) {
+    errors_[thread_id] = std::current_exception();
+  }
+}
+
+
+void
+ThreadPool::Worker_(int thread_id)
+{
+  int seen_generation = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      start_cv_.wait(lock, [&]() { return shutdown_ || generation_ != seen_generation; });
+      if (shutdown_) return;
+      seen_generation = generation_;
+    }
+
+    Run_(thread_id);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      nrunning_--;
+    }
+    done_cv_.notify_one();
+  }
+}
+
+} // namespace Amanzi
@@ -0,0 +1,83 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+//! A small, persistent pool of threads for independent, column-wise work.
+
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+*/
+
+/*!
+
+Many PKs loop over independent units of work -- columns, sites, subgrid
+domains -- calling process models that have no coupling between units.
+This pool runs such loops concurrently on a fixed number of threads within a
+single MPI rank.  Threads are created once and reused across calls.
+
+Work is statically split into contiguous chunks, one per thread, so that a
+given thread always sees the same range of units for the same loop length.
+Exceptions thrown by the work function are caught and rethrown on the calling
+thread once all threads have finished.
+
+Note that the work function must be thread-safe: in particular, it should not
+call into the mesh or State, which are not.  Data should be gathered before,
+and scattered after, the parallel loop, or accessed by entity index into
+preallocated arrays.
+
+.. _thread-pool-spec:
+.. admonition:: thread-pool-spec
+
+    * `"number of threads`" ``[int]`` **1** Number of threads used,
+      including the calling thread.  A value of 1 executes serially.
+
+*/
+
+#ifndef ATS_PKS_THREAD_POOL_HH_
+#define ATS_PKS_THREAD_POOL_HH_
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Amanzi {
+
+class ThreadPool {
+ public:
+  // work(begin, end, thread_id) operates on units [begin, end)
+  typedef std::function<void(int, int, int)> WorkFunction;
+
+  explicit ThreadPool(int nthreads);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool& other) = delete;
+  ThreadPool& operator=(const ThreadPool& other) = delete;
+
+  int num_threads() const { return nthreads_; }
+
+  // Executes work over [0, n), blocking until all units are done.
+  void ParallelFor(int n, const WorkFunction& work);
+
+ private:
+  void Worker_(int thread_id);
+  void Run_(int thread_id);
+
+ private:
+  int nthreads_;
+  std::vector<std::thread> workers_;
+
+  std::mutex mutex_;
+  std::condition_variable start_cv_, done_cv_;
+  const WorkFunction* work_;
+  int n_;
+  int generation_;
+  int nrunning_;
+  bool shutdown_;
+  std::vector<std::exception_ptr> errors_;
+};
+
+} // namespace Amanzi
+
+#endif
@@ -307,11 +307,14 @@ void SedimentTransport_PK::Initialize(const Teuchos::Ptr<State>& S)
   // *tcc_tmp = *tcc;
 
   // upwind 
-  const Epetra_Map& fmap_wghost = mesh_->face_map(true);
-  upwind_cell_ = Teuchos::rcp(new Epetra_IntVector(fmap_wghost));
-  downwind_cell_ = Teuchos::rcp(new Epetra_IntVector(fmap_wghost));
+  thread_pool_ = Teuchos::rcp(new ThreadPool(tp_list_->get<int>("number of threads", 1)));
+  Teuchos::RCP<ThreadPool> pool = thread_pool_;
+  advection_ = Teuchos::rcp(new Operators::AdvectionDonorUpwindExplicit(mesh_,
+          [pool](int n, const ThreadPool::WorkFunction& work) { pool->ParallelFor(n, work); }));
+  upwind_cell_ = advection_->upwind_cell();
+  downwind_cell_ = advection_->downwind_cell();
 
-  IdentifyUpwindCells();
+  advection_->IdentifyUpwindCells(*flux_);
 
   // advection block initialization
   current_component_ = -1;
@@ -598,7 +601,7 @@ double SedimentTransport_PK::StableTimeStep()
     // }
   //}
   
-  IdentifyUpwindCells();
+  advection_->IdentifyUpwindCells(*flux_);
 
   tcc = S_inter_->GetFieldData(tcc_key_, passwd_);
   Epetra_MultiVector& tcc_prev = *tcc->ViewComponent("cell");
@@ -752,8 +755,8 @@ bool SedimentTransport_PK::AdvanceStep(double t_old, double t_new, bool reinit)
   double dt_cycle;
   if (interpolate_ws) {        
     dt_cycle = std::min(dt_stable, dt_MPC);
-    InterpolateCellVector(*ws_prev_, *ws_, dt_shift, dt_global, *ws_subcycle_start);
-    InterpolateCellVector(*ws_prev_, *ws_, dt_shift + dt_cycle, dt_global, *ws_subcycle_end);
+    Operators::AdvectionDonorUpwindExplicit::InterpolateCellVector(*ws_prev_, *ws_, dt_shift, dt_global, *ws_subcycle_start);
+    Operators::AdvectionDonorUpwindExplicit::InterpolateCellVector(*ws_prev_, *ws_, dt_shift + dt_cycle, dt_global, *ws_subcycle_end);
     ws_start = ws_subcycle_start;
     ws_end = ws_subcycle_end;
     mol_dens_start = mol_dens_;
@@ -812,8 +815,8 @@ bool SedimentTransport_PK::AdvanceStep(double t_old, double t_new, bool reinit)
         mol_dens_end = mol_dens_;
                 
         double dt_int = dt_sum + dt_shift;
-        InterpolateCellVector(*ws_prev_, *ws_, dt_int, dt_global, *ws_subcycle_end);
-        //InterpolateCellVector(*mol_dens_prev_, *mol_dens_, dt_int, dt_global, *mol_dens_subcycle_end);
+        Operators::AdvectionDonorUpwindExplicit::InterpolateCellVector(*ws_prev_, *ws_, dt_int, dt_global, *ws_subcycle_end);
+        //Operators::AdvectionDonorUpwindExplicit::InterpolateCellVector(*mol_dens_prev_, *mol_dens_, dt_int, dt_global, *mol_dens_subcycle_end);
       } else {  // Initial water saturation is in 'end'.
         ws_start = ws_subcycle_end;
         ws_end = ws_subcycle_start;
@@ -821,8 +824,8 @@ bool SedimentTransport_PK::AdvanceStep(double t_old, double t_new, bool reinit)
         mol_dens_end = mol_dens_;
 
         double dt_int = dt_sum + dt_shift;
-        InterpolateCellVector(*ws_prev_, *ws_, dt_int, dt_global, *ws_subcycle_start);
-        //InterpolateCellVector(*mol_dens_prev_, *mol_dens_, dt_int, dt_global, *mol_dens_subcycle_start);
+        Operators::AdvectionDonorUpwindExplicit::InterpolateCellVector(*ws_prev_, *ws_, dt_int, dt_global, *ws_subcycle_start);
+        //Operators::AdvectionDonorUpwindExplicit::InterpolateCellVector(*mol_dens_prev_, *mol_dens_, dt_int, dt_global, *mol_dens_subcycle_start);
       }
       swap = 1 - swap;
     }
@@ -835,8 +838,13 @@ bool SedimentTransport_PK::AdvanceStep(double t_old, double t_new, bool reinit)
     //   AdvanceSecondOrderUpwindRK2(dt_cycle);
     }
    
-    if (! final_cycle) {  // rotate concentrations (we need new memory for tcc)
-      tcc = Teuchos::RCP<CompositeVector>(new CompositeVector(*tcc_tmp));
+    if (! final_cycle) {  // rotate concentrations, into storage reused across steps
+      if (tcc_subcycle_ == Teuchos::null) {
+        tcc_subcycle_ = Teuchos::rcp(new CompositeVector(*tcc_tmp));
+      } else {
+        *tcc_subcycle_ = *tcc_tmp;
+      }
+      tcc = tcc_subcycle_;
     }
 
     ncycles++;
@@ -1026,34 +1034,9 @@ void SedimentTransport_PK::AdvanceDonorUpwind(double dt_cycle)
 
   
   // advance all components at once
-  for (int f = 0; f < nfaces_wghost; f++) {  // loop over master and slave faces
-    int c1 = (*upwind_cell_)[f];
-    int c2 = (*downwind_cell_)[f];
-
-    double u = fabs((*flux_)[0][f]);
-
-    if (c1 >=0 && c1 < ncells_owned && c2 >= 0 && c2 < ncells_owned) {
-      for (int i = 0; i < num_advect; i++) {
-        tcc_flux = dt_ * u * tcc_prev[i][c1];
-        (*conserve_qty_)[i][c1] -= tcc_flux;
-        (*conserve_qty_)[i][c2] += tcc_flux;
-      }
-
-    }
-    else if (c1 >=0 && c1 < ncells_owned && (c2 >= ncells_owned || c2 < 0)) {
-      for (int i = 0; i < num_advect; i++) {
-        tcc_flux = dt_ * u * tcc_prev[i][c1];
-        (*conserve_qty_)[i][c1] -= tcc_flux;
-        if (c2 < 0) mass_sediment_bc_ -= tcc_flux;
-      }
-
-    } else if (c1 >= ncells_owned && c2 >= 0 && c2 < ncells_owned) {
-      for (int i = 0; i < num_advect; i++) {
-        tcc_flux = dt_ * u * tcc_prev[i][c1];
-        (*conserve_qty_)[i][c2] += tcc_flux;
-      }
-    }
-  }
+  mass_bc_.assign(num_advect, 0.);
+  advection_->Advect(dt_, *flux_, tcc_prev, num_advect, *conserve_qty_, &mass_bc_);
+  for (int i = 0; i < num_advect; i++) mass_sediment_bc_ += mass_bc_[i];
 
  
   // loop over exterior boundary sets
@@ -1517,39 +1500,6 @@ bool SedimentTransport_PK::PopulateBoundaryData(
 }
 
 
-/* *******************************************************************
-* Identify flux direction based on orientation of the face normal 
-* and sign of the  Darcy velocity.                               
-******************************************************************* */
-void SedimentTransport_PK::IdentifyUpwindCells()
-{
-  for (int f = 0; f < nfaces_wghost; f++) {
-    (*upwind_cell_)[f] = -1;  // negative value indicates boundary
-    (*downwind_cell_)[f] = -1;
-
-    }
-  AmanziMesh::Entity_ID_List faces;
-  std::vector<int> dirs;
-
-  for (int c = 0; c < ncells_wghost; c++) {
-    mesh_->cell_get_faces_and_dirs(c, &faces, &dirs);
-
-    for (int i = 0; i < faces.size(); i++) {
-      int f = faces[i];
-      double tmp = (*flux_)[0][f] * dirs[i];
-      if (tmp > 0.0) {
-        (*upwind_cell_)[f] = c;
-      } else if (tmp < 0.0) {
-        (*downwind_cell_)[f] = c;
-      } else if (dirs[i] > 0) {
-        (*upwind_cell_)[f] = c;
-      } else {
-        (*downwind_cell_)[f] = c;
-      }
-    }
-  }
-}
-
 // void SedimentTransport_PK::ComputeVolumeDarcyFlux(Teuchos::RCP<const Epetra_MultiVector> flux,
 //                                               Teuchos::RCP<const Epetra_MultiVector> molar_density,
 //                                               Teuchos::RCP<Epetra_MultiVector>& vol_darcy_flux){
@@ -1570,20 +1520,6 @@ void SedimentTransport_PK::IdentifyUpwindCells()
   // 
 
 
-/* *******************************************************************
-* Interpolate linearly in time between two values v0 and v1. The time 
-* is measuared relative to value v0; so that v1 is at time dt. The
-* interpolated data are at time dt_int.            
-******************************************************************* */
-void SedimentTransport_PK::InterpolateCellVector(
-    const Epetra_MultiVector& v0, const Epetra_MultiVector& v1, 
-    double dt_int, double dt, Epetra_MultiVector& v_int) 
-{
-  double a = dt_int / dt;
-  double b = 1.0 - a;
-  v_int.Update(b, v0, a, v1, 0.);
-}
-
 }  // namespace SedimentTransport
 }  // namespace Amanzi
 
@@ -35,6 +35,8 @@
 #include <string>
 
 // Transport
+#include "advection_donor_upwind_explicit.hh"
+#include "thread_pool.hh"
 #include "TransportDomainFunction.hh"
 #include "SedimentTransportDefs.hh"
 
@@ -145,12 +147,6 @@ typedef double AnalyticFunction(const AmanziGeometry::Point&, const double);
     void FunctionalTimeDerivative(const double t, const Epetra_Vector& component, Epetra_Vector& f_component){};
     //  void Functional(const double t, const Epetra_Vector& component, TreeVector& f_component);
 
-  void IdentifyUpwindCells();
-
-  void InterpolateCellVector(
-      const Epetra_MultiVector& v0, const Epetra_MultiVector& v1, 
-      double dT_int, double dT, Epetra_MultiVector& v_int);
-
   const Teuchos::RCP<Epetra_IntVector>& upwind_cell() { return upwind_cell_; }
   const Teuchos::RCP<Epetra_IntVector>& downwind_cell() { return downwind_cell_; }  
 
@@ -215,8 +211,12 @@ typedef double AnalyticFunction(const AmanziGeometry::Point&, const double);
   Teuchos::RCP<Epetra_MultiVector> flux_copy_;
   Teuchos::RCP<const Epetra_MultiVector> km_;  
     
-  Teuchos::RCP<Epetra_IntVector> upwind_cell_;
+  Teuchos::RCP<ThreadPool> thread_pool_;
+  Teuchos::RCP<Operators::AdvectionDonorUpwindExplicit> advection_;
+  Teuchos::RCP<Epetra_IntVector> upwind_cell_;  // views of advection_'s upwinding
   Teuchos::RCP<Epetra_IntVector> downwind_cell_;
+  Teuchos::RCP<CompositeVector> tcc_subcycle_;  // storage for tcc between subcycles
+  std::vector<double> mass_bc_;
 
   Teuchos::RCP<const Epetra_MultiVector> ws_start, ws_end;  // data for subcycling 
   Teuchos::RCP<const Epetra_MultiVector> mol_dens_start, mol_dens_end;  // data for subcycling 
@@ -109,6 +109,9 @@ The advection-diffusion equation for component *i* in the surface may be written
     * `"transport subcycling`" ``[bool]`` **true** The code will default to subcycling for transport within
       the master PK if there is one.
 
+    * `"number of threads`" ``[int]`` **1** Number of threads used in the
+      explicit advection update.  See thread-pool-spec_.
+
 
     Developer parameters:
 
@@ -274,6 +277,8 @@ The advection-diffusion equation for component *i* in the surface may be written
 #endif
 
 // Transport
+#include "advection_donor_upwind_explicit.hh"
+#include "thread_pool.hh"
 #include "LimiterCell.hh"
 #include "MDMPartition.hh"
 #include "MultiscaleTransportPorosityPartition.hh"
@@ -397,12 +402,6 @@ private:
   void FunctionalTimeDerivative(const double t, const Epetra_Vector& component, Epetra_Vector& f_component);
   //  void FunctionalTimeDerivative(const double t, const Epetra_Vector& component, TreeVector& f_component);
 
-  void IdentifyUpwindCells();
-
-  void InterpolateCellVector(
-    const Epetra_MultiVector& v0, const Epetra_MultiVector& v1,
-    double dT_int, double dT, Epetra_MultiVector& v_int);
-
   const Teuchos::RCP<Epetra_IntVector>& upwind_cell() { return upwind_cell_; }
   const Teuchos::RCP<Epetra_IntVector>& downwind_cell() { return downwind_cell_; }
 
@@ -490,8 +489,11 @@ protected:
   Teuchos::RCP<AmanziChemistry::ChemistryEngine> chem_engine_;
 #endif
 
-  Teuchos::RCP<Epetra_IntVector> upwind_cell_;
+  Teuchos::RCP<ThreadPool> thread_pool_;
+  Teuchos::RCP<Operators::AdvectionDonorUpwindExplicit> advection_;
+  Teuchos::RCP<Epetra_IntVector> upwind_cell_;  // views of advection_'s upwinding
   Teuchos::RCP<Epetra_IntVector> downwind_cell_;
+  Teuchos::RCP<CompositeVector> tcc_subcycle_;  // storage for tcc between subcycles
 
   Teuchos::RCP<const Epetra_MultiVector> ws_start, ws_end;  // data for subcycling
   Teuchos::RCP<const Epetra_MultiVector> mol_dens_start, mol_dens_end;  // data for subcycling
@@ -344,11 +344,14 @@ void Transport_ATS::Initialize(const Teuchos::Ptr<State>& S)
   conserve_qty_ = S->GetFieldData(conserve_qty_key_, name_)->ViewComponent("cell", true);
 
   // upwind
-  const Epetra_Map& fmap_wghost = mesh_->face_map(true);
-  upwind_cell_ = Teuchos::rcp(new Epetra_IntVector(fmap_wghost));
-  downwind_cell_ = Teuchos::rcp(new Epetra_IntVector(fmap_wghost));
+  thread_pool_ = Teuchos::rcp(new ThreadPool(plist_->get<int>("number of threads", 1)));
+  Teuchos::RCP<ThreadPool> pool = thread_pool_;
+  advection_ = Teuchos::rcp(new Operators::AdvectionDonorUpwindExplicit(mesh_,
+          [pool](int n, const ThreadPool::WorkFunction& work) { pool->ParallelFor(n, work); }));
+  upwind_cell_ = advection_->upwind_cell();
+  downwind_cell_ = advection_->downwind_cell();
 
-  IdentifyUpwindCells();
+  advection_->IdentifyUpwindCells(*flux_);
 
   // advection block initialization
   current_component_ = -1;
@@ -627,8 +630,7 @@ double Transport_ATS::StableTimeStep()
 
   flux_ = S_next_->GetFieldData(flux_key_)->ViewComponent("face", true);
 
-  Teuchos::RCP<Epetra_Map> cell_map = Teuchos::rcp(new Epetra_Map(mesh_->cell_map(false)));
-  IdentifyUpwindCells();
+  advection_->IdentifyUpwindCells(*flux_);
 
   tcc = S_inter_->GetFieldData(tcc_key_, name_);
   Epetra_MultiVector& tcc_prev = *tcc->ViewComponent("cell");
@@ -828,10 +830,10 @@ bool Transport_ATS::AdvanceStep(double t_old, double t_new, bool reinit)
   double dt_cycle;
   if (interpolate_ws) {
     dt_cycle = std::min(dt_stable, dt_MPC);
-    InterpolateCellVector(*ws_prev_, *ws_, dt_shift, dt_global, *ws_subcycle_start);
-    InterpolateCellVector(*mol_dens_prev_, *mol_dens_, dt_shift, dt_global, *mol_dens_subcycle_start);
-    InterpolateCellVector(*ws_prev_, *ws_, dt_shift + dt_cycle, dt_global, *ws_subcycle_end);
-    InterpolateCellVector(*mol_dens_prev_, *mol_dens_, dt_shift + dt_cycle, dt_global, *mol_dens_subcycle_end);
+    Operators::AdvectionDonorUpwindExplicit::InterpolateCellVector(*ws_prev_, *ws_, dt_shift, dt_global, *ws_subcycle_start);
+    Operators::AdvectionDonorUpwindExplicit::InterpolateCellVector(*mol_dens_prev_, *mol_dens_, dt_shift, dt_global, *mol_dens_subcycle_start);
+    Operators::AdvectionDonorUpwindExplicit::InterpolateCellVector(*ws_prev_, *ws_, dt_shift + dt_cycle, dt_global, *ws_subcycle_end);
+    Operators::AdvectionDonorUpwindExplicit::InterpolateCellVector(*mol_dens_prev_, *mol_dens_, dt_shift + dt_cycle, dt_global, *mol_dens_subcycle_end);
     ws_start = ws_subcycle_start;
     ws_end = ws_subcycle_end;
     mol_dens_start = mol_dens_subcycle_start;
@@ -885,8 +887,8 @@ bool Transport_ATS::AdvanceStep(double t_old, double t_new, bool reinit)
         mol_dens_end = mol_dens_subcycle_end;
 
         double dt_int = dt_sum + dt_shift;
-        InterpolateCellVector(*ws_prev_, *ws_, dt_int, dt_global, *ws_subcycle_end);
-        InterpolateCellVector(*mol_dens_prev_, *mol_dens_, dt_int, dt_global, *mol_dens_subcycle_end);
+        Operators::AdvectionDonorUpwindExplicit::InterpolateCellVector(*ws_prev_, *ws_, dt_int, dt_global, *ws_subcycle_end);
+        Operators::AdvectionDonorUpwindExplicit::InterpolateCellVector(*mol_dens_prev_, *mol_dens_, dt_int, dt_global, *mol_dens_subcycle_end);
       } else {  // Initial water saturation is in 'end'.
         ws_start = ws_subcycle_end;
         ws_end = ws_subcycle_start;
@@ -894,8 +896,8 @@ bool Transport_ATS::AdvanceStep(double t_old, double t_new, bool reinit)
         mol_dens_end = mol_dens_subcycle_start;
 
         double dt_int = dt_sum + dt_shift;
-        InterpolateCellVector(*ws_prev_, *ws_, dt_int, dt_global, *ws_subcycle_start);
-        InterpolateCellVector(*mol_dens_prev_, *mol_dens_, dt_int, dt_global, *mol_dens_subcycle_start);
+        Operators::AdvectionDonorUpwindExplicit::InterpolateCellVector(*ws_prev_, *ws_, dt_int, dt_global, *ws_subcycle_start);
+        Operators::AdvectionDonorUpwindExplicit::InterpolateCellVector(*mol_dens_prev_, *mol_dens_, dt_int, dt_global, *mol_dens_subcycle_start);
       }
       swap = 1 - swap;
     }
@@ -915,8 +917,13 @@ bool Transport_ATS::AdvanceStep(double t_old, double t_new, bool reinit)
       AddMultiscalePorosity_(t_old, t_new, t_int1, t_int2);
     }
 
-    if (! final_cycle) {  // rotate concentrations (we need new memory for tcc)
-      tcc = Teuchos::RCP<CompositeVector>(new CompositeVector(*tcc_tmp));
+    if (! final_cycle) {  // rotate concentrations, into storage reused across steps
+      if (tcc_subcycle_ == Teuchos::null) {
+        tcc_subcycle_ = Teuchos::rcp(new CompositeVector(*tcc_tmp));
+      } else {
+        *tcc_subcycle_ = *tcc_tmp;
+      }
+      tcc = tcc_subcycle_;
     }
 
     ncycles++;
@@ -1284,43 +1291,8 @@ void Transport_ATS::AdvanceDonorUpwind(double dt_cycle)
   mesh_->get_comm()->SumAll(&tmp1, &mass_start, 1);
 
   // advance all components at once
-  for (int f = 0; f < nfaces_wghost; f++) {  // loop over master and slave faces
-    int c1 = (*upwind_cell_)[f];
-    int c2 = (*downwind_cell_)[f];
-    double u = fabs((*flux_)[0][f]);
-
-    if (c1 >=0 && c1 < ncells_owned && c2 >= 0 && c2 < ncells_owned) {
-      for (int i = 0; i < num_advect; i++) {
-        double tcc_flux = dt_ * u * tcc_prev[i][c1];
-        (*conserve_qty_)[i][c1] -= tcc_flux;
-        (*conserve_qty_)[i][c2] += tcc_flux;
-      }
-      (*conserve_qty_)[num_components+1][c1] -= dt_ * u;
-      (*conserve_qty_)[num_components+1][c2] += dt_ * u;
-    }
-    else if (c1 >=0 && c1 < ncells_owned && (c2 >= ncells_owned || c2 < 0)) {
-      for (int i = 0; i < num_advect; i++) {
-        double tcc_flux = dt_ * u * tcc_prev[i][c1];
-        (*conserve_qty_)[i][c1] -= tcc_flux;
-        if (c2 < 0) mass_solutes_bc_[i] -= tcc_flux;
-        //AmanziGeometry::Point normal = mesh_->face_normal(f);
-      }
-      (*conserve_qty_)[num_components+1][c1] -= dt_ * u;
-
-    } else if (c1 >= ncells_owned && c2 >= 0 && c2 < ncells_owned) {
-      for (int i = 0; i < num_advect; i++) {
-        double tcc_flux = dt_ * u * tcc_prev[i][c1];
-        (*conserve_qty_)[i][c2] += tcc_flux;
-      }
-      (*conserve_qty_)[num_components+1][c2] += dt_ * u;
-
-    } else if (c2 < 0 && c1 >= 0 && c1 < ncells_owned) {
-      (*conserve_qty_)[num_components+1][c1] -= dt_ * u;
-
-    } else if (c1 < 0 && c2 >= 0 && c2 < ncells_owned) {
-      (*conserve_qty_)[num_components+1][c2] += dt_ * u;
-    }
-  }
+  advection_->Advect(dt_, *flux_, tcc_prev, num_advect, *conserve_qty_,
+                     &mass_solutes_bc_, num_components+1);
 
   // loop over exterior boundary sets
   for (int m = 0; m < bcs_.size(); m++) {
@@ -1760,39 +1732,6 @@ bool Transport_ATS::PopulateBoundaryData(
 }
 
 
-/* *******************************************************************
-* Identify flux direction based on orientation of the face normal
-* and sign of the  Darcy velocity.
-******************************************************************* */
-void Transport_ATS::IdentifyUpwindCells()
-{
-  for (int f = 0; f < nfaces_wghost; f++) {
-    (*upwind_cell_)[f] = -1;  // negative value indicates boundary
-    (*downwind_cell_)[f] = -1;
-  }
-
-  AmanziMesh::Entity_ID_List faces;
-  std::vector<int> dirs;
-  for (int c = 0; c < ncells_wghost; c++) {
-    mesh_->cell_get_faces_and_dirs(c, &faces, &dirs);
-
-    for (int i = 0; i < faces.size(); i++) {
-      int f = faces[i];
-      double tmp = (*flux_)[0][f] * dirs[i];
-      if (tmp > 0.0) {
-        (*upwind_cell_)[f] = c;
-      } else if (tmp < 0.0) {
-        (*downwind_cell_)[f] = c;
-      } else if (dirs[i] > 0) {
-        (*upwind_cell_)[f] = c;
-      } else {
-        (*downwind_cell_)[f] = c;
-      }
-    }
-  }
-}
-
-
 void Transport_ATS::ComputeVolumeDarcyFlux(Teuchos::RCP<const Epetra_MultiVector> flux,
                                               Teuchos::RCP<const Epetra_MultiVector> molar_density,
                                               Teuchos::RCP<Epetra_MultiVector>& vol_darcy_flux)
@@ -1810,20 +1749,6 @@ void Transport_ATS::ComputeVolumeDarcyFlux(Teuchos::RCP<const Epetra_MultiVector
 }
 
 
-/* *******************************************************************
-* Interpolate linearly in time between two values v0 and v1. The time
-* is measuared relative to value v0; so that v1 is at time dt. The
-* interpolated data are at time dt_int.
-******************************************************************* */
-void Transport_ATS::InterpolateCellVector(
-    const Epetra_MultiVector& v0, const Epetra_MultiVector& v1,
-    double dt_int, double dt, Epetra_MultiVector& v_int)
-{
-  double a = dt_int / dt;
-  double b = 1.0 - a;
-  v_int.Update(b, v0, a, v1, 0.);
-}
-
 }  // namespace Transport
 }  // namespace Amanzi
 
@@ -37,11 +37,11 @@ int main() {
 
     std::cout << "NNodes on the surf = " << m.coords.size() << std::endl;
     std::cout << "Ncells on the surf = " << m.cell2node.size() << std::endl;
-    std::cout << "NNodes on 3D = " << m3.coords.size() << std::endl;
-    std::cout << "Ncells on 3D = " << m3.cell2face.size() << std::endl;
-    assert(m3.coords.size() == 11);
-    assert(m3.cell2face.size() == 4);
-    assert(m3.face2node.size() == 16);
+    std::cout << "NNodes on 3D = " << m3.num_nodes() << std::endl;
+    std::cout << "Ncells on 3D = " << m3.num_cells() << std::endl;
+    assert(m3.num_nodes() == 11);
+    assert(m3.num_cells() == 4);
+    assert(m3.num_faces() == 16);
     
     writeMesh3D_exodus(m3, mesh_out);
 
@@ -54,11 +54,11 @@ int main() {
     
     std::cout << "NNodes on the surf = " << m.coords.size() << std::endl;
     std::cout << "Ncells on the surf = " << m.cell2node.size() << std::endl;
-    std::cout << "NNodes on 3D = " << m3_ns.coords.size() << std::endl;
-    std::cout << "Ncells on 3D = " << m3_ns.cell2face.size() << std::endl;
-    assert(m3_ns.coords.size() == 12);
-    assert(m3_ns.cell2face.size() == 4);
-    assert(m3_ns.face2node.size() == 16);
+    std::cout << "NNodes on 3D = " << m3_ns.num_nodes() << std::endl;
+    std::cout << "Ncells on 3D = " << m3_ns.num_cells() << std::endl;
+    assert(m3_ns.num_nodes() == 12);
+    assert(m3_ns.num_cells() == 4);
+    assert(m3_ns.num_faces() == 16);
     
     writeMesh3D_exodus(m3_ns, mesh_out_ns);
   }
@@ -80,11 +80,11 @@ int main() {
 
     std::cout << "NNodes on the surf = " << m.coords.size() << std::endl;
     std::cout << "Ncells on the surf = " << m.cell2node.size() << std::endl;
-    std::cout << "NNodes on 3D = " << m3.coords.size() << std::endl;
-    std::cout << "Ncells on 3D = " << m3.cell2face.size() << std::endl;
-    assert(m3.coords.size() == 10);
-    assert(m3.cell2face.size() == 4);
-    assert(m3.face2node.size() == 15);
+    std::cout << "NNodes on 3D = " << m3.num_nodes() << std::endl;
+    std::cout << "Ncells on 3D = " << m3.num_cells() << std::endl;
+    assert(m3.num_nodes() == 10);
+    assert(m3.num_cells() == 4);
+    assert(m3.num_faces() == 15);
     
     writeMesh3D_exodus(m3, mesh_out);
 
@@ -97,11 +97,11 @@ int main() {
     
     std::cout << "NNodes on the surf = " << m.coords.size() << std::endl;
     std::cout << "Ncells on the surf = " << m.cell2node.size() << std::endl;
-    std::cout << "NNodes on 3D = " << m3_ns.coords.size() << std::endl;
-    std::cout << "Ncells on 3D = " << m3_ns.cell2face.size() << std::endl;
-    assert(m3_ns.coords.size() == 12);
-    assert(m3_ns.cell2face.size() == 4);
-    assert(m3_ns.face2node.size() == 16);
+    std::cout << "NNodes on 3D = " << m3_ns.num_nodes() << std::endl;
+    std::cout << "Ncells on 3D = " << m3_ns.num_cells() << std::endl;
+    assert(m3_ns.num_nodes() == 12);
+    assert(m3_ns.num_cells() == 4);
+    assert(m3_ns.num_faces() == 16);
     
     writeMesh3D_exodus(m3_ns, mesh_out_ns);
   }
@@ -122,11 +122,11 @@ int main() {
 
     std::cout << "NNodes on the surf = " << m.coords.size() << std::endl;
     std::cout << "Ncells on the surf = " << m.cell2node.size() << std::endl;
-    std::cout << "NNodes on 3D = " << m3.coords.size() << std::endl;
-    std::cout << "Ncells on 3D = " << m3.cell2face.size() << std::endl;
-    assert(m3.coords.size() == 9);
-    assert(m3.cell2face.size() == 3);
-    assert(m3.face2node.size() == 12);
+    std::cout << "NNodes on 3D = " << m3.num_nodes() << std::endl;
+    std::cout << "Ncells on 3D = " << m3.num_cells() << std::endl;
+    assert(m3.num_nodes() == 9);
+    assert(m3.num_cells() == 3);
+    assert(m3.num_faces() == 12);
     
     writeMesh3D_exodus(m3, mesh_out);
 
@@ -139,11 +139,11 @@ int main() {
     
     std::cout << "NNodes on the surf = " << m.coords.size() << std::endl;
     std::cout << "Ncells on the surf = " << m.cell2node.size() << std::endl;
-    std::cout << "NNodes on 3D = " << m3_ns.coords.size() << std::endl;
-    std::cout << "Ncells on 3D = " << m3_ns.cell2face.size() << std::endl;
-    assert(m3_ns.coords.size() == 12);
-    assert(m3_ns.cell2face.size() == 4);
-    assert(m3_ns.face2node.size() == 16);
+    std::cout << "NNodes on 3D = " << m3_ns.num_nodes() << std::endl;
+    std::cout << "Ncells on 3D = " << m3_ns.num_cells() << std::endl;
+    assert(m3_ns.num_nodes() == 12);
+    assert(m3_ns.num_cells() == 4);
+    assert(m3_ns.num_faces() == 16);
     
     writeMesh3D_exodus(m3_ns, mesh_out_ns);
   }
@@ -163,11 +163,11 @@ int main() {
 
     std::cout << "NNodes on the surf = " << m.coords.size() << std::endl;
     std::cout << "Ncells on the surf = " << m.cell2node.size() << std::endl;
-    std::cout << "NNodes on 3D = " << m3.coords.size() << std::endl;
-    std::cout << "Ncells on 3D = " << m3.cell2face.size() << std::endl;
-    assert(m3.coords.size() == 8);
-    assert(m3.cell2face.size() == 2);
-    assert(m3.face2node.size() == 9);
+    std::cout << "NNodes on 3D = " << m3.num_nodes() << std::endl;
+    std::cout << "Ncells on 3D = " << m3.num_cells() << std::endl;
+    assert(m3.num_nodes() == 8);
+    assert(m3.num_cells() == 2);
+    assert(m3.num_faces() == 9);
     
     writeMesh3D_exodus(m3, mesh_out);
 
@@ -180,11 +180,11 @@ int main() {
     
     std::cout << "NNodes on the surf = " << m.coords.size() << std::endl;
     std::cout << "Ncells on the surf = " << m.cell2node.size() << std::endl;
-    std::cout << "NNodes on 3D = " << m3_ns.coords.size() << std::endl;
-    std::cout << "Ncells on 3D = " << m3_ns.cell2face.size() << std::endl;
-    assert(m3_ns.coords.size() == 12);
-    assert(m3_ns.cell2face.size() == 4);
-    assert(m3_ns.face2node.size() == 16);
+    std::cout << "NNodes on 3D = " << m3_ns.num_nodes() << std::endl;
+    std::cout << "Ncells on 3D = " << m3_ns.num_cells() << std::endl;
+    assert(m3_ns.num_nodes() == 12);
+    assert(m3_ns.num_cells() == 4);
+    assert(m3_ns.num_faces() == 16);
     
     writeMesh3D_exodus(m3_ns, mesh_out_ns);
   }
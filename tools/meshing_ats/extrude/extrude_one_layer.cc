@@ -24,8 +24,8 @@ int main() {
 
   std::cout << "NNodes on the surf = " << m.coords.size() << std::endl;
   std::cout << "Ncells on the surf = " << m.cell2node.size() << std::endl;
-  std::cout << "NNodes on 3D = " << m3.coords.size() << std::endl;
-  std::cout << "Ncells on 3D = " << m3.cell2face.size() << std::endl;
+  std::cout << "NNodes on 3D = " << m3.num_nodes() << std::endl;
+  std::cout << "Ncells on 3D = " << m3.num_cells() << std::endl;
 
   writeMesh3D_exodus(m3, mesh_out);
   return 0;
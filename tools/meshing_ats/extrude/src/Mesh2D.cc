@@ -20,6 +20,12 @@ Mesh2D::Mesh2D(std::vector<Point>& coords_,
 
   nnodes = coords.size();
   ncells = cell2node.size();
+
+  // a triangulation has roughly 3/2 faces per cell
+  int nfaces_guess = 3*ncells/2 + nnodes;
+  faces_sorted.reserve(nfaces_guess);
+  face2node.reserve(nfaces_guess);
+  cell2face.reserve(ncells);
   
   for (auto& c : cell2node) {
     Point v1(2), v2(2);
@@ -86,16 +92,15 @@ Mesh2D::face_constructor(const std::vector<int>& nodes,
   auto h = nodes[0] > nodes[1] ? hash(nodes[1], nodes[0]) :
       hash(nodes[0],nodes[1]);
 
-  auto match = faces_sorted.find(h);
-  if (match != faces_sorted.end()) {
-    int f = match->second;
+  int f = faces_sorted.find(h);
+  if (f >= 0) {
     side_face_counts[f]++;
     return f;
   }
 
   // not already created
-  int f = face2node.size();
-  faces_sorted[h] = f;
+  f = face2node.size();
+  faces_sorted.insert(h, f);
   face2node.emplace_back(nodes);
   face_in_cell_when_created.push_back(index_in_cell);
   face_cell_when_created.push_back(cell);
@@ -104,6 +109,61 @@ Mesh2D::face_constructor(const std::vector<int>& nodes,
 }
 
 
+namespace {
+
+inline std::size_t
+hash_slot(int64_t key, std::size_t mask) {
+  // splitmix64 finalizer, as keys are far from uniformly distributed
+  uint64_t z = (uint64_t) key;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  z = z ^ (z >> 31);
+  return (std::size_t) z & mask;
+}
+
+}
+
+
+void
+FaceHash::reserve(int n) {
+  // keep the load factor under 1/2
+  std::size_t capacity = 16;
+  while (capacity < 2 * (std::size_t) std::max(n, size)) capacity *= 2;
+  if (capacity <= keys.size()) return;
+
+  std::vector<int64_t> old_keys(capacity, -1);
+  std::vector<int> old_vals(capacity, -1);
+  old_keys.swap(keys);
+  old_vals.swap(vals);
+  mask = capacity - 1;
+  size = 0;
+  for (std::size_t i=0; i!=old_keys.size(); ++i) {
+    if (old_keys[i] >= 0) insert(old_keys[i], old_vals[i]);
+  }
+}
+
+
+int
+FaceHash::find(int64_t key) const {
+  if (keys.empty()) return -1;
+  for (std::size_t i=hash_slot(key, mask); ; i=(i+1) & mask) {
+    if (keys[i] == key) return vals[i];
+    if (keys[i] < 0) return -1;
+  }
+}
+
+
+void
+FaceHash::insert(int64_t key, int f) {
+  AMANZI_ASSERT(key >= 0);
+  if (2 * (std::size_t) (size+1) > keys.size()) reserve(2 * (size+1));
+
+  std::size_t i = hash_slot(key, mask);
+  while (keys[i] >= 0 && keys[i] != key) i = (i+1) & mask;
+  if (keys[i] < 0) size++;
+  keys[i] = key;
+  vals[i] = f;
+}
 
 }
 }
@@ -1,7 +1,7 @@
 #include <set>
 #include <algorithm>
 #include <numeric>
-#include <fstream>
+#include <thread>
 
 #include "Mesh2D.hh"
 #include "Mesh3D.hh"
@@ -11,155 +11,159 @@
 namespace Amanzi {
 namespace AmanziGeometry {
 
-Mesh3D::Mesh3D(const Mesh2D * const m_, int n_layers) :
+namespace {
+
+// Calls f(begin, end, thread) on contiguous chunks of [0,n), one per thread.
+template<typename F>
+void
+parallel_chunks(int n, int nthreads, const F& f) {
+  int chunk = (n + nthreads - 1) / nthreads;
+  std::vector<std::thread> threads;
+  for (int t=1; t<nthreads; ++t) {
+    int begin = std::min(t*chunk, n);
+    int end = std::min(begin+chunk, n);
+    threads.emplace_back([&f,begin,end,t]() { f(begin, end, t); });
+  }
+  f(0, std::min(chunk, n), 0);
+  for (auto& thread : threads) thread.join();
+}
+
+}
+
+
+Mesh3D::Mesh3D(const Mesh2D * const m_, int n_layers, int n_threads_) :
     m(m_),
     current_layer(0),
     total_layers(n_layers),
-    datum(m_->datum),
-    cells_in_col(m->ncells, 0)    
+    n_threads(n_threads_),
+    finished(false),
+    datum(m_->datum)
 {
-  // reserve/allocate space
-  Point d(3);
-  int n_nodes = m->nnodes*(n_layers+1);
-  coords.reserve(n_nodes);
-  
-  int n_cells = n_layers * m->ncells;
-  cell2face.reserve(n_cells);
-
-  int n_faces = n_layers * m->nfaces
-      + (n_layers+1)*m->ncells;
-  face2node.reserve(n_faces);
-
-  // copy the top surface coords
-  coords.insert(coords.end(), m->coords.begin(), m->coords.end());
-
-  // create the top layer of faces
-  face2node.insert(face2node.end(), m->cell2node.begin(),
-                   m->cell2node.end());
-  up_faces.resize(face2node.size());
-  std::iota(up_faces.begin(), up_faces.end(), 0);
-  up_nodes.resize(coords.size());
-  std::iota(up_nodes.begin(), up_nodes.end(), 0);
-  dn_nodes = up_nodes;
-  dn_faces = up_faces;
+  if (n_threads <= 0) n_threads = std::max(1, (int) std::thread::hardware_concurrency());
+
+  // the top surface
+  n_nodes = m->nnodes;
+  n_faces = m->ncells;
+  n_cells = 0;
+  n_face_nodes = 0;
+  for (auto& nodes : m->cell2node) n_face_nodes += nodes.size();
+
+  layers.reserve(n_layers);
+  first_layer.resize(m->ncells, -1);
+  last_layer.resize(m->ncells, -1);
 
   // create the "bottom" sideset
   side_sets.emplace_back(std::piecewise_construct,
                          std::forward_as_tuple(m->ncells, -1),
                          std::forward_as_tuple(m->ncells, 1));
   side_sets_id.push_back(1);
-  
+  side_sets_block.emplace_back(m->ncells, -1);
+
   // create the "surface" sideset
   side_sets.emplace_back(std::piecewise_construct,
                          std::forward_as_tuple(m->ncells, -1),
                          std::forward_as_tuple(m->ncells, 0));
   side_sets_id.push_back(2);
+  side_sets_block.emplace_back(m->ncells, -1);
 
   // create an empty "sides" sideset
   side_sets.emplace_back(std::make_pair(std::vector<int>(), std::vector<int>()));
   side_sets_id.push_back(3);
+  side_sets_block.emplace_back();
 }
 
 
 void
-Mesh3D::extrude(const std::vector<double>& dz,
-                const std::vector<int>& block_ids_,
-                bool squash_zero_edges) {
-  AMANZI_ASSERT(dz.size() == m->coords.size());
-  AMANZI_ASSERT(block_ids_.size() == m->cell2node.size());
-
-  auto this_layer_sides = std::vector<int>(m->face2node.size(), -1);
-  auto node_differs = [this](int n) {return this->dn_nodes[n] != this->up_nodes[n];};
-  auto node_same_horiz = [this](int n) {return is_equal(coords[this->dn_nodes[n]][0],
-                                                        coords[this->up_nodes[n]][0])
-                                            && is_equal(coords[this->dn_nodes[n]][1],
-                                                        coords[this->up_nodes[n]][1]);};
-  // shift the up-node coordinates by dz
-  for (int n=0; n!=dz.size(); ++n) {
-    if (!squash_zero_edges || dz[n] > 0.) {
-      Point nc(coords[up_nodes[n]]);
-      nc[2] -= dz[n];
-      coords.emplace_back(std::move(nc));
-      dn_nodes[n] = coords.size()-1;
-    }
+Mesh3D::extrude_(LayerSpec&& spec) {
+  AMANZI_ASSERT(!finished);
+  AMANZI_ASSERT(spec.dzs.empty() || spec.dzs.size() == m->coords.size());
+  AMANZI_ASSERT(spec.block_ids.empty() || spec.block_ids.size() == m->cell2node.size());
+  int layer = layers.size();
+
+  // count the new nodes
+  std::vector<char> moved(m->nnodes);
+  for (int n=0; n!=m->nnodes; ++n) {
+    moved[n] = moves_(spec, n);
+    if (moved[n]) n_nodes++;
   }
+  auto node_differs = [&moved](int n) { return moved[n] != 0; };
 
-  // add cells, faces
+  // count cells and faces, and label them
   for (int c=0; c!=m->ncells; ++c) {
-    if (std::any_of(m->cell2node[c].begin(), m->cell2node[c].end(), node_differs)) {
-      cells_in_col[c]++;
-      
-      // add the bottom face
-      std::vector<int> dn_face;
-      for (auto n : m->cell2node[c]) dn_face.emplace_back(dn_nodes[n]);
-      int my_dn_f = face2node.size();
-      face2node.emplace_back(std::move(dn_face));
-      dn_faces[c] = my_dn_f;
-
-      // push back a cell containing the up, dn faces
-      auto cell_faces = std::vector<int>{up_faces[c], dn_faces[c]};
-      int my_c = cell2face.size();
-
-      // if this is the top cell, put it into the surface side set
-      if (side_sets[1].first[c] < 0) side_sets[1].first[c] = my_c;
-      // put this cell into the bottom side set -- will be overwritten if any lower
-      side_sets[0].first[c] = my_c;
-
-      // add faces for the sides as needed
-      for (auto sf : m->cell2face[c]) {
-        int my_f = this_layer_sides[sf];
-
-        AMANZI_ASSERT(node_same_horiz(m->face2node[sf][0]));
-        AMANZI_ASSERT(node_same_horiz(m->face2node[sf][1]));
-        
-        if (std::any_of(m->face2node[sf].begin(), m->face2node[sf].end(),
-                        node_differs)) {
-          if (my_f < 0) {
-            // may need to create the face
-            my_f = face2node.size();
-            auto side_nodes = std::vector<int>{ up_nodes[m->face2node[sf][1]], 
-                                                up_nodes[m->face2node[sf][0]] };
-            if (node_differs(m->face2node[sf][0])) side_nodes.push_back(dn_nodes[m->face2node[sf][0]]);
-            if (node_differs(m->face2node[sf][1])) side_nodes.push_back(dn_nodes[m->face2node[sf][1]]);
-            face2node.emplace_back(std::move(side_nodes));
-            cell_faces.push_back(my_f);
-            this_layer_sides[sf] = my_f;
-
-            // check if this is a boundary side, and add it to the side_set if so
-            if (m->side_face_counts[sf] == 1) {
-              side_sets[2].first.push_back(my_c);
-              side_sets[2].second.push_back(cell_faces.size() - 1);
-            }
-            
-          } else {
-            // no need to create the face, but the cell still needs to know it
-            cell_faces.push_back(my_f);
-          }
+    if (!std::any_of(m->cell2node[c].begin(), m->cell2node[c].end(), node_differs))
+      continue;
 
+    n_cells++;
+    int block = spec.block_of(c);
+    int my_c = block_counts[block]++;
+
+    // if this is the top cell, put it into the surface side set
+    if (first_layer[c] < 0) {
+      first_layer[c] = layer;
+      side_sets[1].first[c] = my_c;
+      side_sets_block[1][c] = block;
+    }
+    // put this cell into the bottom side set -- will be overwritten if any lower
+    last_layer[c] = layer;
+    side_sets[0].first[c] = my_c;
+    side_sets_block[0][c] = block;
+
+    // the bottom face
+    n_faces++;
+    n_face_nodes += m->cell2node[c].size();
+
+    // the side faces, which are created by the first cell to touch them
+    int n_cell_faces = 2;
+    for (auto sf : m->cell2face[c]) {
+      int n0 = m->face2node[sf][0];
+      int n1 = m->face2node[sf][1];
+      if (!moved[n0] && !moved[n1]) continue;
+
+      n_cell_faces++;
+      if (m->face_cell_when_created[sf] == c) {
+        n_faces++;
+        n_face_nodes += 2 + (moved[n0] ? 1 : 0) + (moved[n1] ? 1 : 0);
+
+        // check if this is a boundary side, and add it to the side_set if so
+        if (m->side_face_counts[sf] == 1) {
+          side_sets[2].first.push_back(my_c);
+          side_sets[2].second.push_back(n_cell_faces - 1);
+          side_sets_block[2].push_back(block);
         }
       }
-
-      // finally add the cell, including a block id
-      cell2face.emplace_back(std::move(cell_faces));
-      block_ids.push_back(block_ids_[c]);
     }
+    block_face_counts[block] += n_cell_faces;
   }
 
   // increment the layer metadata
+  layers.emplace_back(std::move(spec));
   current_layer++;
-  up_nodes = dn_nodes;
-  up_faces = dn_faces;
-
-  AMANZI_ASSERT(block_ids.size() == cell2face.size());
-  std::cout << "POST-Extruding: currently " << cell2face.size() << " cells and " << face2node.size() << " faces." << std::endl;
-
 }
 
+
 void
 Mesh3D::finish() {
-  // flip the bottom faces for proper outward orientation
-  for (auto f : dn_faces)
-    std::reverse(face2node[f].begin(), face2node[f].end());
+  AMANZI_ASSERT(!finished);
+
+  // number cells block by block
+  std::map<int, int> block_start;
+  int start = 0;
+  for (auto& count : block_counts) {
+    block_set_ids.push_back(count.first);
+    block_ncells.push_back(count.second);
+    block_nfaces.push_back(block_face_counts[count.first]);
+    block_start[count.first] = start;
+    start += count.second;
+  }
+  AMANZI_ASSERT(start == n_cells);
+
+  for (int lcv_s=0; lcv_s!=side_sets_block.size(); ++lcv_s) {
+    auto& cells = side_sets[lcv_s].first;
+    for (int i=0; i!=cells.size(); ++i) {
+      if (cells[i] >= 0) cells[i] += block_start[side_sets_block[lcv_s][i]];
+    }
+  }
+  side_sets_block.clear();
 
   // move the 2d cell sets to face sets on the surface
   std::set<int> set_ids;
@@ -171,7 +175,7 @@ Mesh3D::finish() {
     std::vector<int> set_cells;
     for (auto& part : m->cell_sets) {
       for (int c=0; c!=part.size(); ++c) {
-        if (part[c] == sid) {
+        if (part[c] == sid && side_sets[1].first[c] >= 0) {
           set_cells.push_back(side_sets[1].first[c]);
         }
       }
@@ -182,28 +186,227 @@ Mesh3D::finish() {
     side_sets_id.push_back(sid);
   }
 
-  // check side sets
-  std::vector<int> side_face_counts(face2node.size(), 0);
-  for (auto& c : cell2face)
-    for (auto& f : c)
-      side_face_counts[f]++;
-  
-  for (int lcv_s=0; lcv_s!=side_sets.size(); ++lcv_s) {
-    auto& fs = side_sets[lcv_s]; 
-    for (int i=0; i!=side_sets[lcv_s].first.size(); ++i) {
-      int c = fs.first[i];
-      int fi = fs.second[i];
-      int f = cell2face[c][fi];
-      if (side_face_counts[f] != 1) {
-        std::cout << "Face Set " << side_sets_id[lcv_s] << ": face = " << f << " (" << c << "," << fi << ") has been counted " << side_face_counts[f] << " times (should be 1)!" << std::endl;
+  // columns in which every layer was squashed have no cells, and so no top or
+  // bottom face
+  for (int lcv_s=0; lcv_s!=2; ++lcv_s) {
+    auto& cells = side_sets[lcv_s].first;
+    auto& faces = side_sets[lcv_s].second;
+    int n = 0;
+    for (int i=0; i!=cells.size(); ++i) {
+      if (cells[i] >= 0) {
+        cells[n] = cells[i];
+        faces[n] = faces[i];
+        n++;
+      }
+    }
+    cells.resize(n);
+    faces.resize(n);
+  }
+
+  finished = true;
+}
+
+
+void
+Mesh3D::generate(const std::function<void(const Layer&)>& visit) const {
+  AMANZI_ASSERT(finished);
+
+  // the top surface
+  Layer top;
+  top.layer = -1;
+  top.node_begin = 0;
+  top.face_begin = 0;
+  top.cell_begin = 0;
+  for (auto& p : m->coords) {
+    top.x.push_back(p[0]);
+    top.y.push_back(p[1]);
+    top.z.push_back(p[2]);
+  }
+  top.face_offsets.push_back(0);
+  for (int c=0; c!=m->ncells; ++c) {
+    // columns with no cells have their top face on the bottom
+    if (last_layer[c] < 0) {
+      top.face_nodes.insert(top.face_nodes.end(),
+                            m->cell2node[c].rbegin(), m->cell2node[c].rend());
+    } else {
+      top.face_nodes.insert(top.face_nodes.end(),
+                            m->cell2node[c].begin(), m->cell2node[c].end());
+    }
+    top.face_offsets.push_back(top.face_nodes.size());
+  }
+  top.cell_offsets.push_back(0);
+  visit(top);
+
+  // state of the bottom of the previous layer
+  std::vector<int> up_nodes(m->nnodes), dn_nodes(m->nnodes);
+  std::iota(up_nodes.begin(), up_nodes.end(), 0);
+  std::vector<double> up_z(top.z);
+  std::vector<int> up_faces(m->ncells);
+  std::iota(up_faces.begin(), up_faces.end(), 0);
+
+  int next_node = top.num_nodes();
+  int next_face = top.num_faces();
+  int next_cell = 0;
+
+  // per-column work arrays: first counts, then offsets into the layer
+  std::vector<char> moved(m->nnodes), present(m->ncells);
+  std::vector<int> col_cell(m->ncells), col_face(m->ncells);
+  std::vector<int> col_face_node(m->ncells), col_cell_face(m->ncells);
+
+  for (int layer=0; layer!=layers.size(); ++layer) {
+    const LayerSpec& spec = layers[layer];
+    Layer out;
+    out.layer = layer;
+    out.node_begin = next_node;
+    out.face_begin = next_face;
+    out.cell_begin = next_cell;
+
+    // new nodes
+    dn_nodes = up_nodes;
+    for (int n=0; n!=m->nnodes; ++n) {
+      moved[n] = moves_(spec, n);
+      if (moved[n]) {
+        dn_nodes[n] = next_node + out.x.size();
+        up_z[n] -= spec.dz_of(n);
+        out.x.push_back(m->coords[n][0]);
+        out.y.push_back(m->coords[n][1]);
+        out.z.push_back(up_z[n]);
       }
     }
+
+    // Columns are split into contiguous chunks, one per thread.  The first
+    // pass counts each column's entities, the second turns counts into
+    // offsets, and the third fills the layer.  Passes are separate as
+    // columns reference side faces owned by their neighbors.
+    int nthreads = std::max(1, std::min(n_threads, m->ncells / 4096));
+    std::vector<std::vector<int> > chunk_counts(nthreads, std::vector<int>(4, 0));
+
+    parallel_chunks(m->ncells, nthreads, [&](int begin, int end, int t) {
+        auto& counts = chunk_counts[t];
+        for (int c=begin; c!=end; ++c) {
+          col_cell[c] = 0; col_face[c] = 0; col_face_node[c] = 0; col_cell_face[c] = 0;
+          present[c] = std::any_of(m->cell2node[c].begin(), m->cell2node[c].end(),
+                  [&moved](int n) { return moved[n] != 0; });
+          if (!present[c]) continue;
+
+          col_cell[c] = 1;
+          col_face[c] = 1;
+          col_face_node[c] = m->cell2node[c].size();
+          col_cell_face[c] = 2;
+          for (auto sf : m->cell2face[c]) {
+            int n0 = m->face2node[sf][0];
+            int n1 = m->face2node[sf][1];
+            if (!moved[n0] && !moved[n1]) continue;
+            col_cell_face[c]++;
+            if (m->face_cell_when_created[sf] == c) {
+              col_face[c]++;
+              col_face_node[c] += 2 + (moved[n0] ? 1 : 0) + (moved[n1] ? 1 : 0);
+            }
+          }
+          counts[0] += col_cell[c];
+          counts[1] += col_face[c];
+          counts[2] += col_face_node[c];
+          counts[3] += col_cell_face[c];
+        }
+      });
+
+    std::vector<int> totals(4, 0);
+    for (auto& counts : chunk_counts) {
+      for (int i=0; i!=4; ++i) {
+        int count = counts[i];
+        counts[i] = totals[i];
+        totals[i] += count;
+      }
+    }
+
+    parallel_chunks(m->ncells, nthreads, [&](int begin, int end, int t) {
+        auto offsets = chunk_counts[t];
+        for (int c=begin; c!=end; ++c) {
+          int count = col_cell[c]; col_cell[c] = offsets[0]; offsets[0] += count;
+          count = col_face[c]; col_face[c] = offsets[1]; offsets[1] += count;
+          count = col_face_node[c]; col_face_node[c] = offsets[2]; offsets[2] += count;
+          count = col_cell_face[c]; col_cell_face[c] = offsets[3]; offsets[3] += count;
+        }
+      });
+
+    out.cell_offsets.resize(totals[0] + 1);
+    out.cell_block_ids.resize(totals[0]);
+    out.face_offsets.resize(totals[1] + 1);
+    out.face_nodes.resize(totals[2]);
+    out.cell_faces.resize(totals[3]);
+    out.cell_offsets[totals[0]] = totals[3];
+    out.face_offsets[totals[1]] = totals[2];
+
+    // index of side face sf in the layer, owned by column c
+    auto side_face = [&](int c, int sf) {
+      int f = col_face[c] + 1;
+      for (auto other : m->cell2face[c]) {
+        if (other == sf) break;
+        if (m->face_cell_when_created[other] == c &&
+            (moved[m->face2node[other][0]] || moved[m->face2node[other][1]])) f++;
+      }
+      return f;
+    };
+
+    parallel_chunks(m->ncells, nthreads, [&](int begin, int end, int t) {
+        for (int c=begin; c!=end; ++c) {
+          if (!present[c]) continue;
+
+          int cf = col_cell_face[c];
+          int lc = col_cell[c];
+          int f = col_face[c];
+          int fn = col_face_node[c];
+          out.cell_offsets[lc] = cf;
+          out.cell_block_ids[lc] = spec.block_of(c);
+
+          // the bottom face, flipped for proper outward orientation if this
+          // is the bottom of the column
+          out.face_offsets[f] = fn;
+          if (last_layer[c] == layer) {
+            for (auto n = m->cell2node[c].rbegin(); n != m->cell2node[c].rend(); ++n)
+              out.face_nodes[fn++] = dn_nodes[*n];
+          } else {
+            for (auto n : m->cell2node[c]) out.face_nodes[fn++] = dn_nodes[n];
+          }
+          out.cell_faces[cf++] = up_faces[c];
+          out.cell_faces[cf++] = next_face + f;
+          up_faces[c] = next_face + f;
+          f++;
+
+          // add faces for the sides as needed
+          for (auto sf : m->cell2face[c]) {
+            int n0 = m->face2node[sf][0];
+            int n1 = m->face2node[sf][1];
+            if (!moved[n0] && !moved[n1]) continue;
+
+            int owner = m->face_cell_when_created[sf];
+            if (owner == c) {
+              out.face_offsets[f] = fn;
+              out.face_nodes[fn++] = up_nodes[n1];
+              out.face_nodes[fn++] = up_nodes[n0];
+              if (moved[n0]) out.face_nodes[fn++] = dn_nodes[n0];
+              if (moved[n1]) out.face_nodes[fn++] = dn_nodes[n1];
+              out.cell_faces[cf++] = next_face + f;
+              f++;
+            } else {
+              // no need to create the face, but the cell still needs to know it
+              out.cell_faces[cf++] = next_face + side_face(owner, sf);
+            }
+          }
+        }
+      });
+
+    // increment the layer metadata
+    up_nodes.swap(dn_nodes);
+    next_node += out.num_nodes();
+    next_face += out.num_faces();
+    next_cell += out.num_cells();
+    visit(out);
   }
 
-  std::ofstream fid;
-  fid.open("col_counts.txt");
-  for (auto c : cells_in_col) fid << c << std::endl;
-  fid.close();
+  AMANZI_ASSERT(next_node == n_nodes);
+  AMANZI_ASSERT(next_face == n_faces);
+  AMANZI_ASSERT(next_cell == n_cells);
 }
 
 
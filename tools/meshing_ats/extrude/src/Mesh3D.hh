@@ -4,6 +4,7 @@
 #include <vector>
 #include <utility>
 #include <algorithm>
+#include <functional>
 #include <map>
 #include <stdint.h>
 
@@ -14,54 +15,139 @@
 namespace Amanzi {
 namespace AmanziGeometry {
 
-
+//
+// An extruded 3D mesh.
+//
+// The 3D topology and coordinates are never stored.  extrude() records each
+// layer and counts its nodes, faces, and cells, which is enough to know the
+// sizes and labels of the mesh.  The topology and geometry are then generated
+// a layer at a time by generate(), which a writer can stream to disk.
+//
+// This bounds the memory of the connectivity, coordinates, and face-to-node
+// lists by a single layer, but other storage still grows with the 3D mesh:
+// each layer's spec keeps its per-node dzs and per-cell block ids, the side
+// sets are stored in full, and the Exodus writer buffers a node count per
+// face and a face count per cell, as Exodus requires those before the
+// connectivity.
+//
+// Entities are numbered as if the mesh were built layer by layer from the
+// surface down: the top surface nodes and faces come first, then for each
+// layer its new nodes, and for each cell in the layer its bottom face and
+// any side faces it is the first to touch.
+//
 struct Mesh3D {
-  Mesh3D(const Mesh2D * const m_, int n_layers);
+  Mesh3D(const Mesh2D * const m_, int n_layers, int n_threads=0);
 
   void extrude(double dz, const std::vector<int>& cell_set, bool squash_zero_edges=true) {
-    std::vector<double> dzs(m->coords.size(), dz);
-    extrude(dzs, cell_set, squash_zero_edges);
+    LayerSpec spec;
+    spec.dz = dz;
+    spec.block_ids = cell_set;
+    spec.squash_zero_edges = squash_zero_edges;
+    extrude_(std::move(spec));
   }
 
   void extrude(const std::vector<double>& dzs, int my_cell_set, bool squash_zero_edges=true) {
-    std::vector<int> cell_set(m->ncells, my_cell_set);
-    extrude(dzs, cell_set, squash_zero_edges);
+    LayerSpec spec;
+    spec.dzs = dzs;
+    spec.block_id = my_cell_set;
+    spec.squash_zero_edges = squash_zero_edges;
+    extrude_(std::move(spec));
   }
 
   void extrude(double dz, int my_cell_set, bool squash_zero_edges=true) {
-    std::vector<double> dzs(m->coords.size(), dz);
-    std::vector<int> cell_set(m->ncells, my_cell_set);
-    extrude(dzs, cell_set, squash_zero_edges);
+    LayerSpec spec;
+    spec.dz = dz;
+    spec.block_id = my_cell_set;
+    spec.squash_zero_edges = squash_zero_edges;
+    extrude_(std::move(spec));
   }
 
   void extrude(const std::vector<double>& dz,
                const std::vector<int>& cell_set,
-               bool squash_zero_edges=true);
-  void finish(); 
+               bool squash_zero_edges=true) {
+    LayerSpec spec;
+    spec.dzs = dz;
+    spec.block_ids = cell_set;
+    spec.squash_zero_edges = squash_zero_edges;
+    extrude_(std::move(spec));
+  }
+
+  void finish();
+
+  int num_nodes() const { return n_nodes; }
+  int num_faces() const { return n_faces; }
+  int num_cells() const { return n_cells; }
+
+  // One layer of the mesh, in flat CSR storage.  Node and face indices are
+  // global; offsets are local to the layer.  The top surface is passed as
+  // layer -1, with nodes and faces but no cells.
+  struct Layer {
+    int layer;
+    int node_begin, face_begin, cell_begin;
+
+    std::vector<double> x, y, z;                // coordinates of new nodes
+    std::vector<int> face_offsets, face_nodes;  // new faces
+    std::vector<int> cell_offsets, cell_faces;  // new cells
+    std::vector<int> cell_block_ids;
+
+    int num_nodes() const { return x.size(); }
+    int num_faces() const { return face_offsets.size() - 1; }
+    int num_cells() const { return cell_offsets.size() - 1; }
+  };
+
+  // Generates the mesh a layer at a time, top down, calling visit on each.
+  // Each layer is generated in parallel over columns.  Only valid after
+  // finish().
+  void generate(const std::function<void(const Layer&)>& visit) const;
 
   const Mesh2D * const m;
 
-  // basic geometric/topology info
-  std::vector<Point> coords;
-  std::vector<std::vector<int> > cell2face;
-  std::vector<std::vector<int> > face2node;
+  // sizes
+  int n_nodes, n_faces, n_cells;
+  long n_face_nodes;  // length of the flattened face-to-node list
+
+  // blocks, sorted by id, with cells numbered block by block as in the
+  // written file
+  std::vector<int> block_set_ids;
+  std::vector<int> block_ncells;
+  std::vector<long> block_nfaces;  // length of the flattened cell-to-face list
 
-  // labels
-  std::vector<int> block_ids;
+  // labels -- side set cells are in the block-by-block numbering
   std::vector<std::pair<std::vector<int>,
                         std::vector<int> > > side_sets;
   std::vector<int> side_sets_id;
 
   // internally used to extrude
-  std::vector<int> up_faces;
-  std::vector<int> dn_faces;
-  std::vector<int> up_nodes;
-  std::vector<int> dn_nodes;
-  std::vector<int> cells_in_col;
+  struct LayerSpec {
+    LayerSpec() : dz(0.), block_id(-1), squash_zero_edges(true) {}
+
+    double dz_of(int n) const { return dzs.empty() ? dz : dzs[n]; }
+    int block_of(int c) const { return block_ids.empty() ? block_id : block_ids[c]; }
+
+    double dz;                 // used if dzs is empty
+    std::vector<double> dzs;
+    int block_id;              // used if block_ids is empty
+    std::vector<int> block_ids;
+    bool squash_zero_edges;
+  };
+  void extrude_(LayerSpec&& spec);
+  bool moves_(const LayerSpec& spec, int n) const {
+    return !spec.squash_zero_edges || spec.dz_of(n) > 0.;
+  }
+
+  std::vector<LayerSpec> layers;
+  std::map<int, int> block_counts;        // cells counted so far, by block id
+  std::map<int, long> block_face_counts;
+  std::vector<int> first_layer, last_layer;
+
+  // side set cells, as (block id, index within block) until finish()
+  std::vector<std::vector<int> > side_sets_block;
 
   // other meta-data
   int current_layer;
   int total_layers;
+  int n_threads;
+  bool finished;
   Point datum;
 };
 
@@ -22,49 +22,17 @@ writeMesh3D_exodus(const Mesh3D& m, const std::string& filename) {
     return;
   }
   
-  // make the blocks by set
-  std::set<int> set_ids(m.block_ids.begin(), m.block_ids.end());
-  std::vector<std::vector<int> > blocks;
-  std::vector<int> blocks_ncells;
-  std::vector<int> blocks_id;
-  std::vector<std::vector<int> > block_face_counts;
-
-  int new_id = 0;
-  std::vector<int> cell_map(m.cell2face.size(), -1);
-  for (auto sid : set_ids) {
-    std::vector<int> block;
-    std::vector<int> face_counts;
-    // count things
-    int ncells = 0;
-
-    for (int i=0; i!=m.cell2face.size(); ++i) {
-      if (m.block_ids[i] == sid) {
-        ncells++;
-        block.insert(block.end(), m.cell2face[i].begin(), m.cell2face[i].end());
-        face_counts.push_back(m.cell2face[i].size());
-        cell_map[i] = new_id;
-        new_id++;
-      }
-    }
-
-    blocks.emplace_back(block);
-    blocks_ncells.push_back(ncells);
-    blocks_id.push_back(sid);
-    block_face_counts.emplace_back(face_counts);
-  }
-
-
   // create the params
   ex_init_params params;
   sprintf(params.title, "my_mesh");
   params.num_dim = 3;
-  params.num_nodes = m.coords.size();
+  params.num_nodes = m.num_nodes();
   params.num_edge = 0;
   params.num_edge_blk = 0;
-  params.num_face = m.face2node.size();
+  params.num_face = m.num_faces();
   params.num_face_blk = 1;
-  params.num_elem = m.cell2face.size();
-  params.num_elem_blk = set_ids.size();
+  params.num_elem = m.num_cells();
+  params.num_elem_blk = m.block_set_ids.size();
   params.num_node_maps = 0;
   params.num_edge_maps = 0;
   params.num_face_maps = 0;
@@ -77,19 +45,6 @@ writeMesh3D_exodus(const Mesh3D& m, const std::string& filename) {
 
   int ierr = ex_put_init_ext(fid, &params);
   AMANZI_ASSERT(!ierr);
-  
-  // make the coordinate arrays, set the coordinates
-  // NOTE: exodus seems to only deal with floats!
-  std::vector<std::vector<float> > coords(3);
-  for (int i=0; i!=3; ++i) {
-    coords[i].resize(m.coords.size());
-  }
-
-  for (int n=0; n!=coords[0].size(); ++n) {
-    coords[0][n] = m.coords[n][0];
-    coords[1][n] = m.coords[n][1];
-    coords[2][n] = m.coords[n][2];
-  }
 
   char* coord_names[3];
   char a[10]="xcoord";
@@ -101,54 +56,94 @@ writeMesh3D_exodus(const Mesh3D& m, const std::string& filename) {
 
   ierr |= ex_put_coord_names(fid, coord_names);
   AMANZI_ASSERT(!ierr);
-  ierr |= ex_put_coord(fid, &coords[0][0], &coords[1][0], &coords[2][0]);
-  AMANZI_ASSERT(!ierr);
 
-  
-  // put in the face block
-  std::vector<int> facenodes;
-  std::vector<int> facenodes_counts;
-  for (auto& nodes : m.face2node) {
-    facenodes_counts.push_back(nodes.size());
-    facenodes.insert(facenodes.end(), nodes.begin(), nodes.end());
-  }
+  // define the face block and element blocks, which are filled as the mesh
+  // is generated
   ierr |= ex_put_block(fid, EX_FACE_BLOCK, 1, "NSIDED",
-                       m.face2node.size(), facenodes.size(), 0,0,0);
+                       m.num_faces(), m.n_face_nodes, 0,0,0);
   AMANZI_ASSERT(!ierr);
 
+  int nblocks = m.block_set_ids.size();
+  for (int lcvb=0; lcvb!=nblocks; ++lcvb) {
+    ierr |= ex_put_block(fid, EX_ELEM_BLOCK, m.block_set_ids[lcvb], "NFACED",
+                         m.block_ncells[lcvb], 0, 0, m.block_nfaces[lcvb],0);
+    AMANZI_ASSERT(!ierr);
+  }
+
+  // Stream the mesh to the file a layer at a time.  Within a block, cells
+  // are numbered layer by layer, so each layer's cells are a contiguous
+  // range of the block.  Polyhedral connectivity is a single flat list, so
+  // partial writes are in units of entries of that list.
+  //
+  // NOTE: exodus seems to only deal with floats!
+  std::vector<int> facenodes_counts;
+  facenodes_counts.reserve(m.num_faces());
+  std::vector<std::vector<int> > block_face_counts(nblocks);
+  std::vector<int64_t> block_entries(nblocks, 0);
+  int64_t face_entries = 0;
+
+  std::vector<float> xs, ys, zs;
+  std::vector<int> conn;
+  m.generate([&](const Mesh3D::Layer& layer) {
+      // coordinates
+      if (layer.num_nodes() > 0) {
+        xs.assign(layer.x.begin(), layer.x.end());
+        ys.assign(layer.y.begin(), layer.y.end());
+        zs.assign(layer.z.begin(), layer.z.end());
+        ierr |= ex_put_partial_coord(fid, layer.node_begin+1, layer.num_nodes(),
+                &xs[0], &ys[0], &zs[0]);
+        AMANZI_ASSERT(!ierr);
+      }
+
+      // faces
+      if (layer.num_faces() > 0) {
+        for (int f=0; f!=layer.num_faces(); ++f)
+          facenodes_counts.push_back(layer.face_offsets[f+1] - layer.face_offsets[f]);
+        conn.resize(layer.face_nodes.size());
+        for (int i=0; i!=conn.size(); ++i) conn[i] = layer.face_nodes[i] + 1;
+        ierr |= ex_put_partial_conn(fid, EX_FACE_BLOCK, 1, face_entries+1, conn.size(),
+                &conn[0], NULL, NULL);
+        AMANZI_ASSERT(!ierr);
+        face_entries += conn.size();
+      }
+
+      // cells, by block
+      for (int lcvb=0; lcvb!=nblocks; ++lcvb) {
+        conn.clear();
+        for (int lc=0; lc!=layer.num_cells(); ++lc) {
+          if (layer.cell_block_ids[lc] != m.block_set_ids[lcvb]) continue;
+          int begin = layer.cell_offsets[lc];
+          int end = layer.cell_offsets[lc+1];
+          block_face_counts[lcvb].push_back(end - begin);
+          for (int i=begin; i!=end; ++i) conn.push_back(layer.cell_faces[i] + 1);
+        }
+        if (conn.size() > 0) {
+          ierr |= ex_put_partial_conn(fid, EX_ELEM_BLOCK, m.block_set_ids[lcvb],
+                  block_entries[lcvb]+1, conn.size(), NULL, NULL, &conn[0]);
+          AMANZI_ASSERT(!ierr);
+          block_entries[lcvb] += conn.size();
+        }
+      }
+    });
+  AMANZI_ASSERT(face_entries == m.n_face_nodes);
+
   ierr |= ex_put_entity_count_per_polyhedra(fid, EX_FACE_BLOCK, 1,
           &facenodes_counts[0]);
   AMANZI_ASSERT(!ierr);
 
-  for (auto& e : facenodes) e++;
-  ierr |= ex_put_conn(fid, EX_FACE_BLOCK, 1, &facenodes[0], NULL, NULL);
-  AMANZI_ASSERT(!ierr);
-  
-
-  // put in the element blocks
-  for (int lcvb=0; lcvb!=blocks.size(); ++lcvb) {
-    ierr |= ex_put_block(fid, EX_ELEM_BLOCK, blocks_id[lcvb], "NFACED",
-                         blocks_ncells[lcvb], 0, 0, blocks[lcvb].size(),0);
-    AMANZI_ASSERT(!ierr);
-
-    ierr |= ex_put_entity_count_per_polyhedra(fid, EX_ELEM_BLOCK, blocks_id[lcvb],
+  for (int lcvb=0; lcvb!=nblocks; ++lcvb) {
+    AMANZI_ASSERT(block_entries[lcvb] == m.block_nfaces[lcvb]);
+    ierr |= ex_put_entity_count_per_polyhedra(fid, EX_ELEM_BLOCK, m.block_set_ids[lcvb],
             &block_face_counts[lcvb][0]);
     AMANZI_ASSERT(!ierr);
-
-    for (auto&e : blocks[lcvb]) e++;
-    ierr |= ex_put_conn(fid, EX_ELEM_BLOCK, blocks_id[lcvb], NULL, NULL, &blocks[lcvb][0]);
-    AMANZI_ASSERT(!ierr);
   }
 
-  
-  // add the side sets, mapping elems to the new ids
+  // add the side sets, which are already in the block-by-block numbering
   for (int lcvs=0; lcvs!=m.side_sets.size(); ++lcvs) {
     auto& s = m.side_sets[lcvs];
-    std::vector<int> elems_copy(s.first.size(), -1);
+    std::vector<int> elems_copy(s.first);
     auto faces_copy(s.second);
-    for (int i=0; i!=elems_copy.size(); ++i) {
-      elems_copy[i] = cell_map[s.first[i]] + 1;
-    }
+    for (auto& e : elems_copy) e++;
     for (auto& e : faces_copy) e++;
     ierr |= ex_put_set_param(fid, EX_SIDE_SET, m.side_sets_id[lcvs], elems_copy.size(), 0);
     AMANZI_ASSERT(!ierr);
@@ -162,9 +157,9 @@ writeMesh3D_exodus(const Mesh3D& m, const std::string& filename) {
 
   // debugging/nice output
   std::cout << "Wrote 3D Mesh:" << std::endl
-            << "  ncells = " << m.cell2face.size() << std::endl
-            << "  nfaces = " << m.face2node.size() << std::endl
-            << "  nnodes = " << m.coords.size() << std::endl
+            << "  ncells = " << m.num_cells() << std::endl
+            << "  nfaces = " << m.num_faces() << std::endl
+            << "  nnodes = " << m.num_nodes() << std::endl
             << std::endl
             << "  side sets = " << std::endl;
   for (int i=0; i!=m.side_sets.size(); ++i)
@@ -172,9 +167,9 @@ writeMesh3D_exodus(const Mesh3D& m, const std::string& filename) {
               << m.side_sets[i].first.size() << " faces)" << std::endl;
   std::cout << std::endl
             << "  block ids = " << std::endl;
-  for (int i=0; i!=blocks_id.size(); ++i)
-    std::cout << "    " << blocks_id[i] << " ("
-              << blocks_ncells[i] << " cells)" << std::endl;
+  for (int i=0; i!=nblocks; ++i)
+    std::cout << "    " << m.block_set_ids[i] << " ("
+              << m.block_ncells[i] << " cells)" << std::endl;
   std::cout << std::endl;
   
 }
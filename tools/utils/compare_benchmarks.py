@@ -0,0 +1,45 @@
+"""Compares two sets of ats_benchmarks JSON results, e.g. between releases.
+
+Prints the ratio of ns/cell (new / old) for each benchmark, flagging any
+that slowed down by more than a given tolerance.  Exits nonzero if any
+regression is found.
+"""
+
+import sys
+import json
+
+def load(filename):
+    with open(filename, 'r') as fid:
+        data = json.load(fid)
+    return data['label'], dict(((b['group'], b['name']), b) for b in data['benchmarks'])
+
+def compare(old, new, tolerance):
+    old_label, old_b = load(old)
+    new_label, new_b = load(new)
+
+    print("{:14s} {:48s} {:>12s} {:>12s} {:>8s}".format("group", "benchmark", old_label, new_label, "ratio"))
+    print("-"*98)
+    regressions = 0
+    for key in sorted(new_b.keys()):
+        if key not in old_b:
+            continue
+        t_old = old_b[key]['ns_per_cell']
+        t_new = new_b[key]['ns_per_cell']
+        ratio = t_new / t_old if t_old > 0 else float('nan')
+        flag = ""
+        if ratio > 1 + tolerance:
+            flag = "  <-- REGRESSION"
+            regressions += 1
+        print("{:14s} {:48s} {:12.3f} {:12.3f} {:8.3f}{}".format(key[0], key[1], t_old, t_new, ratio, flag))
+    return regressions
+
+if __name__ == "__main__":
+    import argparse
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("OLD", type=str, help="Baseline JSON results.")
+    parser.add_argument("NEW", type=str, help="New JSON results.")
+    parser.add_argument("--tolerance", type=float, default=0.1,
+                        help="Relative slowdown considered a regression.")
+    args = parser.parse_args()
+
+    sys.exit(1 if compare(args.OLD, args.NEW, args.tolerance) > 0 else 0)